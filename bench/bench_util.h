@@ -0,0 +1,220 @@
+#pragma once
+
+// Helpers shared by the benchmark tools. Header-only so each tool stays one
+// translation unit.
+
+#include "maany_mpc.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace maany::bench {
+
+inline void Check(maany_mpc_error_t err, const char* where) {
+  if (err == MAANY_MPC_OK) return;
+  std::fprintf(stderr, "%s failed: %s (%d)\n", where, maany_mpc_error_string(err), static_cast<int>(err));
+  std::exit(1);
+}
+
+inline void FreeBuf(maany_mpc_ctx_t* ctx, maany_mpc_buf_t& buf) {
+  if (!buf.data) return;
+  maany_mpc_buf_free(ctx, &buf);
+  buf.data = nullptr;
+  buf.len = 0;
+}
+
+struct Message {
+  std::string from;
+  size_t bytes = 0;
+};
+
+// One call to a party's step function. `consumed` and `produced` index into
+// Transcript::messages, or are -1.
+struct Step {
+  int party = 0;  // 0: first, 1: second
+  double compute_ms = 0;
+  int consumed = -1;
+  int produced = -1;
+};
+
+// `steps` is recorded for two-party runs only, which is what --net models.
+struct Transcript {
+  std::vector<Message> messages;
+  std::vector<Step> steps;
+  int rounds = 0;  // step calls per party
+};
+
+using StepFn = std::function<maany_mpc_error_t(const maany_mpc_buf_t*, maany_mpc_buf_t*, maany_mpc_step_result_t*)>;
+
+// Alternates `first` and `second` until both report DONE, handing each
+// outbound frame to the other side, and records every frame and step in `log`.
+inline void Exchange(maany_mpc_ctx_t* ctx, const char* first_name, const StepFn& first, const char* second_name,
+                     const StepFn& second, Transcript* log) {
+  maany_mpc_buf_t to_first{nullptr, 0};
+  maany_mpc_buf_t to_second{nullptr, 0};
+  int to_first_index = -1;
+  int to_second_index = -1;
+  bool first_done = false;
+  bool second_done = false;
+
+  auto turn = [&](int party, const char* name, const StepFn& step, maany_mpc_buf_t& inbound, int& inbound_index,
+                  maany_mpc_buf_t& peer_inbound, int& peer_inbound_index, bool& done) {
+    if (done) return;
+    maany_mpc_buf_t outbound{nullptr, 0};
+    maany_mpc_step_result_t result{};
+    const auto start = std::chrono::steady_clock::now();
+    maany_mpc_error_t err = step(inbound.data ? &inbound : nullptr, &outbound, &result);
+    const auto end = std::chrono::steady_clock::now();
+    Step record;
+    record.party = party;
+    record.compute_ms = std::chrono::duration<double, std::milli>(end - start).count();
+    record.consumed = inbound.data ? inbound_index : -1;
+    FreeBuf(ctx, inbound);
+    inbound_index = -1;
+    Check(err, name);
+    if (outbound.data) {
+      FreeBuf(ctx, peer_inbound);
+      peer_inbound = outbound;
+      if (log) {
+        record.produced = static_cast<int>(log->messages.size());
+        log->messages.push_back({name, outbound.len});
+      }
+      peer_inbound_index = record.produced;
+    }
+    if (log) log->steps.push_back(record);
+    done = result == MAANY_MPC_STEP_DONE;
+  };
+
+  int rounds = 0;
+  for (; !(first_done && second_done); ++rounds) {
+    if (rounds > 256) {
+      std::fprintf(stderr, "protocol loop guard triggered\n");
+      std::exit(1);
+    }
+    turn(0, first_name, first, to_first, to_first_index, to_second, to_second_index, first_done);
+    turn(1, second_name, second, to_second, to_second_index, to_first, to_first_index, second_done);
+  }
+  FreeBuf(ctx, to_first);
+  FreeBuf(ctx, to_second);
+  if (log) log->rounds = rounds;
+}
+
+using PeerStepFn = std::function<maany_mpc_error_t(const maany_mpc_peer_msg_t*, size_t, maany_mpc_peer_msg_t**,
+                                                   size_t*, maany_mpc_step_result_t*)>;
+
+// Multi-party counterpart of Exchange for t-of-n sessions, keyed by party
+// index. Each round steps every unfinished party once with the frames sent
+// to it in the previous round; `log` gets every frame and the round count.
+inline void ExchangeParties(maany_mpc_ctx_t* ctx, const std::map<uint32_t, PeerStepFn>& parties, Transcript* log) {
+  struct Frame {
+    uint32_t from;
+    std::vector<uint8_t> bytes;
+  };
+  std::map<uint32_t, std::vector<Frame>> inboxes;
+  std::map<uint32_t, bool> done;
+  for (const auto& party : parties) done[party.first] = false;
+
+  int rounds = 0;
+  for (;; ++rounds) {
+    bool all_done = true;
+    for (const auto& d : done) all_done = all_done && d.second;
+    if (all_done) break;
+    if (rounds > 256) {
+      std::fprintf(stderr, "protocol loop guard triggered\n");
+      std::exit(1);
+    }
+    std::map<uint32_t, std::vector<Frame>> next;
+    for (const auto& [index, step] : parties) {
+      if (done[index]) continue;
+      std::vector<maany_mpc_peer_msg_t> in;
+      for (auto& frame : inboxes[index]) in.push_back({frame.from, {frame.bytes.data(), frame.bytes.size()}});
+      maany_mpc_peer_msg_t* out = nullptr;
+      size_t out_count = 0;
+      maany_mpc_step_result_t result{};
+      Check(step(in.data(), in.size(), &out, &out_count, &result), "peer step");
+      for (size_t i = 0; i < out_count; ++i) {
+        next[out[i].peer].push_back({index, std::vector<uint8_t>(out[i].msg.data, out[i].msg.data + out[i].msg.len)});
+        if (log) log->messages.push_back({"party " + std::to_string(index), out[i].msg.len});
+      }
+      maany_mpc_peer_msgs_free(ctx, out, out_count);
+      done[index] = result == MAANY_MPC_STEP_DONE;
+    }
+    inboxes = std::move(next);
+  }
+  if (log) log->rounds = rounds;
+}
+
+// Two-party secp256k1 ECDSA DKG with both sides in this process.
+// With `defer_paillier` the pair is pending; see maany_mpc_paillier_setup_new.
+inline void Dkg(maany_mpc_ctx_t* ctx, maany_mpc_keypair_t** out_device, maany_mpc_keypair_t** out_server,
+                Transcript* log, bool defer_paillier = false) {
+  maany_mpc_dkg_opts_t opts{};
+  opts.curve = MAANY_MPC_CURVE_SECP256K1;
+  opts.scheme = MAANY_MPC_SCHEME_ECDSA_2P;
+  opts.kind = MAANY_MPC_SHARE_DEVICE;
+  opts.defer_paillier = defer_paillier ? 1 : 0;
+  std::memset(opts.key_id_hint.bytes, 0x11, sizeof(opts.key_id_hint.bytes));
+  maany_mpc_dkg_opts_t server_opts = opts;
+  server_opts.kind = MAANY_MPC_SHARE_SERVER;
+  maany_mpc_dkg_t* device = nullptr;
+  maany_mpc_dkg_t* server = nullptr;
+  Check(maany_mpc_dkg_new(ctx, &opts, &device), "maany_mpc_dkg_new(device)");
+  Check(maany_mpc_dkg_new(ctx, &server_opts, &server), "maany_mpc_dkg_new(server)");
+  Exchange(
+      ctx, "device",
+      [&](const maany_mpc_buf_t* in, maany_mpc_buf_t* out, maany_mpc_step_result_t* r) {
+        return maany_mpc_dkg_step(ctx, device, in, out, r);
+      },
+      "server",
+      [&](const maany_mpc_buf_t* in, maany_mpc_buf_t* out, maany_mpc_step_result_t* r) {
+        return maany_mpc_dkg_step(ctx, server, in, out, r);
+      },
+      log);
+  Check(maany_mpc_dkg_finalize(ctx, device, out_device), "maany_mpc_dkg_finalize(device)");
+  Check(maany_mpc_dkg_finalize(ctx, server, out_server), "maany_mpc_dkg_finalize(server)");
+  maany_mpc_dkg_free(device);
+  maany_mpc_dkg_free(server);
+}
+
+// `sorted` must be in ascending order.
+inline double SortedPercentile(const std::vector<double>& sorted, double p) {
+  if (sorted.empty()) return 0;
+  size_t rank = static_cast<size_t>(p / 100.0 * static_cast<double>(sorted.size()) + 0.5);
+  rank = std::clamp<size_t>(rank, 1, sorted.size());
+  return sorted[rank - 1];
+}
+
+inline double Percentile(std::vector<double> values, double p) {
+  std::sort(values.begin(), values.end());
+  return SortedPercentile(values, p);
+}
+
+inline std::vector<std::string> SplitList(const std::string& text) {
+  std::vector<std::string> out;
+  std::stringstream list(text);
+  std::string item;
+  while (std::getline(list, item, ',')) {
+    if (!item.empty()) out.push_back(item);
+  }
+  return out;
+}
+
+inline std::string JsonString(const std::string& s) {
+  std::string out = "\"";
+  for (char c : s) {
+    if (c == '"' || c == '\\') out += '\\';
+    if (static_cast<unsigned char>(c) < 0x20) continue;
+    out += c;
+  }
+  return out + "\"";
+}
+
+}  // namespace maany::bench
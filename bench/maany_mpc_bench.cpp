@@ -0,0 +1,1143 @@
+// Micro-benchmarks for the C API. Both parties of each two-party protocol run
+// in this process, one step at a time, so protocol latency is the sum of both
+// sides' compute with no network.
+//
+//   maany_mpc_bench [--ops dkg,sign,...] [--iterations N] [--warmup N]
+//                   [--threads N] [--json PATH|-] [--compare BASELINE.json]
+//                   [--tolerance PCT] [--net PROFILE]... [--seed N] [--perf]
+//
+// --compare exits with status 2 if any operation's p50 latency or CPU time per
+// iteration grew by more than --tolerance percent (default 10).
+//
+// --net replays each two-party run over a modeled link (see net_sim.h) and
+// reports the end-to-end latency it would have had there, split into compute
+// and network time. PROFILE is a preset (lan, 4g, 3g), optionally with
+// overrides, or key=value pairs such as "name=sat,rtt=600,jitter=50,bw=2".
+//
+// With a library built with MAANY_MPC_PROFILE_PRIMITIVES, each operation also
+// reports calls and time per crypto primitive per run, in the table and JSON.
+//
+// --perf turns on hardware counters for the sessions' protocol threads and
+// reports cycles, instructions, IPC and cache and branch misses per run. Where
+// perf events are unavailable (most containers) it warns and runs without.
+
+#include "bench_util.h"
+#include "maany_mpc.h"
+#include "net_sim.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <fstream>
+#include <functional>
+#include <map>
+#include <new>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#if !defined(_WIN32)
+#include <stdlib.h>
+#include <unistd.h>
+#endif
+
+// The replacement operator new below allocates with malloc, which GCC cannot
+// see when it pairs operator delete with free.
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+#endif
+
+namespace {
+
+// Every operator new in the process (the library is linked statically) and
+// every allocation the library routes through maany_mpc_init_opts_t.
+std::atomic<uint64_t> g_alloc_count{0};
+std::atomic<uint64_t> g_alloc_bytes{0};
+
+void* CountedAlloc(size_t size) {
+  g_alloc_count.fetch_add(1, std::memory_order_relaxed);
+  g_alloc_bytes.fetch_add(size, std::memory_order_relaxed);
+  return std::malloc(size ? size : 1);
+}
+
+void CountedFree(void* p) {
+  std::free(p);
+}
+
+}  // namespace
+
+void* operator new(size_t size) {
+  if (void* p = CountedAlloc(size)) return p;
+  throw std::bad_alloc();
+}
+void* operator new[](size_t size) {
+  if (void* p = CountedAlloc(size)) return p;
+  throw std::bad_alloc();
+}
+void* operator new(size_t size, const std::nothrow_t&) noexcept {
+  return CountedAlloc(size);
+}
+void* operator new[](size_t size, const std::nothrow_t&) noexcept {
+  return CountedAlloc(size);
+}
+void operator delete(void* p) noexcept {
+  std::free(p);
+}
+void operator delete[](void* p) noexcept {
+  std::free(p);
+}
+void operator delete(void* p, size_t) noexcept {
+  std::free(p);
+}
+void operator delete[](void* p, size_t) noexcept {
+  std::free(p);
+}
+
+namespace {
+
+using maany::bench::Check;
+using maany::bench::Exchange;
+using maany::bench::ExchangeParties;
+using maany::bench::FreeBuf;
+using maany::bench::JsonString;
+using maany::bench::LinkProfile;
+using maany::bench::LinkTiming;
+using maany::bench::Message;
+using maany::bench::Transcript;
+using maany::bench::Percentile;
+
+struct OpResult {
+  std::string name;
+  uint32_t batch = 1;           // runs per sample
+  std::vector<double> wall_ms;  // per run, averaged within each sample
+  double cpu_ms = 0;
+  uint64_t allocs = 0;
+  uint64_t alloc_bytes = 0;
+  std::vector<Transcript> transcripts;  // last run of each sample; empty for local ops
+  // Totals over the measured runs, indexed by maany_mpc_primitive_t; empty
+  // when the library was built without the primitive profiler.
+  std::vector<maany_mpc_primitive_stats_t> primitives;
+  // Hardware counter totals over the measured runs, indexed by
+  // maany_mpc_perf_counter_t; perf_sessions is 0 when --perf is off or
+  // unsupported.
+  uint64_t perf_sessions = 0;
+  uint64_t perf[MAANY_MPC_PERF_COUNT] = {};
+};
+
+double Mean(const std::vector<double>& v) {
+  if (v.empty()) return 0;
+  double sum = 0;
+  for (double x : v) sum += x;
+  return sum / static_cast<double>(v.size());
+}
+
+// Nearest-rank p99 of fewer samples than this is just the maximum, so it is
+// reported as n/a (null in JSON) instead.
+constexpr size_t kMinP99Samples = 100;
+
+std::string FormatMs(double ms, int precision, bool valid = true) {
+  if (!valid) return "n/a";
+  char buf[32];
+  std::snprintf(buf, sizeof(buf), "%.*f", precision, ms);
+  return buf;
+}
+
+struct Summary {
+  double mean = 0, p50 = 0, p90 = 0, p99 = 0, max = 0;
+  bool has_p99 = false;
+  double cpu_ms = 0;
+  double allocs = 0;
+  double alloc_bytes = 0;
+  size_t bytes = 0;
+  int rounds = 0;
+};
+
+Summary Summarize(const OpResult& r) {
+  Summary s;
+  const double n = static_cast<double>(std::max<size_t>(r.wall_ms.size(), 1) * r.batch);
+  s.mean = Mean(r.wall_ms);
+  s.p50 = Percentile(r.wall_ms, 50);
+  s.p90 = Percentile(r.wall_ms, 90);
+  s.p99 = Percentile(r.wall_ms, 99);
+  s.has_p99 = r.wall_ms.size() >= kMinP99Samples;
+  s.max = r.wall_ms.empty() ? 0 : *std::max_element(r.wall_ms.begin(), r.wall_ms.end());
+  s.cpu_ms = r.cpu_ms / n;
+  s.allocs = static_cast<double>(r.allocs) / n;
+  s.alloc_bytes = static_cast<double>(r.alloc_bytes) / n;
+  if (!r.transcripts.empty()) {
+    for (const auto& m : r.transcripts.back().messages) s.bytes += m.bytes;
+    s.rounds = r.transcripts.back().rounds;
+  }
+  return s;
+}
+
+// std::clock is process CPU time, so it includes the context's worker threads.
+double CpuMs() {
+  return 1000.0 * static_cast<double>(std::clock()) / CLOCKS_PER_SEC;
+}
+
+// Sums the profile over session types, since one operation can run several
+// kinds of session. False when the profiler is not compiled in.
+bool PrimitiveTotals(std::vector<maany_mpc_primitive_stats_t>* out) {
+  maany_mpc_primitive_profile_t profile;
+  if (maany_mpc_primitive_profile(&profile) != MAANY_MPC_OK) return false;
+  out->assign(MAANY_MPC_PRIM_COUNT, maany_mpc_primitive_stats_t{});
+  for (const auto& row : profile.by_session) {
+    for (size_t p = 0; p < MAANY_MPC_PRIM_COUNT; ++p) {
+      (*out)[p].calls += row[p].calls;
+      (*out)[p].wall_ns += row[p].wall_ns;
+      (*out)[p].cpu_ns += row[p].cpu_ns;
+    }
+  }
+  return true;
+}
+
+// Summed over session types like PrimitiveTotals; the counters are only ever
+// read for session protocol threads.
+void PerfTotals(uint64_t* sessions, uint64_t* values) {
+  maany_mpc_perf_stats_t stats;
+  *sessions = 0;
+  std::fill(values, values + MAANY_MPC_PERF_COUNT, 0);
+  if (maany_mpc_perf_snapshot(&stats) != MAANY_MPC_OK) return;
+  for (const auto& row : stats.by_session) {
+    *sessions += row.sessions;
+    for (size_t c = 0; c < MAANY_MPC_PERF_COUNT; ++c) values[c] += row.values[c];
+  }
+}
+
+struct Options {
+  std::vector<std::string> ops;
+  uint32_t iterations = 0;  // 0: per-operation default
+  uint32_t warmup = 1;
+  uint32_t threads = 0;
+  std::string json_path;
+  std::string compare_path;
+  double tolerance = 10.0;
+  std::vector<LinkProfile> links;
+  uint64_t seed = 1;
+  bool perf = false;
+};
+
+class Bench {
+ public:
+  explicit Bench(const Options& opts) : opts_(opts) {
+    maany_mpc_init_opts_t init{};
+    init.malloc_fn = CountedAlloc;
+    init.free_fn = CountedFree;
+    init.max_threads = opts.threads;
+    ctx_ = maany_mpc_init(&init);
+    if (!ctx_) {
+      std::fprintf(stderr, "maany_mpc_init failed\n");
+      std::exit(1);
+    }
+    std::memset(message_, 0x5C, sizeof(message_));
+    std::memset(chain_code_.bytes, 0x33, sizeof(chain_code_.bytes));
+  }
+
+  ~Bench() {
+    maany_mpc_kp_free(device_);
+    maany_mpc_kp_free(server_);
+    FreeBuf(ctx_, export_);
+    maany_mpc_shutdown(ctx_);
+  }
+
+  // One untimed DKG provides the pair every other operation works on.
+  void Setup() {
+    Dkg(&device_, &server_, nullptr);
+    Check(maany_mpc_kp_export(ctx_, server_, &export_), "maany_mpc_kp_export");
+  }
+
+  void Dkg(maany_mpc_keypair_t** out_device, maany_mpc_keypair_t** out_server, Transcript* log) {
+    maany::bench::Dkg(ctx_, out_device, out_server, log);
+  }
+
+  void RunDkgSessions(maany_mpc_dkg_t* device, maany_mpc_dkg_t* server, Transcript* log) {
+    Exchange(
+        ctx_, "device",
+        [&](const maany_mpc_buf_t* in, maany_mpc_buf_t* out, maany_mpc_step_result_t* r) {
+          return maany_mpc_dkg_step(ctx_, device, in, out, r);
+        },
+        "server",
+        [&](const maany_mpc_buf_t* in, maany_mpc_buf_t* out, maany_mpc_step_result_t* r) {
+          return maany_mpc_dkg_step(ctx_, server, in, out, r);
+        },
+        log);
+  }
+
+  // Registered operations in report order. `prepare` and `finish` bracket the
+  // warmup and measured iterations and are not timed.
+  struct Op {
+    const char* name;
+    uint32_t default_iterations;
+    std::function<void(Transcript*)> run;
+    std::function<void()> prepare = nullptr;
+    std::function<void()> finish = nullptr;
+  };
+
+  std::vector<Op> Ops() {
+    std::vector<Op> ops = {
+        {"dkg", 100,
+         [this](Transcript* log) {
+           maany_mpc_keypair_t* device = nullptr;
+           maany_mpc_keypair_t* server = nullptr;
+           Dkg(&device, &server, log);
+           maany_mpc_kp_free(device);
+           maany_mpc_kp_free(server);
+         }},
+        // kBatchKeys keys in one session; per key, compare with dkg.
+        {"dkg_batch", 3, [this](Transcript* log) { DkgBatch(log); }},
+        // The two phases of a deferred DKG. Paillier setup latency varies
+        // widely with prime search, so its p99 matters as much as its p50.
+        {"dkg_deferred", 100,
+         [this](Transcript* log) {
+           maany_mpc_keypair_t* device = nullptr;
+           maany_mpc_keypair_t* server = nullptr;
+           maany::bench::Dkg(ctx_, &device, &server, log, true);
+           maany_mpc_kp_free(device);
+           maany_mpc_kp_free(server);
+         }},
+        {"paillier_setup", 100, [this](Transcript* log) { PaillierSetup(log); },
+         [this] { maany::bench::Dkg(ctx_, &pending_device_, &pending_server_, nullptr, true); },
+         [this] {
+           maany_mpc_kp_free(pending_device_);
+           maany_mpc_kp_free(pending_server_);
+           pending_device_ = pending_server_ = nullptr;
+         }},
+        {"sign", 30, [this](Transcript* log) { Sign(log); }},
+        {"refresh", 5, [this](Transcript* log) { Refresh(log, false); }},
+        {"refresh_light", 50, [this](Transcript* log) { Refresh(log, true); }},
+        {"kp_export", 200,
+         [this](Transcript*) {
+           maany_mpc_buf_t blob{nullptr, 0};
+           Check(maany_mpc_kp_export(ctx_, server_, &blob), "maany_mpc_kp_export");
+           FreeBuf(ctx_, blob);
+         }},
+        {"kp_import", 200,
+         [this](Transcript*) {
+           maany_mpc_keypair_t* kp = nullptr;
+           Check(maany_mpc_kp_import(ctx_, &export_, &kp), "maany_mpc_kp_import");
+           maany_mpc_kp_free(kp);
+         }},
+        {"kp_pubkey", 500,
+         [this](Transcript*) {
+           maany_mpc_pubkey_t pub{};
+           Check(maany_mpc_kp_pubkey(ctx_, server_, &pub), "maany_mpc_kp_pubkey");
+           FreeBuf(ctx_, pub.pubkey);
+         }},
+        {"derive_pubkey", 200,
+         [this](Transcript*) {
+           const uint32_t parent[] = {0};
+           maany_mpc_bip32_path_t path{parent, 1};
+           maany_mpc_pubkey_t pub{};
+           Check(maany_mpc_kp_derive_pubkeys(ctx_, server_, &chain_code_, &path, derive_index_++ & 0x7FFFFFFF, 1, &pub),
+                 "maany_mpc_kp_derive_pubkeys");
+           FreeBuf(ctx_, pub.pubkey);
+         }},
+        {"backup_create", 30,
+         [this](Transcript*) {
+           maany_mpc_backup_ciphertext_t cipher{};
+           std::vector<maany_mpc_backup_share_t> shares(kBackupShares);
+           Check(maany_mpc_backup_create(ctx_, server_, kBackupThreshold, shares.size(), nullptr, &cipher,
+                                         shares.data()),
+                 "maany_mpc_backup_create");
+           FreeBackup(cipher, shares);
+         }},
+        {"backup_restore", 30,
+         [this](Transcript*) {
+           maany_mpc_keypair_t* kp = nullptr;
+           Check(maany_mpc_backup_restore(ctx_, &backup_, backup_shares_.data(), kBackupThreshold, &kp),
+                 "maany_mpc_backup_restore");
+           maany_mpc_kp_free(kp);
+         },
+         [this] { PrepareBackup(); }, [this] { ReleaseBackup(); }},
+        // One share set for both keys; compare with two backup_create runs.
+        {"backup_create_many", 30,
+         [this](Transcript*) {
+           const maany_mpc_keypair_t* kps[] = {device_, server_};
+           maany_mpc_backup_bundle_t bundle{};
+           std::vector<maany_mpc_backup_share_t> shares(kBackupShares);
+           Check(maany_mpc_backup_create_many(ctx_, kps, 2, kBackupThreshold, shares.size(), nullptr, &bundle,
+                                              shares.data()),
+                 "maany_mpc_backup_create_many");
+           FreeBuf(ctx_, bundle.label);
+           FreeBuf(ctx_, bundle.envelope);
+           FreeBuf(ctx_, bundle.commitments);
+           for (auto& share : shares) FreeBuf(ctx_, share.data);
+         }},
+        // kRewrapEnvelopes per run, split across the context's worker pool.
+        {"envelope_rewrap", 20,
+         [this](Transcript*) {
+           std::vector<maany_mpc_buf_t> out(envelopes_.size());
+           Check(maany_mpc_envelope_rewrap_many(ctx_, &old_kek_, &new_kek_, envelopes_.data(), envelopes_.size(),
+                                                out.data()),
+                 "maany_mpc_envelope_rewrap_many");
+           for (auto& buf : out) FreeBuf(ctx_, buf);
+         },
+         [this] { PrepareEnvelopes(); }, [this] { ReleaseEnvelopes(); }},
+    };
+    // t-of-n rounds and traffic for the README table; sign cases reuse one
+    // key from an untimed DKG of the same n and t.
+    for (const TnCase& c : kTnCases) {
+      if (!c.signers) {
+        ops.push_back({c.name, 3, [this, c](Transcript* log) { FreeTnKeys(TnDkg(c.parties, c.threshold, log)); }});
+        continue;
+      }
+      ops.push_back({c.name, 10, [this, c](Transcript* log) { TnSign(c.signers, log); },
+                     [this, c] { tn_kps_ = TnDkg(c.parties, c.threshold, nullptr); },
+                     [this] {
+                       FreeTnKeys(tn_kps_);
+                       tn_kps_.clear();
+                     }});
+    }
+#if !defined(_WIN32)
+    // A hit in the embedded share store: index probe plus decrypt from the map.
+    ops.push_back({"store_get", 200,
+                   [this](Transcript*) {
+                     maany_mpc_keypair_t* kp = nullptr;
+                     Check(maany_mpc_store_get(ctx_, store_, &store_key_id_, &kp), "maany_mpc_store_get");
+                     maany_mpc_kp_free(kp);
+                   },
+                   [this] { PrepareStore(); }, [this] { ReleaseStore(); }});
+#endif
+    return ops;
+  }
+
+  OpResult Run(const Op& op) {
+    const uint32_t iterations = opts_.iterations ? opts_.iterations : op.default_iterations;
+    if (op.prepare) op.prepare();
+    for (uint32_t i = 0; i < opts_.warmup; ++i) op.run(nullptr);
+
+    OpResult result;
+    result.name = op.name;
+    result.batch = Calibrate(op);
+    result.wall_ms.reserve(iterations);
+    std::vector<maany_mpc_primitive_stats_t> before;
+    const bool profiled = PrimitiveTotals(&before);
+    uint64_t perf_sessions = 0;
+    uint64_t perf_before[MAANY_MPC_PERF_COUNT];
+    PerfTotals(&perf_sessions, perf_before);
+    for (uint32_t i = 0; i < iterations; ++i) {
+      Transcript log;
+      const uint64_t allocs = g_alloc_count.load(std::memory_order_relaxed);
+      const uint64_t bytes = g_alloc_bytes.load(std::memory_order_relaxed);
+      const double cpu = CpuMs();
+      const auto start = std::chrono::steady_clock::now();
+      for (uint32_t b = 0; b < result.batch; ++b) op.run(b + 1 == result.batch ? &log : nullptr);
+      const auto end = std::chrono::steady_clock::now();
+      result.cpu_ms += CpuMs() - cpu;
+      result.allocs += g_alloc_count.load(std::memory_order_relaxed) - allocs;
+      result.alloc_bytes += g_alloc_bytes.load(std::memory_order_relaxed) - bytes;
+      result.wall_ms.push_back(std::chrono::duration<double, std::milli>(end - start).count() / result.batch);
+      if (!log.messages.empty()) result.transcripts.push_back(std::move(log));
+    }
+    if (profiled && PrimitiveTotals(&result.primitives)) {
+      for (size_t p = 0; p < result.primitives.size(); ++p) {
+        result.primitives[p].calls -= before[p].calls;
+        result.primitives[p].wall_ns -= before[p].wall_ns;
+        result.primitives[p].cpu_ns -= before[p].cpu_ns;
+      }
+    }
+    PerfTotals(&result.perf_sessions, result.perf);
+    result.perf_sessions -= perf_sessions;
+    for (size_t c = 0; c < MAANY_MPC_PERF_COUNT; ++c) result.perf[c] -= perf_before[c];
+    if (op.finish) op.finish();
+    return result;
+  }
+
+ private:
+  static constexpr uint32_t kBackupThreshold = 2;
+  static constexpr size_t kBackupShares = 3;
+  static constexpr size_t kRewrapEnvelopes = 1024;
+  static constexpr uint32_t kBatchKeys = 4;
+
+  // t is a majority of n; signing runs with the smallest and the full quorum.
+  // `signers` is 0 for the DKG.
+  struct TnCase {
+    const char* name;
+    uint32_t parties;
+    uint32_t threshold;
+    uint32_t signers;
+  };
+  static constexpr TnCase kTnCases[] = {
+      {"tn_dkg_n3", 3, 2, 0}, {"tn_sign_n3_k2", 3, 2, 2}, {"tn_sign_n3_k3", 3, 2, 3},
+      {"tn_dkg_n5", 5, 3, 0}, {"tn_sign_n5_k3", 5, 3, 3}, {"tn_sign_n5_k5", 5, 3, 5},
+      {"tn_dkg_n7", 7, 4, 0}, {"tn_sign_n7_k4", 7, 4, 4}, {"tn_sign_n7_k7", 7, 4, 7},
+  };
+  // Operations faster than this are run in batches so one sample is well
+  // above clock resolution; percentiles are then over batch means.
+  static constexpr double kMinSampleMs = 1.0;
+
+  uint32_t Calibrate(const Op& op) {
+    const auto start = std::chrono::steady_clock::now();
+    op.run(nullptr);
+    const double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    if (ms >= kMinSampleMs) return 1;
+    return static_cast<uint32_t>(std::min(10000.0, kMinSampleMs / std::max(ms, 1e-4) + 1));
+  }
+
+  void Sign(Transcript* log) {
+    maany_mpc_sign_opts_t opts{};
+    opts.scheme = MAANY_MPC_SCHEME_ECDSA_2P;
+    maany_mpc_sign_t* device = nullptr;
+    maany_mpc_sign_t* server = nullptr;
+    Check(maany_mpc_sign_new(ctx_, device_, &opts, &device), "maany_mpc_sign_new(device)");
+    Check(maany_mpc_sign_new(ctx_, server_, &opts, &server), "maany_mpc_sign_new(server)");
+    Check(maany_mpc_sign_set_message(ctx_, device, message_, sizeof(message_)), "maany_mpc_sign_set_message(device)");
+    Check(maany_mpc_sign_set_message(ctx_, server, message_, sizeof(message_)), "maany_mpc_sign_set_message(server)");
+    Exchange(
+        ctx_, "server",
+        [&](const maany_mpc_buf_t* in, maany_mpc_buf_t* out, maany_mpc_step_result_t* r) {
+          return maany_mpc_sign_step(ctx_, server, in, out, r);
+        },
+        "device",
+        [&](const maany_mpc_buf_t* in, maany_mpc_buf_t* out, maany_mpc_step_result_t* r) {
+          return maany_mpc_sign_step(ctx_, device, in, out, r);
+        },
+        log);
+    maany_mpc_buf_t sig{nullptr, 0};
+    Check(maany_mpc_sign_finalize(ctx_, device, MAANY_MPC_SIG_FORMAT_DER, &sig), "maany_mpc_sign_finalize");
+    FreeBuf(ctx_, sig);
+    maany_mpc_sign_free(device);
+    maany_mpc_sign_free(server);
+  }
+
+  void Refresh(Transcript* log, bool reuse_paillier) {
+    maany_mpc_refresh_opts_t opts{};
+    opts.reuse_paillier = reuse_paillier ? 1 : 0;
+    maany_mpc_dkg_t* device = nullptr;
+    maany_mpc_dkg_t* server = nullptr;
+    Check(maany_mpc_refresh_new(ctx_, device_, &opts, &device), "maany_mpc_refresh_new(device)");
+    Check(maany_mpc_refresh_new(ctx_, server_, &opts, &server), "maany_mpc_refresh_new(server)");
+    RunDkgSessions(device, server, log);
+    maany_mpc_keypair_t* new_device = nullptr;
+    maany_mpc_keypair_t* new_server = nullptr;
+    Check(maany_mpc_dkg_finalize(ctx_, device, &new_device), "maany_mpc_refresh_finalize(device)");
+    Check(maany_mpc_dkg_finalize(ctx_, server, &new_server), "maany_mpc_refresh_finalize(server)");
+    maany_mpc_kp_free(new_device);
+    maany_mpc_kp_free(new_server);
+    maany_mpc_dkg_free(device);
+    maany_mpc_dkg_free(server);
+  }
+
+  void DkgBatch(Transcript* log) {
+    maany_mpc_dkg_opts_t opts{};
+    opts.curve = MAANY_MPC_CURVE_SECP256K1;
+    opts.scheme = MAANY_MPC_SCHEME_ECDSA_2P;
+    opts.kind = MAANY_MPC_SHARE_DEVICE;
+    opts.count = kBatchKeys;
+    maany_mpc_dkg_opts_t server_opts = opts;
+    server_opts.kind = MAANY_MPC_SHARE_SERVER;
+    maany_mpc_dkg_t* device = nullptr;
+    maany_mpc_dkg_t* server = nullptr;
+    Check(maany_mpc_dkg_new(ctx_, &opts, &device), "maany_mpc_dkg_new(device batch)");
+    Check(maany_mpc_dkg_new(ctx_, &server_opts, &server), "maany_mpc_dkg_new(server batch)");
+    RunDkgSessions(device, server, log);
+    std::vector<maany_mpc_keypair_t*> kps(2 * kBatchKeys, nullptr);
+    Check(maany_mpc_dkg_finalize_many(ctx_, device, kps.data(), kBatchKeys), "maany_mpc_dkg_finalize_many(device)");
+    Check(maany_mpc_dkg_finalize_many(ctx_, server, kps.data() + kBatchKeys, kBatchKeys),
+          "maany_mpc_dkg_finalize_many(server)");
+    for (auto* kp : kps) maany_mpc_kp_free(kp);
+    maany_mpc_dkg_free(device);
+    maany_mpc_dkg_free(server);
+  }
+
+  std::vector<maany_mpc_keypair_t*> TnDkg(uint32_t parties, uint32_t threshold, Transcript* log) {
+    std::vector<maany_mpc_tn_dkg_t*> sessions(parties, nullptr);
+    std::map<uint32_t, maany::bench::PeerStepFn> steps;
+    for (uint32_t p = 0; p < parties; ++p) {
+      maany_mpc_tn_dkg_opts_t opts{};
+      opts.curve = MAANY_MPC_CURVE_SECP256K1;
+      opts.party_index = p;
+      opts.party_count = parties;
+      opts.threshold = threshold;
+      Check(maany_mpc_tn_dkg_new(ctx_, &opts, &sessions[p]), "maany_mpc_tn_dkg_new");
+      steps[p] = [this, dkg = sessions[p]](const maany_mpc_peer_msg_t* in, size_t in_count,
+                                           maany_mpc_peer_msg_t** out, size_t* out_count,
+                                           maany_mpc_step_result_t* r) {
+        return maany_mpc_tn_dkg_step(ctx_, dkg, in, in_count, out, out_count, r);
+      };
+    }
+    ExchangeParties(ctx_, steps, log);
+    std::vector<maany_mpc_keypair_t*> kps(parties, nullptr);
+    for (uint32_t p = 0; p < parties; ++p) {
+      Check(maany_mpc_tn_dkg_finalize(ctx_, sessions[p], &kps[p]), "maany_mpc_tn_dkg_finalize");
+      maany_mpc_tn_dkg_free(sessions[p]);
+    }
+    return kps;
+  }
+
+  void FreeTnKeys(const std::vector<maany_mpc_keypair_t*>& kps) {
+    for (auto* kp : kps) maany_mpc_kp_free(kp);
+  }
+
+  // Parties 0..signers-1 of tn_kps_ sign, and party 0 receives the signature.
+  void TnSign(uint32_t signers, Transcript* log) {
+    std::vector<uint32_t> quorum(signers);
+    for (uint32_t p = 0; p < signers; ++p) quorum[p] = p;
+    maany_mpc_tn_sign_opts_t opts{};
+    opts.signers = quorum.data();
+    opts.signer_count = quorum.size();
+    opts.sig_receiver = 0;
+    std::vector<maany_mpc_tn_sign_t*> sessions(signers, nullptr);
+    std::map<uint32_t, maany::bench::PeerStepFn> steps;
+    for (uint32_t p : quorum) {
+      Check(maany_mpc_tn_sign_new(ctx_, tn_kps_[p], &opts, &sessions[p]), "maany_mpc_tn_sign_new");
+      Check(maany_mpc_tn_sign_set_message(ctx_, sessions[p], message_, sizeof(message_)),
+            "maany_mpc_tn_sign_set_message");
+      steps[p] = [this, sign = sessions[p]](const maany_mpc_peer_msg_t* in, size_t in_count,
+                                            maany_mpc_peer_msg_t** out, size_t* out_count,
+                                            maany_mpc_step_result_t* r) {
+        return maany_mpc_tn_sign_step(ctx_, sign, in, in_count, out, out_count, r);
+      };
+    }
+    ExchangeParties(ctx_, steps, log);
+    maany_mpc_buf_t sig{nullptr, 0};
+    Check(maany_mpc_tn_sign_finalize(ctx_, sessions[0], MAANY_MPC_SIG_FORMAT_DER, &sig), "maany_mpc_tn_sign_finalize");
+    FreeBuf(ctx_, sig);
+    for (auto* session : sessions) maany_mpc_tn_sign_free(session);
+  }
+
+  // Repeatable from the same pending pair; each run generates a new Paillier key.
+  void PaillierSetup(Transcript* log) {
+    maany_mpc_dkg_t* device = nullptr;
+    maany_mpc_dkg_t* server = nullptr;
+    Check(maany_mpc_paillier_setup_new(ctx_, pending_device_, &device), "maany_mpc_paillier_setup_new(device)");
+    Check(maany_mpc_paillier_setup_new(ctx_, pending_server_, &server), "maany_mpc_paillier_setup_new(server)");
+    RunDkgSessions(device, server, log);
+    maany_mpc_keypair_t* ready_device = nullptr;
+    maany_mpc_keypair_t* ready_server = nullptr;
+    Check(maany_mpc_dkg_finalize(ctx_, device, &ready_device), "maany_mpc_paillier_setup_finalize(device)");
+    Check(maany_mpc_dkg_finalize(ctx_, server, &ready_server), "maany_mpc_paillier_setup_finalize(server)");
+    maany_mpc_kp_free(ready_device);
+    maany_mpc_kp_free(ready_server);
+    maany_mpc_dkg_free(device);
+    maany_mpc_dkg_free(server);
+  }
+
+  void FreeBackup(maany_mpc_backup_ciphertext_t& cipher, std::vector<maany_mpc_backup_share_t>& shares) {
+    FreeBuf(ctx_, cipher.label);
+    FreeBuf(ctx_, cipher.ciphertext);
+    FreeBuf(ctx_, cipher.commitments);
+    FreeBuf(ctx_, cipher.ephemeral);
+    FreeBuf(ctx_, cipher.auth);
+    for (auto& share : shares) FreeBuf(ctx_, share.data);
+  }
+
+  void PrepareBackup() {
+    backup_ = maany_mpc_backup_ciphertext_t{};
+    backup_shares_.assign(kBackupShares, maany_mpc_backup_share_t{});
+    Check(maany_mpc_backup_create(ctx_, server_, kBackupThreshold, backup_shares_.size(), nullptr, &backup_,
+                                  backup_shares_.data()),
+          "maany_mpc_backup_create");
+  }
+
+  void ReleaseBackup() { FreeBackup(backup_, backup_shares_); }
+
+  // Sealed exports without AAD have the envelope layout rewrap takes.
+  void PrepareEnvelopes() {
+    std::memset(kek_bytes_[0], 0x21, sizeof(kek_bytes_[0]));
+    std::memset(kek_bytes_[1], 0x42, sizeof(kek_bytes_[1]));
+    old_kek_ = maany_mpc_buf_t{kek_bytes_[0], sizeof(kek_bytes_[0])};
+    new_kek_ = maany_mpc_buf_t{kek_bytes_[1], sizeof(kek_bytes_[1])};
+    maany_mpc_kek_t* kek = nullptr;
+    Check(maany_mpc_kek_register(ctx_, &old_kek_, &kek), "maany_mpc_kek_register");
+    envelopes_.assign(kRewrapEnvelopes, maany_mpc_buf_t{nullptr, 0});
+    for (auto& envelope : envelopes_)
+      Check(maany_mpc_kp_export_sealed(ctx_, server_, kek, nullptr, &envelope), "maany_mpc_kp_export_sealed");
+    maany_mpc_kek_free(kek);
+  }
+
+  void ReleaseEnvelopes() {
+    for (auto& envelope : envelopes_) FreeBuf(ctx_, envelope);
+    envelopes_.clear();
+  }
+
+#if !defined(_WIN32)
+  void PrepareStore() {
+    char dir[] = "/tmp/maany_bench_store_XXXXXX";
+    if (!mkdtemp(dir)) {
+      std::fprintf(stderr, "mkdtemp failed\n");
+      std::exit(1);
+    }
+    store_dir_ = dir;
+    uint8_t key[32];
+    std::memset(key, 0x42, sizeof(key));
+    maany_mpc_buf_t key_buf{key, sizeof(key)};
+    maany_mpc_kek_t* kek = nullptr;
+    Check(maany_mpc_kek_register(ctx_, &key_buf, &kek), "maany_mpc_kek_register");
+    Check(maany_mpc_store_open(ctx_, (store_dir_ + "/shares").c_str(), kek, nullptr, &store_), "maany_mpc_store_open");
+    maany_mpc_kek_free(kek);
+    Check(maany_mpc_store_put(ctx_, store_, server_), "maany_mpc_store_put");
+    maany_mpc_kp_meta_t meta{};
+    Check(maany_mpc_kp_meta(ctx_, server_, &meta), "maany_mpc_kp_meta");
+    store_key_id_ = meta.key_id;
+  }
+
+  void ReleaseStore() {
+    maany_mpc_store_close(store_);
+    store_ = nullptr;
+    ::unlink((store_dir_ + "/shares").c_str());
+    ::unlink((store_dir_ + "/shares.idx").c_str());
+    ::rmdir(store_dir_.c_str());
+  }
+#endif
+
+  Options opts_;
+  maany_mpc_ctx_t* ctx_ = nullptr;
+  maany_mpc_keypair_t* device_ = nullptr;
+  maany_mpc_keypair_t* server_ = nullptr;
+  maany_mpc_keypair_t* pending_device_ = nullptr;
+  maany_mpc_keypair_t* pending_server_ = nullptr;
+  std::vector<maany_mpc_keypair_t*> tn_kps_;
+  maany_mpc_buf_t export_{nullptr, 0};
+  uint8_t message_[32];
+  maany_mpc_chain_code_t chain_code_{};
+  uint32_t derive_index_ = 0;
+  maany_mpc_backup_ciphertext_t backup_{};
+  std::vector<maany_mpc_backup_share_t> backup_shares_;
+  uint8_t kek_bytes_[2][32];
+  maany_mpc_buf_t old_kek_{nullptr, 0};
+  maany_mpc_buf_t new_kek_{nullptr, 0};
+  std::vector<maany_mpc_buf_t> envelopes_;
+  maany_mpc_store_t* store_ = nullptr;
+  std::string store_dir_;
+  maany_mpc_key_id_t store_key_id_{};
+};
+
+// Modeled latency of an operation's recorded runs over one link. Run i uses
+// seed + i, so reports are reproducible for the same transcripts.
+struct NetSummary {
+  double p50 = 0, p99 = 0;
+  double compute_p50 = 0, network_p50 = 0;
+  bool has_p99 = false;
+};
+
+// Only two-party runs record steps, and only those are modeled.
+bool Modeled(const OpResult& r) {
+  return !r.transcripts.empty() && !r.transcripts.back().steps.empty();
+}
+
+NetSummary SummarizeNetwork(const OpResult& r, const LinkProfile& link, uint64_t seed) {
+  std::vector<double> total, compute, network;
+  for (size_t i = 0; i < r.transcripts.size(); ++i) {
+    const LinkTiming t = maany::bench::SimulateLink(r.transcripts[i], link, seed + i);
+    total.push_back(t.total_ms);
+    compute.push_back(t.compute_ms);
+    network.push_back(t.network_ms);
+  }
+  return {Percentile(total, 50), Percentile(total, 99), Percentile(compute, 50), Percentile(network, 50),
+          total.size() >= kMinP99Samples};
+}
+
+/*--- JSON ---*/
+
+double Ipc(const OpResult& r) {
+  const uint64_t cycles = r.perf[MAANY_MPC_PERF_CYCLES];
+  return cycles ? static_cast<double>(r.perf[MAANY_MPC_PERF_INSTRUCTIONS]) / static_cast<double>(cycles) : 0;
+}
+
+// `value` as the report's other numbers print, or null when it is not valid.
+std::string JsonNumber(double value, bool valid) {
+  if (!valid) return "null";
+  std::ostringstream os;
+  os.precision(6);
+  os << value;
+  return os.str();
+}
+
+std::string ToJson(const std::vector<OpResult>& results, const Options& opts) {
+  const maany_mpc_version_t v = maany_mpc_version();
+  std::ostringstream os;
+  os.precision(6);
+  os << "{\n  \"version\": \"" << v.major << '.' << v.minor << '.' << v.patch << "\",\n";
+  os << "  \"threads\": " << opts.threads << ",\n";
+  os << "  \"hardware_concurrency\": " << std::thread::hardware_concurrency() << ",\n";
+#ifdef NDEBUG
+  os << "  \"build\": \"release\",\n";
+#else
+  os << "  \"build\": \"debug\",\n";
+#endif
+  os << "  \"ops\": {";
+  for (size_t i = 0; i < results.size(); ++i) {
+    const auto& r = results[i];
+    const Summary s = Summarize(r);
+    os << (i ? ",\n" : "\n") << "    " << JsonString(r.name) << ": {\n";
+    os << "      \"iterations\": " << r.wall_ms.size() << ",\n";
+    os << "      \"batch\": " << r.batch << ",\n";
+    os << "      \"wall_ms\": {\"mean\": " << s.mean << ", \"p50\": " << s.p50 << ", \"p90\": " << s.p90
+       << ", \"p99\": " << JsonNumber(s.p99, s.has_p99) << ", \"max\": " << s.max << "},\n";
+    os << "      \"cpu_ms\": " << s.cpu_ms << ",\n";
+    os << "      \"allocs\": " << s.allocs << ",\n";
+    os << "      \"alloc_bytes\": " << s.alloc_bytes << ",\n";
+    os << "      \"bytes\": " << s.bytes << ",\n";
+    os << "      \"round_count\": " << s.rounds << ",\n";
+    os << "      \"rounds\": [";
+    const std::vector<Message> none;
+    const auto& messages = r.transcripts.empty() ? none : r.transcripts.back().messages;
+    for (size_t m = 0; m < messages.size(); ++m) {
+      os << (m ? ", " : "") << "{\"from\": " << JsonString(messages[m].from) << ", \"bytes\": " << messages[m].bytes
+         << "}";
+    }
+    os << "]";
+    if (Modeled(r) && !opts.links.empty()) {
+      os << ",\n      \"network\": {";
+      for (size_t l = 0; l < opts.links.size(); ++l) {
+        const NetSummary n = SummarizeNetwork(r, opts.links[l], opts.seed);
+        os << (l ? ",\n" : "\n") << "        " << JsonString(opts.links[l].name) << ": {\"total_ms\": {\"p50\": "
+           << n.p50 << ", \"p99\": " << JsonNumber(n.p99, n.has_p99) << "}, \"compute_ms\": " << n.compute_p50
+           << ", \"network_ms\": " << n.network_p50 << "}";
+      }
+      os << "\n      }";
+    }
+    if (!r.primitives.empty()) {
+      const double runs = static_cast<double>(std::max<size_t>(r.wall_ms.size(), 1) * r.batch);
+      os << ",\n      \"primitives\": {";
+      bool first = true;
+      for (size_t p = 0; p < r.primitives.size(); ++p) {
+        const auto& prim = r.primitives[p];
+        if (!prim.calls) continue;
+        os << (first ? "\n" : ",\n") << "        "
+           << JsonString(maany_mpc_primitive_name(static_cast<maany_mpc_primitive_t>(p)))
+           << ": {\"calls\": " << static_cast<double>(prim.calls) / runs
+           << ", \"cpu_ms\": " << static_cast<double>(prim.cpu_ns) / 1e6 / runs
+           << ", \"wall_ms\": " << static_cast<double>(prim.wall_ns) / 1e6 / runs << "}";
+        first = false;
+      }
+      os << "\n      }";
+    }
+    if (r.perf_sessions) {
+      const double runs = static_cast<double>(std::max<size_t>(r.wall_ms.size(), 1) * r.batch);
+      os << ",\n      \"perf\": {\"sessions\": " << static_cast<double>(r.perf_sessions) / runs
+         << ", \"cycles\": " << static_cast<double>(r.perf[MAANY_MPC_PERF_CYCLES]) / runs
+         << ", \"instructions\": " << static_cast<double>(r.perf[MAANY_MPC_PERF_INSTRUCTIONS]) / runs
+         << ", \"ipc\": " << Ipc(r) << ", \"cache_misses\": "
+         << static_cast<double>(r.perf[MAANY_MPC_PERF_CACHE_MISSES]) / runs
+         << ", \"branch_misses\": " << static_cast<double>(r.perf[MAANY_MPC_PERF_BRANCH_MISSES]) / runs << "}";
+    }
+    os << "\n    }";
+  }
+  os << "\n  }\n}\n";
+  return os.str();
+}
+
+// Just enough of a JSON reader for baselines this tool wrote.
+struct Json {
+  enum class Type { Null, Bool, Number, String, Array, Object } type = Type::Null;
+  double number = 0;
+  std::string str;
+  std::vector<Json> items;
+  std::map<std::string, Json> fields;
+
+  const Json* Get(const std::string& key) const {
+    auto it = fields.find(key);
+    return it == fields.end() ? nullptr : &it->second;
+  }
+  double Num(const std::string& key) const {
+    const Json* v = Get(key);
+    return v && v->type == Type::Number ? v->number : 0;
+  }
+};
+
+class JsonParser {
+ public:
+  explicit JsonParser(const std::string& text) : p_(text.c_str()), end_(p_ + text.size()) {}
+
+  bool Parse(Json& out) {
+    if (!Value(out)) return false;
+    Skip();
+    return p_ == end_;
+  }
+
+ private:
+  void Skip() {
+    while (p_ < end_ && (*p_ == ' ' || *p_ == '\n' || *p_ == '\r' || *p_ == '\t')) ++p_;
+  }
+
+  bool Literal(const char* word) {
+    size_t n = std::strlen(word);
+    if (static_cast<size_t>(end_ - p_) < n || std::strncmp(p_, word, n) != 0) return false;
+    p_ += n;
+    return true;
+  }
+
+  bool String(std::string& out) {
+    if (p_ >= end_ || *p_ != '"') return false;
+    ++p_;
+    while (p_ < end_ && *p_ != '"') {
+      if (*p_ == '\\' && p_ + 1 < end_) ++p_;
+      out += *p_++;
+    }
+    if (p_ >= end_) return false;
+    ++p_;
+    return true;
+  }
+
+  bool Value(Json& out) {
+    Skip();
+    if (p_ >= end_) return false;
+    if (*p_ == '{') {
+      out.type = Json::Type::Object;
+      ++p_;
+      Skip();
+      if (p_ < end_ && *p_ == '}') return ++p_, true;
+      while (true) {
+        std::string key;
+        Skip();
+        if (!String(key)) return false;
+        Skip();
+        if (p_ >= end_ || *p_++ != ':') return false;
+        if (!Value(out.fields[key])) return false;
+        Skip();
+        if (p_ < end_ && *p_ == ',') {
+          ++p_;
+          continue;
+        }
+        return p_ < end_ && *p_++ == '}';
+      }
+    }
+    if (*p_ == '[') {
+      out.type = Json::Type::Array;
+      ++p_;
+      Skip();
+      if (p_ < end_ && *p_ == ']') return ++p_, true;
+      while (true) {
+        out.items.emplace_back();
+        if (!Value(out.items.back())) return false;
+        Skip();
+        if (p_ < end_ && *p_ == ',') {
+          ++p_;
+          continue;
+        }
+        return p_ < end_ && *p_++ == ']';
+      }
+    }
+    if (*p_ == '"') {
+      out.type = Json::Type::String;
+      return String(out.str);
+    }
+    if (Literal("true") || Literal("false")) {
+      out.type = Json::Type::Bool;
+      return true;
+    }
+    if (Literal("null")) return true;
+    char* num_end = nullptr;
+    out.number = std::strtod(p_, &num_end);
+    if (num_end == p_) return false;
+    out.type = Json::Type::Number;
+    p_ = num_end;
+    return true;
+  }
+
+  const char* p_;
+  const char* end_;
+};
+
+double PctChange(double now, double base) {
+  return base > 0 ? (now - base) * 100.0 / base : 0;
+}
+
+// Prints a per-op delta table; returns false if anything regressed past the tolerance.
+bool Compare(const std::vector<OpResult>& results, const Options& opts) {
+  std::ifstream in(opts.compare_path);
+  if (!in) {
+    std::fprintf(stderr, "cannot read baseline %s\n", opts.compare_path.c_str());
+    std::exit(1);
+  }
+  std::stringstream text;
+  text << in.rdbuf();
+  Json baseline;
+  if (!JsonParser(text.str()).Parse(baseline) || !baseline.Get("ops")) {
+    std::fprintf(stderr, "baseline %s is not a maany_mpc_bench report\n", opts.compare_path.c_str());
+    std::exit(1);
+  }
+  const Json& base_ops = *baseline.Get("ops");
+
+  bool ok = true;
+  std::printf("\n%-16s %10s %10s %10s %10s %10s\n", "vs baseline", "p50", "p99", "cpu", "allocs", "bytes");
+  for (const auto& r : results) {
+    const Json* base = base_ops.Get(r.name);
+    if (!base || !base->Get("wall_ms")) {
+      std::printf("%-16s %10s\n", r.name.c_str(), "(new)");
+      continue;
+    }
+    const Summary s = Summarize(r);
+    const Json& wall = *base->Get("wall_ms");
+    const double p50 = PctChange(s.p50, wall.Num("p50"));
+    const Json* base_p99 = wall.Get("p99");
+    const bool has_p99 = s.has_p99 && base_p99 && base_p99->type == Json::Type::Number;
+    const double p99 = has_p99 ? PctChange(s.p99, base_p99->number) : 0;
+    const double cpu = PctChange(s.cpu_ms, base->Num("cpu_ms"));
+    const double allocs = PctChange(s.allocs, base->Num("allocs"));
+    const double bytes = PctChange(static_cast<double>(s.bytes), base->Num("bytes"));
+    const bool regressed = p50 > opts.tolerance || cpu > opts.tolerance;
+    ok = ok && !regressed;
+    char p99_cell[16] = "n/a";
+    if (has_p99) std::snprintf(p99_cell, sizeof(p99_cell), "%+.1f%%", p99);
+    std::printf("%-16s %+9.1f%% %10s %+9.1f%% %+9.1f%% %+9.1f%%%s\n", r.name.c_str(), p50, p99_cell, cpu, allocs,
+                bytes, regressed ? "  REGRESSION" : "");
+  }
+  return ok;
+}
+
+void PrintNetwork(const std::vector<OpResult>& results, const Options& opts) {
+  std::printf("\n%-16s %-12s %6s %12s %12s %12s %12s\n", "modeled", "link", "frames", "p50 ms", "p99 ms",
+              "compute ms", "network ms");
+  for (const auto& link : opts.links) {
+    for (const auto& r : results) {
+      if (!Modeled(r)) continue;
+      const NetSummary n = SummarizeNetwork(r, link, opts.seed);
+      std::printf("%-16s %-12s %6zu %12.1f %12s %12.1f %12.1f\n", r.name.c_str(), link.name.c_str(),
+                  r.transcripts.back().messages.size(), n.p50, FormatMs(n.p99, 1, n.has_p99).c_str(), n.compute_p50,
+                  n.network_p50);
+    }
+  }
+}
+
+// Per run, like the main table.
+void PrintPrimitives(const std::vector<OpResult>& results) {
+  std::printf("\n%-16s %-20s %10s %12s %12s\n", "primitives", "primitive", "calls", "cpu ms", "wall ms");
+  for (const auto& r : results) {
+    const double runs = static_cast<double>(std::max<size_t>(r.wall_ms.size(), 1) * r.batch);
+    for (size_t p = 0; p < r.primitives.size(); ++p) {
+      const auto& prim = r.primitives[p];
+      if (!prim.calls) continue;
+      std::printf("%-16s %-20s %10.1f %12.3f %12.3f\n", r.name.c_str(),
+                  maany_mpc_primitive_name(static_cast<maany_mpc_primitive_t>(p)),
+                  static_cast<double>(prim.calls) / runs, static_cast<double>(prim.cpu_ns) / 1e6 / runs,
+                  static_cast<double>(prim.wall_ns) / 1e6 / runs);
+    }
+  }
+}
+
+// Per run, so the sign row reads as cycles per signature across both parties.
+void PrintPerf(const std::vector<OpResult>& results) {
+  std::printf("\n%-16s %10s %14s %14s %6s %12s %12s\n", "perf", "sessions", "cycles", "instructions", "ipc",
+              "cache miss", "branch miss");
+  for (const auto& r : results) {
+    if (!r.perf_sessions) continue;
+    const double runs = static_cast<double>(std::max<size_t>(r.wall_ms.size(), 1) * r.batch);
+    std::printf("%-16s %10.1f %14.0f %14.0f %6.2f %12.0f %12.0f\n", r.name.c_str(),
+                static_cast<double>(r.perf_sessions) / runs, static_cast<double>(r.perf[MAANY_MPC_PERF_CYCLES]) / runs,
+                static_cast<double>(r.perf[MAANY_MPC_PERF_INSTRUCTIONS]) / runs, Ipc(r),
+                static_cast<double>(r.perf[MAANY_MPC_PERF_CACHE_MISSES]) / runs,
+                static_cast<double>(r.perf[MAANY_MPC_PERF_BRANCH_MISSES]) / runs);
+  }
+}
+
+void PrintTable(const std::vector<OpResult>& results) {
+  std::printf("%-16s %6s %10s %10s %10s %10s %10s %10s %12s %6s %6s %10s\n", "op", "n", "mean ms", "p50 ms",
+              "p90 ms", "p99 ms", "max ms", "cpu ms", "allocs", "rounds", "msgs", "bytes");
+  for (const auto& r : results) {
+    const Summary s = Summarize(r);
+    std::printf("%-16s %6zu %10.3f %10.3f %10.3f %10s %10.3f %10.3f %12.0f %6d %6zu %10zu\n", r.name.c_str(),
+                r.wall_ms.size(), s.mean, s.p50, s.p90, FormatMs(s.p99, 3, s.has_p99).c_str(), s.max, s.cpu_ms,
+                s.allocs, s.rounds,
+                r.transcripts.empty() ? 0 : r.transcripts.back().messages.size(), s.bytes);
+  }
+}
+
+[[noreturn]] void Usage(const char* argv0) {
+  std::fprintf(stderr,
+               "usage: %s [--ops a,b,...] [--iterations N] [--warmup N] [--threads N]\n"
+               "          [--json PATH|-] [--compare BASELINE.json] [--tolerance PCT]\n"
+               "          [--net PROFILE]... [--seed N] [--perf]\n",
+               argv0);
+  std::exit(1);
+}
+
+Options ParseArgs(int argc, char** argv) {
+  Options opts;
+  for (int i = 1; i < argc; ++i) {
+    std::string arg = argv[i];
+    auto next = [&]() -> std::string {
+      if (i + 1 >= argc) Usage(argv[0]);
+      return argv[++i];
+    };
+    if (arg == "--ops") {
+      opts.ops = maany::bench::SplitList(next());
+    } else if (arg == "--iterations") {
+      opts.iterations = static_cast<uint32_t>(std::strtoul(next().c_str(), nullptr, 10));
+    } else if (arg == "--warmup") {
+      opts.warmup = static_cast<uint32_t>(std::strtoul(next().c_str(), nullptr, 10));
+    } else if (arg == "--threads") {
+      opts.threads = static_cast<uint32_t>(std::strtoul(next().c_str(), nullptr, 10));
+    } else if (arg == "--json") {
+      opts.json_path = next();
+    } else if (arg == "--compare") {
+      opts.compare_path = next();
+    } else if (arg == "--tolerance") {
+      opts.tolerance = std::strtod(next().c_str(), nullptr);
+    } else if (arg == "--net") {
+      const std::string spec = next();
+      LinkProfile link;
+      if (!maany::bench::ParseLinkProfile(spec, &link)) {
+        std::fprintf(stderr, "bad --net profile '%s'\n", spec.c_str());
+        std::exit(1);
+      }
+      opts.links.push_back(link);
+    } else if (arg == "--seed") {
+      opts.seed = std::strtoull(next().c_str(), nullptr, 10);
+    } else if (arg == "--perf") {
+      opts.perf = true;
+    } else {
+      Usage(argv[0]);
+    }
+  }
+  return opts;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  const Options opts = ParseArgs(argc, argv);
+  Bench bench(opts);
+  auto ops = bench.Ops();
+  for (const auto& name : opts.ops) {
+    if (std::none_of(ops.begin(), ops.end(), [&](const Bench::Op& op) { return name == op.name; })) {
+      std::fprintf(stderr, "unknown op '%s'; available:", name.c_str());
+      for (const auto& op : ops) std::fprintf(stderr, " %s", op.name);
+      std::fprintf(stderr, "\n");
+      return 1;
+    }
+  }
+
+  if (opts.perf && maany_mpc_perf_enable(1) != MAANY_MPC_OK) {
+    maany_mpc_perf_stats_t stats{};
+    maany_mpc_perf_snapshot(&stats);
+    std::fprintf(stderr, "--perf: hardware counters unavailable (%s); continuing without\n",
+                 std::strerror(stats.error));
+  }
+  bench.Setup();
+  std::vector<OpResult> results;
+  for (const auto& op : ops) {
+    if (!opts.ops.empty() && std::find(opts.ops.begin(), opts.ops.end(), op.name) == opts.ops.end()) continue;
+    results.push_back(bench.Run(op));
+  }
+
+  PrintTable(results);
+  if (!opts.links.empty()) PrintNetwork(results, opts);
+  if (std::any_of(results.begin(), results.end(), [](const OpResult& r) { return !r.primitives.empty(); }))
+    PrintPrimitives(results);
+  if (std::any_of(results.begin(), results.end(), [](const OpResult& r) { return r.perf_sessions != 0; }))
+    PrintPerf(results);
+  if (!opts.json_path.empty()) {
+    const std::string json = ToJson(results, opts);
+    if (opts.json_path == "-") {
+      std::fputs(json.c_str(), stdout);
+    } else {
+      std::ofstream out(opts.json_path);
+      out << json;
+      if (!out) {
+        std::fprintf(stderr, "cannot write %s\n", opts.json_path.c_str());
+        return 1;
+      }
+    }
+  }
+  if (!opts.compare_path.empty() && !Compare(results, opts)) return 2;
+  return 0;
+}
@@ -0,0 +1,522 @@
+// Load generator for concurrent two-party signing. Runs many device/server
+// sign session pairs in this process over in-memory channels and reports how
+// throughput, round latency, memory and thread count scale with the number of
+// sessions in flight and the number of carrier threads stepping them.
+//
+//   maany_mpc_loadgen [--mode dual|server-only] [--sessions 1,16,64,...]
+//                     [--threads 1,2,4,...] [--rate PER_SEC] [--duration SEC]
+//                     [--device-threads N] [--ctx-threads N] [--seed N]
+//                     [--json PATH|-]
+//
+// Each side of a pair is an actor: inbound frames queue in its mailbox and
+// one pool thread at a time steps it. `--threads` sizes the carrier pool that
+// steps server sessions, the part a coordinator runs. In dual mode the device
+// sessions run on the same carrier pool, as the Node coordinator does when it
+// simulates the device. In server-only mode they run on a separate pool of
+// `--device-threads` threads standing in for remote devices, so only server
+// work competes for the carriers.
+//
+// With --rate, sessions arrive as a Poisson process and wait for a free slot
+// once `sessions` are in flight; session latency counts from the scheduled
+// arrival so a saturated box shows up as queueing rather than a lower
+// offered load. Without --rate the generator keeps `sessions` in flight.
+// Round latency is from a frame reaching a server mailbox to that server step
+// returning, including time queued for a carrier.
+
+#include "bench_util.h"
+#include "maany_mpc.h"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <fstream>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <random>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+using maany::bench::Check;
+using maany::bench::FreeBuf;
+using maany::bench::JsonString;
+using maany::bench::SortedPercentile;
+using Clock = std::chrono::steady_clock;
+
+double MsBetween(Clock::time_point a, Clock::time_point b) {
+  return std::chrono::duration<double, std::milli>(b - a).count();
+}
+
+struct ProcSample {
+  uint64_t rss_bytes = 0;
+  uint32_t threads = 0;
+};
+
+// Current resident set and thread count. Zero where /proc is unavailable.
+ProcSample SampleProc() {
+  ProcSample s;
+#ifdef __linux__
+  std::ifstream status("/proc/self/status");
+  std::string line;
+  while (std::getline(status, line)) {
+    if (line.rfind("VmRSS:", 0) == 0) {
+      s.rss_bytes = std::strtoull(line.c_str() + 6, nullptr, 10) * 1024;
+    } else if (line.rfind("Threads:", 0) == 0) {
+      s.threads = static_cast<uint32_t>(std::strtoul(line.c_str() + 8, nullptr, 10));
+    }
+  }
+#endif
+  return s;
+}
+
+// Fixed-size thread pool. Tasks receive the index of the thread running
+// them so results can be collected without a shared lock.
+class Pool {
+ public:
+  explicit Pool(unsigned threads) {
+    for (unsigned i = 0; i < threads; ++i) workers_.emplace_back([this, i] { Run(i); });
+  }
+
+  ~Pool() {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      stop_ = true;
+    }
+    cv_.notify_all();
+    for (auto& t : workers_) t.join();
+  }
+
+  size_t size() const { return workers_.size(); }
+
+  void Post(std::function<void(size_t)> task) {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      queue_.push_back(std::move(task));
+    }
+    cv_.notify_one();
+  }
+
+ private:
+  void Run(size_t index) {
+    for (;;) {
+      std::function<void(size_t)> task;
+      {
+        std::unique_lock<std::mutex> lock(mutex_);
+        cv_.wait(lock, [&] { return stop_ || !queue_.empty(); });
+        if (queue_.empty()) return;
+        task = std::move(queue_.front());
+        queue_.pop_front();
+      }
+      task(index);
+    }
+  }
+
+  std::vector<std::thread> workers_;
+  std::deque<std::function<void(size_t)>> queue_;
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  bool stop_ = false;
+};
+
+struct Options {
+  std::string mode = "dual";
+  std::vector<uint32_t> sessions{1, 16, 64, 256};
+  std::vector<uint32_t> threads{1, 2, 4, 8};
+  double rate = 0;  // sessions per second; 0 = closed loop
+  double duration = 5;
+  uint32_t device_threads = 0;  // 0 = hardware concurrency
+  uint32_t ctx_threads = 1;
+  uint64_t seed = 1;
+  std::string json_path;
+};
+
+struct RunResult {
+  uint32_t threads = 0;
+  uint32_t sessions = 0;
+  uint64_t completed = 0;
+  double elapsed_s = 0;
+  std::vector<double> round_ms;    // sorted
+  std::vector<double> session_ms;  // sorted
+  uint64_t peak_rss = 0;
+  uint32_t peak_threads = 0;
+  uint64_t idle_rss = 0;
+  uint32_t idle_threads = 0;
+};
+
+class LoadGen {
+ public:
+  LoadGen(maany_mpc_ctx_t* ctx, maany_mpc_keypair_t* device, maany_mpc_keypair_t* server, const Options& opts)
+      : ctx_(ctx), device_kp_(device), server_kp_(server), opts_(opts) {
+    std::memset(message_, 0x5C, sizeof(message_));
+  }
+
+  RunResult Run(uint32_t carriers, uint32_t max_sessions) {
+    RunResult result;
+    result.threads = carriers;
+    result.sessions = max_sessions;
+    const ProcSample idle = SampleProc();
+    result.idle_rss = idle.rss_bytes;
+    result.idle_threads = idle.threads;
+
+    const bool server_only = opts_.mode == "server-only";
+    const unsigned device_threads =
+        opts_.device_threads ? opts_.device_threads : std::max(1u, std::thread::hardware_concurrency());
+    Pool server_pool(carriers);
+    std::optional<Pool> device_pool;
+    if (server_only) device_pool.emplace(device_threads);
+
+    RunState run;
+    run.server_pool = &server_pool;
+    run.device_pool = server_only ? &*device_pool : &server_pool;
+    run.server_rounds.resize(server_pool.size());
+
+    std::atomic<bool> sampling{true};
+    std::thread monitor([&] {
+      while (sampling.load()) {
+        const ProcSample s = SampleProc();
+        result.peak_rss = std::max(result.peak_rss, s.rss_bytes);
+        result.peak_threads = std::max(result.peak_threads, s.threads);
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+      }
+    });
+
+    std::mt19937_64 rng(opts_.seed);
+    std::exponential_distribution<double> gap(opts_.rate > 0 ? opts_.rate : 1);
+    const auto start = Clock::now();
+    const auto stop = start + std::chrono::duration_cast<Clock::duration>(
+                                  std::chrono::duration<double>(opts_.duration));
+    auto next = start;
+    for (;;) {
+      if (opts_.rate > 0) {
+        next += std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(gap(rng)));
+        if (next >= stop) break;
+        std::this_thread::sleep_until(next);
+      } else if (Clock::now() >= stop) {
+        break;
+      }
+      {
+        std::unique_lock<std::mutex> lock(run.mutex);
+        run.cv.wait(lock, [&] { return run.in_flight < max_sessions; });
+        ++run.in_flight;
+      }
+      Start(run, opts_.rate > 0 ? next : Clock::now());
+    }
+    {
+      std::unique_lock<std::mutex> lock(run.mutex);
+      run.cv.wait(lock, [&] { return run.in_flight == 0; });
+    }
+    result.elapsed_s = std::chrono::duration<double>(Clock::now() - start).count();
+    sampling = false;
+    monitor.join();
+
+    for (auto& v : run.server_rounds) result.round_ms.insert(result.round_ms.end(), v.begin(), v.end());
+    result.session_ms = std::move(run.session_ms);
+    std::sort(result.round_ms.begin(), result.round_ms.end());
+    std::sort(result.session_ms.begin(), result.session_ms.end());
+    result.completed = result.session_ms.size();
+    return result;
+  }
+
+ private:
+  struct Pair;
+  struct RunState;
+
+  struct Frame {
+    maany_mpc_buf_t buf{nullptr, 0};
+    bool kick = false;  // the empty first step, not a protocol round
+    Clock::time_point arrived;
+  };
+
+  // One side of a pair. `mailbox`, `scheduled` and `done` are guarded by
+  // `mutex`; `scheduled` is set while a pool task owns the session, and stays
+  // set once it is done so nothing else is queued for it.
+  struct Side {
+    Pair* pair = nullptr;
+    Side* peer = nullptr;
+    Pool* pool = nullptr;
+    bool is_server = false;
+    maany_mpc_sign_t* sign = nullptr;
+    std::mutex mutex;
+    std::deque<Frame> mailbox;
+    bool scheduled = false;
+    bool done = false;
+  };
+
+  // Freed by whichever side finishes last, after its final delivery.
+  struct Pair {
+    RunState* run = nullptr;
+    Clock::time_point arrival;
+    Side device;
+    Side server;
+    std::atomic<int> remaining{2};
+  };
+
+  struct RunState {
+    Pool* server_pool = nullptr;
+    Pool* device_pool = nullptr;
+    std::vector<std::vector<double>> server_rounds;  // per server pool thread
+    std::mutex mutex;
+    std::condition_variable cv;
+    uint32_t in_flight = 0;
+    std::vector<double> session_ms;
+  };
+
+  void Start(RunState& run, Clock::time_point arrival) {
+    auto* pair = new Pair;
+    pair->run = &run;
+    pair->arrival = arrival;
+    maany_mpc_sign_opts_t opts{};
+    opts.scheme = MAANY_MPC_SCHEME_ECDSA_2P;
+    Check(maany_mpc_sign_new(ctx_, device_kp_, &opts, &pair->device.sign), "maany_mpc_sign_new(device)");
+    Check(maany_mpc_sign_new(ctx_, server_kp_, &opts, &pair->server.sign), "maany_mpc_sign_new(server)");
+    Check(maany_mpc_sign_set_message(ctx_, pair->device.sign, message_, sizeof(message_)),
+          "maany_mpc_sign_set_message(device)");
+    Check(maany_mpc_sign_set_message(ctx_, pair->server.sign, message_, sizeof(message_)),
+          "maany_mpc_sign_set_message(server)");
+    for (Side* side : {&pair->server, &pair->device}) {
+      side->pair = pair;
+      side->is_server = side == &pair->server;
+      side->peer = side->is_server ? &pair->device : &pair->server;
+      side->pool = side->is_server ? run.server_pool : run.device_pool;
+    }
+    // Both sides get an empty first step; whichever opens the protocol emits
+    // its first frame and the other starts waiting for it.
+    const auto now = Clock::now();
+    Deliver(pair->server, Frame{{nullptr, 0}, true, now});
+    Deliver(pair->device, Frame{{nullptr, 0}, true, now});
+  }
+
+  void Deliver(Side& side, Frame frame) {
+    {
+      std::lock_guard<std::mutex> lock(side.mutex);
+      side.mailbox.push_back(frame);
+      if (side.scheduled) return;
+      side.scheduled = true;
+    }
+    side.pool->Post([this, &side](size_t worker) { Drain(side, worker); });
+  }
+
+  // Steps `side` once per queued frame. Frames that arrive while it runs are
+  // picked up by the same task.
+  void Drain(Side& side, size_t worker) {
+    for (;;) {
+      Frame frame;
+      {
+        std::lock_guard<std::mutex> lock(side.mutex);
+        if (side.mailbox.empty()) {
+          side.scheduled = false;
+          return;
+        }
+        frame = side.mailbox.front();
+        side.mailbox.pop_front();
+      }
+      maany_mpc_buf_t out{nullptr, 0};
+      maany_mpc_step_result_t status{};
+      maany_mpc_error_t err =
+          maany_mpc_sign_step(ctx_, side.sign, frame.buf.data ? &frame.buf : nullptr, &out, &status);
+      FreeBuf(ctx_, frame.buf);
+      Check(err, side.is_server ? "maany_mpc_sign_step(server)" : "maany_mpc_sign_step(device)");
+      const auto now = Clock::now();
+      if (side.is_server && !frame.kick) side.pair->run->server_rounds[worker].push_back(MsBetween(frame.arrived, now));
+      if (out.data) Deliver(*side.peer, Frame{out, false, now});
+      if (status == MAANY_MPC_STEP_DONE) {
+        Finish(side);
+        return;
+      }
+    }
+  }
+
+  void Finish(Side& side) {
+    {
+      std::lock_guard<std::mutex> lock(side.mutex);
+      side.done = true;
+    }
+    if (!side.is_server) {
+      maany_mpc_buf_t sig{nullptr, 0};
+      Check(maany_mpc_sign_finalize(ctx_, side.sign, MAANY_MPC_SIG_FORMAT_DER, &sig), "maany_mpc_sign_finalize");
+      FreeBuf(ctx_, sig);
+    }
+    maany_mpc_sign_free(side.sign);
+    side.sign = nullptr;
+
+    Pair* pair = side.pair;
+    if (pair->remaining.fetch_sub(1) != 1) return;
+    const double latency = MsBetween(pair->arrival, Clock::now());
+    RunState& run = *pair->run;
+    for (Side* s : {&pair->device, &pair->server}) {
+      for (auto& f : s->mailbox) FreeBuf(ctx_, f.buf);
+    }
+    delete pair;
+    // Notify under the lock: `run` lives on the generator's stack and may go
+    // away as soon as in_flight reaches zero.
+    std::lock_guard<std::mutex> lock(run.mutex);
+    run.session_ms.push_back(latency);
+    --run.in_flight;
+    run.cv.notify_all();
+  }
+
+  maany_mpc_ctx_t* ctx_;
+  maany_mpc_keypair_t* device_kp_;
+  maany_mpc_keypair_t* server_kp_;
+  Options opts_;
+  uint8_t message_[32];
+};
+
+/*--- Reporting ---*/
+
+double Mb(uint64_t bytes) {
+  return static_cast<double>(bytes) / (1024.0 * 1024.0);
+}
+
+void PrintHeader(const Options& opts) {
+  std::printf("mode=%s rate=%s duration=%.1fs\n", opts.mode.c_str(),
+              opts.rate > 0 ? std::to_string(opts.rate).c_str() : "closed-loop", opts.duration);
+  std::printf("%7s %8s %9s %10s %9s %9s %9s %10s %10s %9s %9s\n", "threads", "sessions", "completed", "signs/s",
+              "rnd p50", "rnd p99", "rnd p999", "sess p50", "sess p99", "rss MB", "os thr");
+}
+
+void PrintRow(const RunResult& r) {
+  std::printf("%7u %8u %9llu %10.1f %9.3f %9.3f %9.3f %10.3f %10.3f %9.1f %9u\n", r.threads, r.sessions,
+              static_cast<unsigned long long>(r.completed), r.elapsed_s > 0 ? r.completed / r.elapsed_s : 0,
+              SortedPercentile(r.round_ms, 50), SortedPercentile(r.round_ms, 99), SortedPercentile(r.round_ms, 99.9),
+              SortedPercentile(r.session_ms, 50), SortedPercentile(r.session_ms, 99), Mb(r.peak_rss),
+              r.peak_threads);
+  std::fflush(stdout);
+}
+
+std::string ToJson(const std::vector<RunResult>& results, const Options& opts) {
+  const maany_mpc_version_t v = maany_mpc_version();
+  std::ostringstream os;
+  os.precision(6);
+  os << "{\n  \"version\": \"" << v.major << '.' << v.minor << '.' << v.patch << "\",\n";
+  os << "  \"mode\": " << JsonString(opts.mode) << ",\n";
+  os << "  \"rate\": " << opts.rate << ",\n";
+  os << "  \"duration_s\": " << opts.duration << ",\n";
+  os << "  \"hardware_concurrency\": " << std::thread::hardware_concurrency() << ",\n";
+  os << "  \"runs\": [";
+  for (size_t i = 0; i < results.size(); ++i) {
+    const auto& r = results[i];
+    os << (i ? ",\n" : "\n") << "    {\"threads\": " << r.threads << ", \"sessions\": " << r.sessions
+       << ", \"completed\": " << r.completed << ", \"elapsed_s\": " << r.elapsed_s
+       << ", \"throughput\": " << (r.elapsed_s > 0 ? r.completed / r.elapsed_s : 0) << ",\n";
+    os << "     \"round_ms\": {\"p50\": " << SortedPercentile(r.round_ms, 50)
+       << ", \"p99\": " << SortedPercentile(r.round_ms, 99) << ", \"p999\": " << SortedPercentile(r.round_ms, 99.9)
+       << ", \"max\": " << (r.round_ms.empty() ? 0 : r.round_ms.back()) << "},\n";
+    os << "     \"session_ms\": {\"p50\": " << SortedPercentile(r.session_ms, 50)
+       << ", \"p99\": " << SortedPercentile(r.session_ms, 99)
+       << ", \"p999\": " << SortedPercentile(r.session_ms, 99.9) << "},\n";
+    os << "     \"rss_bytes\": {\"idle\": " << r.idle_rss << ", \"peak\": " << r.peak_rss << "}, "
+       << "\"os_threads\": {\"idle\": " << r.idle_threads << ", \"peak\": " << r.peak_threads << "}}";
+  }
+  os << "\n  ]\n}\n";
+  return os.str();
+}
+
+[[noreturn]] void Usage(const char* argv0) {
+  std::fprintf(stderr,
+               "usage: %s [--mode dual|server-only] [--sessions N,N,...] [--threads N,N,...]\n"
+               "          [--rate PER_SEC] [--duration SEC] [--device-threads N] [--ctx-threads N]\n"
+               "          [--seed N] [--json PATH|-]\n",
+               argv0);
+  std::exit(1);
+}
+
+std::vector<uint32_t> ParseCounts(const std::string& text, const char* argv0) {
+  std::vector<uint32_t> out;
+  for (const auto& item : maany::bench::SplitList(text)) {
+    const unsigned long n = std::strtoul(item.c_str(), nullptr, 10);
+    if (n == 0) Usage(argv0);
+    out.push_back(static_cast<uint32_t>(n));
+  }
+  if (out.empty()) Usage(argv0);
+  return out;
+}
+
+Options ParseArgs(int argc, char** argv) {
+  Options opts;
+  for (int i = 1; i < argc; ++i) {
+    std::string arg = argv[i];
+    auto next = [&]() -> std::string {
+      if (i + 1 >= argc) Usage(argv[0]);
+      return argv[++i];
+    };
+    if (arg == "--mode") {
+      opts.mode = next();
+      if (opts.mode != "dual" && opts.mode != "server-only") Usage(argv[0]);
+    } else if (arg == "--sessions") {
+      opts.sessions = ParseCounts(next(), argv[0]);
+    } else if (arg == "--threads") {
+      opts.threads = ParseCounts(next(), argv[0]);
+    } else if (arg == "--rate") {
+      opts.rate = std::strtod(next().c_str(), nullptr);
+    } else if (arg == "--duration") {
+      opts.duration = std::strtod(next().c_str(), nullptr);
+    } else if (arg == "--device-threads") {
+      opts.device_threads = static_cast<uint32_t>(std::strtoul(next().c_str(), nullptr, 10));
+    } else if (arg == "--ctx-threads") {
+      opts.ctx_threads = static_cast<uint32_t>(std::strtoul(next().c_str(), nullptr, 10));
+    } else if (arg == "--seed") {
+      opts.seed = std::strtoull(next().c_str(), nullptr, 10);
+    } else if (arg == "--json") {
+      opts.json_path = next();
+    } else {
+      Usage(argv[0]);
+    }
+  }
+  return opts;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  const Options opts = ParseArgs(argc, argv);
+  maany_mpc_init_opts_t init{};
+  init.max_threads = opts.ctx_threads;
+  maany_mpc_ctx_t* ctx = maany_mpc_init(&init);
+  if (!ctx) {
+    std::fprintf(stderr, "maany_mpc_init failed\n");
+    return 1;
+  }
+  maany_mpc_keypair_t* device = nullptr;
+  maany_mpc_keypair_t* server = nullptr;
+  maany::bench::Dkg(ctx, &device, &server, nullptr);
+
+  LoadGen gen(ctx, device, server, opts);
+  std::vector<RunResult> results;
+  PrintHeader(opts);
+  for (uint32_t threads : opts.threads) {
+    for (uint32_t sessions : opts.sessions) {
+      results.push_back(gen.Run(threads, sessions));
+      PrintRow(results.back());
+    }
+  }
+
+  maany_mpc_kp_free(device);
+  maany_mpc_kp_free(server);
+  maany_mpc_shutdown(ctx);
+
+  if (!opts.json_path.empty()) {
+    const std::string json = ToJson(results, opts);
+    if (opts.json_path == "-") {
+      std::fputs(json.c_str(), stdout);
+    } else {
+      std::ofstream out(opts.json_path);
+      out << json;
+      if (!out) {
+        std::fprintf(stderr, "cannot write %s\n", opts.json_path.c_str());
+        return 1;
+      }
+    }
+  }
+  return 0;
+}
@@ -0,0 +1,199 @@
+// Re-runs one party of a recorded two-party session (see transcript_path in
+// the DKG, sign and refresh options) against its recorded peer frames, with
+// the randomness it was recorded with. Nothing but that party's compute runs,
+// so this is the target to put under perf or VTune:
+//
+//   maany_mpc_replay TRANSCRIPT [--key SHARE] [--iterations N] [--warmup N]
+//                    [--json PATH|-]
+//
+// SHARE is the maany_mpc_kp_export blob of the recorded party's share from
+// before the session; sign and refresh transcripts need it, DKG ones do not.
+// Exits with status 2 if the party no longer produces the recorded frames,
+// which means the protocol or its encoding changed since the recording.
+
+#include "bench_util.h"
+#include "maany_mpc.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iterator>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace {
+
+using maany::bench::Check;
+using maany::bench::JsonString;
+using maany::bench::SortedPercentile;
+
+struct Options {
+  std::string transcript_path;
+  std::string key_path;
+  uint32_t iterations = 50;
+  uint32_t warmup = 3;
+  std::string json_path;
+};
+
+struct StepStats {
+  size_t in_bytes = 0;
+  size_t out_bytes = 0;
+  std::vector<double> compute_ms;  // one per iteration, sorted once collected
+};
+
+bool ReadFile(const std::string& path, std::vector<uint8_t>* out) {
+  std::ifstream in(path, std::ios::binary);
+  if (!in) return false;
+  out->assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+  return true;
+}
+
+// Returns false when the replay diverged from the recording.
+bool ReplayOnce(maany_mpc_ctx_t* ctx, const maany_mpc_buf_t& transcript, const maany_mpc_keypair_t* kp,
+                std::vector<maany_mpc_replay_step_t>* steps) {
+  size_t count = 0;
+  maany_mpc_error_t err = maany_mpc_replay(ctx, &transcript, kp, steps->data(), steps->size(), &count);
+  if (err == MAANY_MPC_ERR_PROTO_STATE) return false;
+  Check(err, "maany_mpc_replay");
+  if (count > steps->size()) {
+    steps->resize(count);
+    return ReplayOnce(ctx, transcript, kp, steps);
+  }
+  steps->resize(count);
+  return true;
+}
+
+// `totals` must be sorted.
+std::string ToJson(const Options& opts, const std::vector<StepStats>& steps, const std::vector<double>& totals) {
+  std::ostringstream out;
+  out << "{\n  \"transcript\": " << JsonString(opts.transcript_path) << ",\n  \"iterations\": " << opts.iterations
+      << ",\n  \"total_ms\": {\"p50\": " << SortedPercentile(totals, 50)
+      << ", \"p90\": " << SortedPercentile(totals, 90) << ", \"max\": " << (totals.empty() ? 0 : totals.back())
+      << "},\n  \"steps\": [";
+  for (size_t i = 0; i < steps.size(); ++i) {
+    const StepStats& s = steps[i];
+    out << (i ? ",\n" : "\n") << "    {\"step\": " << i << ", \"in_bytes\": " << s.in_bytes
+        << ", \"out_bytes\": " << s.out_bytes << ", \"p50_ms\": " << SortedPercentile(s.compute_ms, 50)
+        << ", \"p90_ms\": " << SortedPercentile(s.compute_ms, 90)
+        << ", \"max_ms\": " << (s.compute_ms.empty() ? 0 : s.compute_ms.back()) << "}";
+  }
+  out << "\n  ]\n}\n";
+  return out.str();
+}
+
+[[noreturn]] void Usage(const char* argv0) {
+  std::fprintf(stderr, "usage: %s TRANSCRIPT [--key SHARE] [--iterations N] [--warmup N] [--json PATH|-]\n", argv0);
+  std::exit(1);
+}
+
+Options ParseArgs(int argc, char** argv) {
+  Options opts;
+  for (int i = 1; i < argc; ++i) {
+    std::string arg = argv[i];
+    auto next = [&]() -> std::string {
+      if (i + 1 >= argc) Usage(argv[0]);
+      return argv[++i];
+    };
+    if (arg == "--key") {
+      opts.key_path = next();
+    } else if (arg == "--iterations") {
+      opts.iterations = static_cast<uint32_t>(std::strtoul(next().c_str(), nullptr, 10));
+    } else if (arg == "--warmup") {
+      opts.warmup = static_cast<uint32_t>(std::strtoul(next().c_str(), nullptr, 10));
+    } else if (arg == "--json") {
+      opts.json_path = next();
+    } else if (arg.rfind("--", 0) == 0 || !opts.transcript_path.empty()) {
+      Usage(argv[0]);
+    } else {
+      opts.transcript_path = arg;
+    }
+  }
+  if (opts.transcript_path.empty() || opts.iterations == 0) Usage(argv[0]);
+  return opts;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  const Options opts = ParseArgs(argc, argv);
+
+  std::vector<uint8_t> transcript_bytes;
+  if (!ReadFile(opts.transcript_path, &transcript_bytes) || transcript_bytes.empty()) {
+    std::fprintf(stderr, "cannot read %s\n", opts.transcript_path.c_str());
+    return 1;
+  }
+  maany_mpc_buf_t transcript{transcript_bytes.data(), transcript_bytes.size()};
+
+  maany_mpc_init_opts_t init{};
+  maany_mpc_ctx_t* ctx = maany_mpc_init(&init);
+  if (!ctx) {
+    std::fprintf(stderr, "maany_mpc_init failed\n");
+    return 1;
+  }
+
+  maany_mpc_keypair_t* kp = nullptr;
+  if (!opts.key_path.empty()) {
+    std::vector<uint8_t> key_bytes;
+    if (!ReadFile(opts.key_path, &key_bytes)) {
+      std::fprintf(stderr, "cannot read %s\n", opts.key_path.c_str());
+      return 1;
+    }
+    maany_mpc_buf_t key{key_bytes.data(), key_bytes.size()};
+    Check(maany_mpc_kp_import(ctx, &key, &kp), "maany_mpc_kp_import");
+  }
+
+  std::vector<maany_mpc_replay_step_t> run(16);
+  std::vector<StepStats> steps;
+  std::vector<double> totals;
+  for (uint32_t i = 0; i < opts.warmup + opts.iterations; ++i) {
+    if (!ReplayOnce(ctx, transcript, kp, &run)) {
+      std::fprintf(stderr, "replay diverged from the recorded session\n");
+      return 2;
+    }
+    if (i < opts.warmup) continue;
+    if (steps.empty()) {
+      steps.resize(run.size());
+      for (size_t s = 0; s < run.size(); ++s) {
+        steps[s].in_bytes = run[s].in_bytes;
+        steps[s].out_bytes = run[s].out_bytes;
+      }
+    }
+    double total = 0;
+    for (size_t s = 0; s < run.size() && s < steps.size(); ++s) {
+      steps[s].compute_ms.push_back(run[s].compute_ms);
+      total += run[s].compute_ms;
+    }
+    totals.push_back(total);
+  }
+  for (auto& s : steps) std::sort(s.compute_ms.begin(), s.compute_ms.end());
+  std::sort(totals.begin(), totals.end());
+
+  std::printf("%-6s %10s %10s %10s %10s %10s\n", "step", "in_bytes", "out_bytes", "p50_ms", "p90_ms", "max_ms");
+  for (size_t s = 0; s < steps.size(); ++s) {
+    const auto& c = steps[s].compute_ms;
+    std::printf("%-6zu %10zu %10zu %10.3f %10.3f %10.3f\n", s, steps[s].in_bytes, steps[s].out_bytes,
+                SortedPercentile(c, 50), SortedPercentile(c, 90), c.empty() ? 0 : c.back());
+  }
+  std::printf("%-6s %10s %10s %10.3f %10.3f %10.3f\n", "total", "", "", SortedPercentile(totals, 50),
+              SortedPercentile(totals, 90), totals.empty() ? 0 : totals.back());
+
+  if (!opts.json_path.empty()) {
+    const std::string json = ToJson(opts, steps, totals);
+    if (opts.json_path == "-") {
+      std::fputs(json.c_str(), stdout);
+    } else {
+      std::ofstream out(opts.json_path);
+      out << json;
+      if (!out) {
+        std::fprintf(stderr, "cannot write %s\n", opts.json_path.c_str());
+        return 1;
+      }
+    }
+  }
+
+  if (kp) maany_mpc_kp_free(kp);
+  maany_mpc_shutdown(ctx);
+  return 0;
+}
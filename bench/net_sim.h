@@ -0,0 +1,137 @@
+#pragma once
+
+// Deterministic model of the device <-> server link for the two-party
+// protocol benchmarks. The protocol runs at full speed in process and its
+// Transcript (who sent which frame after how much compute) is replayed in
+// virtual time over a modeled link, so a run on a LAN box reports what the
+// same compute would cost over a mobile network.
+
+#include "bench_util.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace maany::bench {
+
+struct LinkProfile {
+  std::string name;
+  double rtt_ms = 0;
+  double jitter_ms = 0;  // extra one-way delay, uniform in [0, jitter]
+  double up_mbps = 0;    // device -> server; 0 = unlimited
+  double down_mbps = 0;  // server -> device; 0 = unlimited
+  // Probability a frame is overtaken in flight. Delivery stays in order, as
+  // over TCP or a WebSocket, so the frame arrives half an RTT late and holds
+  // up any frame behind it in the same direction.
+  double reorder = 0;
+};
+
+inline std::vector<LinkProfile> LinkPresets() {
+  return {
+      {"lan", 1, 0.2, 1000, 1000, 0},
+      {"4g", 100, 20, 5, 20, 0.01},
+      {"3g", 300, 60, 0.5, 2, 0.02},
+  };
+}
+
+// Accepts a preset name, optionally followed by overrides, or a list of
+// key=value pairs: "4g", "4g,rtt=150", "name=sat,rtt=600,jitter=50,up=1,down=10".
+// Keys: name, rtt, jitter (ms), up, down, bw (Mbit/s; bw sets both), reorder (0..1).
+inline bool ParseLinkProfile(const std::string& spec, LinkProfile* out) {
+  LinkProfile link;
+  link.name = spec;
+  bool named = false;
+  for (const auto& item : SplitList(spec)) {
+    const size_t eq = item.find('=');
+    if (eq == std::string::npos) {
+      const auto presets = LinkPresets();
+      auto it = std::find_if(presets.begin(), presets.end(), [&](const LinkProfile& p) { return p.name == item; });
+      if (it == presets.end()) return false;
+      link = *it;
+      named = true;
+      continue;
+    }
+    const std::string key = item.substr(0, eq);
+    const std::string value = item.substr(eq + 1);
+    char* end = nullptr;
+    const double v = std::strtod(value.c_str(), &end);
+    const bool numeric = !value.empty() && *end == '\0' && v >= 0;
+    if (key == "name") {
+      link.name = value;
+      named = true;
+    } else if (!numeric) {
+      return false;
+    } else if (key == "rtt") {
+      link.rtt_ms = v;
+    } else if (key == "jitter") {
+      link.jitter_ms = v;
+    } else if (key == "up") {
+      link.up_mbps = v;
+    } else if (key == "down") {
+      link.down_mbps = v;
+    } else if (key == "bw") {
+      link.up_mbps = link.down_mbps = v;
+    } else if (key == "reorder" && v <= 1) {
+      link.reorder = v;
+    } else {
+      return false;
+    }
+  }
+  if (!named) link.name = spec;
+  *out = link;
+  return true;
+}
+
+// End-to-end time of one protocol run over a link, split along the critical
+// path into time spent computing and time spent waiting on the network.
+struct LinkTiming {
+  double total_ms = 0;
+  double compute_ms = 0;
+  double network_ms = 0;
+};
+
+// Replays `t` over `link`. Each party has its own virtual clock: a step
+// starts when the party is free and the frame it consumes has arrived, and
+// runs for the compute time measured in process. Frames queue on the
+// per-direction link for serialization, then take rtt/2 plus jitter. Party 0
+// or 1 is the device according to Message::from. The same seed gives the
+// same network draws.
+inline LinkTiming SimulateLink(const Transcript& t, const LinkProfile& link, uint64_t seed) {
+  std::mt19937_64 rng(seed);
+  std::uniform_real_distribution<double> unit(0.0, 1.0);
+
+  LinkTiming party[2];
+  std::vector<LinkTiming> arrival(t.messages.size());
+  double link_free[2] = {0, 0};      // by direction: 0 = up, 1 = down
+  double last_delivery[2] = {0, 0};
+
+  for (const Step& step : t.steps) {
+    LinkTiming& clock = party[step.party & 1];
+    if (step.consumed >= 0 && arrival[step.consumed].total_ms > clock.total_ms) clock = arrival[step.consumed];
+    clock.total_ms += step.compute_ms;
+    clock.compute_ms += step.compute_ms;
+    if (step.produced < 0) continue;
+
+    const Message& msg = t.messages[step.produced];
+    const int dir = msg.from == "device" ? 0 : 1;
+    const double mbps = dir == 0 ? link.up_mbps : link.down_mbps;
+    const double serialize_ms = mbps > 0 ? static_cast<double>(msg.bytes) * 8.0 / (mbps * 1000.0) : 0;
+    const double departed = std::max(clock.total_ms, link_free[dir]) + serialize_ms;
+    link_free[dir] = departed;
+    double delay = link.rtt_ms / 2 + link.jitter_ms * unit(rng);
+    if (unit(rng) < link.reorder) delay += link.rtt_ms / 2;
+    const double delivered = std::max(departed + delay, last_delivery[dir]);
+    last_delivery[dir] = delivered;
+
+    LinkTiming& at = arrival[step.produced];
+    at = clock;
+    at.network_ms += delivered - clock.total_ms;
+    at.total_ms = delivered;
+  }
+  return party[0].total_ms >= party[1].total_ms ? party[0] : party[1];
+}
+
+}  // namespace maany::bench
@@ -1,8 +1,10 @@
 #include <node_api.h>
 
+#include <algorithm>
 #include <array>
 #include <cassert>
 #include <cstdint>
+#include <cstdio>
 #include <string>
 #include <vector>
 
@@ -274,6 +276,27 @@ std::vector<uint8_t> BufferToVector(napi_env env, napi_value value, const char*
   return out;
 }
 
+// Reads an optional string option. Returns false with a pending exception when
+// the property is present but not a string.
+bool GetOptionalString(napi_env env, napi_value opts, const char* name, std::string* out) {
+  napi_value value;
+  if (napi_get_named_property(env, opts, name, &value) != napi_ok) return true;
+  napi_valuetype type;
+  napi_typeof(env, value, &type);
+  if (type == napi_undefined || type == napi_null) return true;
+  if (type != napi_string) {
+    std::string message = std::string(name) + " must be a string";
+    napi_throw_type_error(env, nullptr, message.c_str());
+    return false;
+  }
+  size_t length = 0;
+  napi_get_value_string_utf8(env, value, nullptr, 0, &length);
+  out->assign(length, '\0');
+  napi_get_value_string_utf8(env, value, out->data(), out->size() + 1, &length);
+  out->resize(length);
+  return true;
+}
+
 void SetBufferProp(napi_env env, napi_value obj, const char* name, const uint8_t* data, size_t len) {
   napi_value buffer;
   napi_create_buffer_copy(env, len, data, nullptr, &buffer);
@@ -358,6 +381,10 @@ napi_value JsDkgNew(napi_env env, napi_callback_info info) {
     }
   }
 
+  std::string transcript_path;
+  if (!GetOptionalString(env, opts, "transcriptPath", &transcript_path)) return nullptr;
+  if (!transcript_path.empty()) dkg_opts.transcript_path = transcript_path.c_str();
+
   maany_mpc_dkg_t* dkg = nullptr;
   maany_mpc_error_t status = maany_mpc_dkg_new(ctx_handle->ctx, &dkg_opts, &dkg);
   if (status != MAANY_MPC_OK) {
@@ -611,6 +638,7 @@ napi_value JsSignNew(napi_env env, napi_callback_info info) {
 
   maany_mpc_sign_opts_t opts{};
   opts.scheme = MAANY_MPC_SCHEME_ECDSA_2P;
+  std::string transcript_path;
 
   if (argc >= 3 && argv[2] != nullptr) {
     napi_valuetype opt_type;
@@ -656,6 +684,8 @@ napi_value JsSignNew(napi_env env, napi_callback_info info) {
           opts.extra_aad.len = len;
         }
       }
+      if (!GetOptionalString(env, argv[2], "transcriptPath", &transcript_path)) return nullptr;
+      if (!transcript_path.empty()) opts.transcript_path = transcript_path.c_str();
     }
   }
 
@@ -939,6 +969,7 @@ napi_value JsRefreshNew(napi_env env, napi_callback_info info) {
   }
 
   maany_mpc_refresh_opts_t opts{};
+  std::string transcript_path;
   if (argc >= 3 && argv[2] != nullptr) {
     napi_valuetype opt_type;
     napi_typeof(env, argv[2], &opt_type);
@@ -961,6 +992,8 @@ napi_value JsRefreshNew(napi_env env, napi_callback_info info) {
         opts.session_id.data = static_cast<uint8_t*>(data);
         opts.session_id.len = len;
       }
+      if (!GetOptionalString(env, argv[2], "transcriptPath", &transcript_path)) return nullptr;
+      if (!transcript_path.empty()) opts.transcript_path = transcript_path.c_str();
     }
   }
 
@@ -981,6 +1014,151 @@ napi_value JsRefreshNew(napi_env env, napi_callback_info info) {
   return result;
 }
 
+// Backup ciphertext as passed in from JS; the vectors own the bytes `cipher`
+// points at.
+struct BackupCiphertextArg {
+  maany_mpc_backup_ciphertext_t cipher{};
+  std::vector<uint8_t> label;
+  std::vector<uint8_t> blob;
+  std::vector<uint8_t> commitments;
+  std::vector<uint8_t> ephemeral;
+  std::vector<uint8_t> auth;
+};
+
+// Reads an optional Buffer property; missing, undefined and null yield empty.
+std::vector<uint8_t> OptionalBufferProp(napi_env env, napi_value obj, const char* name) {
+  napi_value value;
+  if (napi_get_named_property(env, obj, name, &value) != napi_ok) return {};
+  napi_valuetype type;
+  napi_typeof(env, value, &type);
+  if (type == napi_undefined || type == napi_null) return {};
+  return BufferToVector(env, value, name);
+}
+
+void PointAt(std::vector<uint8_t>& bytes, maany_mpc_buf_t& buf) {
+  buf.data = bytes.empty() ? nullptr : bytes.data();
+  buf.len = bytes.size();
+}
+
+bool ParseBackupCiphertext(napi_env env, napi_value cipher_obj, BackupCiphertextArg& out) {
+  napi_valuetype cipher_type;
+  napi_typeof(env, cipher_obj, &cipher_type);
+  if (cipher_type != napi_object) {
+    napi_throw_type_error(env, nullptr, "ciphertext must be an object");
+    return false;
+  }
+
+  maany_mpc_backup_ciphertext_t& cipher = out.cipher;
+
+  napi_value kind_value;
+  napi_get_named_property(env, cipher_obj, "kind", &kind_value);
+  cipher.kind = ShareKindFromString(env, kind_value);
+
+  napi_value curve_value;
+  napi_get_named_property(env, cipher_obj, "curve", &curve_value);
+  cipher.curve = CurveFromString(env, curve_value);
+
+  napi_value scheme_value;
+  napi_get_named_property(env, cipher_obj, "scheme", &scheme_value);
+  cipher.scheme = SchemeFromString(env, scheme_value);
+
+  napi_value threshold_value;
+  napi_get_named_property(env, cipher_obj, "threshold", &threshold_value);
+  napi_get_value_uint32(env, threshold_value, &cipher.threshold);
+
+  napi_value share_count_value;
+  napi_get_named_property(env, cipher_obj, "shareCount", &share_count_value);
+  napi_get_value_uint32(env, share_count_value, &cipher.share_count);
+
+  napi_value key_id_value;
+  napi_get_named_property(env, cipher_obj, "keyId", &key_id_value);
+  std::vector<uint8_t> key_id_vec = BufferToVector(env, key_id_value, "keyId");
+  if (key_id_vec.size() != sizeof(cipher.key_id.bytes)) {
+    napi_throw_range_error(env, nullptr, "keyId must be 32 bytes");
+    return false;
+  }
+  std::memcpy(cipher.key_id.bytes, key_id_vec.data(), key_id_vec.size());
+
+  out.label = OptionalBufferProp(env, cipher_obj, "label");
+  PointAt(out.label, cipher.label);
+
+  napi_value blob_value;
+  napi_get_named_property(env, cipher_obj, "blob", &blob_value);
+  out.blob = BufferToVector(env, blob_value, "blob");
+  if (out.blob.empty()) {
+    napi_throw_range_error(env, nullptr, "ciphertext blob must not be empty");
+    return false;
+  }
+  PointAt(out.blob, cipher.ciphertext);
+
+  // Backups created before Feldman commitments and payload wrapping have neither.
+  out.commitments = OptionalBufferProp(env, cipher_obj, "commitments");
+  PointAt(out.commitments, cipher.commitments);
+  out.ephemeral = OptionalBufferProp(env, cipher_obj, "ephemeral");
+  PointAt(out.ephemeral, cipher.ephemeral);
+  out.auth = OptionalBufferProp(env, cipher_obj, "auth");
+  PointAt(out.auth, cipher.auth);
+  return true;
+}
+
+// Builds the JS ciphertext object and releases the library-owned buffers.
+napi_value BackupCiphertextToJs(napi_env env, maany_mpc_ctx_t* ctx, maany_mpc_backup_ciphertext_t& cipher) {
+  napi_value ciphertext_obj;
+  napi_create_object(env, &ciphertext_obj);
+
+  napi_value kind_value;
+  napi_create_string_utf8(env, ShareKindToString(cipher.kind), NAPI_AUTO_LENGTH, &kind_value);
+  napi_set_named_property(env, ciphertext_obj, "kind", kind_value);
+
+  napi_value curve_value;
+  napi_create_string_utf8(env, CurveToString(cipher.curve), NAPI_AUTO_LENGTH, &curve_value);
+  napi_set_named_property(env, ciphertext_obj, "curve", curve_value);
+
+  napi_value scheme_value;
+  napi_create_string_utf8(env, SchemeToString(cipher.scheme), NAPI_AUTO_LENGTH, &scheme_value);
+  napi_set_named_property(env, ciphertext_obj, "scheme", scheme_value);
+
+  napi_value threshold_value;
+  napi_create_uint32(env, cipher.threshold, &threshold_value);
+  napi_set_named_property(env, ciphertext_obj, "threshold", threshold_value);
+
+  napi_value share_count_value;
+  napi_create_uint32(env, cipher.share_count, &share_count_value);
+  napi_set_named_property(env, ciphertext_obj, "shareCount", share_count_value);
+
+  SetBufferProp(env, ciphertext_obj, "keyId", cipher.key_id.bytes, sizeof(cipher.key_id.bytes));
+  if (cipher.label.data && cipher.label.len) {
+    SetBufferProp(env, ciphertext_obj, "label", static_cast<uint8_t*>(cipher.label.data), cipher.label.len);
+  } else {
+    napi_value empty;
+    napi_create_buffer(env, 0, nullptr, &empty);
+    napi_set_named_property(env, ciphertext_obj, "label", empty);
+  }
+  if (cipher.ciphertext.data && cipher.ciphertext.len) {
+    SetBufferProp(env, ciphertext_obj, "blob", static_cast<uint8_t*>(cipher.ciphertext.data), cipher.ciphertext.len);
+  } else {
+    napi_value empty;
+    napi_create_buffer(env, 0, nullptr, &empty);
+    napi_set_named_property(env, ciphertext_obj, "blob", empty);
+  }
+  if (cipher.commitments.data && cipher.commitments.len) {
+    SetBufferProp(env, ciphertext_obj, "commitments", cipher.commitments.data, cipher.commitments.len);
+  }
+  if (cipher.ephemeral.data && cipher.ephemeral.len) {
+    SetBufferProp(env, ciphertext_obj, "ephemeral", cipher.ephemeral.data, cipher.ephemeral.len);
+  }
+  if (cipher.auth.data && cipher.auth.len) {
+    SetBufferProp(env, ciphertext_obj, "auth", cipher.auth.data, cipher.auth.len);
+  }
+
+  maany_mpc_buf_free(ctx, &cipher.label);
+  maany_mpc_buf_free(ctx, &cipher.ciphertext);
+  maany_mpc_buf_free(ctx, &cipher.commitments);
+  maany_mpc_buf_free(ctx, &cipher.ephemeral);
+  maany_mpc_buf_free(ctx, &cipher.auth);
+  return ciphertext_obj;
+}
+
 napi_value JsBackupCreate(napi_env env, napi_callback_info info) {
   size_t argc = 3;
   napi_value argv[3];
@@ -1059,60 +1237,22 @@ napi_value JsBackupCreate(napi_env env, napi_callback_info info) {
 
   maany_mpc_backup_ciphertext_t cipher{};
   std::vector<maany_mpc_backup_share_t> share_structs(share_count);
-  maany_mpc_error_t status = maany_mpc_backup_create(
+  maany_mpc_buf_t update_key{nullptr, 0};
+  maany_mpc_error_t status = maany_mpc_backup_create_updatable(
     ctx_handle->ctx,
     kp_handle->kp,
     threshold,
     share_count,
     label_vec.empty() ? nullptr : &label_buf,
     &cipher,
-    share_structs.data());
+    share_structs.data(),
+    &update_key);
   if (status != MAANY_MPC_OK) {
-    napi_throw(env, CreateError(env, "maany_mpc_backup_create", status));
+    napi_throw(env, CreateError(env, "maany_mpc_backup_create_updatable", status));
     return nullptr;
   }
 
-  napi_value ciphertext_obj;
-  napi_create_object(env, &ciphertext_obj);
-
-  napi_value kind_value;
-  napi_create_string_utf8(env, ShareKindToString(cipher.kind), NAPI_AUTO_LENGTH, &kind_value);
-  napi_set_named_property(env, ciphertext_obj, "kind", kind_value);
-
-  napi_value curve_value;
-  napi_create_string_utf8(env, CurveToString(cipher.curve), NAPI_AUTO_LENGTH, &curve_value);
-  napi_set_named_property(env, ciphertext_obj, "curve", curve_value);
-
-  napi_value scheme_value;
-  napi_create_string_utf8(env, SchemeToString(cipher.scheme), NAPI_AUTO_LENGTH, &scheme_value);
-  napi_set_named_property(env, ciphertext_obj, "scheme", scheme_value);
-
-  napi_value threshold_value;
-  napi_create_uint32(env, cipher.threshold, &threshold_value);
-  napi_set_named_property(env, ciphertext_obj, "threshold", threshold_value);
-
-  napi_value share_count_value;
-  napi_create_uint32(env, cipher.share_count, &share_count_value);
-  napi_set_named_property(env, ciphertext_obj, "shareCount", share_count_value);
-
-  SetBufferProp(env, ciphertext_obj, "keyId", cipher.key_id.bytes, sizeof(cipher.key_id.bytes));
-  if (cipher.label.data && cipher.label.len) {
-    SetBufferProp(env, ciphertext_obj, "label", static_cast<uint8_t*>(cipher.label.data), cipher.label.len);
-  } else {
-    napi_value empty;
-    napi_create_buffer(env, 0, nullptr, &empty);
-    napi_set_named_property(env, ciphertext_obj, "label", empty);
-  }
-  if (cipher.ciphertext.data && cipher.ciphertext.len) {
-    SetBufferProp(env, ciphertext_obj, "blob", static_cast<uint8_t*>(cipher.ciphertext.data), cipher.ciphertext.len);
-  } else {
-    napi_value empty;
-    napi_create_buffer(env, 0, nullptr, &empty);
-    napi_set_named_property(env, ciphertext_obj, "blob", empty);
-  }
-
-  maany_mpc_buf_free(ctx_handle->ctx, &cipher.label);
-  maany_mpc_buf_free(ctx_handle->ctx, &cipher.ciphertext);
+  napi_value ciphertext_obj = BackupCiphertextToJs(env, ctx_handle->ctx, cipher);
 
   napi_value shares_array;
   napi_create_array_with_length(env, share_count, &shares_array);
@@ -1127,91 +1267,74 @@ napi_value JsBackupCreate(napi_env env, napi_callback_info info) {
     maany_mpc_buf_free(ctx_handle->ctx, &share_structs[i].data);
   }
 
+  napi_value update_key_buffer;
+  napi_create_buffer_copy(env, update_key.len, update_key.data, nullptr, &update_key_buffer);
+  maany_mpc_buf_free(ctx_handle->ctx, &update_key);
+
   napi_value result;
   napi_create_object(env, &result);
   napi_set_named_property(env, result, "ciphertext", ciphertext_obj);
   napi_set_named_property(env, result, "shares", shares_array);
+  napi_set_named_property(env, result, "updateKey", update_key_buffer);
   return result;
 }
 
-napi_value JsBackupRestore(napi_env env, napi_callback_info info) {
-  size_t argc = 3;
-  napi_value argv[3];
+napi_value JsBackupUpdate(napi_env env, napi_callback_info info) {
+  size_t argc = 4;
+  napi_value argv[4];
   napi_get_cb_info(env, info, &argc, argv, nullptr, nullptr);
-  if (argc < 3) {
-    napi_throw_type_error(env, nullptr, "backupRestore expects (ctx, ciphertext, shares)");
+  if (argc < 4) {
+    napi_throw_type_error(env, nullptr, "backupUpdate expects (ctx, keypair, ciphertext, updateKey)");
     return nullptr;
   }
 
   CtxHandle* ctx_handle = nullptr;
-  if (!UnwrapHandle(env, argv[0], &ctx_handle)) return nullptr;
-  if (!ctx_handle->ctx) {
-    napi_throw_error(env, nullptr, "Context already shut down");
+  KeypairHandle* kp_handle = nullptr;
+  if (!UnwrapHandle(env, argv[0], &ctx_handle) || !UnwrapHandle(env, argv[1], &kp_handle)) return nullptr;
+  if (!ctx_handle->ctx || !kp_handle->kp) {
+    napi_throw_error(env, nullptr, "Context or keypair handle invalid");
     return nullptr;
   }
 
-  napi_value cipher_obj = argv[1];
-  napi_valuetype cipher_type;
-  napi_typeof(env, cipher_obj, &cipher_type);
-  if (cipher_type != napi_object) {
-    napi_throw_type_error(env, nullptr, "ciphertext must be an object");
+  BackupCiphertextArg existing;
+  if (!ParseBackupCiphertext(env, argv[2], existing)) return nullptr;
+  std::vector<uint8_t> update_key = BufferToVector(env, argv[3], "updateKey");
+  if (update_key.empty()) {
+    napi_throw_range_error(env, nullptr, "updateKey must not be empty");
     return nullptr;
   }
+  maany_mpc_buf_t update_key_buf{update_key.data(), update_key.size()};
 
-  maany_mpc_backup_ciphertext_t cipher{};
-
-  napi_value kind_value;
-  napi_get_named_property(env, cipher_obj, "kind", &kind_value);
-  cipher.kind = ShareKindFromString(env, kind_value);
-
-  napi_value curve_value;
-  napi_get_named_property(env, cipher_obj, "curve", &curve_value);
-  cipher.curve = CurveFromString(env, curve_value);
-
-  napi_value scheme_value;
-  napi_get_named_property(env, cipher_obj, "scheme", &scheme_value);
-  cipher.scheme = SchemeFromString(env, scheme_value);
-
-  napi_value threshold_value;
-  napi_get_named_property(env, cipher_obj, "threshold", &threshold_value);
-  napi_get_value_uint32(env, threshold_value, &cipher.threshold);
-
-  napi_value share_count_value;
-  napi_get_named_property(env, cipher_obj, "shareCount", &share_count_value);
-  napi_get_value_uint32(env, share_count_value, &cipher.share_count);
-
-  napi_value key_id_value;
-  napi_get_named_property(env, cipher_obj, "keyId", &key_id_value);
-  std::vector<uint8_t> key_id_vec = BufferToVector(env, key_id_value, "keyId");
-  if (key_id_vec.size() != sizeof(cipher.key_id.bytes)) {
-    napi_throw_range_error(env, nullptr, "keyId must be 32 bytes");
+  maany_mpc_backup_ciphertext_t updated{};
+  maany_mpc_error_t status =
+    maany_mpc_backup_update(ctx_handle->ctx, kp_handle->kp, &existing.cipher, &update_key_buf, &updated);
+  std::fill(update_key.begin(), update_key.end(), 0);
+  if (status != MAANY_MPC_OK) {
+    napi_throw(env, CreateError(env, "maany_mpc_backup_update", status));
     return nullptr;
   }
-  std::memcpy(cipher.key_id.bytes, key_id_vec.data(), key_id_vec.size());
+  return BackupCiphertextToJs(env, ctx_handle->ctx, updated);
+}
 
-  std::vector<uint8_t> label_vec;
-  napi_value label_value;
-  if (napi_get_named_property(env, cipher_obj, "label", &label_value) == napi_ok) {
-    napi_valuetype label_type;
-    napi_typeof(env, label_value, &label_type);
-    if (label_type != napi_undefined && label_type != napi_null) {
-      label_vec = BufferToVector(env, label_value, "label");
-    }
-  }
-  if (!label_vec.empty()) {
-    cipher.label.data = label_vec.data();
-    cipher.label.len = label_vec.size();
+napi_value JsBackupRestore(napi_env env, napi_callback_info info) {
+  size_t argc = 3;
+  napi_value argv[3];
+  napi_get_cb_info(env, info, &argc, argv, nullptr, nullptr);
+  if (argc < 3) {
+    napi_throw_type_error(env, nullptr, "backupRestore expects (ctx, ciphertext, shares)");
+    return nullptr;
   }
 
-  napi_value blob_value;
-  napi_get_named_property(env, cipher_obj, "blob", &blob_value);
-  std::vector<uint8_t> blob_vec = BufferToVector(env, blob_value, "blob");
-  if (blob_vec.empty()) {
-    napi_throw_range_error(env, nullptr, "ciphertext blob must not be empty");
+  CtxHandle* ctx_handle = nullptr;
+  if (!UnwrapHandle(env, argv[0], &ctx_handle)) return nullptr;
+  if (!ctx_handle->ctx) {
+    napi_throw_error(env, nullptr, "Context already shut down");
     return nullptr;
   }
-  cipher.ciphertext.data = blob_vec.data();
-  cipher.ciphertext.len = blob_vec.size();
+
+  BackupCiphertextArg cipher_arg;
+  if (!ParseBackupCiphertext(env, argv[1], cipher_arg)) return nullptr;
+  maany_mpc_backup_ciphertext_t& cipher = cipher_arg.cipher;
 
   bool is_array = false;
   napi_is_array(env, argv[2], &is_array);
@@ -1262,12 +1385,74 @@ napi_value JsBackupRestore(napi_env env, napi_callback_info info) {
   return result;
 }
 
-napi_value JsKpExport(napi_env env, napi_callback_info info) {
-  size_t argc = 2;
-  napi_value argv[2];
+struct EnvelopeRewrapWork : public DeferredWorkBase {
+  CtxHandle* ctx_handle = nullptr;
+  std::vector<uint8_t> old_kek;
+  std::vector<uint8_t> new_kek;
+  std::vector<std::vector<uint8_t>> blobs;
+  std::vector<std::vector<uint8_t>> rewrapped;
+};
+
+void EnvelopeRewrapExecute(napi_env /*env*/, void* data) {
+  auto* work = static_cast<EnvelopeRewrapWork*>(data);
+  maany_mpc_buf_t old_buf{work->old_kek.data(), work->old_kek.size()};
+  maany_mpc_buf_t new_buf{work->new_kek.data(), work->new_kek.size()};
+  std::vector<maany_mpc_buf_t> in(work->blobs.size());
+  for (size_t i = 0; i < in.size(); ++i) in[i] = maany_mpc_buf_t{work->blobs[i].data(), work->blobs[i].size()};
+  std::vector<maany_mpc_buf_t> out(in.size(), maany_mpc_buf_t{nullptr, 0});
+  work->status = maany_mpc_envelope_rewrap_many(work->ctx_handle->ctx, &old_buf, &new_buf, in.data(), in.size(),
+                                                out.data());
+  maany_mpc_secure_zero(work->old_kek.data(), work->old_kek.size());
+  maany_mpc_secure_zero(work->new_kek.data(), work->new_kek.size());
+  work->error_context = "maany_mpc_envelope_rewrap_many";
+  if (work->status != MAANY_MPC_OK) return;
+  work->rewrapped.resize(out.size());
+  for (size_t i = 0; i < out.size(); ++i) {
+    work->rewrapped[i].assign(out[i].data, out[i].data + out[i].len);
+    maany_mpc_buf_free(work->ctx_handle->ctx, &out[i]);
+  }
+}
+
+void EnvelopeRewrapComplete(napi_env env, napi_status status, void* data) {
+  auto* work = static_cast<EnvelopeRewrapWork*>(data);
+  if (status != napi_ok) {
+    napi_value err;
+    napi_get_and_clear_last_exception(env, &err);
+    napi_reject_deferred(env, work->deferred, err);
+    napi_delete_async_work(env, work->work);
+    delete work;
+    return;
+  }
+
+  if (work->status != MAANY_MPC_OK) {
+    napi_value err = CreateError(env, work->error_context, work->status);
+    napi_reject_deferred(env, work->deferred, err);
+    napi_delete_async_work(env, work->work);
+    delete work;
+    return;
+  }
+
+  napi_value array;
+  napi_create_array_with_length(env, work->rewrapped.size(), &array);
+  for (size_t i = 0; i < work->rewrapped.size(); ++i) {
+    napi_value buffer;
+    napi_create_buffer_copy(env, work->rewrapped[i].size(), work->rewrapped[i].data(), nullptr, &buffer);
+    napi_set_element(env, array, static_cast<uint32_t>(i), buffer);
+  }
+
+  napi_resolve_deferred(env, work->deferred, array);
+  napi_delete_async_work(env, work->work);
+  delete work;
+}
+
+// Resolves with the rewrapped envelopes in input order. The index.js wrapper
+// turns this into an async iterator over arbitrarily long inputs.
+napi_value JsEnvelopeRewrapMany(napi_env env, napi_callback_info info) {
+  size_t argc = 4;
+  napi_value argv[4];
   napi_get_cb_info(env, info, &argc, argv, nullptr, nullptr);
-  if (argc < 2) {
-    napi_throw_type_error(env, nullptr, "kpExport expects (ctx, keypair)");
+  if (argc < 4) {
+    napi_throw_type_error(env, nullptr, "envelopeRewrapMany expects (ctx, oldKek, newKek, blobs)");
     return nullptr;
   }
 
@@ -1278,10 +1463,74 @@ napi_value JsKpExport(napi_env env, napi_callback_info info) {
     return nullptr;
   }
 
-  KeypairHandle* kp_handle = nullptr;
-  if (!UnwrapHandle(env, argv[1], &kp_handle)) return nullptr;
-  if (!kp_handle->kp) {
-    napi_throw_error(env, nullptr, "Keypair handle already freed");
+  bool is_array = false;
+  napi_is_array(env, argv[3], &is_array);
+  if (!is_array) {
+    napi_throw_type_error(env, nullptr, "blobs must be an array");
+    return nullptr;
+  }
+  uint32_t blob_count = 0;
+  napi_get_array_length(env, argv[3], &blob_count);
+  if (blob_count == 0) {
+    napi_throw_range_error(env, nullptr, "blobs must not be empty");
+    return nullptr;
+  }
+
+  auto* work = new EnvelopeRewrapWork();
+  work->env = env;
+  work->ctx_handle = ctx_handle;
+  work->old_kek = BufferToVector(env, argv[1], "oldKek");
+  work->new_kek = BufferToVector(env, argv[2], "newKek");
+  if (work->old_kek.size() != 32 || work->new_kek.size() != 32) {
+    delete work;
+    napi_throw_range_error(env, nullptr, "keks must be 32-byte Buffers");
+    return nullptr;
+  }
+  // Copied because JS may reuse or release the buffers while the work runs.
+  work->blobs.resize(blob_count);
+  for (uint32_t i = 0; i < blob_count; ++i) {
+    napi_value blob;
+    napi_get_element(env, argv[3], i, &blob);
+    work->blobs[i] = BufferToVector(env, blob, "blob");
+    if (work->blobs[i].empty()) {
+      delete work;
+      napi_throw_range_error(env, nullptr, "blob must not be empty");
+      return nullptr;
+    }
+  }
+
+  napi_value promise;
+  napi_create_promise(env, &work->deferred, &promise);
+
+  napi_value resource_name;
+  napi_create_string_utf8(env, "envelopeRewrapMany", NAPI_AUTO_LENGTH, &resource_name);
+  napi_create_async_work(env, nullptr, resource_name, EnvelopeRewrapExecute, EnvelopeRewrapComplete, work,
+                         &work->work);
+  napi_queue_async_work(env, work->work);
+
+  return promise;
+}
+
+napi_value JsKpExport(napi_env env, napi_callback_info info) {
+  size_t argc = 2;
+  napi_value argv[2];
+  napi_get_cb_info(env, info, &argc, argv, nullptr, nullptr);
+  if (argc < 2) {
+    napi_throw_type_error(env, nullptr, "kpExport expects (ctx, keypair)");
+    return nullptr;
+  }
+
+  CtxHandle* ctx_handle = nullptr;
+  if (!UnwrapHandle(env, argv[0], &ctx_handle)) return nullptr;
+  if (!ctx_handle->ctx) {
+    napi_throw_error(env, nullptr, "Context already shut down");
+    return nullptr;
+  }
+
+  KeypairHandle* kp_handle = nullptr;
+  if (!UnwrapHandle(env, argv[1], &kp_handle)) return nullptr;
+  if (!kp_handle->kp) {
+    napi_throw_error(env, nullptr, "Keypair handle already freed");
     return nullptr;
   }
 
@@ -1344,6 +1593,660 @@ napi_value JsKpImport(napi_env env, napi_callback_info info) {
   return result;
 }
 
+struct KekHandle {
+  maany_mpc_kek_t* kek;
+};
+
+void FinalizeKek(napi_env /*env*/, void* data, void* /*hint*/) {
+  auto* handle = static_cast<KekHandle*>(data);
+  if (!handle) return;
+  if (handle->kek) {
+    maany_mpc_kek_free(handle->kek);
+    handle->kek = nullptr;
+  }
+  delete handle;
+}
+
+// Borrows a Buffer argument that may be omitted; `present` is false for
+// undefined/null.
+bool BorrowOptionalBuffer(napi_env env, napi_value value, const char* label, maany_mpc_buf_t& out, bool& present) {
+  out = maany_mpc_buf_t{nullptr, 0};
+  present = false;
+  napi_valuetype type;
+  napi_typeof(env, value, &type);
+  if (type == napi_undefined || type == napi_null) return true;
+  bool is_buffer = false;
+  napi_is_buffer(env, value, &is_buffer);
+  if (!is_buffer) {
+    std::string message = std::string(label) + " must be a Buffer";
+    napi_throw_type_error(env, nullptr, message.c_str());
+    return false;
+  }
+  void* data = nullptr;
+  napi_get_buffer_info(env, value, &data, &out.len);
+  out.data = static_cast<uint8_t*>(data);
+  present = true;
+  return true;
+}
+
+bool UnwrapKek(napi_env env, napi_value value, KekHandle** out_handle) {
+  if (!UnwrapHandle(env, value, out_handle)) return false;
+  if (!(*out_handle)->kek) {
+    napi_throw_error(env, nullptr, "Kek handle already freed");
+    return false;
+  }
+  return true;
+}
+
+napi_value JsKekRegister(napi_env env, napi_callback_info info) {
+  size_t argc = 2;
+  napi_value argv[2];
+  napi_get_cb_info(env, info, &argc, argv, nullptr, nullptr);
+  if (argc < 2) {
+    napi_throw_type_error(env, nullptr, "kekRegister expects (ctx, key)");
+    return nullptr;
+  }
+
+  CtxHandle* ctx_handle = nullptr;
+  if (!UnwrapHandle(env, argv[0], &ctx_handle)) return nullptr;
+  if (!ctx_handle->ctx) {
+    napi_throw_error(env, nullptr, "Context already shut down");
+    return nullptr;
+  }
+
+  maany_mpc_buf_t key{nullptr, 0};
+  bool present = false;
+  if (!BorrowOptionalBuffer(env, argv[1], "key", key, present)) return nullptr;
+  if (!present || key.len != 32) {
+    napi_throw_range_error(env, nullptr, "key must be a 32-byte Buffer");
+    return nullptr;
+  }
+
+  maany_mpc_kek_t* kek = nullptr;
+  maany_mpc_error_t status = maany_mpc_kek_register(ctx_handle->ctx, &key, &kek);
+  if (status != MAANY_MPC_OK) {
+    napi_throw(env, CreateError(env, "maany_mpc_kek_register", status));
+    return nullptr;
+  }
+
+  auto* handle = new KekHandle{kek};
+  napi_value result = WrapHandle(env, handle, FinalizeKek);
+  if (!result) {
+    FinalizeKek(env, handle, nullptr);
+    napi_throw_error(env, nullptr, "Failed to wrap kek handle");
+    return nullptr;
+  }
+  return result;
+}
+
+napi_value JsKekFree(napi_env env, napi_callback_info info) {
+  size_t argc = 1;
+  napi_value argv[1];
+  napi_get_cb_info(env, info, &argc, argv, nullptr, nullptr);
+  if (argc < 1) {
+    napi_throw_type_error(env, nullptr, "kekFree expects a kek handle");
+    return nullptr;
+  }
+
+  KekHandle* kek_handle = nullptr;
+  if (!UnwrapHandle(env, argv[0], &kek_handle)) return nullptr;
+  if (kek_handle->kek) {
+    maany_mpc_kek_free(kek_handle->kek);
+    kek_handle->kek = nullptr;
+  }
+  return nullptr;
+}
+
+napi_value JsKpExportSealed(napi_env env, napi_callback_info info) {
+  size_t argc = 4;
+  napi_value argv[4];
+  napi_get_cb_info(env, info, &argc, argv, nullptr, nullptr);
+  if (argc < 3) {
+    napi_throw_type_error(env, nullptr, "kpExportSealed expects (ctx, keypair, kek, [aad])");
+    return nullptr;
+  }
+
+  CtxHandle* ctx_handle = nullptr;
+  if (!UnwrapHandle(env, argv[0], &ctx_handle)) return nullptr;
+  if (!ctx_handle->ctx) {
+    napi_throw_error(env, nullptr, "Context already shut down");
+    return nullptr;
+  }
+
+  KeypairHandle* kp_handle = nullptr;
+  if (!UnwrapHandle(env, argv[1], &kp_handle)) return nullptr;
+  if (!kp_handle->kp) {
+    napi_throw_error(env, nullptr, "Keypair handle already freed");
+    return nullptr;
+  }
+
+  KekHandle* kek_handle = nullptr;
+  if (!UnwrapKek(env, argv[2], &kek_handle)) return nullptr;
+
+  maany_mpc_buf_t aad{nullptr, 0};
+  bool has_aad = false;
+  if (argc >= 4 && !BorrowOptionalBuffer(env, argv[3], "aad", aad, has_aad)) return nullptr;
+
+  maany_mpc_buf_t sealed{nullptr, 0};
+  maany_mpc_error_t status =
+      maany_mpc_kp_export_sealed(ctx_handle->ctx, kp_handle->kp, kek_handle->kek, has_aad ? &aad : nullptr, &sealed);
+  if (status != MAANY_MPC_OK) {
+    napi_throw(env, CreateError(env, "maany_mpc_kp_export_sealed", status));
+    return nullptr;
+  }
+
+  napi_value buffer;
+  napi_create_buffer_copy(env, sealed.len, sealed.data, nullptr, &buffer);
+  maany_mpc_buf_free(ctx_handle->ctx, &sealed);
+  return buffer;
+}
+
+napi_value JsKpImportSealed(napi_env env, napi_callback_info info) {
+  size_t argc = 4;
+  napi_value argv[4];
+  napi_get_cb_info(env, info, &argc, argv, nullptr, nullptr);
+  if (argc < 3) {
+    napi_throw_type_error(env, nullptr, "kpImportSealed expects (ctx, kek, sealed, [aad])");
+    return nullptr;
+  }
+
+  CtxHandle* ctx_handle = nullptr;
+  if (!UnwrapHandle(env, argv[0], &ctx_handle)) return nullptr;
+  if (!ctx_handle->ctx) {
+    napi_throw_error(env, nullptr, "Context already shut down");
+    return nullptr;
+  }
+
+  KekHandle* kek_handle = nullptr;
+  if (!UnwrapKek(env, argv[1], &kek_handle)) return nullptr;
+
+  maany_mpc_buf_t sealed{nullptr, 0};
+  bool has_sealed = false;
+  if (!BorrowOptionalBuffer(env, argv[2], "sealed", sealed, has_sealed)) return nullptr;
+  if (!has_sealed) {
+    napi_throw_type_error(env, nullptr, "sealed must be a Buffer");
+    return nullptr;
+  }
+  maany_mpc_buf_t aad{nullptr, 0};
+  bool has_aad = false;
+  if (argc >= 4 && !BorrowOptionalBuffer(env, argv[3], "aad", aad, has_aad)) return nullptr;
+
+  maany_mpc_keypair_t* kp = nullptr;
+  maany_mpc_error_t status =
+      maany_mpc_kp_import_sealed(ctx_handle->ctx, kek_handle->kek, has_aad ? &aad : nullptr, &sealed, &kp);
+  if (status != MAANY_MPC_OK) {
+    napi_throw(env, CreateError(env, "maany_mpc_kp_import_sealed", status));
+    return nullptr;
+  }
+
+  auto* kp_handle = new KeypairHandle{kp};
+  napi_value result = WrapHandle(env, kp_handle, FinalizeKeypair);
+  if (!result) {
+    FinalizeKeypair(env, kp_handle, nullptr);
+    napi_throw_error(env, nullptr, "Failed to wrap keypair handle");
+    return nullptr;
+  }
+  return result;
+}
+
+struct StoreHandle {
+  maany_mpc_store_t* store;
+};
+
+void FinalizeStore(napi_env /*env*/, void* data, void* /*hint*/) {
+  auto* handle = static_cast<StoreHandle*>(data);
+  if (!handle) return;
+  if (handle->store) {
+    maany_mpc_store_close(handle->store);
+    handle->store = nullptr;
+  }
+  delete handle;
+}
+
+// Unwraps the (ctx, store) pair every store call starts with.
+bool UnwrapCtxStore(napi_env env, napi_value ctx_value, napi_value store_value, CtxHandle** ctx, StoreHandle** store) {
+  if (!UnwrapHandle(env, ctx_value, ctx)) return false;
+  if (!(*ctx)->ctx) {
+    napi_throw_error(env, nullptr, "Context already shut down");
+    return false;
+  }
+  if (!UnwrapHandle(env, store_value, store)) return false;
+  if (!(*store)->store) {
+    napi_throw_error(env, nullptr, "Store already closed");
+    return false;
+  }
+  return true;
+}
+
+bool ReadKeyId(napi_env env, napi_value value, maany_mpc_key_id_t& out) {
+  maany_mpc_buf_t buf{nullptr, 0};
+  bool present = false;
+  if (!BorrowOptionalBuffer(env, value, "keyId", buf, present)) return false;
+  if (!present || buf.len != sizeof(out.bytes)) {
+    napi_throw_range_error(env, nullptr, "keyId must be a 32-byte Buffer");
+    return false;
+  }
+  std::memcpy(out.bytes, buf.data, sizeof(out.bytes));
+  return true;
+}
+
+napi_value JsStoreOpen(napi_env env, napi_callback_info info) {
+  size_t argc = 4;
+  napi_value argv[4];
+  napi_get_cb_info(env, info, &argc, argv, nullptr, nullptr);
+  if (argc < 3) {
+    napi_throw_type_error(env, nullptr, "storeOpen expects (ctx, path, kek, [options])");
+    return nullptr;
+  }
+
+  CtxHandle* ctx_handle = nullptr;
+  if (!UnwrapHandle(env, argv[0], &ctx_handle)) return nullptr;
+  if (!ctx_handle->ctx) {
+    napi_throw_error(env, nullptr, "Context already shut down");
+    return nullptr;
+  }
+
+  napi_valuetype path_type;
+  napi_typeof(env, argv[1], &path_type);
+  if (path_type != napi_string) {
+    napi_throw_type_error(env, nullptr, "path must be a string");
+    return nullptr;
+  }
+  size_t length = 0;
+  napi_get_value_string_utf8(env, argv[1], nullptr, 0, &length);
+  std::string path(length, '\0');
+  napi_get_value_string_utf8(env, argv[1], path.data(), path.size() + 1, &length);
+  path.resize(length);
+
+  KekHandle* kek_handle = nullptr;
+  if (!UnwrapKek(env, argv[2], &kek_handle)) return nullptr;
+
+  maany_mpc_store_opts_t opts{};
+  if (argc >= 4) {
+    napi_valuetype opts_type;
+    napi_typeof(env, argv[3], &opts_type);
+    if (opts_type == napi_object) {
+      bool has_sync = false;
+      napi_has_named_property(env, argv[3], "syncWrites", &has_sync);
+      if (has_sync) {
+        napi_value sync_value;
+        napi_get_named_property(env, argv[3], "syncWrites", &sync_value);
+        bool sync_writes = false;
+        napi_get_value_bool(env, sync_value, &sync_writes);
+        opts.sync_writes = sync_writes ? 1u : 0u;
+      }
+    }
+  }
+
+  maany_mpc_store_t* store = nullptr;
+  maany_mpc_error_t status = maany_mpc_store_open(ctx_handle->ctx, path.c_str(), kek_handle->kek, &opts, &store);
+  if (status != MAANY_MPC_OK) {
+    napi_throw(env, CreateError(env, "maany_mpc_store_open", status));
+    return nullptr;
+  }
+
+  auto* handle = new StoreHandle{store};
+  napi_value result = WrapHandle(env, handle, FinalizeStore);
+  if (!result) {
+    FinalizeStore(env, handle, nullptr);
+    napi_throw_error(env, nullptr, "Failed to wrap store handle");
+    return nullptr;
+  }
+  return result;
+}
+
+napi_value JsStoreClose(napi_env env, napi_callback_info info) {
+  size_t argc = 1;
+  napi_value argv[1];
+  napi_get_cb_info(env, info, &argc, argv, nullptr, nullptr);
+  if (argc < 1) {
+    napi_throw_type_error(env, nullptr, "storeClose expects a store handle");
+    return nullptr;
+  }
+
+  StoreHandle* store_handle = nullptr;
+  if (!UnwrapHandle(env, argv[0], &store_handle)) return nullptr;
+  if (store_handle->store) {
+    maany_mpc_store_close(store_handle->store);
+    store_handle->store = nullptr;
+  }
+  return nullptr;
+}
+
+napi_value JsStorePut(napi_env env, napi_callback_info info) {
+  size_t argc = 3;
+  napi_value argv[3];
+  napi_get_cb_info(env, info, &argc, argv, nullptr, nullptr);
+  if (argc < 3) {
+    napi_throw_type_error(env, nullptr, "storePut expects (ctx, store, keypair)");
+    return nullptr;
+  }
+
+  CtxHandle* ctx_handle = nullptr;
+  StoreHandle* store_handle = nullptr;
+  if (!UnwrapCtxStore(env, argv[0], argv[1], &ctx_handle, &store_handle)) return nullptr;
+  KeypairHandle* kp_handle = nullptr;
+  if (!UnwrapHandle(env, argv[2], &kp_handle)) return nullptr;
+  if (!kp_handle->kp) {
+    napi_throw_error(env, nullptr, "Keypair handle already freed");
+    return nullptr;
+  }
+
+  maany_mpc_error_t status = maany_mpc_store_put(ctx_handle->ctx, store_handle->store, kp_handle->kp);
+  if (status != MAANY_MPC_OK) {
+    napi_throw(env, CreateError(env, "maany_mpc_store_put", status));
+    return nullptr;
+  }
+  return nullptr;
+}
+
+napi_value JsStoreGet(napi_env env, napi_callback_info info) {
+  size_t argc = 3;
+  napi_value argv[3];
+  napi_get_cb_info(env, info, &argc, argv, nullptr, nullptr);
+  if (argc < 3) {
+    napi_throw_type_error(env, nullptr, "storeGet expects (ctx, store, keyId)");
+    return nullptr;
+  }
+
+  CtxHandle* ctx_handle = nullptr;
+  StoreHandle* store_handle = nullptr;
+  if (!UnwrapCtxStore(env, argv[0], argv[1], &ctx_handle, &store_handle)) return nullptr;
+  maany_mpc_key_id_t key_id{};
+  if (!ReadKeyId(env, argv[2], key_id)) return nullptr;
+
+  maany_mpc_keypair_t* kp = nullptr;
+  maany_mpc_error_t status = maany_mpc_store_get(ctx_handle->ctx, store_handle->store, &key_id, &kp);
+  if (status != MAANY_MPC_OK) {
+    napi_throw(env, CreateError(env, "maany_mpc_store_get", status));
+    return nullptr;
+  }
+  if (!kp) {
+    napi_value null_value;
+    napi_get_null(env, &null_value);
+    return null_value;
+  }
+
+  auto* kp_handle = new KeypairHandle{kp};
+  napi_value result = WrapHandle(env, kp_handle, FinalizeKeypair);
+  if (!result) {
+    FinalizeKeypair(env, kp_handle, nullptr);
+    napi_throw_error(env, nullptr, "Failed to wrap keypair handle");
+    return nullptr;
+  }
+  return result;
+}
+
+napi_value JsStoreRemove(napi_env env, napi_callback_info info) {
+  size_t argc = 3;
+  napi_value argv[3];
+  napi_get_cb_info(env, info, &argc, argv, nullptr, nullptr);
+  if (argc < 3) {
+    napi_throw_type_error(env, nullptr, "storeRemove expects (ctx, store, keyId)");
+    return nullptr;
+  }
+
+  CtxHandle* ctx_handle = nullptr;
+  StoreHandle* store_handle = nullptr;
+  if (!UnwrapCtxStore(env, argv[0], argv[1], &ctx_handle, &store_handle)) return nullptr;
+  maany_mpc_key_id_t key_id{};
+  if (!ReadKeyId(env, argv[2], key_id)) return nullptr;
+
+  uint32_t removed = 0;
+  maany_mpc_error_t status = maany_mpc_store_remove(ctx_handle->ctx, store_handle->store, &key_id, &removed);
+  if (status != MAANY_MPC_OK) {
+    napi_throw(env, CreateError(env, "maany_mpc_store_remove", status));
+    return nullptr;
+  }
+  napi_value result;
+  napi_get_boolean(env, removed != 0, &result);
+  return result;
+}
+
+napi_value JsStoreCompact(napi_env env, napi_callback_info info) {
+  size_t argc = 2;
+  napi_value argv[2];
+  napi_get_cb_info(env, info, &argc, argv, nullptr, nullptr);
+  if (argc < 2) {
+    napi_throw_type_error(env, nullptr, "storeCompact expects (ctx, store)");
+    return nullptr;
+  }
+
+  CtxHandle* ctx_handle = nullptr;
+  StoreHandle* store_handle = nullptr;
+  if (!UnwrapCtxStore(env, argv[0], argv[1], &ctx_handle, &store_handle)) return nullptr;
+  maany_mpc_error_t status = maany_mpc_store_compact(ctx_handle->ctx, store_handle->store);
+  if (status != MAANY_MPC_OK) {
+    napi_throw(env, CreateError(env, "maany_mpc_store_compact", status));
+    return nullptr;
+  }
+  return nullptr;
+}
+
+napi_value JsStoreStats(napi_env env, napi_callback_info info) {
+  size_t argc = 2;
+  napi_value argv[2];
+  napi_get_cb_info(env, info, &argc, argv, nullptr, nullptr);
+  if (argc < 2) {
+    napi_throw_type_error(env, nullptr, "storeStats expects (ctx, store)");
+    return nullptr;
+  }
+
+  CtxHandle* ctx_handle = nullptr;
+  StoreHandle* store_handle = nullptr;
+  if (!UnwrapCtxStore(env, argv[0], argv[1], &ctx_handle, &store_handle)) return nullptr;
+  maany_mpc_store_stats_t stats{};
+  maany_mpc_error_t status = maany_mpc_store_stats(ctx_handle->ctx, store_handle->store, &stats);
+  if (status != MAANY_MPC_OK) {
+    napi_throw(env, CreateError(env, "maany_mpc_store_stats", status));
+    return nullptr;
+  }
+
+  napi_value result;
+  napi_create_object(env, &result);
+  napi_value value;
+  napi_create_double(env, static_cast<double>(stats.live_records), &value);
+  napi_set_named_property(env, result, "liveRecords", value);
+  napi_create_double(env, static_cast<double>(stats.live_bytes), &value);
+  napi_set_named_property(env, result, "liveBytes", value);
+  napi_create_double(env, static_cast<double>(stats.file_bytes), &value);
+  napi_set_named_property(env, result, "fileBytes", value);
+  return result;
+}
+
+const char* const kSessionTypeLabels[MAANY_MPC_SESSION_TYPE_COUNT] = {
+    "dkg", "refresh", "paillier_setup", "sign", "tn_dkg", "tn_sign"};
+
+bool SnapshotStats(napi_env env, napi_callback_info info, const char* name, maany_mpc_stats_t* out_stats) {
+  size_t argc = 1;
+  napi_value argv[1];
+  napi_get_cb_info(env, info, &argc, argv, nullptr, nullptr);
+  if (argc < 1) {
+    napi_throw_type_error(env, nullptr, (std::string(name) + " expects a context handle").c_str());
+    return false;
+  }
+
+  CtxHandle* ctx_handle = nullptr;
+  if (!UnwrapHandle(env, argv[0], &ctx_handle)) return false;
+  if (!ctx_handle->ctx) {
+    napi_throw_error(env, nullptr, "Context already shut down");
+    return false;
+  }
+  maany_mpc_error_t status = maany_mpc_stats_snapshot(ctx_handle->ctx, out_stats);
+  if (status != MAANY_MPC_OK) {
+    napi_throw(env, CreateError(env, "maany_mpc_stats_snapshot", status));
+    return false;
+  }
+  return true;
+}
+
+void SetDouble(napi_env env, napi_value obj, const char* name, double v) {
+  napi_value value;
+  napi_create_double(env, v, &value);
+  napi_set_named_property(env, obj, name, value);
+}
+
+napi_value JsStatsSnapshot(napi_env env, napi_callback_info info) {
+  maany_mpc_stats_t stats{};
+  if (!SnapshotStats(env, info, "statsSnapshot", &stats)) return nullptr;
+
+  napi_value result;
+  napi_create_object(env, &result);
+  napi_value sessions;
+  napi_create_object(env, &sessions);
+  for (size_t t = 0; t < MAANY_MPC_SESSION_TYPE_COUNT; ++t) {
+    const maany_mpc_session_stats_t& s = stats.sessions[t];
+    napi_value entry;
+    napi_create_object(env, &entry);
+    SetDouble(env, entry, "live", static_cast<double>(s.live));
+    SetDouble(env, entry, "started", static_cast<double>(s.started));
+    SetDouble(env, entry, "completed", static_cast<double>(s.completed));
+    SetDouble(env, entry, "failed", static_cast<double>(s.failed));
+    SetDouble(env, entry, "steps", static_cast<double>(s.steps));
+    SetDouble(env, entry, "stepSeconds", static_cast<double>(s.step_ns) / 1e9);
+    napi_value hist;
+    napi_create_array_with_length(env, MAANY_MPC_STATS_STEP_BUCKETS, &hist);
+    for (uint32_t b = 0; b < MAANY_MPC_STATS_STEP_BUCKETS; ++b) {
+      napi_value count;
+      napi_create_double(env, static_cast<double>(s.step_hist[b]), &count);
+      napi_set_element(env, hist, b, count);
+    }
+    napi_set_named_property(env, entry, "stepHistogram", hist);
+    SetDouble(env, entry, "bytesIn", static_cast<double>(s.bytes_in));
+    SetDouble(env, entry, "bytesOut", static_cast<double>(s.bytes_out));
+    napi_set_named_property(env, sessions, kSessionTypeLabels[t], entry);
+  }
+  napi_set_named_property(env, result, "sessions", sessions);
+  SetDouble(env, result, "workerThreads", stats.worker_threads);
+  SetDouble(env, result, "storeHits", static_cast<double>(stats.store_hits));
+  SetDouble(env, result, "storeMisses", static_cast<double>(stats.store_misses));
+  return result;
+}
+
+void AppendMetricHeader(std::string& out, const char* name, const char* type, const char* help) {
+  out += "# HELP ";
+  out += name;
+  out += ' ';
+  out += help;
+  out += "\n# TYPE ";
+  out += name;
+  out += ' ';
+  out += type;
+  out += '\n';
+}
+
+void AppendSample(std::string& out, const char* name, const char* labels, double value) {
+  char line[256];
+  if (*labels) {
+    std::snprintf(line, sizeof(line), "%s{%s} %.17g\n", name, labels, value);
+  } else {
+    std::snprintf(line, sizeof(line), "%s %.17g\n", name, value);
+  }
+  out += line;
+}
+
+// One sample per session type, labelled type="...".
+template <typename Field>
+void AppendPerType(std::string& out, const maany_mpc_stats_t& stats, const char* name, const char* type,
+                   const char* help, Field field) {
+  AppendMetricHeader(out, name, type, help);
+  for (size_t t = 0; t < MAANY_MPC_SESSION_TYPE_COUNT; ++t) {
+    std::string labels = std::string("type=\"") + kSessionTypeLabels[t] + "\"";
+    AppendSample(out, name, labels.c_str(), static_cast<double>(field(stats.sessions[t])));
+  }
+}
+
+// Renders a snapshot in the Prometheus text exposition format, so a server
+// can serve it from its /metrics handler as is.
+napi_value JsStatsPrometheus(napi_env env, napi_callback_info info) {
+  maany_mpc_stats_t stats{};
+  if (!SnapshotStats(env, info, "statsPrometheus", &stats)) return nullptr;
+
+  using S = maany_mpc_session_stats_t;
+  std::string out;
+  AppendPerType(out, stats, "maany_mpc_sessions_live", "gauge", "Sessions created and not yet freed.",
+                [](const S& s) { return s.live; });
+  AppendPerType(out, stats, "maany_mpc_sessions_started_total", "counter", "Sessions created.",
+                [](const S& s) { return s.started; });
+  AppendPerType(out, stats, "maany_mpc_sessions_completed_total", "counter", "Sessions that reached done.",
+                [](const S& s) { return s.completed; });
+  AppendPerType(out, stats, "maany_mpc_sessions_failed_total", "counter", "Sessions failed before completion.",
+                [](const S& s) { return s.failed; });
+  AppendPerType(out, stats, "maany_mpc_bytes_in_total", "counter", "Peer frame bytes fed to step.",
+                [](const S& s) { return s.bytes_in; });
+  AppendPerType(out, stats, "maany_mpc_bytes_out_total", "counter", "Frame bytes produced by step.",
+                [](const S& s) { return s.bytes_out; });
+
+  // Native bucket i ends at 2^i us; the last one is unbounded and only shows
+  // up in +Inf.
+  AppendMetricHeader(out, "maany_mpc_step_seconds", "histogram", "Wall time of one protocol step call.");
+  for (size_t t = 0; t < MAANY_MPC_SESSION_TYPE_COUNT; ++t) {
+    const S& s = stats.sessions[t];
+    const std::string type = std::string("type=\"") + kSessionTypeLabels[t] + "\"";
+    uint64_t cumulative = 0;
+    char labels[96];
+    for (size_t b = 0; b + 1 < MAANY_MPC_STATS_STEP_BUCKETS; ++b) {
+      cumulative += s.step_hist[b];
+      std::snprintf(labels, sizeof(labels), "%s,le=\"%g\"", type.c_str(), 1e-6 * static_cast<double>(1ull << b));
+      AppendSample(out, "maany_mpc_step_seconds_bucket", labels, static_cast<double>(cumulative));
+    }
+    std::snprintf(labels, sizeof(labels), "%s,le=\"+Inf\"", type.c_str());
+    AppendSample(out, "maany_mpc_step_seconds_bucket", labels, static_cast<double>(s.steps));
+    AppendSample(out, "maany_mpc_step_seconds_sum", type.c_str(), static_cast<double>(s.step_ns) / 1e9);
+    AppendSample(out, "maany_mpc_step_seconds_count", type.c_str(), static_cast<double>(s.steps));
+  }
+
+  AppendMetricHeader(out, "maany_mpc_worker_threads", "gauge", "Threads for parallel work inside one call.");
+  AppendSample(out, "maany_mpc_worker_threads", "", stats.worker_threads);
+  AppendMetricHeader(out, "maany_mpc_store_lookups_total", "counter", "Share store lookups by key id.");
+  AppendSample(out, "maany_mpc_store_lookups_total", "result=\"hit\"", static_cast<double>(stats.store_hits));
+  AppendSample(out, "maany_mpc_store_lookups_total", "result=\"miss\"", static_cast<double>(stats.store_misses));
+
+  napi_value result;
+  napi_create_string_utf8(env, out.data(), out.size(), &result);
+  return result;
+}
+
+napi_value JsTraceEnable(napi_env env, napi_callback_info info) {
+  size_t argc = 1;
+  napi_value argv[1];
+  napi_get_cb_info(env, info, &argc, argv, nullptr, nullptr);
+  bool enabled = true;
+  if (argc >= 1 && napi_get_value_bool(env, argv[0], &enabled) != napi_ok) {
+    napi_throw_type_error(env, nullptr, "traceEnable expects a boolean");
+    return nullptr;
+  }
+  maany_mpc_trace_enable(enabled ? 1 : 0);
+  return nullptr;
+}
+
+napi_value JsTraceDump(napi_env env, napi_callback_info info) {
+  size_t argc = 1;
+  napi_value argv[1];
+  napi_get_cb_info(env, info, &argc, argv, nullptr, nullptr);
+  if (argc < 1) {
+    napi_throw_type_error(env, nullptr, "traceDump expects a context handle");
+    return nullptr;
+  }
+
+  CtxHandle* ctx_handle = nullptr;
+  if (!UnwrapHandle(env, argv[0], &ctx_handle)) return nullptr;
+  if (!ctx_handle->ctx) {
+    napi_throw_error(env, nullptr, "Context already shut down");
+    return nullptr;
+  }
+  maany_mpc_buf_t json{nullptr, 0};
+  maany_mpc_error_t status = maany_mpc_trace_dump(ctx_handle->ctx, &json);
+  if (status != MAANY_MPC_OK) {
+    napi_throw(env, CreateError(env, "maany_mpc_trace_dump", status));
+    return nullptr;
+  }
+  napi_value result;
+  napi_create_string_utf8(env, reinterpret_cast<const char*>(json.data), json.len, &result);
+  maany_mpc_buf_free(ctx_handle->ctx, &json);
+  return result;
+}
+
 napi_value JsKpPubkey(napi_env env, napi_callback_info info) {
   size_t argc = 2;
   napi_value argv[2];
@@ -1404,6 +2307,21 @@ napi_value InitModule(napi_env env, napi_value exports) {
       {"kpImport", nullptr, JsKpImport, nullptr, nullptr, nullptr, napi_default, nullptr},
       {"kpPubkey", nullptr, JsKpPubkey, nullptr, nullptr, nullptr, napi_default, nullptr},
       {"kpFree", nullptr, JsKpFree, nullptr, nullptr, nullptr, napi_default, nullptr},
+      {"kekRegister", nullptr, JsKekRegister, nullptr, nullptr, nullptr, napi_default, nullptr},
+      {"kekFree", nullptr, JsKekFree, nullptr, nullptr, nullptr, napi_default, nullptr},
+      {"kpExportSealed", nullptr, JsKpExportSealed, nullptr, nullptr, nullptr, napi_default, nullptr},
+      {"kpImportSealed", nullptr, JsKpImportSealed, nullptr, nullptr, nullptr, napi_default, nullptr},
+      {"storeOpen", nullptr, JsStoreOpen, nullptr, nullptr, nullptr, napi_default, nullptr},
+      {"storeClose", nullptr, JsStoreClose, nullptr, nullptr, nullptr, napi_default, nullptr},
+      {"storePut", nullptr, JsStorePut, nullptr, nullptr, nullptr, napi_default, nullptr},
+      {"storeGet", nullptr, JsStoreGet, nullptr, nullptr, nullptr, napi_default, nullptr},
+      {"storeRemove", nullptr, JsStoreRemove, nullptr, nullptr, nullptr, napi_default, nullptr},
+      {"storeCompact", nullptr, JsStoreCompact, nullptr, nullptr, nullptr, napi_default, nullptr},
+      {"storeStats", nullptr, JsStoreStats, nullptr, nullptr, nullptr, napi_default, nullptr},
+      {"statsSnapshot", nullptr, JsStatsSnapshot, nullptr, nullptr, nullptr, napi_default, nullptr},
+      {"statsPrometheus", nullptr, JsStatsPrometheus, nullptr, nullptr, nullptr, napi_default, nullptr},
+      {"traceEnable", nullptr, JsTraceEnable, nullptr, nullptr, nullptr, napi_default, nullptr},
+      {"traceDump", nullptr, JsTraceDump, nullptr, nullptr, nullptr, napi_default, nullptr},
       {"signNew", nullptr, JsSignNew, nullptr, nullptr, nullptr, napi_default, nullptr},
       {"signSetMessage", nullptr, JsSignSetMessage, nullptr, nullptr, nullptr, napi_default, nullptr},
       {"signStep", nullptr, JsSignStep, nullptr, nullptr, nullptr, napi_default, nullptr},
@@ -1411,7 +2329,9 @@ napi_value InitModule(napi_env env, napi_value exports) {
       {"signFree", nullptr, JsSignFree, nullptr, nullptr, nullptr, napi_default, nullptr},
       {"refreshNew", nullptr, JsRefreshNew, nullptr, nullptr, nullptr, napi_default, nullptr},
       {"backupCreate", nullptr, JsBackupCreate, nullptr, nullptr, nullptr, napi_default, nullptr},
+      {"backupUpdate", nullptr, JsBackupUpdate, nullptr, nullptr, nullptr, napi_default, nullptr},
       {"backupRestore", nullptr, JsBackupRestore, nullptr, nullptr, nullptr, napi_default, nullptr},
+      {"envelopeRewrapMany", nullptr, JsEnvelopeRewrapMany, nullptr, nullptr, nullptr, napi_default, nullptr},
   };
 
   napi_status status = napi_define_properties(env, exports, sizeof(descriptors) / sizeof(descriptors[0]), descriptors);
@@ -1,12 +1,16 @@
 export type Ctx = { readonly __brand: 'ctx' };
 export type Dkg = { readonly __brand: 'dkg' };
 export type Keypair = { readonly __brand: 'keypair' };
+export type Kek = { readonly __brand: 'kek' };
+export type ShareStore = { readonly __brand: 'store' };
 export type SignSession = { readonly __brand: 'sign' };
 
 export interface DkgOptions {
   role: 'device' | 'server';
   keyId?: Uint8Array;
   sessionId?: Uint8Array;
+  /** Writes this side's frames and RNG seed here when the session ends, for `maany_mpc_replay`. */
+  transcriptPath?: string;
 }
 
 export interface StepResult {
@@ -17,6 +21,8 @@ export interface StepResult {
 export interface SignOptions {
   sessionId?: Uint8Array;
   extraAad?: Uint8Array;
+  /** See DkgOptions.transcriptPath. The transcript fixes the session's nonces; keep it as secret as the share. */
+  transcriptPath?: string;
 }
 
 export type SignatureFormat = 'der' | 'raw-rs';
@@ -35,6 +41,12 @@ export interface BackupCiphertext {
   shareCount: number;
   label: Uint8Array;
   blob: Uint8Array;
+  /** Feldman commitments; restore uses them to skip bad shares. Absent on older backups. */
+  commitments?: Uint8Array;
+  /** Ephemeral point the payload key is wrapped to; absent on backups that predate backupUpdate. */
+  ephemeral?: Uint8Array;
+  /** MAC under the update key; present exactly when `ephemeral` is. */
+  auth?: Uint8Array;
 }
 
 export interface BackupCreateOptions {
@@ -46,6 +58,8 @@ export interface BackupCreateOptions {
 export interface BackupCreateResult {
   ciphertext: BackupCiphertext;
   shares: Uint8Array[];
+  /** Authorizes backupUpdate. Keep it with the keypair, never next to the ciphertext. */
+  updateKey: Uint8Array;
 }
 
 export declare function init(): Ctx;
@@ -58,11 +72,105 @@ export declare function kpExport(ctx: Ctx, kp: Keypair): Uint8Array;
 export declare function kpImport(ctx: Ctx, blob: Uint8Array): Keypair;
 export declare function kpPubkey(ctx: Ctx, kp: Keypair): Pubkey;
 export declare function kpFree(kp: Keypair): void;
+/** Registers a 32-byte key-encryption key with `ctx`; only usable with that context. */
+export declare function kekRegister(ctx: Ctx, key: Uint8Array): Kek;
+export declare function kekFree(kek: Kek): void;
+/** nonce || tag || AES-256-GCM(kek, kpExport bytes), sealed natively so the share never reaches the JS heap. */
+export declare function kpExportSealed(ctx: Ctx, kp: Keypair, kek: Kek, aad?: Uint8Array): Uint8Array;
+export declare function kpImportSealed(ctx: Ctx, kek: Kek, sealed: Uint8Array, aad?: Uint8Array): Keypair;
+
+export interface ShareStoreStats {
+  liveRecords: number;
+  liveBytes: number;
+  /** Total log length; compact when this is well above liveBytes. */
+  fileBytes: number;
+}
+
+/**
+ * Opens (or creates) an on-disk store of shares sealed under `kek`, indexed by key id.
+ * POSIX only. The store keeps its own reference to the kek.
+ */
+export declare function storeOpen(ctx: Ctx, path: string, kek: Kek, options?: { syncWrites?: boolean }): ShareStore;
+export declare function storeClose(store: ShareStore): void;
+/** Stores `kp` under its key id, replacing any earlier share. */
+export declare function storePut(ctx: Ctx, store: ShareStore, kp: Keypair): void;
+export declare function storeGet(ctx: Ctx, store: ShareStore, keyId: Uint8Array): Keypair | null;
+export declare function storeRemove(ctx: Ctx, store: ShareStore, keyId: Uint8Array): boolean;
+/** Rewrites the log without dead records. Blocks the calling thread and the store while it runs. */
+export declare function storeCompact(ctx: Ctx, store: ShareStore): void;
+export declare function storeStats(ctx: Ctx, store: ShareStore): ShareStoreStats;
+
+export type SessionType = 'dkg' | 'refresh' | 'paillier_setup' | 'sign' | 'tn_dkg' | 'tn_sign';
+
+export interface SessionStats {
+  /** Created and not yet freed. */
+  live: number;
+  started: number;
+  /** Reached done. */
+  completed: number;
+  /** A step or finalize failed before completion. */
+  failed: number;
+  steps: number;
+  /** Total wall time inside step calls. */
+  stepSeconds: number;
+  /** Step counts: entry 0 under 1 us, entry i in [2^(i-1), 2^i) us, the last one 2^22 us and up. */
+  stepHistogram: number[];
+  bytesIn: number;
+  bytesOut: number;
+}
+
+export interface Stats {
+  sessions: Record<SessionType, SessionStats>;
+  workerThreads: number;
+  storeHits: number;
+  storeMisses: number;
+}
+
+/** Counters for `ctx` since init; see maany_mpc_stats_snapshot. */
+export declare function statsSnapshot(ctx: Ctx): Stats;
+/** The same snapshot in the Prometheus text exposition format, ready to serve from /metrics. */
+export declare function statsPrometheus(ctx: Ctx): string;
+/**
+ * Turns the process-wide session timeline on or off. Enabling drops earlier
+ * events. See maany_mpc_trace_enable.
+ */
+export declare function traceEnable(enabled: boolean): void;
+/** Chrome trace event JSON of the recorded session events; load it in Perfetto. */
+export declare function traceDump(ctx: Ctx): string;
 export declare function signNew(ctx: Ctx, kp: Keypair, options?: SignOptions): SignSession;
 export declare function signSetMessage(ctx: Ctx, sign: SignSession, message: Uint8Array): void;
 export declare function signStep(ctx: Ctx, sign: SignSession, inPeerMsg?: Uint8Array | null): Promise<StepResult>;
 export declare function signFinalize(ctx: Ctx, sign: SignSession, format?: SignatureFormat): Uint8Array;
 export declare function signFree(sign: SignSession): void;
-export declare function refreshNew(ctx: Ctx, kp: Keypair, options?: { sessionId?: Uint8Array }): Dkg;
+export declare function refreshNew(
+  ctx: Ctx,
+  kp: Keypair,
+  options?: { sessionId?: Uint8Array; transcriptPath?: string },
+): Dkg;
 export declare function backupCreate(ctx: Ctx, kp: Keypair, options?: BackupCreateOptions): BackupCreateResult;
 export declare function backupRestore(ctx: Ctx, ciphertext: BackupCiphertext, shares: Uint8Array[]): Keypair;
+export declare function backupUpdate(
+  ctx: Ctx,
+  kp: Keypair,
+  ciphertext: BackupCiphertext,
+  updateKey: Uint8Array,
+): BackupCiphertext;
+/**
+ * Re-encrypts stored share envelopes (nonce || tag || AES-256-GCM(kek, kpExport bytes))
+ * from `oldKek` to `newKek` on the native worker pool. Rejects if any envelope fails to
+ * decrypt or does not hold a key blob.
+ */
+export declare function envelopeRewrapMany(
+  ctx: Ctx,
+  oldKek: Uint8Array,
+  newKek: Uint8Array,
+  blobs: Uint8Array[],
+): Promise<Uint8Array[]>;
+/** Streams `envelopeRewrapMany` over any (async) iterable, `batchSize` (default 4096) at a time. */
+export declare function envelopeRewrap(
+  ctx: Ctx,
+  oldKek: Uint8Array,
+  newKek: Uint8Array,
+  envelopes: Iterable<Uint8Array> | AsyncIterable<Uint8Array>,
+  options?: { batchSize?: number },
+): AsyncGenerator<Uint8Array, void, undefined>;
@@ -11,6 +11,48 @@ function resolveBinding() {
 
 const binding = require(resolveBinding());
 
+function toBuffer(bytes) {
+  return Buffer.isBuffer(bytes) ? bytes : Buffer.from(bytes.buffer, bytes.byteOffset, bytes.byteLength);
+}
+
+// Rewraps stored share envelopes from oldKek to newKek, yielding results in
+// input order. `envelopes` may be any iterable or async iterable, so a whole
+// table can be streamed from storage. Each batch is one native call spread over
+// the context's worker threads; the next batch is collected while the previous
+// one is still being processed.
+async function* envelopeRewrap(ctx, oldKek, newKek, envelopes, options = {}) {
+  const batchSize = options.batchSize ?? 4096;
+  if (!Number.isInteger(batchSize) || batchSize <= 0) {
+    throw new RangeError('batchSize must be a positive integer');
+  }
+  const oldKey = toBuffer(oldKek);
+  const newKey = toBuffer(newKek);
+  let pending = null;
+  let batch = [];
+  const submit = () => {
+    const next = binding.envelopeRewrapMany(ctx, oldKey, newKey, batch);
+    // Observed below; this only keeps an abandoned iterator from raising an
+    // unhandled rejection.
+    next.catch(() => {});
+    batch = [];
+    return next;
+  };
+
+  for await (const envelope of envelopes) {
+    batch.push(toBuffer(envelope));
+    if (batch.length < batchSize) continue;
+    const next = submit();
+    if (pending) yield* await pending;
+    pending = next;
+  }
+  if (batch.length > 0) {
+    const next = submit();
+    if (pending) yield* await pending;
+    pending = next;
+  }
+  if (pending) yield* await pending;
+}
+
 module.exports = {
   init: binding.init,
   shutdown: binding.shutdown,
@@ -22,6 +64,21 @@ module.exports = {
   kpImport: binding.kpImport,
   kpPubkey: binding.kpPubkey,
   kpFree: binding.kpFree,
+  kekRegister: binding.kekRegister,
+  kekFree: binding.kekFree,
+  kpExportSealed: binding.kpExportSealed,
+  kpImportSealed: binding.kpImportSealed,
+  storeOpen: binding.storeOpen,
+  storeClose: binding.storeClose,
+  storePut: binding.storePut,
+  storeGet: binding.storeGet,
+  storeRemove: binding.storeRemove,
+  storeCompact: binding.storeCompact,
+  storeStats: binding.storeStats,
+  statsSnapshot: binding.statsSnapshot,
+  statsPrometheus: binding.statsPrometheus,
+  traceEnable: binding.traceEnable,
+  traceDump: binding.traceDump,
   signNew: binding.signNew,
   signSetMessage: binding.signSetMessage,
   signStep: binding.signStep,
@@ -29,5 +86,8 @@ module.exports = {
   signFree: binding.signFree,
   refreshNew: binding.refreshNew,
   backupCreate: binding.backupCreate,
-  backupRestore: binding.backupRestore
+  backupRestore: binding.backupRestore,
+  backupUpdate: binding.backupUpdate,
+  envelopeRewrapMany: binding.envelopeRewrapMany,
+  envelopeRewrap
 };
@@ -37,6 +37,12 @@ export interface BackupCiphertext {
   shareCount: number;
   label: Uint8Array;
   blob: Uint8Array;
+  /** Feldman commitments; restore uses them to skip bad shares. Absent on older backups. */
+  commitments?: Uint8Array;
+  /** Ephemeral point the payload key is wrapped to; absent on backups that predate backupUpdate. */
+  ephemeral?: Uint8Array;
+  /** MAC under the update key; present exactly when `ephemeral` is. */
+  auth?: Uint8Array;
 }
 
 export interface BackupCreateOptions {
@@ -48,6 +54,34 @@ export interface BackupCreateOptions {
 export interface BackupCreateResult {
   ciphertext: BackupCiphertext;
   shares: Uint8Array[];
+  /** Authorizes backupUpdate. Keep it with the keypair, never next to the ciphertext. */
+  updateKey: Uint8Array;
+}
+
+export type SessionType = 'dkg' | 'refresh' | 'paillier_setup' | 'sign' | 'tn_dkg' | 'tn_sign';
+
+export interface SessionStats {
+  /** Created and not yet freed. */
+  live: number;
+  started: number;
+  /** Reached done. */
+  completed: number;
+  /** A step or finalize failed before completion. */
+  failed: number;
+  steps: number;
+  /** Total wall time inside step calls. */
+  stepSeconds: number;
+  /** Step counts: entry 0 under 1 us, entry i in [2^(i-1), 2^i) us, the last one 2^22 us and up. */
+  stepHistogram: number[];
+  bytesIn: number;
+  bytesOut: number;
+}
+
+export interface Stats {
+  sessions: Record<SessionType, SessionStats>;
+  workerThreads: number;
+  storeHits: number;
+  storeMisses: number;
 }
 
 interface NativeBinding {
@@ -69,6 +103,8 @@ interface NativeBinding {
   refreshNew(ctx: Ctx, kp: Keypair, options?: { sessionId?: Uint8Array }): Dkg;
   backupCreate(ctx: Ctx, kp: Keypair, options?: BackupCreateOptions): BackupCreateResult;
   backupRestore(ctx: Ctx, ciphertext: BackupCiphertext, shares: Uint8Array[]): Keypair;
+  backupUpdate(ctx: Ctx, kp: Keypair, ciphertext: BackupCiphertext, updateKey: Uint8Array): BackupCiphertext;
+  statsSnapshot(ctx: Ctx): Stats;
 }
 
 let cachedBinding: NativeBinding | null = null;
@@ -170,3 +206,16 @@ export function backupCreate(ctx: Ctx, kp: Keypair, options?: BackupCreateOption
 export function backupRestore(ctx: Ctx, ciphertext: BackupCiphertext, shares: Uint8Array[]): Keypair {
   return ensureBinding().backupRestore(ctx, ciphertext, shares);
 }
+
+export function backupUpdate(
+  ctx: Ctx,
+  kp: Keypair,
+  ciphertext: BackupCiphertext,
+  updateKey: Uint8Array,
+): BackupCiphertext {
+  return ensureBinding().backupUpdate(ctx, kp, ciphertext, updateKey);
+}
+
+export function statsSnapshot(ctx: Ctx): Stats {
+  return ensureBinding().statsSnapshot(ctx);
+}
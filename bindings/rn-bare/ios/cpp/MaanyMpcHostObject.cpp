@@ -5,6 +5,7 @@
 
 #include <jsi/jsi.h>
 
+#include <algorithm>
 #include <cstring>
 #include <functional>
 #include <memory>
@@ -401,6 +402,105 @@ maany_mpc_sig_format_t parseSignatureFormat(Runtime& runtime, const Value& value
   return MAANY_MPC_SIG_FORMAT_DER;
 }
 
+// Owns the bytes that a parsed maany_mpc_backup_ciphertext_t points into.
+struct BackupCiphertextArg {
+  maany_mpc_backup_ciphertext_t cipher{};
+  std::vector<uint8_t> label;
+  std::vector<uint8_t> blob;
+  std::vector<uint8_t> commitments;
+  std::vector<uint8_t> ephemeral;
+  std::vector<uint8_t> auth;
+};
+
+void setOptionalBuf(maany_mpc_buf_t& buf, std::vector<uint8_t>& bytes) {
+  buf.data = bytes.empty() ? nullptr : bytes.data();
+  buf.len = bytes.size();
+}
+
+void parseBackupCiphertext(Runtime& runtime, const Value& value, BackupCiphertextArg& out) {
+  if (!value.isObject()) {
+    throwTypeError(runtime, "ciphertext must be an object");
+  }
+  auto cipherObj = value.getObject(runtime);
+  auto& cipher = out.cipher;
+  cipher.kind = parseShareKind(runtime, cipherObj.getProperty(runtime, "kind"));
+  cipher.curve = parseCurve(runtime, cipherObj.getProperty(runtime, "curve"));
+  cipher.scheme = parseScheme(runtime, cipherObj.getProperty(runtime, "scheme"));
+  cipher.threshold = static_cast<uint32_t>(cipherObj.getProperty(runtime, "threshold").asNumber());
+  cipher.share_count = static_cast<uint32_t>(cipherObj.getProperty(runtime, "shareCount").asNumber());
+
+  auto keyIdVec = toByteVector(runtime, cipherObj.getProperty(runtime, "keyId"), "keyId");
+  if (keyIdVec.size() != sizeof(cipher.key_id.bytes)) {
+    throwTypeError(runtime, "keyId must be 32 bytes");
+  }
+  std::memcpy(cipher.key_id.bytes, keyIdVec.data(), keyIdVec.size());
+
+  out.label = toByteVector(runtime, cipherObj.getProperty(runtime, "label"), "label");
+  cipher.label.data = out.label.data();
+  cipher.label.len = out.label.size();
+
+  out.blob = toByteVector(runtime, cipherObj.getProperty(runtime, "blob"), "blob");
+  if (out.blob.empty()) {
+    throwTypeError(runtime, "ciphertext blob must not be empty");
+  }
+  cipher.ciphertext.data = out.blob.data();
+  cipher.ciphertext.len = out.blob.size();
+
+  // Older backups carry neither Feldman commitments nor an ephemeral wrap point
+  // and its authentication tag.
+  if (auto commitmentsProp = getOptionalProperty(runtime, cipherObj, "commitments")) {
+    out.commitments = toByteVector(runtime, *commitmentsProp, "commitments");
+  }
+  setOptionalBuf(cipher.commitments, out.commitments);
+  if (auto ephemeralProp = getOptionalProperty(runtime, cipherObj, "ephemeral")) {
+    out.ephemeral = toByteVector(runtime, *ephemeralProp, "ephemeral");
+  }
+  setOptionalBuf(cipher.ephemeral, out.ephemeral);
+  if (auto authProp = getOptionalProperty(runtime, cipherObj, "auth")) {
+    out.auth = toByteVector(runtime, *authProp, "auth");
+  }
+  setOptionalBuf(cipher.auth, out.auth);
+}
+
+std::vector<uint8_t> bufBytes(const maany_mpc_buf_t& buf) {
+  if (!buf.data || !buf.len) return {};
+  auto* ptr = static_cast<const uint8_t*>(buf.data);
+  return std::vector<uint8_t>(ptr, ptr + buf.len);
+}
+
+// Converts a library-owned ciphertext to a JS object and releases its buffers.
+Object backupCiphertextToJs(Runtime& runtime, maany_mpc_ctx_t* ctx, maany_mpc_backup_ciphertext_t& cipher) {
+  auto cipherObj = Object(runtime);
+  cipherObj.setProperty(runtime, "kind", makeString(runtime, shareKindToString(cipher.kind)));
+  cipherObj.setProperty(runtime, "curve", makeString(runtime, curveToString(cipher.curve)));
+  cipherObj.setProperty(runtime, "scheme", makeString(runtime, schemeToString(cipher.scheme)));
+  cipherObj.setProperty(runtime, "threshold", Value(static_cast<double>(cipher.threshold)));
+  cipherObj.setProperty(runtime, "shareCount", Value(static_cast<double>(cipher.share_count)));
+  cipherObj.setProperty(
+      runtime,
+      "keyId",
+      makeUint8Array(
+          runtime, std::vector<uint8_t>(cipher.key_id.bytes, cipher.key_id.bytes + sizeof(cipher.key_id.bytes))));
+  cipherObj.setProperty(runtime, "label", makeUint8Array(runtime, bufBytes(cipher.label)));
+  cipherObj.setProperty(runtime, "blob", makeUint8Array(runtime, bufBytes(cipher.ciphertext)));
+  if (cipher.commitments.data && cipher.commitments.len) {
+    cipherObj.setProperty(runtime, "commitments", makeUint8Array(runtime, bufBytes(cipher.commitments)));
+  }
+  if (cipher.ephemeral.data && cipher.ephemeral.len) {
+    cipherObj.setProperty(runtime, "ephemeral", makeUint8Array(runtime, bufBytes(cipher.ephemeral)));
+  }
+  if (cipher.auth.data && cipher.auth.len) {
+    cipherObj.setProperty(runtime, "auth", makeUint8Array(runtime, bufBytes(cipher.auth)));
+  }
+
+  maany_mpc_buf_free(ctx, &cipher.label);
+  maany_mpc_buf_free(ctx, &cipher.ciphertext);
+  maany_mpc_buf_free(ctx, &cipher.commitments);
+  maany_mpc_buf_free(ctx, &cipher.ephemeral);
+  maany_mpc_buf_free(ctx, &cipher.auth);
+  return cipherObj;
+}
+
 class MaanyMpcHostObject final : public HostObject {
  public:
   Value get(Runtime& runtime, const PropNameID& nameId) override {
@@ -619,44 +719,15 @@ class MaanyMpcHostObject final : public HostObject {
 
             maany_mpc_backup_ciphertext_t cipher{};
             std::vector<maany_mpc_backup_share_t> shareStructs(shareCount);
-            maany_mpc_error_t status = maany_mpc_backup_create(
+            maany_mpc_buf_t updateKey{nullptr, 0};
+            maany_mpc_error_t status = maany_mpc_backup_create_updatable(
               ctx->ptr(rt), kp->ptr(rt), threshold, shareCount,
-              label.empty() ? nullptr : &labelBuf, &cipher, shareStructs.data());
+              label.empty() ? nullptr : &labelBuf, &cipher, shareStructs.data(), &updateKey);
             if (status != MAANY_MPC_OK) {
-              throwMaanyError(rt, "maany_mpc_backup_create", status);
+              throwMaanyError(rt, "maany_mpc_backup_create_updatable", status);
             }
 
-            auto cipherObj = Object(rt);
-            cipherObj.setProperty(rt, "kind", makeString(rt, shareKindToString(cipher.kind)));
-            cipherObj.setProperty(rt, "curve", makeString(rt, curveToString(cipher.curve)));
-            cipherObj.setProperty(rt, "scheme", makeString(rt, schemeToString(cipher.scheme)));
-            cipherObj.setProperty(rt, "threshold", Value(static_cast<double>(cipher.threshold)));
-            cipherObj.setProperty(rt, "shareCount", Value(static_cast<double>(cipher.share_count)));
-            cipherObj.setProperty(
-                rt,
-                "keyId",
-                makeUint8Array(
-                    rt,
-                    std::vector<uint8_t>(
-                        cipher.key_id.bytes,
-                        cipher.key_id.bytes + sizeof(cipher.key_id.bytes))));
-
-            std::vector<uint8_t> labelOut;
-            if (cipher.label.data && cipher.label.len) {
-              auto* ptr = static_cast<uint8_t*>(cipher.label.data);
-              labelOut.assign(ptr, ptr + cipher.label.len);
-            }
-            cipherObj.setProperty(rt, "label", makeUint8Array(rt, labelOut));
-
-            std::vector<uint8_t> blobOut;
-            if (cipher.ciphertext.data && cipher.ciphertext.len) {
-              auto* ptr = static_cast<uint8_t*>(cipher.ciphertext.data);
-              blobOut.assign(ptr, ptr + cipher.ciphertext.len);
-            }
-            cipherObj.setProperty(rt, "blob", makeUint8Array(rt, blobOut));
-
-            maany_mpc_buf_free(ctx->ptr(rt), &cipher.label);
-            maany_mpc_buf_free(ctx->ptr(rt), &cipher.ciphertext);
+            auto cipherObj = backupCiphertextToJs(rt, ctx->ptr(rt), cipher);
 
             auto sharesArray = Array(rt, shareCount);
             for (size_t i = 0; i < shareCount; ++i) {
@@ -669,9 +740,13 @@ class MaanyMpcHostObject final : public HostObject {
               maany_mpc_buf_free(ctx->ptr(rt), &shareStructs[i].data);
             }
 
+            auto updateKeyArray = makeUint8Array(rt, bufBytes(updateKey));
+            maany_mpc_buf_free(ctx->ptr(rt), &updateKey);
+
             auto result = Object(rt);
             result.setProperty(rt, "ciphertext", cipherObj);
             result.setProperty(rt, "shares", sharesArray);
+            result.setProperty(rt, "updateKey", updateKeyArray);
             return result;
           });
     }
@@ -684,34 +759,9 @@ class MaanyMpcHostObject final : public HostObject {
               throwTypeError(rt, "backupRestore expects (ctx, ciphertext, shares)");
             }
             auto ctx = requireCtx(rt, args[0]);
-            if (!args[1].isObject()) {
-              throwTypeError(rt, "ciphertext must be an object");
-            }
-            auto cipherObj = args[1].getObject(rt);
-
-            maany_mpc_backup_ciphertext_t cipher{};
-            cipher.kind = parseShareKind(rt, cipherObj.getProperty(rt, "kind"));
-            cipher.curve = parseCurve(rt, cipherObj.getProperty(rt, "curve"));
-            cipher.scheme = parseScheme(rt, cipherObj.getProperty(rt, "scheme"));
-            cipher.threshold = static_cast<uint32_t>(cipherObj.getProperty(rt, "threshold").asNumber());
-            cipher.share_count = static_cast<uint32_t>(cipherObj.getProperty(rt, "shareCount").asNumber());
-
-            auto keyIdVec = toByteVector(rt, cipherObj.getProperty(rt, "keyId"), "keyId");
-            if (keyIdVec.size() != sizeof(cipher.key_id.bytes)) {
-              throwTypeError(rt, "keyId must be 32 bytes");
-            }
-            std::memcpy(cipher.key_id.bytes, keyIdVec.data(), keyIdVec.size());
-
-            auto labelVec = toByteVector(rt, cipherObj.getProperty(rt, "label"), "label");
-            cipher.label.data = labelVec.data();
-            cipher.label.len = labelVec.size();
-
-            auto blobVec = toByteVector(rt, cipherObj.getProperty(rt, "blob"), "blob");
-            if (blobVec.empty()) {
-              throwTypeError(rt, "ciphertext blob must not be empty");
-            }
-            cipher.ciphertext.data = blobVec.data();
-            cipher.ciphertext.len = blobVec.size();
+            BackupCiphertextArg parsed;
+            parseBackupCiphertext(rt, args[1], parsed);
+            const auto& cipher = parsed.cipher;
 
             if (!args[2].isObject() || !args[2].getObject(rt).isArray(rt)) {
               throwTypeError(rt, "shares must be an array");
@@ -746,6 +796,34 @@ class MaanyMpcHostObject final : public HostObject {
           });
     }
 
+    if (name == "backupUpdate") {
+      return Function::createFromHostFunction(
+          runtime, PropNameID::forAscii(runtime, "backupUpdate"), 4,
+          [](Runtime& rt, const Value&, const Value* args, size_t count) -> Value {
+            if (count < 4) {
+              throwTypeError(rt, "backupUpdate expects (ctx, keypair, ciphertext, updateKey)");
+            }
+            auto ctx = requireCtx(rt, args[0]);
+            auto kp = requireKeypair(rt, args[1]);
+            BackupCiphertextArg existing;
+            parseBackupCiphertext(rt, args[2], existing);
+            auto updateKey = toByteVector(rt, args[3], "updateKey");
+            if (updateKey.empty()) {
+              throwTypeError(rt, "updateKey must not be empty");
+            }
+            maany_mpc_buf_t updateKeyBuf{updateKey.data(), updateKey.size()};
+
+            maany_mpc_backup_ciphertext_t cipher{};
+            maany_mpc_error_t status =
+              maany_mpc_backup_update(ctx->ptr(rt), kp->ptr(rt), &existing.cipher, &updateKeyBuf, &cipher);
+            std::fill(updateKey.begin(), updateKey.end(), 0);
+            if (status != MAANY_MPC_OK) {
+              throwMaanyError(rt, "maany_mpc_backup_update", status);
+            }
+            return backupCiphertextToJs(rt, ctx->ptr(rt), cipher);
+          });
+    }
+
     if (name == "kpExport") {
       return Function::createFromHostFunction(
           runtime, PropNameID::forAscii(runtime, "kpExport"), 2,
@@ -1042,6 +1120,52 @@ class MaanyMpcHostObject final : public HostObject {
           });
     }
 
+    if (name == "statsSnapshot") {
+      return Function::createFromHostFunction(
+          runtime, PropNameID::forAscii(runtime, "statsSnapshot"), 1,
+          [](Runtime& rt, const Value&, const Value* args, size_t count) -> Value {
+            if (count < 1) {
+              throwTypeError(rt, "statsSnapshot expects a context handle");
+            }
+            auto ctx = requireCtx(rt, args[0]);
+
+            maany_mpc_stats_t stats{};
+            maany_mpc_error_t status = maany_mpc_stats_snapshot(ctx->ptr(rt), &stats);
+            if (status != MAANY_MPC_OK) {
+              throwMaanyError(rt, "maany_mpc_stats_snapshot", status);
+            }
+
+            static const char* kTypes[MAANY_MPC_SESSION_TYPE_COUNT] = {
+                "dkg", "refresh", "paillier_setup", "sign", "tn_dkg", "tn_sign"};
+            auto sessions = Object(rt);
+            for (size_t t = 0; t < MAANY_MPC_SESSION_TYPE_COUNT; ++t) {
+              const maany_mpc_session_stats_t& s = stats.sessions[t];
+              auto entry = Object(rt);
+              entry.setProperty(rt, "live", Value(static_cast<double>(s.live)));
+              entry.setProperty(rt, "started", Value(static_cast<double>(s.started)));
+              entry.setProperty(rt, "completed", Value(static_cast<double>(s.completed)));
+              entry.setProperty(rt, "failed", Value(static_cast<double>(s.failed)));
+              entry.setProperty(rt, "steps", Value(static_cast<double>(s.steps)));
+              entry.setProperty(rt, "stepSeconds", Value(static_cast<double>(s.step_ns) / 1e9));
+              auto hist = Array(rt, MAANY_MPC_STATS_STEP_BUCKETS);
+              for (size_t b = 0; b < MAANY_MPC_STATS_STEP_BUCKETS; ++b) {
+                hist.setValueAtIndex(rt, b, Value(static_cast<double>(s.step_hist[b])));
+              }
+              entry.setProperty(rt, "stepHistogram", hist);
+              entry.setProperty(rt, "bytesIn", Value(static_cast<double>(s.bytes_in)));
+              entry.setProperty(rt, "bytesOut", Value(static_cast<double>(s.bytes_out)));
+              sessions.setProperty(rt, kTypes[t], entry);
+            }
+
+            auto result = Object(rt);
+            result.setProperty(rt, "sessions", sessions);
+            result.setProperty(rt, "workerThreads", Value(static_cast<double>(stats.worker_threads)));
+            result.setProperty(rt, "storeHits", Value(static_cast<double>(stats.store_hits)));
+            result.setProperty(rt, "storeMisses", Value(static_cast<double>(stats.store_misses)));
+            return result;
+          });
+    }
+
     return Value::undefined();
   }
 
@@ -1049,7 +1173,8 @@ class MaanyMpcHostObject final : public HostObject {
     static const char* kProps[] = {
         "init",        "shutdown",    "dkgNew",        "dkgStep",      "dkgFinalize", "dkgFree",
         "kpExport",    "kpImport",    "kpPubkey",      "kpFree",       "signNew",     "signSetMessage",
-        "signStep",    "signFinalize", "signFree",      "refreshNew",   "backupCreate", "backupRestore"};
+        "signStep",    "signFinalize", "signFree",      "refreshNew",   "backupCreate", "backupRestore",
+        "backupUpdate", "statsSnapshot"};
     std::vector<PropNameID> names;
     names.reserve(sizeof(kProps) / sizeof(kProps[0]));
     for (const char* prop : kProps) {
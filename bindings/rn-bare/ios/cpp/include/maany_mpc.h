@@ -9,7 +9,10 @@ extern "C" {
 /*============================*
  *  Versioning & ABI
  *============================*/
-#define MAANY_MPC_API_VERSION_MAJOR 1
+/* 2.0: init/dkg/sign/refresh opts and maany_mpc_backup_ciphertext_t gained
+ * trailing fields. Zero-initialized 1.x callers compile and behave as before,
+ * but binaries built against 1.x headers must be rebuilt. */
+#define MAANY_MPC_API_VERSION_MAJOR 2
 #define MAANY_MPC_API_VERSION_MINOR 0
 #define MAANY_MPC_API_VERSION_PATCH 0
 
@@ -37,6 +40,10 @@ typedef struct maany_mpc_ctx_s     maany_mpc_ctx_t;       /* library/global ctx
 typedef struct maany_mpc_kp_s      maany_mpc_keypair_t;   /* device/server share */
 typedef struct maany_mpc_dkg_s     maany_mpc_dkg_t;       /* DKG session */
 typedef struct maany_mpc_sign_s    maany_mpc_sign_t;      /* Sign session */
+typedef struct maany_mpc_tn_dkg_s  maany_mpc_tn_dkg_t;    /* t-of-n DKG session */
+typedef struct maany_mpc_tn_sign_s maany_mpc_tn_sign_t;   /* t-of-n Sign session */
+typedef struct maany_mpc_kek_s     maany_mpc_kek_t;       /* registered key-encryption key */
+typedef struct maany_mpc_store_s   maany_mpc_store_t;     /* embedded sealed share store */
 
 /*============================*
  *  Curves & Schemes
@@ -48,7 +55,7 @@ typedef enum {
 
 typedef enum {
   MAANY_MPC_SCHEME_ECDSA_2P = 0,   /* 2-of-2 ECDSA */
-  MAANY_MPC_SCHEME_ECDSA_TN = 1,   /* t-of-n ECDSA (future) */
+  MAANY_MPC_SCHEME_ECDSA_TN = 1,   /* t-of-n ECDSA (see maany_mpc_tn_*) */
   MAANY_MPC_SCHEME_SCHNORR_2P = 2  /* optional */
 } maany_mpc_scheme_t;
 
@@ -83,8 +90,29 @@ typedef enum {
   MAANY_MPC_LOG_DEBUG = 3
 } maany_mpc_log_level_t;
 
+/* Each message is one logfmt event, e.g.
+ *   event=step session=7 type=sign round=2 in_bytes=412 out_bytes=96 dur_us=840
+ * Sessions log session_start and step at DEBUG, session_done and
+ * session_abandoned (freed mid-protocol) at INFO, and session_failed with its
+ * error at WARN. `session` numbers the context's sessions; `sid` is the first
+ * 8 bytes of the caller's session_id in hex, when one was given. The callback
+ * runs on the thread that logs, possibly several at once. Levels above the
+ * configured one cost a single atomic load and format nothing. */
 typedef void (*maany_mpc_log_cb)(maany_mpc_log_level_t level, const char* msg);
 
+typedef struct {
+  maany_mpc_log_level_t level;   /* most verbose level passed to the logger */
+  /* Messages per second over all levels; 0 = unlimited. The first message
+   * after a drop carries suppressed=N. */
+  uint32_t max_per_second;
+  /* Keep INFO and DEBUG events of 1 in N sessions; 0 or 1 = all. WARN and
+   * ERROR events are never sampled out. */
+  uint32_t sample_every;
+} maany_mpc_log_config_t;
+
+/* Changes filtering while sessions run. A no-op without init_opts.logger. */
+maany_mpc_error_t maany_mpc_log_configure(maany_mpc_ctx_t* ctx, const maany_mpc_log_config_t* config);
+
 /*============================*
  *  Key Identifiers & Public Key
  *============================*/
@@ -108,6 +136,8 @@ typedef struct {
   maany_mpc_free_fn        free_fn;       /* optional; default free */
   maany_mpc_secure_zero_fn secure_zero;   /* optional; internal if NULL */
   maany_mpc_log_cb         logger;        /* optional */
+  uint32_t                 max_threads;   /* optional cap on worker threads; 0 = all cores, 1 = sequential */
+  maany_mpc_log_level_t    log_level;     /* initial logger level; 0 = ERROR only */
 } maany_mpc_init_opts_t;
 
 maany_mpc_ctx_t* maany_mpc_init(const maany_mpc_init_opts_t* opts);
@@ -125,7 +155,8 @@ const char*       maany_mpc_error_string(maany_mpc_error_t err);
 
 typedef enum {
   MAANY_MPC_SHARE_DEVICE = 0,
-  MAANY_MPC_SHARE_SERVER = 1
+  MAANY_MPC_SHARE_SERVER = 1,
+  MAANY_MPC_SHARE_RECOVERY = 2   /* t-of-n only: any party index >= 2 */
 } maany_mpc_share_kind_t;
 
 typedef struct {
@@ -144,6 +175,9 @@ typedef struct {
   uint32_t               share_count;
   maany_mpc_buf_t        label;      /* optional AAD; lib-alloc */
   maany_mpc_buf_t        ciphertext; /* AES-GCM nonce|tag|payload */
+  maany_mpc_buf_t        commitments; /* Feldman: threshold x 33-byte points; lib-alloc, empty on legacy backups */
+  maany_mpc_buf_t        ephemeral;   /* payload wrapping point; lib-alloc, empty on legacy backups */
+  maany_mpc_buf_t        auth;        /* HMAC under the update key; lib-alloc, empty on legacy backups */
 } maany_mpc_backup_ciphertext_t;
 
 typedef struct {
@@ -172,6 +206,149 @@ maany_mpc_error_t maany_mpc_kp_pubkey(
   const maany_mpc_keypair_t* kp,
   maany_mpc_pubkey_t* out_pub /* pubkey.data allocated by lib */);
 
+/* Master key rotation for shares stored encrypted outside the library. Each
+ * blob is nonce(12)|tag(16)|AES-256-GCM(old_kek, kp_export bytes) with no
+ * AAD, the layout the Node coordinator's AesGcmKeyEncryptor writes. The
+ * decrypted share must start with the key blob magic and a known version. Work
+ * is split across the context's worker threads, and each worker sets up both
+ * key schedules once. Both keks are 32 bytes. out_blobs[i] is lib-alloc; on
+ * error nothing is returned, so callers rotating a large table should pass
+ * batches of a few thousand blobs. */
+maany_mpc_error_t maany_mpc_envelope_rewrap_many(
+  maany_mpc_ctx_t* ctx,
+  const maany_mpc_buf_t* old_kek,
+  const maany_mpc_buf_t* new_kek,
+  const maany_mpc_buf_t* blobs,
+  size_t blob_count,
+  maany_mpc_buf_t* out_blobs);
+
+/* Sealed export/import: the share is encrypted inside the library and the
+ * plaintext blob is never handed to the caller. A KEK is registered once per
+ * context. Only its AES key schedule is kept; the library's copy of the raw key
+ * is wiped. Sealed shares are nonce(12)|tag(16)|AES-256-GCM(kek, kp_export
+ * bytes) with the optional `aad` bound. With no AAD this is the layout that
+ * maany_mpc_envelope_rewrap_many takes. A KEK only works with the context it
+ * was registered on. */
+maany_mpc_error_t maany_mpc_kek_register(
+  maany_mpc_ctx_t* ctx,
+  const maany_mpc_buf_t* key /* 32 bytes */,
+  maany_mpc_kek_t** out_kek);
+
+/* Safe to call after the owning context has been shut down. */
+void maany_mpc_kek_free(maany_mpc_kek_t* kek);
+
+maany_mpc_error_t maany_mpc_kp_export_sealed(
+  maany_mpc_ctx_t* ctx,
+  const maany_mpc_keypair_t* kp,
+  const maany_mpc_kek_t* kek,
+  const maany_mpc_buf_t* aad /* optional */,
+  maany_mpc_buf_t* out_sealed /* lib-alloc, caller frees */);
+
+maany_mpc_error_t maany_mpc_kp_import_sealed(
+  maany_mpc_ctx_t* ctx,
+  const maany_mpc_kek_t* kek,
+  const maany_mpc_buf_t* aad /* optional */,
+  const maany_mpc_buf_t* in_sealed,
+  maany_mpc_keypair_t** out_kp);
+
+/*============================*
+ *  Embedded share store (POSIX only)
+ *============================*/
+/* Optional on-disk store for signing nodes that keep shares local. `path` is
+ * an append-only log of shares sealed under `kek` with their key_id as AAD;
+ * `path`.idx is a memory-mapped hash index by key_id. A get decrypts straight
+ * out of the mapped log. The index is rebuilt from the log whenever it is
+ * stale, e.g. after a crash, and a torn record at the log tail is dropped.
+ * Put and remove append, so overwritten and removed shares take space until
+ * maany_mpc_store_compact rewrites the log. Compaction blocks the store while
+ * it runs. Calls on one store are thread-safe. Only one handle may have a
+ * path open: a second open, from any process, returns IO. If the store cannot
+ * be reopened after compaction, later calls return IO until it is closed and
+ * opened again. The store keeps its own reference to the KEK. Windows returns
+ * UNSUPPORTED. */
+typedef struct {
+  uint32_t sync_writes;  /* nonzero: fdatasync after each put/remove, not just on sync/close */
+} maany_mpc_store_opts_t;
+
+typedef struct {
+  uint64_t live_records;
+  uint64_t live_bytes;   /* log bytes held by live records */
+  uint64_t file_bytes;   /* total log length; compact when this is far above live_bytes */
+} maany_mpc_store_stats_t;
+
+maany_mpc_error_t maany_mpc_store_open(
+  maany_mpc_ctx_t* ctx,
+  const char* path,
+  const maany_mpc_kek_t* kek,
+  const maany_mpc_store_opts_t* opts /* optional */,
+  maany_mpc_store_t** out_store);
+
+/* Flushes and closes. Safe to call after the owning context has been shut down. */
+void maany_mpc_store_close(maany_mpc_store_t* store);
+
+/* Stores `kp` under its key_id, replacing any earlier share. A zero key_id is
+ * rejected with INVALID_ARG. */
+maany_mpc_error_t maany_mpc_store_put(
+  maany_mpc_ctx_t* ctx,
+  maany_mpc_store_t* store,
+  const maany_mpc_keypair_t* kp);
+
+/* On a miss, returns OK and sets *out_kp to NULL. */
+maany_mpc_error_t maany_mpc_store_get(
+  maany_mpc_ctx_t* ctx,
+  maany_mpc_store_t* store,
+  const maany_mpc_key_id_t* key_id,
+  maany_mpc_keypair_t** out_kp);
+
+maany_mpc_error_t maany_mpc_store_remove(
+  maany_mpc_ctx_t* ctx,
+  maany_mpc_store_t* store,
+  const maany_mpc_key_id_t* key_id,
+  uint32_t* out_removed /* optional: 1 if a share was removed */);
+
+maany_mpc_error_t maany_mpc_store_compact(maany_mpc_ctx_t* ctx, maany_mpc_store_t* store);
+maany_mpc_error_t maany_mpc_store_sync(maany_mpc_ctx_t* ctx, maany_mpc_store_t* store);
+maany_mpc_error_t maany_mpc_store_stats(
+  maany_mpc_ctx_t* ctx,
+  maany_mpc_store_t* store,
+  maany_mpc_store_stats_t* out_stats);
+
+/*============================*
+ *  HD derivation (BIP-32, non-hardened)
+ *============================*/
+/* Child shares are derived locally; no messages are exchanged. Device and
+ * server must apply the same chain code and path to obtain a matching pair.
+ * Hardened indices (bit 31 set) are rejected with INVALID_ARG. A child's
+ * key_id is SHA-256(parent key_id || big-endian path indices), or zero when
+ * the parent's is; children share the parent's Paillier material.
+ */
+typedef struct {
+  uint8_t bytes[32];
+} maany_mpc_chain_code_t;
+
+typedef struct {
+  const uint32_t* indices;
+  size_t          len;
+} maany_mpc_bip32_path_t;
+
+maany_mpc_error_t maany_mpc_kp_derive_child(
+  maany_mpc_ctx_t* ctx,
+  const maany_mpc_keypair_t* kp,
+  const maany_mpc_chain_code_t* chain_code,
+  const maany_mpc_bip32_path_t* path,
+  maany_mpc_keypair_t** out_child);
+
+/* Public keys of children parent_path/first_index .. parent_path/(first_index+count-1).
+ * out_pubs must hold `count` entries; each pubkey buffer is lib-allocated. */
+maany_mpc_error_t maany_mpc_kp_derive_pubkeys(
+  maany_mpc_ctx_t* ctx,
+  const maany_mpc_keypair_t* kp,
+  const maany_mpc_chain_code_t* chain_code,
+  const maany_mpc_bip32_path_t* parent_path,
+  uint32_t first_index,
+  size_t count,
+  maany_mpc_pubkey_t* out_pubs);
+
 void maany_mpc_buf_free(maany_mpc_ctx_t* ctx, maany_mpc_buf_t* buf);
 
 maany_mpc_error_t maany_mpc_backup_create(
@@ -183,6 +360,22 @@ maany_mpc_error_t maany_mpc_backup_create(
   maany_mpc_backup_ciphertext_t* out_ciphertext,
   maany_mpc_backup_share_t* out_shares);
 
+/* maany_mpc_backup_create that also returns the 32-byte update key
+ * (lib-alloc) needed by maany_mpc_backup_update. Backups from
+ * maany_mpc_backup_create restore the same way but cannot be updated. */
+maany_mpc_error_t maany_mpc_backup_create_updatable(
+  maany_mpc_ctx_t* ctx,
+  const maany_mpc_keypair_t* kp,
+  uint32_t threshold,
+  size_t share_count,
+  const maany_mpc_buf_t* label,
+  maany_mpc_backup_ciphertext_t* out_ciphertext,
+  maany_mpc_backup_share_t* out_shares,
+  maany_mpc_buf_t* out_update_key);
+
+/* Restore checks every share against the Feldman commitments and interpolates
+ * from the first `threshold` valid ones, so extra shares may be passed and bad
+ * ones are skipped. Backups without commitments use every share as given. */
 maany_mpc_error_t maany_mpc_backup_restore(
   maany_mpc_ctx_t* ctx,
   const maany_mpc_backup_ciphertext_t* ciphertext,
@@ -190,6 +383,70 @@ maany_mpc_error_t maany_mpc_backup_restore(
   size_t share_count,
   maany_mpc_keypair_t** out_kp);
 
+/* Replaces the payload of an existing backup with a fresh export of `kp`, for
+ * example after a refresh. The shares protect a long-lived wrapping key whose
+ * public half is the first commitment, so no shares are needed and the
+ * existing ones stay valid: only the returned ciphertext has to be stored.
+ * `update_key` is the key returned by maany_mpc_backup_create_updatable. Restore
+ * derives it from the shares and rejects payloads not MACed under it, so it
+ * must stay with the share owner and never be stored with the ciphertext.
+ * `kp` must have the backup's key_id and kind, and a wrong update key returns
+ * MAANY_MPC_ERR_INVALID_ARG, as do backups without commitments; replace those
+ * with maany_mpc_backup_create. */
+maany_mpc_error_t maany_mpc_backup_update(
+  maany_mpc_ctx_t* ctx,
+  const maany_mpc_keypair_t* kp,
+  const maany_mpc_backup_ciphertext_t* existing,
+  const maany_mpc_buf_t* update_key,
+  maany_mpc_backup_ciphertext_t* out_ciphertext);
+
+/* Backup of many keypairs under one backup key: a single envelope and a single
+ * set of `share_count` shares. Records follow the order of `kps` (1..4096
+ * entries); the envelope lists each record's kind/scheme/curve/key_id in
+ * plaintext and binds them, with the label, into that record's AES-GCM AAD. */
+typedef struct {
+  uint32_t        threshold;
+  uint32_t        share_count;
+  uint32_t        record_count;
+  maany_mpc_buf_t label;       /* optional AAD; lib-alloc */
+  maany_mpc_buf_t envelope;    /* record table + AES-GCM records */
+  maany_mpc_buf_t commitments; /* Feldman: threshold x 33-byte points; lib-alloc */
+} maany_mpc_backup_bundle_t;
+
+maany_mpc_error_t maany_mpc_backup_create_many(
+  maany_mpc_ctx_t* ctx,
+  const maany_mpc_keypair_t* const* kps,
+  size_t kp_count,
+  uint32_t threshold,
+  size_t share_count,
+  const maany_mpc_buf_t* label,
+  maany_mpc_backup_bundle_t* out_bundle,
+  maany_mpc_backup_share_t* out_shares);
+
+/* Restores the records at indices[0..index_count) into out_kps, in that order,
+ * after one interpolation of the shares. indices == NULL restores every record;
+ * index_count must then equal bundle->record_count. On error no handles are
+ * returned. */
+maany_mpc_error_t maany_mpc_backup_restore_many(
+  maany_mpc_ctx_t* ctx,
+  const maany_mpc_backup_bundle_t* bundle,
+  const maany_mpc_backup_share_t* shares,
+  size_t share_count,
+  const uint32_t* indices,
+  size_t index_count,
+  maany_mpc_keypair_t** out_kps);
+
+/* Checks shares against the commitments of a backup or bundle without
+ * restoring it: out_valid[i] is 1 for a valid share and 0 for a corrupt,
+ * foreign or repeated one. Costs one scalar multiplication per share. */
+maany_mpc_error_t maany_mpc_backup_verify_shares(
+  maany_mpc_ctx_t* ctx,
+  const maany_mpc_buf_t* commitments,
+  uint32_t threshold,
+  const maany_mpc_backup_share_t* shares,
+  size_t share_count,
+  uint8_t* out_valid);
+
 /*============================*
  *  DKG (2-of-2 example)
  *============================*/
@@ -208,6 +465,9 @@ typedef struct {
   maany_mpc_share_kind_t kind;    /* DEVICE or SERVER */
   maany_mpc_key_id_t key_id_hint; /* optional: coordinator-provided */
   maany_mpc_buf_t    session_id;  /* optional stable SID (e.g., 32B) */
+  uint32_t           count;       /* keys per session; 0 or 1 = single key, up to 128 */
+  uint32_t           defer_paillier; /* nonzero: EC-only DKG, finish with maany_mpc_paillier_setup_new */
+  const char*        transcript_path; /* optional: record this side for maany_mpc_replay (count <= 1) */
 } maany_mpc_dkg_opts_t;
 
 /* Create a DKG session */
@@ -234,6 +494,15 @@ maany_mpc_error_t maany_mpc_dkg_finalize(
   maany_mpc_dkg_t* dkg,
   maany_mpc_keypair_t** out_local_share);
 
+/* Finalize a batch session (opts.count > 1 or maany_mpc_refresh_new_many):
+ * out_shares must hold `count` entries, matching the count the session was
+ * created with. On error no handles are returned. */
+maany_mpc_error_t maany_mpc_dkg_finalize_many(
+  maany_mpc_ctx_t* ctx,
+  maany_mpc_dkg_t* dkg,
+  maany_mpc_keypair_t** out_shares,
+  size_t count);
+
 void maany_mpc_dkg_free(maany_mpc_dkg_t* dkg);
 
 /*============================*
@@ -247,6 +516,7 @@ typedef struct {
   maany_mpc_scheme_t scheme;       /* ECDSA_2P typically */
   maany_mpc_buf_t    session_id;   /* optional; bind policy/session */
   maany_mpc_buf_t    extra_aad;    /* optional additional associated data */
+  const char*        transcript_path; /* optional: record this side for maany_mpc_replay */
 } maany_mpc_sign_opts_t;
 
 /* Begin a signing session for a given local share */
@@ -290,6 +560,8 @@ void maany_mpc_sign_free(maany_mpc_sign_t* sign);
  *============================*/
 typedef struct {
   maany_mpc_buf_t session_id;   /* optional */
+  uint32_t        reuse_paillier; /* nonzero: re-randomize EC shares only, keep the Paillier key */
+  const char*     transcript_path; /* optional: record this side; not with refresh_new_many */
 } maany_mpc_refresh_opts_t;
 
 /* Similar round-based API; returns an updated local share handle */
@@ -301,6 +573,287 @@ maany_mpc_error_t maany_mpc_refresh_new(
 
 /* Use dkg_step/dkg_finalize to complete refresh; finalize returns new kp handle. */
 
+/* Refresh n keys (2..128) of the same party in one session: every round carries
+ * one message with the payloads of all n keys. Both sides must pass the
+ * matching keys in the same order. Complete with dkg_step and
+ * dkg_finalize_many(count = n); finalize returns all n new handles or none. */
+maany_mpc_error_t maany_mpc_refresh_new_many(
+  maany_mpc_ctx_t* ctx,
+  const maany_mpc_keypair_t* const* kps,
+  size_t n,
+  const maany_mpc_refresh_opts_t* opts,
+  maany_mpc_dkg_t** out_refresh);
+
+/* Second phase of a DKG created with defer_paillier. Until it completes, the
+ * keypair answers kp_pubkey/kp_meta and can be exported or backed up, while
+ * sign, refresh and derive_child fail with MAANY_MPC_ERR_PROTO_STATE. Drive it
+ * with dkg_step; dkg_finalize returns the sign-ready handle. */
+maany_mpc_error_t maany_mpc_paillier_setup_new(
+  maany_mpc_ctx_t* ctx,
+  const maany_mpc_keypair_t* kp,
+  maany_mpc_dkg_t** out_setup);
+
+/*============================*
+ *  Session transcripts (profiling)
+ *============================*/
+/* A transcript_path in the DKG, sign or refresh options makes that side write
+ * every frame it sent and received, with timestamps and the seed its
+ * randomness was drawn from, once the session ends. Replaying the transcript
+ * re-runs that one party in process, without the peer or the network, which
+ * gives perf/VTune a clean, repeatable target. The seed fixes the session's
+ * nonces: treat a transcript like the share it was recorded with, and record
+ * only keys and messages meant for profiling. Batch sessions are not recorded.
+ */
+
+typedef struct {
+  double compute_ms;  /* wall time of this step */
+  size_t in_bytes;    /* recorded inbound frame fed to the step; 0 for none */
+  size_t out_bytes;   /* outbound frame produced */
+} maany_mpc_replay_step_t;
+
+/* Replays one transcript. kp is the recorded party's share from before the
+ * session (NULL for DKG). Fails with MAANY_MPC_ERR_PROTO_STATE if the party
+ * produces a frame that differs from the recording. *out_count receives the
+ * number of steps; the first min(cap, *out_count) are written to out_steps,
+ * which may be NULL when cap is 0. */
+maany_mpc_error_t maany_mpc_replay(
+  maany_mpc_ctx_t* ctx,
+  const maany_mpc_buf_t* transcript,
+  const maany_mpc_keypair_t* kp,
+  maany_mpc_replay_step_t* out_steps,
+  size_t cap,
+  size_t* out_count);
+
+/*============================*
+ *  Threshold ECDSA (t-of-n)
+ *============================*/
+/* Parties are addressed by index in [0, party_count): 0 is the device, 1 the
+ * server, 2.. recovery or replica services. Every frame carries a peer index:
+ * the sender on inbound frames and the destination on outbound frames. A step
+ * may emit several frames (one per peer and round); route each to its `peer`.
+ * Keypairs produced here report MAANY_MPC_SCHEME_ECDSA_TN and work with
+ * kp_export/kp_import/kp_pubkey/kp_meta and backups, but not with sign_new.
+ */
+
+typedef struct {
+  uint32_t        peer;  /* sender (inbound) or destination (outbound) party index */
+  maany_mpc_buf_t msg;
+} maany_mpc_peer_msg_t;
+
+typedef struct {
+  maany_mpc_curve_t  curve;
+  uint32_t           party_index;  /* this party */
+  uint32_t           party_count;  /* n >= 2 */
+  uint32_t           threshold;    /* t in [2, n] */
+  maany_mpc_key_id_t key_id_hint;  /* optional */
+  maany_mpc_buf_t    session_id;   /* optional; identical on all parties */
+} maany_mpc_tn_dkg_opts_t;
+
+maany_mpc_error_t maany_mpc_tn_dkg_new(
+  maany_mpc_ctx_t* ctx,
+  const maany_mpc_tn_dkg_opts_t* opts,
+  maany_mpc_tn_dkg_t** out_dkg);
+
+/* Feed every inbound frame received since the previous step (in_count may be 0).
+ * out_msgs: lib-alloc array of out_count frames; release with maany_mpc_peer_msgs_free().
+ */
+maany_mpc_error_t maany_mpc_tn_dkg_step(
+  maany_mpc_ctx_t* ctx,
+  maany_mpc_tn_dkg_t* dkg,
+  const maany_mpc_peer_msg_t* in_msgs,  /* nullable when in_count == 0 */
+  size_t in_count,
+  maany_mpc_peer_msg_t** out_msgs,
+  size_t* out_count,
+  maany_mpc_step_result_t* result);
+
+maany_mpc_error_t maany_mpc_tn_dkg_finalize(
+  maany_mpc_ctx_t* ctx,
+  maany_mpc_tn_dkg_t* dkg,
+  maany_mpc_keypair_t** out_local_share);
+
+void maany_mpc_tn_dkg_free(maany_mpc_tn_dkg_t* dkg);
+
+typedef struct {
+  const uint32_t* signers;       /* party indices in the signing quorum (incl. self) */
+  size_t          signer_count;  /* >= threshold */
+  uint32_t        sig_receiver;  /* party index that can finalize the signature */
+  maany_mpc_buf_t session_id;    /* optional */
+} maany_mpc_tn_sign_opts_t;
+
+maany_mpc_error_t maany_mpc_tn_sign_new(
+  maany_mpc_ctx_t* ctx,
+  const maany_mpc_keypair_t* kp,
+  const maany_mpc_tn_sign_opts_t* opts,
+  maany_mpc_tn_sign_t** out_sign);
+
+maany_mpc_error_t maany_mpc_tn_sign_set_message(
+  maany_mpc_ctx_t* ctx,
+  maany_mpc_tn_sign_t* sign,
+  const uint8_t* msg,
+  size_t msg_len);
+
+maany_mpc_error_t maany_mpc_tn_sign_step(
+  maany_mpc_ctx_t* ctx,
+  maany_mpc_tn_sign_t* sign,
+  const maany_mpc_peer_msg_t* in_msgs,
+  size_t in_count,
+  maany_mpc_peer_msg_t** out_msgs,
+  size_t* out_count,
+  maany_mpc_step_result_t* result);
+
+/* Only the sig_receiver party obtains signature bytes. */
+maany_mpc_error_t maany_mpc_tn_sign_finalize(
+  maany_mpc_ctx_t* ctx,
+  maany_mpc_tn_sign_t* sign,
+  maany_mpc_sig_format_t fmt,
+  maany_mpc_buf_t* out_signature);
+
+void maany_mpc_tn_sign_free(maany_mpc_tn_sign_t* sign);
+
+/* Frees every frame buffer and the array returned by a tn_*_step call. */
+void maany_mpc_peer_msgs_free(maany_mpc_ctx_t* ctx, maany_mpc_peer_msg_t* msgs, size_t count);
+
+/*============================*
+ *  Runtime statistics
+ *============================*/
+/* Counters kept per context since maany_mpc_init. Recording is lock-free and
+ * costs a few relaxed atomic adds per call; a snapshot sums per-thread slots,
+ * so counters of concurrent calls may be mid-update relative to each other. */
+
+typedef enum {
+  MAANY_MPC_SESSION_DKG            = 0,  /* including batch DKG */
+  MAANY_MPC_SESSION_REFRESH        = 1,  /* including refresh_new_many */
+  MAANY_MPC_SESSION_PAILLIER_SETUP = 2,
+  MAANY_MPC_SESSION_SIGN           = 3,
+  MAANY_MPC_SESSION_TN_DKG         = 4,
+  MAANY_MPC_SESSION_TN_SIGN        = 5,
+  MAANY_MPC_SESSION_TYPE_COUNT     = 6
+} maany_mpc_session_type_t;
+
+/* Step-time histogram buckets: bucket 0 counts steps under 1 us, bucket i
+ * steps in [2^(i-1), 2^i) us, the last one steps of 2^22 us (~4.2 s) or more. */
+#define MAANY_MPC_STATS_STEP_BUCKETS 24
+
+typedef struct {
+  uint64_t live;        /* created and not yet freed */
+  uint64_t started;
+  uint64_t completed;   /* reached MAANY_MPC_STEP_DONE */
+  uint64_t failed;      /* a step or finalize failed before completion */
+  uint64_t steps;       /* step calls; each runs one protocol round */
+  uint64_t step_ns;     /* total wall time inside step calls */
+  uint64_t step_hist[MAANY_MPC_STATS_STEP_BUCKETS];
+  uint64_t bytes_in;    /* peer frames fed to step */
+  uint64_t bytes_out;   /* frames produced by step */
+} maany_mpc_session_stats_t;
+
+typedef struct {
+  maany_mpc_session_stats_t sessions[MAANY_MPC_SESSION_TYPE_COUNT];
+  /* Threads for parallel work inside one call, including the caller; the
+   * pool starts them on first use. Each live session also holds one protocol
+   * thread of its own. */
+  uint32_t worker_threads;
+  uint64_t store_hits;    /* maany_mpc_store_get calls that found the key */
+  uint64_t store_misses;
+} maany_mpc_stats_t;
+
+maany_mpc_error_t maany_mpc_stats_snapshot(maany_mpc_ctx_t* ctx, maany_mpc_stats_t* out_stats);
+
+/*============================*
+ *  Session timeline
+ *============================*/
+/* Process-wide and off by default. While enabled, every session records
+ * timestamped events: its creation, its worker's span, each frame sent and
+ * received, each wait for a peer frame, every step and finalize call, and the
+ * cb-mpc protocol call its worker runs. Each thread writes a lock-free ring of
+ * its most recent 4096 events; when disabled a hook costs one atomic load.
+ * Enabling drops the events recorded before. */
+void maany_mpc_trace_enable(int enabled);
+
+/* Chrome trace event JSON (Perfetto, chrome://tracing) of the events still
+ * held, enabled or not. Release with maany_mpc_buf_free. */
+maany_mpc_error_t maany_mpc_trace_dump(maany_mpc_ctx_t* ctx, maany_mpc_buf_t* out_json);
+
+/*============================*
+ *  Primitive profile
+ *============================*/
+/* Process-wide CPU and wall time of the crypto primitives the library calls,
+ * split by the session type whose protocol thread made the call. Compiled in
+ * only when the library is built with MAANY_MPC_PROFILE_PRIMITIVES (CMake
+ * option of the same name); otherwise maany_mpc_primitive_profile returns
+ * MAANY_MPC_ERR_UNSUPPORTED. cb-mpc's protocols are timed per call, so the
+ * Paillier and zero-knowledge work inside them lands in the MAANY_MPC_PRIM_CBMPC_*
+ * entries; their CPU time excludes waits for peer frames. */
+
+typedef enum {
+  MAANY_MPC_PRIM_PAILLIER_HOMOMORPHIC = 0,  /* ciphertext arithmetic outside cb-mpc protocols */
+  MAANY_MPC_PRIM_EC_MUL               = 1,
+  MAANY_MPC_PRIM_HASH                 = 2,  /* SHA-256, HMAC-SHA512 */
+  MAANY_MPC_PRIM_SYMMETRIC            = 3,  /* AES-256-GCM */
+  MAANY_MPC_PRIM_SERIALIZE            = 4,  /* key blob import and export */
+  MAANY_MPC_PRIM_SECRET_SHARING       = 5,  /* Shamir split and interpolation */
+  MAANY_MPC_PRIM_CBMPC_2P_DKG         = 6,
+  MAANY_MPC_PRIM_CBMPC_2P_REFRESH     = 7,
+  MAANY_MPC_PRIM_CBMPC_2P_SIGN        = 8,
+  MAANY_MPC_PRIM_CBMPC_TN_DKG         = 9,
+  MAANY_MPC_PRIM_CBMPC_TN_SIGN        = 10,
+  MAANY_MPC_PRIM_COUNT                = 11
+} maany_mpc_primitive_t;
+
+typedef struct {
+  uint64_t calls;
+  uint64_t wall_ns;
+  uint64_t cpu_ns;   /* calling thread's CPU time; 0 where no thread clock exists */
+} maany_mpc_primitive_stats_t;
+
+typedef struct {
+  /* Indexed by maany_mpc_session_type_t; the extra last row holds calls made
+   * outside any session (key import/export, backups, derivation). */
+  maany_mpc_primitive_stats_t by_session[MAANY_MPC_SESSION_TYPE_COUNT + 1][MAANY_MPC_PRIM_COUNT];
+} maany_mpc_primitive_profile_t;
+
+/* Totals since the process started; diff two snapshots to profile a run. */
+maany_mpc_error_t maany_mpc_primitive_profile(maany_mpc_primitive_profile_t* out_profile);
+
+/* Short snake_case name, e.g. "ec_mul"; NULL for values out of range. */
+const char* maany_mpc_primitive_name(maany_mpc_primitive_t primitive);
+
+/*============================*
+ *  Hardware counters
+ *============================*/
+/* Opt-in, process-wide CPU counters for each session's protocol thread, read
+ * with perf_event_open on Linux. Counting follows the thread, so waits for
+ * peer frames are left out. Where the kernel refuses kernel-mode counting
+ * (perf_event_paranoid >= 2) only user-mode events are counted. */
+
+typedef enum {
+  MAANY_MPC_PERF_CYCLES        = 0,
+  MAANY_MPC_PERF_INSTRUCTIONS  = 1,
+  MAANY_MPC_PERF_CACHE_MISSES  = 2,  /* last-level cache */
+  MAANY_MPC_PERF_BRANCH_MISSES = 3,
+  MAANY_MPC_PERF_COUNT         = 4
+} maany_mpc_perf_counter_t;
+
+typedef struct {
+  uint64_t sessions;  /* sessions whose counters were read */
+  uint64_t values[MAANY_MPC_PERF_COUNT];
+} maany_mpc_perf_session_stats_t;
+
+typedef struct {
+  int enabled;
+  uint32_t counters;  /* bit (1 << maany_mpc_perf_counter_t) set for each counter the CPU provided */
+  int32_t error;      /* errno of the last failed perf_event_open, 0 if none */
+  maany_mpc_perf_session_stats_t by_session[MAANY_MPC_SESSION_TYPE_COUNT];
+} maany_mpc_perf_stats_t;
+
+/* Sessions started afterwards are counted. Enabling fails with
+ * MAANY_MPC_ERR_UNSUPPORTED when perf events are unavailable (non-Linux,
+ * containers without CAP_PERFMON, no PMU); sessions then run uncounted and
+ * maany_mpc_perf_snapshot reports the errno. */
+maany_mpc_error_t maany_mpc_perf_enable(int enabled);
+
+/* Totals since the process started; diff two snapshots to measure a run. */
+maany_mpc_error_t maany_mpc_perf_snapshot(maany_mpc_perf_stats_t* out_stats);
+
 /*============================*
  *  Utilities
  *============================*/
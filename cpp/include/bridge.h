@@ -39,12 +39,24 @@ using MallocCallback = std::function<void*(size_t)>;
 using FreeCallback = std::function<void(void*)>;
 using LogCallback = std::function<void(int level, const std::string& msg)>;
 
+// Values match maany_mpc_log_level_t; higher is more verbose.
+enum class LogLevel {
+  Error = 0,
+  Warn = 1,
+  Info = 2,
+  Debug = 3
+};
+
 struct InitOptions {
   RngCallback rng;
   SecureZeroCallback secure_zero;
   MallocCallback malloc_fn;
   FreeCallback free_fn;
   LogCallback logger;
+  LogLevel log_level{LogLevel::Error};
+  // Upper bound on threads used for parallel work inside one call, including
+  // the caller. 0 = hardware concurrency, 1 = fully sequential.
+  uint32_t max_threads{0};
 };
 
 enum class Curve {
@@ -60,7 +72,8 @@ enum class Scheme {
 
 enum class ShareKind {
   Device = 0,
-  Server = 1
+  Server = 1,
+  Recovery = 2
 };
 
 enum class SigFormat {
@@ -77,6 +90,12 @@ struct BufferOwner {
   std::vector<uint8_t> bytes;
 };
 
+// Caller-owned bytes, borrowed for the duration of a bulk call.
+struct ByteView {
+  const uint8_t* data{nullptr};
+  size_t len{0};
+};
+
 struct PubKey {
   Curve curve;
   BufferOwner compressed;
@@ -86,22 +105,51 @@ struct KeyId {
   std::array<uint8_t, 32> bytes{};
 };
 
+struct ChainCode {
+  std::array<uint8_t, 32> bytes{};
+};
+
 struct DkgOptions {
   Curve curve{Curve::Secp256k1};
   Scheme scheme{Scheme::Ecdsa2p};
   ShareKind kind{ShareKind::Device};
   KeyId key_id{};
   BufferOwner session_id;  // optional; empty when unset
+  uint32_t count{1};       // >1 runs a batch producing `count` independent keys
+  // Run only the EC part; the keypair answers pubkey/meta immediately and must
+  // finish Context::CreatePaillierSetup before it can sign or refresh.
+  bool defer_paillier{false};
+  // Optional: record this party's side for Context::Replay (single-key only).
+  std::string transcript_path;
 };
 
 struct SignOptions {
   Scheme scheme{Scheme::Ecdsa2p};
   BufferOwner session_id;
   BufferOwner extra_aad;
+  std::string transcript_path;  // optional; see DkgOptions
 };
 
 struct RefreshOptions {
   BufferOwner session_id;
+  // Re-randomize the EC shares only and keep the existing Paillier key.
+  bool reuse_paillier{false};
+  std::string transcript_path;  // optional; see DkgOptions, not for batches
+};
+
+struct ThresholdDkgOptions {
+  Curve curve{Curve::Secp256k1};
+  uint32_t party_index{0};
+  uint32_t party_count{0};
+  uint32_t threshold{0};
+  KeyId key_id{};
+  BufferOwner session_id;
+};
+
+struct ThresholdSignOptions {
+  std::vector<uint32_t> signers;  // party indices taking part; size >= threshold
+  uint32_t sig_receiver{0};       // party index that obtains the signature
+  BufferOwner session_id;
 };
 
 struct StepOutput {
@@ -109,6 +157,18 @@ struct StepOutput {
   std::optional<BufferOwner> outbound;
 };
 
+// Frame exchanged in multi-party sessions. `peer` is the sender party index on
+// inbound frames and the destination party index on outbound frames.
+struct PeerMessage {
+  uint32_t peer{0};
+  BufferOwner data;
+};
+
+struct MpStepOutput {
+  StepState state{StepState::Continue};
+  std::vector<PeerMessage> outbound;
+};
+
 struct BackupCiphertext {
   ShareKind kind{ShareKind::Device};
   Scheme scheme{Scheme::Ecdsa2p};
@@ -118,15 +178,47 @@ struct BackupCiphertext {
   uint32_t share_count{0};
   BufferOwner label;
   BufferOwner payload;  // nonce || tag || ciphertext
+  BufferOwner commitments;  // Feldman: threshold compressed points; empty on legacy backups
+  // E = e*G. The payload key is derived from e*C_0 = s*E, where C_0 is the first
+  // commitment, so the payload can be replaced without the shares. Empty on
+  // backups whose payload key is the shared secret itself.
+  BufferOwner ephemeral;
+  // HMAC-SHA256 over the other fields under the update key, which restore
+  // re-derives from s. Present exactly when `ephemeral` is.
+  BufferOwner auth;
 };
 
 struct BackupShare {
   BufferOwner data;  // encoded pid||share
 };
 
+// Several keypair blobs encrypted under one Shamir-shared backup key. The
+// envelope holds a plaintext record table (kind, scheme, curve, key_id) and one
+// AES-GCM payload per record, so any subset can be opened after a single
+// interpolation of the shares.
+struct BackupBundle {
+  uint32_t threshold{0};
+  uint32_t share_count{0};
+  uint32_t record_count{0};
+  BufferOwner label;
+  BufferOwner envelope;
+  BufferOwner commitments;  // Feldman: threshold compressed points
+};
+
+// One Step call made while replaying a transcript.
+struct ReplayStep {
+  double compute_ms{0};  // wall time of the call
+  size_t in_bytes{0};
+  size_t out_bytes{0};
+};
+
 class Keypair;
+class Kek;
 class DkgSession;
 class SignSession;
+class MpDkgSession;
+class MpSignSession;
+class Logger;
 
 class Context {
  public:
@@ -136,19 +228,107 @@ class Context {
   virtual std::unique_ptr<DkgSession> CreateDkg(const DkgOptions& opts) = 0;
   virtual std::unique_ptr<Keypair> ImportKey(const BufferOwner& blob) = 0;
   virtual BufferOwner ExportKey(const Keypair& kp) = 0;
+  // Registers a 32-byte AES-256-GCM key-encryption key for sealed export/import.
+  virtual std::unique_ptr<Kek> CreateKek(const BufferOwner& key) = 0;
+  // nonce || tag || AES-256-GCM(kek, ExportKey(kp)) with `aad` bound. The
+  // plaintext blob is wiped before returning and never leaves the library.
+  virtual BufferOwner ExportKeySealed(const Keypair& kp, const Kek& kek, const BufferOwner& aad) = 0;
+  // Takes a view so callers holding the envelope elsewhere (e.g. a mapped
+  // share store) can decrypt in place.
+  virtual std::unique_ptr<Keypair> ImportKeySealed(
+    const Kek& kek,
+    const BufferOwner& aad,
+    ByteView sealed) = 0;
   virtual PubKey GetPubKey(const Keypair& kp) = 0;
   virtual std::unique_ptr<SignSession> CreateSign(const Keypair& kp, const SignOptions& opts) = 0;
   virtual std::unique_ptr<DkgSession> CreateRefresh(const Keypair& kp, const RefreshOptions& opts) = 0;
+  // One session refreshing every key in `kps` (same party, same order on both
+  // sides); FinalizeMany returns the new keys in order.
+  virtual std::unique_ptr<DkgSession> CreateRefreshMany(
+    const std::vector<const Keypair*>& kps,
+    const RefreshOptions& opts) = 0;
+  // Second phase of a deferred DKG; Finalize returns the sign-ready keypair.
+  virtual std::unique_ptr<DkgSession> CreatePaillierSetup(const Keypair& kp) = 0;
+  // `out_update_key` authorizes later UpdateBackup calls; it stays with the
+  // share owner and is never stored next to the ciphertext.
   virtual void CreateBackup(
     const Keypair& kp,
     uint32_t threshold,
     size_t share_count,
     const BufferOwner& label,
     BackupCiphertext& out_ciphertext,
-    std::vector<BackupShare>& out_shares) = 0;
+    std::vector<BackupShare>& out_shares,
+    BufferOwner& out_update_key) = 0;
   virtual std::unique_ptr<Keypair> RestoreBackup(
     const BackupCiphertext& ciphertext,
     const std::vector<BackupShare>& shares) = 0;
+  // Re-encrypts a fresh export of `kp` under an existing backup's wrapping key.
+  // Threshold, commitments and shares are unchanged, so nothing is redistributed.
+  virtual void UpdateBackup(
+    const Keypair& kp,
+    const BackupCiphertext& existing,
+    const BufferOwner& update_key,
+    BackupCiphertext& out_ciphertext) = 0;
+  // Records follow the order of `kps`. RestoreBackupMany opens the records at
+  // `indices` (every record when empty) and returns them in that order.
+  virtual void CreateBackupMany(
+    const std::vector<const Keypair*>& kps,
+    uint32_t threshold,
+    size_t share_count,
+    const BufferOwner& label,
+    BackupBundle& out_bundle,
+    std::vector<BackupShare>& out_shares) = 0;
+  virtual std::vector<std::unique_ptr<Keypair>> RestoreBackupMany(
+    const BackupBundle& bundle,
+    const std::vector<BackupShare>& shares,
+    const std::vector<uint32_t>& indices) = 0;
+  // Checks each share against the Feldman commitments of its backup. Restore
+  // runs the same check and interpolates from the first `threshold` valid
+  // shares, so callers only need this to find out which holders to replace.
+  virtual std::vector<bool> VerifyBackupShares(
+    const BufferOwner& commitments,
+    uint32_t threshold,
+    const std::vector<BackupShare>& shares) = 0;
+
+  // Re-encrypts stored-share envelopes (nonce || tag || AES-256-GCM(kek, key blob),
+  // no AAD) from old_kek to new_kek. Each decrypted payload must carry KeyBlob
+  // magic and a known version. All or nothing: any bad envelope fails the call.
+  virtual std::vector<BufferOwner> RewrapEnvelopes(
+    const BufferOwner& old_kek,
+    const BufferOwner& new_kek,
+    const std::vector<ByteView>& envelopes) = 0;
+
+  // Non-hardened BIP-32 derivation applied locally to a 2p share. Both parties
+  // must use the same chain code and path to obtain matching child shares.
+  virtual std::unique_ptr<Keypair> DeriveChild(
+    const Keypair& kp,
+    const ChainCode& chain_code,
+    const std::vector<uint32_t>& path) = 0;
+  // Public keys for children first_index..first_index+count-1 below parent_path.
+  virtual std::vector<PubKey> DerivePubKeys(
+    const Keypair& kp,
+    const ChainCode& chain_code,
+    const std::vector<uint32_t>& parent_path,
+    uint32_t first_index,
+    size_t count) = 0;
+
+  // Re-runs the party recorded in a session transcript (transcript.h) with its
+  // recorded randomness, feeding it the recorded inbound frames, and throws
+  // ProtocolState if any outbound frame differs from the recording. `kp` is
+  // that party's share from before the session; DKG transcripts take none.
+  virtual std::vector<ReplayStep> Replay(ByteView transcript, const Keypair* kp) = 0;
+
+  // Threads available to ParallelFor work inside one call, the caller's
+  // included.
+  virtual uint32_t WorkerThreads() const = 0;
+
+  // Structured events for InitOptions::logger (log.h).
+  virtual Logger& Log() = 0;
+
+  virtual std::unique_ptr<MpDkgSession> CreateThresholdDkg(const ThresholdDkgOptions& opts) = 0;
+  virtual std::unique_ptr<MpSignSession> CreateThresholdSign(
+    const Keypair& kp,
+    const ThresholdSignOptions& opts) = 0;
 };
 
 class Keypair {
@@ -160,11 +340,20 @@ class Keypair {
   virtual KeyId key_id() const = 0;
 };
 
+// Key-encryption key registered with a context. Only the expanded AES key
+// schedule is kept; the raw key bytes are wiped at registration.
+class Kek {
+ public:
+  virtual ~Kek();
+};
+
 class DkgSession {
  public:
   virtual ~DkgSession();
   virtual StepOutput Step(const std::optional<BufferOwner>& inbound) = 0;
   virtual std::unique_ptr<Keypair> Finalize() = 0;
+  // Every key produced by the session; single-key sessions return one entry.
+  virtual std::vector<std::unique_ptr<Keypair>> FinalizeMany();
 };
 
 class SignSession {
@@ -175,4 +364,19 @@ class SignSession {
   virtual BufferOwner Finalize(SigFormat fmt) = 0;
 };
 
+class MpDkgSession {
+ public:
+  virtual ~MpDkgSession();
+  virtual MpStepOutput Step(const std::vector<PeerMessage>& inbound) = 0;
+  virtual std::unique_ptr<Keypair> Finalize() = 0;
+};
+
+class MpSignSession {
+ public:
+  virtual ~MpSignSession();
+  virtual void SetMessage(const uint8_t* msg, size_t len) = 0;
+  virtual MpStepOutput Step(const std::vector<PeerMessage>& inbound) = 0;
+  virtual BufferOwner Finalize(SigFormat fmt) = 0;
+};
+
 }  // namespace maany::bridge
@@ -0,0 +1,75 @@
+#pragma once
+
+#include "bridge.h"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace maany::bridge {
+
+struct LogConfig {
+  LogLevel level{LogLevel::Error};
+  // Events passed to the sink per wall-clock second, over all levels; 0 is no
+  // limit. The first event let through after a drop carries `suppressed=N`.
+  uint32_t max_per_second{0};
+  // Info and Debug events of a session are kept for one session in
+  // `sample_every`, chosen by session id; 0 and 1 keep every session.
+  uint32_t sample_every{1};
+};
+
+// One logfmt line, e.g. `event=step session=7 type=sign round=2 dur_us=840`.
+class LogLine {
+ public:
+  explicit LogLine(const char* event);
+
+  LogLine& Add(const char* key, uint64_t value);
+  // Quoted, with `"` and `\` escaped, when the value has spaces or quotes.
+  LogLine& Add(const char* key, const std::string& value);
+  LogLine& AddHex(const char* key, const uint8_t* data, size_t len);
+
+  std::string& text() { return text_; }
+
+ private:
+  std::string text_;
+};
+
+// Structured events for a context's log callback. Callers ask ShouldLog
+// before building a LogLine, so an event that is filtered out costs a relaxed
+// load or two and formats nothing. Without a sink every event is filtered out.
+// The sink is called on whichever thread logs, possibly several at once.
+class Logger {
+ public:
+  Logger(LogCallback sink, LogLevel level);
+  Logger(const Logger&) = delete;
+  Logger& operator=(const Logger&) = delete;
+
+  void Configure(const LogConfig& config);
+
+  bool Enabled(LogLevel level) const {
+    return static_cast<int>(level) <= level_.load(std::memory_order_relaxed);
+  }
+
+  // Level, then session sampling, then the rate limit; a true result uses up
+  // one of this second's events, so follow it with Write.
+  bool ShouldLog(LogLevel level, uint64_t session = 0);
+  void Write(LogLevel level, LogLine& line);
+
+  // Per-context ids for the `session` field.
+  uint64_t NewSessionId() { return next_session_.fetch_add(1, std::memory_order_relaxed) + 1; }
+
+ private:
+  bool TakeToken();
+
+  LogCallback sink_;
+  std::atomic<int> level_;
+  std::atomic<uint32_t> max_per_second_{0};
+  std::atomic<uint32_t> sample_every_{1};
+  std::atomic<uint64_t> window_{0};  // steady-clock second of window_count_
+  std::atomic<uint32_t> window_count_{0};
+  std::atomic<uint64_t> suppressed_{0};
+  std::atomic<uint64_t> next_session_{0};
+};
+
+}  // namespace maany::bridge
@@ -0,0 +1,161 @@
+#pragma once
+
+#include "log.h"
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+namespace maany::bridge {
+
+// Values match maany_mpc_session_type_t.
+enum class SessionType : uint32_t {
+  Dkg = 0,
+  Refresh = 1,
+  PaillierSetup = 2,
+  Sign = 3,
+  ThresholdDkg = 4,
+  ThresholdSign = 5
+};
+constexpr size_t kSessionTypeCount = 6;
+
+inline const char* SessionTypeName(SessionType type) {
+  switch (type) {
+    case SessionType::Dkg:
+      return "dkg";
+    case SessionType::Refresh:
+      return "refresh";
+    case SessionType::PaillierSetup:
+      return "paillier_setup";
+    case SessionType::Sign:
+      return "sign";
+    case SessionType::ThresholdDkg:
+      return "tn_dkg";
+    case SessionType::ThresholdSign:
+      return "tn_sign";
+  }
+  return "unknown";
+}
+
+// Step-time histogram: bucket 0 counts steps under 1 us, bucket i steps in
+// [2^(i-1), 2^i) us, and the last bucket everything from 2^22 us (~4.2 s) up.
+constexpr size_t kStepBuckets = 24;
+
+struct SessionStats {
+  uint64_t live{0};
+  uint64_t started{0};
+  uint64_t completed{0};
+  uint64_t failed{0};
+  uint64_t steps{0};
+  uint64_t step_ns{0};
+  std::array<uint64_t, kStepBuckets> step_hist{};
+  uint64_t bytes_in{0};
+  uint64_t bytes_out{0};
+};
+
+struct MetricsSnapshot {
+  std::array<SessionStats, kSessionTypeCount> sessions{};
+  uint64_t store_hits{0};
+  uint64_t store_misses{0};
+};
+
+// Counters for one context. Each thread writes to one of a fixed set of
+// cache-line aligned slots with relaxed atomic adds, so recording never takes
+// a lock or contends with other threads in the common case; Snapshot sums the
+// slots. Totals are exact, but a snapshot taken while sessions run may see one
+// counter of an event before another.
+class Metrics {
+ public:
+  Metrics();
+  ~Metrics();
+  Metrics(const Metrics&) = delete;
+  Metrics& operator=(const Metrics&) = delete;
+
+  void SessionStarted(SessionType type);
+  void SessionCompleted(SessionType type);
+  void SessionFailed(SessionType type);
+  void SessionReleased(SessionType type);
+  // One Step call: wall time spent in it (the worker's compute for that round
+  // plus the hand-off) and the frame bytes it consumed and produced.
+  void RecordStep(SessionType type, uint64_t ns, size_t in_bytes, size_t out_bytes);
+  void RecordStoreLookup(bool hit);
+
+  MetricsSnapshot Snapshot() const;
+
+ private:
+  struct Slot;
+  Slot& Local() const;
+
+  std::unique_ptr<Slot[]> slots_;
+};
+
+// A session handle's link to its context's metrics and log. Counts the
+// session once as completed (it reached Done) or failed (a call on it failed
+// first), and as released when the handle is freed. Logs session_start and
+// step at Debug, session_done and session_abandoned (freed mid-protocol) at
+// Info, and session_failed at Warn. Logging never throws; an event that cannot
+// be formatted is dropped.
+class SessionMeter {
+ public:
+  using Clock = std::chrono::steady_clock;
+
+  void Start(Metrics* metrics, Logger* logger, SessionType type, const BufferOwner* session_id = nullptr) {
+    metrics_ = metrics;
+    logger_ = logger;
+    type_ = type;
+    metrics_->SessionStarted(type_);
+    session_ = logger_->NewSessionId();
+    started_ = Clock::now();
+    if (logger_->ShouldLog(LogLevel::Debug, session_)) LogStart(session_id);
+  }
+
+  void Step(Clock::time_point start, size_t in_bytes, size_t out_bytes, bool done) {
+    if (!metrics_) return;
+    const auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start).count();
+    metrics_->RecordStep(type_, static_cast<uint64_t>(ns), in_bytes, out_bytes);
+    ++rounds_;
+    bytes_in_ += in_bytes;
+    bytes_out_ += out_bytes;
+    if (logger_->ShouldLog(LogLevel::Debug, session_)) LogStep(static_cast<uint64_t>(ns), in_bytes, out_bytes);
+    if (done && !ended_) {
+      ended_ = true;
+      metrics_->SessionCompleted(type_);
+      if (logger_->ShouldLog(LogLevel::Info, session_)) LogEnd(LogLevel::Info, "session_done");
+    }
+  }
+
+  // Call from a catch block; the log event carries the exception's message.
+  void Fail() {
+    if (!metrics_ || ended_) return;
+    ended_ = true;
+    metrics_->SessionFailed(type_);
+    if (logger_->ShouldLog(LogLevel::Warn, session_)) LogEnd(LogLevel::Warn, "session_failed");
+  }
+
+  void Release() {
+    if (!metrics_) return;
+    if (!ended_ && rounds_ && logger_->ShouldLog(LogLevel::Info, session_))
+      LogEnd(LogLevel::Info, "session_abandoned");
+    metrics_->SessionReleased(type_);
+    metrics_ = nullptr;
+  }
+
+ private:
+  void LogStart(const BufferOwner* session_id) noexcept;
+  void LogStep(uint64_t ns, size_t in_bytes, size_t out_bytes) noexcept;
+  void LogEnd(LogLevel level, const char* event) noexcept;
+
+  Metrics* metrics_{nullptr};
+  Logger* logger_{nullptr};
+  SessionType type_{SessionType::Dkg};
+  bool ended_{false};
+  uint64_t session_{0};
+  Clock::time_point started_{};
+  uint32_t rounds_{0};
+  uint64_t bytes_in_{0};
+  uint64_t bytes_out_{0};
+};
+
+}  // namespace maany::bridge
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <cbmpc/core/convert.h>
+#include <cbmpc/crypto/base.h>
+
+namespace maany::bridge {
+
+// Moves a 2p key's Paillier ciphertext by a public scalar while the device's
+// share stays reduced mod q. From c = Enc(x) with x in [0, q) and a shift in
+// [0, q), the device builds c' = Enc((x + shift) mod q) and proves that c'
+// re-randomizes c + shift or c + shift - q, without saying which. The server
+// cannot compute c' itself: which branch holds depends on x.
+//
+// The proof is a Fiat-Shamir OR of two N-th residuosity proofs, one per
+// branch, with 128-bit challenges split by XOR. `binding` is hashed into the
+// challenge and should name the key and session.
+struct PaillierShiftProof {
+  coinbase::crypto::bn_t a[2];
+  coinbase::crypto::bn_t e0;  // e1 = H(...) ^ e0
+  coinbase::crypto::bn_t t[2];
+
+  void convert(coinbase::converter_t& conv) {
+    conv.convert(a[0]);
+    conv.convert(a[1]);
+    conv.convert(e0);
+    conv.convert(t[0]);
+    conv.convert(t[1]);
+  }
+};
+
+// Device side; returns c'. Throws Error(Crypto) if x or shift is out of range.
+coinbase::crypto::bn_t ShiftPaillierShare(const coinbase::crypto::paillier_t& paillier,
+                                          const coinbase::crypto::bn_t& c, const coinbase::crypto::bn_t& x,
+                                          const coinbase::crypto::bn_t& shift, const coinbase::crypto::mod_t& q,
+                                          coinbase::mem_t binding, PaillierShiftProof& proof);
+
+// Server side; only the public key is needed. False also when shift is not in
+// [0, q).
+bool VerifyPaillierShift(const coinbase::crypto::paillier_t& paillier, const coinbase::crypto::bn_t& c,
+                         const coinbase::crypto::bn_t& shift, const coinbase::crypto::mod_t& q,
+                         const coinbase::crypto::bn_t& shifted, coinbase::mem_t binding,
+                         const PaillierShiftProof& proof);
+
+}  // namespace maany::bridge
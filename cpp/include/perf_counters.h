@@ -0,0 +1,81 @@
+#pragma once
+
+#include "metrics.h"
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+namespace maany::bridge::perf {
+
+// Hardware counters for each session's protocol thread, read with
+// perf_event_open. Off until Enable; then every worker opens one counter
+// group for its own thread, which counts only while that thread is on a CPU,
+// so waits for peer frames are left out. Totals are process-wide, per session
+// type. Where perf events are unavailable (non-Linux, containers without
+// CAP_PERFMON, seccomp, VMs without a PMU) Enable fails and sessions run
+// without counters; a counter the CPU lacks is left out of its group.
+//
+// Values match maany_mpc_perf_counter_t.
+enum class Counter : uint32_t {
+  Cycles = 0,
+  Instructions = 1,
+  CacheMisses = 2,
+  BranchMisses = 3
+};
+constexpr size_t kCounterCount = 4;
+
+struct CounterTotals {
+  uint64_t sessions{0};
+  std::array<uint64_t, kCounterCount> values{};
+};
+
+struct PerfSnapshot {
+  bool enabled{false};
+  // Bit i set once counter i has been read for some session.
+  uint32_t counters{0};
+  // errno of the last failed perf_event_open; 0 if none failed.
+  int error{0};
+  std::array<CounterTotals, kSessionTypeCount> sessions{};
+};
+
+namespace detail {
+extern std::atomic<bool> enabled;
+}  // namespace detail
+
+inline bool Enabled() {
+  return detail::enabled.load(std::memory_order_relaxed);
+}
+
+// Opens a trial group on the calling thread first and stays off if that
+// fails; the errno is then in Snapshot().error.
+bool Enable();
+void Disable();
+
+PerfSnapshot Snapshot();
+
+// Counts the current thread from construction to destruction and adds the
+// result to `type`'s totals. Costs nothing while counters are disabled.
+class SessionCounters {
+ public:
+  explicit SessionCounters(SessionType type) : type_(type) {
+    if (Enabled()) Open();
+  }
+  ~SessionCounters() {
+    if (leader_ >= 0) Close();
+  }
+  SessionCounters(const SessionCounters&) = delete;
+  SessionCounters& operator=(const SessionCounters&) = delete;
+
+ private:
+  void Open();
+  void Close();
+
+  SessionType type_;
+  int leader_{-1};
+  // Group fd of each counter, -1 where it could not be opened.
+  std::array<int, kCounterCount> fds_{-1, -1, -1, -1};
+};
+
+}  // namespace maany::bridge::perf
@@ -0,0 +1,92 @@
+#pragma once
+
+#include "metrics.h"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+namespace maany::bridge::profile {
+
+// CPU and wall time per crypto primitive called from the bridge, split by the
+// type of session whose worker made the call. Compiled in only with
+// MAANY_MPC_PROFILE_PRIMITIVES; otherwise Timer and SessionScope are empty and
+// Snapshot returns zeros.
+//
+// cb-mpc is vendored unmodified, so the Paillier encryptions, decryptions,
+// key generation and ZK proofs inside its protocols are timed as one entry
+// per protocol call. Their CPU time excludes waits for peer frames.
+//
+// Values match maany_mpc_primitive_t.
+enum class Primitive : uint32_t {
+  PaillierHomomorphic = 0,
+  EcMul = 1,
+  Hash = 2,
+  Symmetric = 3,
+  Serialize = 4,
+  SecretSharing = 5,
+  Cbmpc2pDkg = 6,
+  Cbmpc2pRefresh = 7,
+  Cbmpc2pSign = 8,
+  CbmpcTnDkg = 9,
+  CbmpcTnSign = 10
+};
+constexpr size_t kPrimitiveCount = 11;
+
+// One scope per session type, plus one for calls made outside any session
+// (key import and export, backups, derivation).
+constexpr size_t kScopeCount = kSessionTypeCount + 1;
+
+struct PrimitiveStats {
+  uint64_t calls{0};
+  uint64_t wall_ns{0};
+  uint64_t cpu_ns{0};
+};
+
+using ProfileSnapshot = std::array<std::array<PrimitiveStats, kPrimitiveCount>, kScopeCount>;
+
+#ifdef MAANY_MPC_PROFILE_PRIMITIVES
+constexpr bool kCompiledIn = true;
+
+// Attributes the current thread's primitive calls to `type` while alive.
+class SessionScope {
+ public:
+  explicit SessionScope(SessionType type);
+  ~SessionScope();
+  SessionScope(const SessionScope&) = delete;
+  SessionScope& operator=(const SessionScope&) = delete;
+
+ private:
+  size_t previous_;
+};
+
+class Timer {
+ public:
+  explicit Timer(Primitive primitive);
+  ~Timer();
+  Timer(const Timer&) = delete;
+  Timer& operator=(const Timer&) = delete;
+
+ private:
+  Primitive primitive_;
+  uint64_t wall_start_;
+  uint64_t cpu_start_;
+};
+#else
+constexpr bool kCompiledIn = false;
+
+class SessionScope {
+ public:
+  explicit SessionScope(SessionType) {}
+};
+
+class Timer {
+ public:
+  explicit Timer(Primitive) {}
+};
+#endif
+
+// Totals since the process started.
+ProfileSnapshot Snapshot();
+
+}  // namespace maany::bridge::profile
@@ -0,0 +1,28 @@
+#pragma once
+
+// USDT (SystemTap/DTrace-style) static probes under provider `maany_mpc`, for
+// bpftrace and other eBPF tools to attach to a running process. Built in when
+// MAANY_MPC_USDT is defined and <sys/sdt.h> exists (Linux with systemtap-sdt
+// headers); everywhere else the macros expand to nothing. Each built-in probe
+// is a single nop plus an ELF note; its arguments are cheap values already at
+// hand, read only when a tool is attached. See scripts/bpftrace/README.md for
+// the probe list and examples.
+
+#if defined(MAANY_MPC_USDT) && defined(__has_include)
+#if __has_include(<sys/sdt.h>)
+#include <sys/sdt.h>
+#define MAANY_MPC_HAVE_USDT 1
+#endif
+#endif
+
+#ifdef MAANY_MPC_HAVE_USDT
+#define MAANY_MPC_PROBE0(name) DTRACE_PROBE(maany_mpc, name)
+#define MAANY_MPC_PROBE1(name, a) DTRACE_PROBE1(maany_mpc, name, a)
+#define MAANY_MPC_PROBE2(name, a, b) DTRACE_PROBE2(maany_mpc, name, a, b)
+#define MAANY_MPC_PROBE3(name, a, b, c) DTRACE_PROBE3(maany_mpc, name, a, b, c)
+#else
+#define MAANY_MPC_PROBE0(name) ((void)0)
+#define MAANY_MPC_PROBE1(name, a) ((void)0)
+#define MAANY_MPC_PROBE2(name, a, b) ((void)0)
+#define MAANY_MPC_PROBE3(name, a, b, c) ((void)0)
+#endif
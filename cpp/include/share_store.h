@@ -0,0 +1,61 @@
+#pragma once
+
+#include "bridge.h"
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+
+namespace maany::bridge {
+
+// Embedded store of sealed key blobs, keyed by KeyId.
+//
+// `<path>` is an append-only log: a header, then records of
+// (magic, op, key_id, length, crc32, payload), 8-byte aligned. Removal appends
+// a tombstone. `<path>.idx` is an open-addressing hash table from KeyId to log
+// offset. Both files are memory-mapped, so a hit costs one probe sequence in
+// the index plus a read of the mapped record.
+//
+// Crash safety: the log is the source of truth. The index records the log
+// generation and length it covers and is marked dirty while open. On open a
+// dirty or mismatched index is rebuilt from the log, and a torn record at the
+// log tail is truncated. Compaction writes both files under new names and
+// renames them into place; the new log carries a new generation, so a crash
+// between the two renames only costs an index rebuild.
+//
+// The log is held under an exclusive flock while open, so a second Open of the
+// same path, in this process or another, fails with Error(Io). If reopening
+// after a compaction fails, every later call throws and the store must be
+// opened again.
+class ShareStore {
+ public:
+  struct Options {
+    // fdatasync the log after every Put/Remove instead of only on Sync/close.
+    bool sync_writes = false;
+  };
+
+  struct Stats {
+    uint64_t live_records = 0;
+    uint64_t live_bytes = 0;  // log bytes held by live records
+    uint64_t file_bytes = 0;  // total log length
+  };
+
+  static std::unique_ptr<ShareStore> Open(const std::string& path, const Options& opts);
+  virtual ~ShareStore();
+
+  // Appends `sealed` as the current record for `key_id`.
+  virtual void Put(const KeyId& key_id, const uint8_t* sealed, size_t len) = 0;
+  // Returns false if there was no record.
+  virtual bool Remove(const KeyId& key_id) = 0;
+  // Calls `fn` with a view into the mapped log while readers are pinned, so
+  // the payload can be decrypted without an intermediate copy. Returns false
+  // on a miss without calling `fn`.
+  virtual bool Read(const KeyId& key_id, const std::function<void(ByteView)>& fn) const = 0;
+  // Rewrites the log with only live records.
+  virtual void Compact() = 0;
+  virtual void Sync() = 0;
+  virtual Stats GetStats() const = 0;
+};
+
+}  // namespace maany::bridge
@@ -0,0 +1,72 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+
+namespace maany::bridge::timeline {
+
+// Process-wide session timeline, for finding where a slow session's time
+// went: the worker's crypto, waiting for the peer, or the Step hand-off.
+//
+// Each thread that records gets its own ring of kEventsPerThread events and is
+// the only writer to it, so recording is a handful of relaxed stores with no
+// lock. A ring is handed to the next new thread when its thread exits, keeping
+// its events, so memory is bounded by the peak number of recording threads.
+// Dump reads the rings concurrently with their writers and skips any slot that
+// is rewritten while it copies it. When recording is off, each hook costs one
+// relaxed load.
+constexpr size_t kEventsPerThread = 4096;
+
+enum class Phase : uint8_t {
+  Begin = 0,
+  End = 1,
+  Instant = 2
+};
+
+namespace detail {
+extern std::atomic<bool> enabled;
+}  // namespace detail
+
+inline bool Enabled() {
+  return detail::enabled.load(std::memory_order_relaxed);
+}
+
+// Start drops everything recorded before it.
+void Start();
+void Stop();
+
+// Ids tie a session's events on the caller and worker threads together.
+uint64_t NewSessionId();
+
+// `name` and `arg_name` must be string literals; only the pointers are kept.
+void Record(const char* name, Phase phase, uint64_t session, const char* arg_name = nullptr, uint64_t arg = 0);
+
+inline void Instant(const char* name, uint64_t session, const char* arg_name = nullptr, uint64_t arg = 0) {
+  if (Enabled()) Record(name, Phase::Instant, session, arg_name, arg);
+}
+
+// Chrome trace event JSON (loads in Perfetto and chrome://tracing) of every
+// event still in the rings since the last Start.
+std::string DumpChromeJson();
+
+// Begin/End pair on the current thread. Ends the span only if it began, so
+// toggling recording mid-span never leaves an unmatched End.
+class Span {
+ public:
+  Span(const char* name, uint64_t session) : name_(name), session_(session), active_(Enabled()) {
+    if (active_) Record(name_, Phase::Begin, session_);
+  }
+  ~Span() {
+    if (active_) Record(name_, Phase::End, session_);
+  }
+  Span(const Span&) = delete;
+  Span& operator=(const Span&) = delete;
+
+ private:
+  const char* name_;
+  uint64_t session_;
+  bool active_;
+};
+
+}  // namespace maany::bridge::timeline
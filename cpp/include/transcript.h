@@ -0,0 +1,106 @@
+#pragma once
+
+#include "bridge.h"
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace maany::bridge {
+
+// One party's side of a two-party session, recorded so it can be re-run
+// without the peer (Context::Replay).
+//
+// While a session is recorded or replayed, every OpenSSL RAND call on its
+// worker thread reads an AES-256-CTR keystream keyed by `seed`. Fed the same
+// inbound frames under the same seed, the party produces the same outbound
+// frames, so the recorded peer frames stay valid. The seed fixes the session's
+// nonces: a transcript is as sensitive as the share it was recorded with.
+//
+// Encoding (big-endian): magic "MPCT" | version | kind | party | curve | flags |
+// key_id[32] | seed[32] | u32 len + session_id | u32 len + message |
+// u32 event count | events of (type u32 | t_ns u64 | u32 len + bytes).
+enum class TranscriptKind : uint32_t {
+  Dkg = 1,
+  Sign = 2,
+  Refresh = 3
+};
+
+struct TranscriptEvent {
+  enum class Type : uint32_t {
+    Send = 1,
+    Receive = 2
+  };
+  Type type{Type::Send};
+  uint64_t t_ns{0};  // since the session was created
+  std::vector<uint8_t> bytes;
+};
+
+struct Transcript {
+  TranscriptKind kind{TranscriptKind::Dkg};
+  ShareKind party{ShareKind::Device};
+  Curve curve{Curve::Secp256k1};
+  KeyId key_id{};
+  bool defer_paillier{false};  // DKG
+  bool reuse_paillier{false};  // refresh
+  BufferOwner session_id;
+  BufferOwner message;  // sign
+  std::array<uint8_t, 32> seed{};
+  std::vector<TranscriptEvent> events;
+};
+
+BufferOwner EncodeTranscript(const Transcript& transcript);
+Transcript DecodeTranscript(ByteView bytes);
+
+// Collects a session's frames and writes the transcript to `path` when the
+// session's worker ends. Every call after construction comes from that
+// worker thread.
+class TranscriptRecorder {
+ public:
+  // Draws a fresh seed from the system RNG.
+  TranscriptRecorder(std::string path, Transcript header);
+
+  const std::array<uint8_t, 32>& seed() const { return transcript_.seed; }
+  void SetMessage(const std::vector<uint8_t>& message);
+  void Record(TranscriptEvent::Type type, const uint8_t* data, size_t len);
+  // Best effort: a transcript that cannot be written is dropped rather than
+  // failing the session it describes.
+  void Write() noexcept;
+
+ private:
+  std::string path_;
+  Transcript transcript_;
+  std::chrono::steady_clock::time_point start_;
+};
+
+// While alive, OpenSSL RAND calls on the constructing thread read the keystream
+// for `seed` instead of the system DRBG. Other threads keep drawing from the
+// private DRBG, and OpenSSL's previous RAND method is restored once no
+// instance is left.
+class ScopedSeededRng {
+ public:
+  explicit ScopedSeededRng(const std::array<uint8_t, 32>& seed);
+  ~ScopedSeededRng();
+  ScopedSeededRng(const ScopedSeededRng&) = delete;
+  ScopedSeededRng& operator=(const ScopedSeededRng&) = delete;
+
+  struct Stream;  // defined in transcript.cpp
+
+ private:
+  std::unique_ptr<Stream> stream_;
+  Stream* previous_;
+};
+
+// Recording or replay hooks for a two-party session's worker.
+struct SessionTrace {
+  std::shared_ptr<TranscriptRecorder> recorder;
+  std::optional<std::array<uint8_t, 32>> seed;
+};
+
+SessionTrace RecordTrace(const std::string& path, Transcript header);
+
+}  // namespace maany::bridge
@@ -1,4 +1,11 @@
 #include "bridge.h"
+#include "log.h"
+#include "paillier_shift.h"
+#include "perf_counters.h"
+#include "primitive_profile.h"
+#include "probes.h"
+#include "timeline.h"
+#include "transcript.h"
 
 #include <cbmpc/core/convert.h>
 #include <cbmpc/core/error.h>
@@ -7,17 +14,26 @@
 #include <cbmpc/crypto/base_pki.h>
 #include <cbmpc/crypto/lagrange.h>
 #include <cbmpc/crypto/secret_sharing.h>
+#include <cbmpc/protocol/ec_dkg.h>
 #include <cbmpc/protocol/ecdsa_2p.h>
+#include <cbmpc/protocol/ecdsa_mp.h>
+#include <openssl/crypto.h>
 #include <openssl/evp.h>
+#include <openssl/hmac.h>
 #include <openssl/rand.h>
 
+#include <atomic>
+#include <chrono>
 #include <cstdint>
 #include <condition_variable>
+#include <exception>
 #include <deque>
 #include <functional>
 #include <cstring>
 #include <algorithm>
+#include <map>
 #include <mutex>
+#include <set>
 #include <optional>
 #include <sstream>
 #include <thread>
@@ -34,20 +50,33 @@ namespace {
 using coinbase::mem_t;
 using coinbase::crypto::bn_t;
 using coinbase::crypto::ecurve_t;
+using coinbase::crypto::mod_t;
 using coinbase::crypto::curve_secp256k1;
 using coinbase::crypto::mpc_pid_t;
 using coinbase::crypto::pid_from_name;
 using coinbase::mpc::ecdsa2pc::dkg;
 using coinbase::mpc::ecdsa2pc::key_t;
 using coinbase::mpc::job_2p_t;
+using coinbase::mpc::job_mp_t;
 using coinbase::mpc::party_idx_t;
+using coinbase::mpc::party_set_t;
 using coinbase::mpc::party_t;
+using TnKey = coinbase::mpc::ecdsampc::key_t;
 
 constexpr uint32_t kKeyBlobMagic = 0x4D50434B;  // 'MPCK'
 constexpr uint32_t kKeyBlobVersion = 1;
+constexpr uint32_t kKeyBlobVersionEcOnly = 2;  // 2p share whose Paillier setup is still pending
 constexpr size_t kBackupNonceSize = 12;
 constexpr size_t kBackupTagSize = 16;
+constexpr size_t kBackupUpdateKeySize = 32;
 constexpr uint8_t kBackupShareVersion = 1;
+constexpr uint32_t kBackupBundleMagic = 0x4D504342;  // 'MPCB'
+constexpr uint32_t kBackupBundleVersion = 1;
+constexpr uint32_t kMaxBackupRecords = 4096;
+constexpr size_t kBackupRecordHeaderSize = 3 * 4 + 32;  // kind, scheme, curve, key_id
+constexpr uint32_t kBip32HardenedBit = 0x80000000u;
+constexpr uint32_t kMaxBatchLanes = 128;
+constexpr size_t kRefreshSaltSize = 32;
 
 const mpc_pid_t& DevicePid() {
   static const mpc_pid_t pid = pid_from_name("maany-device");
@@ -59,6 +88,31 @@ const mpc_pid_t& ServerPid() {
   return pid;
 }
 
+// Threshold parties are addressed by index: 0 is the device, 1 the server and
+// every further index a recovery/replica service. The names feed both the job
+// pids and the access structure leaves, so they must be stable across parties.
+std::string TnPartyName(uint32_t index) {
+  switch (index) {
+    case 0:
+      return "maany-device";
+    case 1:
+      return "maany-server";
+    default:
+      return "maany-party-" + std::to_string(index);
+  }
+}
+
+ShareKind TnShareKind(uint32_t index) {
+  switch (index) {
+    case 0:
+      return ShareKind::Device;
+    case 1:
+      return ShareKind::Server;
+    default:
+      return ShareKind::Recovery;
+  }
+}
+
 ecurve_t ToCbCurve(Curve curve) {
   switch (curve) {
     case Curve::Secp256k1:
@@ -80,6 +134,8 @@ party_t ToParty(ShareKind kind) {
       return party_t::p1;
     case ShareKind::Server:
       return party_t::p2;
+    case ShareKind::Recovery:
+      throw Error(ErrorCode::InvalidArgument, "recovery shares only exist for threshold keys");
   }
   throw Error(ErrorCode::InvalidArgument, "unknown share kind");
 }
@@ -141,6 +197,65 @@ struct KeyBlob {
   }
 };
 
+struct EcOnlyKeyBlob {
+  uint32_t magic = kKeyBlobMagic;
+  uint32_t version = kKeyBlobVersionEcOnly;
+  uint32_t scheme = 0;
+  uint32_t kind = 0;
+  KeyId key_id;
+  ecurve_t curve;
+  coinbase::crypto::ecc_point_t Q;
+  bn_t x_share;
+
+  void convert(coinbase::converter_t& conv) {
+    conv.convert(magic);
+    conv.convert(version);
+    conv.convert(scheme);
+    conv.convert(kind);
+    conv.convert(key_id.bytes);
+    conv.convert(curve);
+    conv.convert(Q);
+    conv.convert(x_share);
+  }
+};
+
+// Leading fields shared by every key blob layout; used to dispatch on import.
+struct KeyBlobHeader {
+  uint32_t magic = 0;
+  uint32_t version = 0;
+  uint32_t scheme = 0;
+
+  void convert(coinbase::converter_t& conv) {
+    conv.convert(magic);
+    conv.convert(version);
+    conv.convert(scheme);
+  }
+};
+
+struct ThresholdKeyBlob {
+  uint32_t magic = kKeyBlobMagic;
+  uint32_t version = kKeyBlobVersion;
+  uint32_t scheme = static_cast<uint32_t>(Scheme::EcdsaThresholdN);
+  uint32_t kind = 0;
+  KeyId key_id;
+  uint32_t party_index = 0;
+  uint32_t party_count = 0;
+  uint32_t threshold = 0;
+  TnKey key;
+
+  void convert(coinbase::converter_t& conv) {
+    conv.convert(magic);
+    conv.convert(version);
+    conv.convert(scheme);
+    conv.convert(kind);
+    conv.convert(key_id.bytes);
+    conv.convert(party_index);
+    conv.convert(party_count);
+    conv.convert(threshold);
+    conv.convert(key);
+  }
+};
+
 std::vector<uint8_t> ToVector(mem_t mem) {
   return std::vector<uint8_t>(mem.data, mem.data + mem.size);
 }
@@ -151,10 +266,50 @@ BufferOwner MakeBuffer(std::vector<uint8_t> bytes) {
   return buf;
 }
 
+// The context's rng callback when one is set, OpenSSL's RAND otherwise.
+std::vector<uint8_t> DrawRandom(const RngCallback& rng, size_t len) {
+  std::vector<uint8_t> out(len);
+  if (len == 0) return out;
+  if (rng) {
+    if (rng(out.data(), len) != 0)
+      throw Error(ErrorCode::Rng, "rng callback failed");
+  } else {
+    if (len > static_cast<size_t>(std::numeric_limits<int>::max()))
+      throw Error(ErrorCode::InvalidArgument, "random length too large");
+    if (RAND_bytes(out.data(), static_cast<int>(len)) != 1)
+      throw Error(ErrorCode::Rng, "RAND_bytes failed");
+  }
+  return out;
+}
+
+// Uniform mod q up to 2^-128, from 128 bits more than q has.
+bn_t DrawRandomScalar(const RngCallback& rng, const mod_t& q) {
+  auto bytes = DrawRandom(rng, static_cast<size_t>(q.get_bin_size()) + 16);
+  bn_t value = bn_t::from_bin(mem_t(bytes.data(), static_cast<int>(bytes.size()))) % q;
+  std::fill(bytes.begin(), bytes.end(), 0);
+  return value;
+}
+
 void Ensure(bool condition, ErrorCode code, const char* message) {
   if (!condition) throw Error(code, message);
 }
 
+void AppendU32(std::vector<uint8_t>& out, uint32_t v) {
+  out.push_back(static_cast<uint8_t>(v >> 24));
+  out.push_back(static_cast<uint8_t>(v >> 16));
+  out.push_back(static_cast<uint8_t>(v >> 8));
+  out.push_back(static_cast<uint8_t>(v));
+}
+
+// Reads a big-endian u32 at `offset` and advances past it.
+uint32_t ReadU32(const std::vector<uint8_t>& bytes, size_t& offset, const char* truncated) {
+  Ensure(offset <= bytes.size() && bytes.size() - offset >= 4, ErrorCode::InvalidArgument, truncated);
+  uint32_t v = (uint32_t(bytes[offset]) << 24) | (uint32_t(bytes[offset + 1]) << 16) |
+               (uint32_t(bytes[offset + 2]) << 8) | uint32_t(bytes[offset + 3]);
+  offset += 4;
+  return v;
+}
+
 BufferOwner EncodeShare(const bn_t& pid, const bn_t& value, size_t scalar_size) {
   auto pid_bin = pid.to_bin(static_cast<int>(scalar_size));
   auto value_bin = value.to_bin(static_cast<int>(scalar_size));
@@ -166,7 +321,10 @@ BufferOwner EncodeShare(const bn_t& pid, const bn_t& value, size_t scalar_size)
   return out;
 }
 
-void DecodeShare(const BufferOwner& data, size_t scalar_size, bn_t& pid_out, bn_t& value_out) {
+// Rejects pids outside [0, q): pid + q would pass the Feldman check as pid
+// while slipping past the repeat check.
+void DecodeShare(const BufferOwner& data, const ecurve_t& curve, bn_t& pid_out, bn_t& value_out) {
+  const size_t scalar_size = static_cast<size_t>(curve.size());
   const size_t expected = 1 + scalar_size * 2;
   if (data.bytes.size() != expected)
     throw Error(ErrorCode::InvalidArgument, "invalid backup share length");
@@ -175,54 +333,209 @@ void DecodeShare(const BufferOwner& data, size_t scalar_size, bn_t& pid_out, bn_
   coinbase::mem_t pid_mem(data.bytes.data() + 1, static_cast<int>(scalar_size));
   coinbase::mem_t value_mem(data.bytes.data() + 1 + scalar_size, static_cast<int>(scalar_size));
   pid_out = bn_t::from_bin(pid_mem);
+  if (!(pid_out < bn_t(curve.order())))
+    throw Error(ErrorCode::InvalidArgument, "backup share pid out of range");
   value_out = bn_t::from_bin(value_mem);
 }
 
-BufferOwner AesGcmEncrypt(
-  const std::vector<uint8_t>& key,
-  const std::vector<uint8_t>& nonce,
-  const BufferOwner& aad,
-  const std::vector<uint8_t>& plaintext) {
-  Ensure(key.size() == 32, ErrorCode::InvalidArgument, "backup key must be 32 bytes");
-  Ensure(nonce.size() == kBackupNonceSize, ErrorCode::InvalidArgument, "backup nonce size invalid");
-  BufferOwner result;
-  std::vector<uint8_t> ciphertext(plaintext.size());
-  std::array<uint8_t, kBackupTagSize> tag{};
+struct Bip32Child {
+  bn_t tweak;  // IL, already checked to be < q
+  coinbase::crypto::ecc_point_t Q;
+  ChainCode chain_code;
+};
+
+// BIP-32 CKDpub: I = HMAC-SHA512(c, ser_P(Q) || ser_32(i)), Q' = Q + IL*G.
+Bip32Child Bip32DerivePublic(
+  const ecurve_t& curve,
+  const coinbase::crypto::ecc_point_t& parent,
+  const ChainCode& chain_code,
+  uint32_t index) {
+  if (index & kBip32HardenedBit)
+    throw Error(ErrorCode::InvalidArgument, "hardened derivation requires the full private key");
+
+  auto parent_bin = parent.to_compressed_bin();
+  std::vector<uint8_t> data(parent_bin.data(), parent_bin.data() + parent_bin.size());
+  data.push_back(static_cast<uint8_t>(index >> 24));
+  data.push_back(static_cast<uint8_t>(index >> 16));
+  data.push_back(static_cast<uint8_t>(index >> 8));
+  data.push_back(static_cast<uint8_t>(index));
+
+  std::array<uint8_t, 64> I{};
+  unsigned int I_len = 0;
+  {
+    profile::Timer timer(profile::Primitive::Hash);
+    if (!HMAC(EVP_sha512(), chain_code.bytes.data(), static_cast<int>(chain_code.bytes.size()), data.data(),
+              data.size(), I.data(), &I_len) ||
+        I_len != I.size())
+      throw Error(ErrorCode::Crypto, "bip32 hmac failed");
+  }
 
-  EVP_CIPHER_CTX* raw_ctx = EVP_CIPHER_CTX_new();
-  if (!raw_ctx) throw Error(ErrorCode::Memory, "failed to allocate cipher ctx");
-  auto ctx = std::unique_ptr<EVP_CIPHER_CTX, decltype(&EVP_CIPHER_CTX_free)>(raw_ctx, &EVP_CIPHER_CTX_free);
+  Bip32Child child;
+  child.tweak = bn_t::from_bin(mem_t(I.data(), 32));
+  // BIP-32 skips such indices; the probability is below 2^-127.
+  if (!(child.tweak < bn_t(curve.order()))) throw Error(ErrorCode::Crypto, "bip32 tweak out of range");
+  {
+    profile::Timer timer(profile::Primitive::EcMul);
+    child.Q = parent + child.tweak * curve.generator();
+  }
+  if (child.Q.is_infinity()) throw Error(ErrorCode::Crypto, "bip32 child is the point at infinity");
+  std::memcpy(child.chain_code.bytes.data(), I.data() + 32, 32);
+  std::fill(I.begin(), I.end(), 0);
+  return child;
+}
+
+// SHA-256(parent_id || ser_32(i) for each index), so every path under a key has
+// its own id in the share store. A zero (unknown) parent id stays zero.
+KeyId ChildKeyId(const KeyId& parent, const std::vector<uint32_t>& path) {
+  if (std::all_of(parent.bytes.begin(), parent.bytes.end(), [](uint8_t b) { return b == 0; })) return parent;
+  std::vector<uint8_t> preimage(parent.bytes.begin(), parent.bytes.end());
+  for (uint32_t index : path) {
+    preimage.push_back(static_cast<uint8_t>(index >> 24));
+    preimage.push_back(static_cast<uint8_t>(index >> 16));
+    preimage.push_back(static_cast<uint8_t>(index >> 8));
+    preimage.push_back(static_cast<uint8_t>(index));
+  }
+  KeyId child;
+  unsigned int digest_len = 0;
+  profile::Timer timer(profile::Primitive::Hash);
+  if (EVP_Digest(preimage.data(), preimage.size(), child.bytes.data(), &digest_len, EVP_sha256(), nullptr) != 1 ||
+      digest_len != child.bytes.size())
+    throw Error(ErrorCode::Crypto, "child key id derivation failed");
+  return child;
+}
+
+// AES-256-GCM with the key schedule expanded once. Seal/Open only reset the IV,
+// so bulk callers pay for key setup once per key rather than once per message.
+// Not thread-safe; parallel callers keep one instance per task.
+class AesGcmCipher {
+ public:
+  enum class Mode { Encrypt, Decrypt };
+
+  AesGcmCipher(const std::vector<uint8_t>& key, Mode mode)
+      : mode_(mode), ctx_(EVP_CIPHER_CTX_new(), &EVP_CIPHER_CTX_free) {
+    Ensure(key.size() == 32, ErrorCode::InvalidArgument, "aes gcm key must be 32 bytes");
+    if (!ctx_) throw Error(ErrorCode::Memory, "failed to allocate cipher ctx");
+    const bool encrypt = mode_ == Mode::Encrypt;
+    if (EVP_CipherInit_ex(ctx_.get(), EVP_aes_256_gcm(), nullptr, nullptr, nullptr, encrypt ? 1 : 0) != 1)
+      throw Error(ErrorCode::Crypto, "aes gcm init failed");
+    if (EVP_CIPHER_CTX_ctrl(ctx_.get(), EVP_CTRL_GCM_SET_IVLEN, static_cast<int>(kBackupNonceSize), nullptr) != 1)
+      throw Error(ErrorCode::Crypto, "aes gcm iv len failed");
+    if (EVP_CipherInit_ex(ctx_.get(), nullptr, nullptr, key.data(), nullptr, encrypt ? 1 : 0) != 1)
+      throw Error(ErrorCode::Crypto, "aes gcm key set failed");
+  }
 
-  if (EVP_EncryptInit_ex(raw_ctx, EVP_aes_256_gcm(), nullptr, nullptr, nullptr) != 1)
-    throw Error(ErrorCode::Crypto, "aes gcm init failed");
-  if (EVP_CIPHER_CTX_ctrl(raw_ctx, EVP_CTRL_GCM_SET_IVLEN, static_cast<int>(nonce.size()), nullptr) != 1)
-    throw Error(ErrorCode::Crypto, "aes gcm iv len failed");
-  if (EVP_EncryptInit_ex(raw_ctx, nullptr, nullptr, key.data(), nonce.data()) != 1)
-    throw Error(ErrorCode::Crypto, "aes gcm key set failed");
+  // Returns nonce || tag || ciphertext.
+  BufferOwner Seal(
+    const uint8_t* nonce,
+    const BufferOwner& aad,
+    const uint8_t* plaintext,
+    size_t plaintext_len) {
+    Ensure(mode_ == Mode::Encrypt, ErrorCode::InvalidArgument, "aes gcm cipher is not in encrypt mode");
+    profile::Timer timer(profile::Primitive::Symmetric);
+    EVP_CIPHER_CTX* raw_ctx = ctx_.get();
+    if (EVP_EncryptInit_ex(raw_ctx, nullptr, nullptr, nullptr, nonce) != 1)
+      throw Error(ErrorCode::Crypto, "aes gcm iv set failed");
+
+    BufferOwner result;
+    result.bytes.resize(kBackupNonceSize + kBackupTagSize + plaintext_len);
+    std::memcpy(result.bytes.data(), nonce, kBackupNonceSize);
+    uint8_t* tag = result.bytes.data() + kBackupNonceSize;
+    uint8_t* ciphertext = tag + kBackupTagSize;
+
+    int out_len = 0;
+    if (!aad.bytes.empty()) {
+      if (EVP_EncryptUpdate(raw_ctx, nullptr, &out_len, aad.bytes.data(), static_cast<int>(aad.bytes.size())) != 1)
+        throw Error(ErrorCode::Crypto, "aes gcm aad failed");
+    }
+    out_len = 0;
+    if (plaintext_len > 0) {
+      if (EVP_EncryptUpdate(raw_ctx, ciphertext, &out_len, plaintext, static_cast<int>(plaintext_len)) != 1)
+        throw Error(ErrorCode::Crypto, "aes gcm encrypt failed");
+    }
+    int final_len = 0;
+    if (EVP_EncryptFinal_ex(raw_ctx, ciphertext + out_len, &final_len) != 1)
+      throw Error(ErrorCode::Crypto, "aes gcm final failed");
+    if (EVP_CIPHER_CTX_ctrl(raw_ctx, EVP_CTRL_GCM_GET_TAG, kBackupTagSize, tag) != 1)
+      throw Error(ErrorCode::Crypto, "aes gcm tag failed");
+    return result;
+  }
 
-  int out_len = 0;
-  if (!aad.bytes.empty()) {
-    if (EVP_EncryptUpdate(raw_ctx, nullptr, &out_len, aad.bytes.data(), static_cast<int>(aad.bytes.size())) != 1)
-      throw Error(ErrorCode::Crypto, "aes gcm aad failed");
+  std::vector<uint8_t> Open(
+    const BufferOwner& aad,
+    const uint8_t* nonce,
+    const uint8_t* tag,
+    const uint8_t* ciphertext,
+    size_t ciphertext_len) {
+    Ensure(mode_ == Mode::Decrypt, ErrorCode::InvalidArgument, "aes gcm cipher is not in decrypt mode");
+    profile::Timer timer(profile::Primitive::Symmetric);
+    EVP_CIPHER_CTX* raw_ctx = ctx_.get();
+    if (EVP_DecryptInit_ex(raw_ctx, nullptr, nullptr, nullptr, nonce) != 1)
+      throw Error(ErrorCode::Crypto, "aes gcm iv set failed");
+
+    std::vector<uint8_t> plaintext(ciphertext_len);
+    int out_len = 0;
+    if (!aad.bytes.empty()) {
+      if (EVP_DecryptUpdate(raw_ctx, nullptr, &out_len, aad.bytes.data(), static_cast<int>(aad.bytes.size())) != 1)
+        throw Error(ErrorCode::Crypto, "aes gcm aad failed");
+    }
+    out_len = 0;
+    if (ciphertext_len > 0) {
+      if (EVP_DecryptUpdate(raw_ctx, plaintext.data(), &out_len, ciphertext, static_cast<int>(ciphertext_len)) != 1)
+        throw Error(ErrorCode::Crypto, "aes gcm decrypt failed");
+    }
+    if (EVP_CIPHER_CTX_ctrl(raw_ctx, EVP_CTRL_GCM_SET_TAG, kBackupTagSize, const_cast<uint8_t*>(tag)) != 1)
+      throw Error(ErrorCode::Crypto, "aes gcm tag set failed");
+    int final_len = 0;
+    if (EVP_DecryptFinal_ex(raw_ctx, plaintext.data() + out_len, &final_len) != 1) {
+      std::fill(plaintext.begin(), plaintext.end(), 0);
+      throw Error(ErrorCode::Crypto, "aes gcm final failed");
+    }
+    plaintext.resize(static_cast<size_t>(out_len + final_len));
+    return plaintext;
   }
 
-  if (!plaintext.empty()) {
-    if (EVP_EncryptUpdate(raw_ctx, ciphertext.data(), &out_len, plaintext.data(), static_cast<int>(plaintext.size())) != 1)
-      throw Error(ErrorCode::Crypto, "aes gcm encrypt failed");
+ private:
+  Mode mode_;
+  std::unique_ptr<EVP_CIPHER_CTX, decltype(&EVP_CIPHER_CTX_free)> ctx_;
+};
+
+// Cipher contexts are expanded once at registration and shared by every
+// sealed export/import on the context, hence the lock.
+class KekImpl final : public Kek {
+ public:
+  explicit KekImpl(const std::vector<uint8_t>& key)
+      : sealer_(key, AesGcmCipher::Mode::Encrypt), opener_(key, AesGcmCipher::Mode::Decrypt) {}
+
+  BufferOwner Seal(const std::vector<uint8_t>& nonce, const BufferOwner& aad, const std::vector<uint8_t>& blob) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return sealer_.Seal(nonce.data(), aad, blob.data(), blob.size());
   }
 
-  int final_len = 0;
-  if (EVP_EncryptFinal_ex(raw_ctx, ciphertext.data() + out_len, &final_len) != 1)
-    throw Error(ErrorCode::Crypto, "aes gcm final failed");
+  std::vector<uint8_t> Open(const BufferOwner& aad, ByteView sealed) const {
+    Ensure(
+      sealed.data && sealed.len > kBackupNonceSize + kBackupTagSize,
+      ErrorCode::InvalidArgument,
+      "sealed key too short");
+    const uint8_t* nonce = sealed.data;
+    const uint8_t* tag = nonce + kBackupNonceSize;
+    std::lock_guard<std::mutex> lock(mutex_);
+    return opener_.Open(aad, nonce, tag, tag + kBackupTagSize, sealed.len - kBackupNonceSize - kBackupTagSize);
+  }
 
-  if (EVP_CIPHER_CTX_ctrl(raw_ctx, EVP_CTRL_GCM_GET_TAG, kBackupTagSize, tag.data()) != 1)
-    throw Error(ErrorCode::Crypto, "aes gcm tag failed");
+ private:
+  mutable std::mutex mutex_;
+  mutable AesGcmCipher sealer_;
+  mutable AesGcmCipher opener_;
+};
 
-  result.bytes.reserve(nonce.size() + tag.size() + ciphertext.size());
-  result.bytes.insert(result.bytes.end(), nonce.begin(), nonce.end());
-  result.bytes.insert(result.bytes.end(), tag.begin(), tag.end());
-  result.bytes.insert(result.bytes.end(), ciphertext.begin(), ciphertext.end());
-  return result;
+BufferOwner AesGcmEncrypt(
+  const std::vector<uint8_t>& key,
+  const std::vector<uint8_t>& nonce,
+  const BufferOwner& aad,
+  const std::vector<uint8_t>& plaintext) {
+  Ensure(nonce.size() == kBackupNonceSize, ErrorCode::InvalidArgument, "backup nonce size invalid");
+  AesGcmCipher cipher(key, AesGcmCipher::Mode::Encrypt);
+  return cipher.Seal(nonce.data(), aad, plaintext.data(), plaintext.size());
 }
 
 std::vector<uint8_t> AesGcmDecrypt(
@@ -234,117 +547,618 @@ std::vector<uint8_t> AesGcmDecrypt(
   size_t tag_len,
   const uint8_t* ciphertext,
   size_t ciphertext_len) {
-  Ensure(key.size() == 32, ErrorCode::InvalidArgument, "backup key must be 32 bytes");
-  std::vector<uint8_t> plaintext(ciphertext_len);
-  EVP_CIPHER_CTX* raw_ctx = EVP_CIPHER_CTX_new();
-  if (!raw_ctx) throw Error(ErrorCode::Memory, "failed to allocate cipher ctx");
-  auto ctx = std::unique_ptr<EVP_CIPHER_CTX, decltype(&EVP_CIPHER_CTX_free)>(raw_ctx, &EVP_CIPHER_CTX_free);
+  Ensure(nonce_len == kBackupNonceSize, ErrorCode::InvalidArgument, "backup nonce size invalid");
+  Ensure(tag_len == kBackupTagSize, ErrorCode::InvalidArgument, "backup tag size invalid");
+  AesGcmCipher cipher(key, AesGcmCipher::Mode::Decrypt);
+  return cipher.Open(aad, nonce, tag, ciphertext, ciphertext_len);
+}
+
+// Decrypts a nonce || tag || ciphertext backup payload.
+std::vector<uint8_t> OpenBackupPayload(
+  const std::vector<uint8_t>& key,
+  const BufferOwner& aad,
+  const uint8_t* payload,
+  size_t payload_len) {
+  if (payload_len < kBackupNonceSize + kBackupTagSize)
+    throw Error(ErrorCode::InvalidArgument, "backup ciphertext too short");
+  return AesGcmDecrypt(
+    key,
+    aad,
+    payload,
+    kBackupNonceSize,
+    payload + kBackupNonceSize,
+    kBackupTagSize,
+    payload + kBackupNonceSize + kBackupTagSize,
+    payload_len - kBackupNonceSize - kBackupTagSize);
+}
+
+std::vector<coinbase::crypto::ecc_point_t> DecodeCommitments(
+  const ecurve_t& curve,
+  const BufferOwner& commitments,
+  uint32_t threshold) {
+  const size_t point_size = static_cast<size_t>(curve.size()) + 1;
+  if (threshold < 1 || commitments.bytes.size() != point_size * threshold)
+    throw Error(ErrorCode::InvalidArgument, "invalid backup commitments");
+  std::vector<coinbase::crypto::ecc_point_t> points(threshold);
+  for (uint32_t j = 0; j < threshold; ++j) {
+    mem_t mem(commitments.bytes.data() + j * point_size, static_cast<int>(point_size));
+    if (points[j].from_bin(curve, mem) != SUCCESS)
+      throw Error(ErrorCode::InvalidArgument, "invalid backup commitment point");
+  }
+  return points;
+}
+
+struct CheckedShare {
+  bn_t pid;
+  bn_t value;
+  bool valid = false;
+};
+
+// Feldman check of every share: value*G must equal sum_j C_j*pid^j, evaluated
+// with Horner's rule so each share costs one full scalar multiplication plus
+// threshold-1 multiplications by its pid. Malformed shares, pids outside
+// [1, q) and repeats of an accepted pid are reported invalid rather than
+// thrown.
+std::vector<CheckedShare> CheckBackupShares(
+  const ecurve_t& curve,
+  const std::vector<coinbase::crypto::ecc_point_t>& points,
+  const std::vector<BackupShare>& shares) {
+  std::vector<CheckedShare> checked(shares.size());
+  for (size_t i = 0; i < shares.size(); ++i) {
+    auto& share = checked[i];
+    try {
+      DecodeShare(shares[i].data, curve, share.pid, share.value);
+    } catch (const Error&) {
+      continue;
+    }
+    if (share.pid == bn_t(0)) continue;
+    bool repeated = false;
+    for (size_t k = 0; k < i && !repeated; ++k) repeated = checked[k].valid && checked[k].pid == share.pid;
+    if (repeated) continue;
+
+    coinbase::crypto::ecc_point_t expected = points.back();
+    for (size_t j = points.size() - 1; j-- > 0;) expected = share.pid * expected + points[j];
+    share.valid = share.value * curve.generator() == expected;
+  }
+  return checked;
+}
+
+// Interpolates the backup key from the encoded shares. With commitments, bad
+// shares are skipped and the first `threshold` valid ones are used; legacy
+// backups without commitments interpolate every share as given.
+std::vector<uint8_t> RecoverBackupKey(
+  uint32_t threshold,
+  const BufferOwner& commitments,
+  const std::vector<BackupShare>& shares) {
+  if (threshold < 1)
+    throw Error(ErrorCode::InvalidArgument, "invalid backup threshold");
+  if (shares.size() < threshold)
+    throw Error(ErrorCode::InvalidArgument, "insufficient backup shares provided");
+
+  const ecurve_t curve = curve_secp256k1;
+  const auto& q = curve.order();
+  const size_t scalar_size = static_cast<size_t>(curve.size());
 
-  if (EVP_DecryptInit_ex(raw_ctx, EVP_aes_256_gcm(), nullptr, nullptr, nullptr) != 1)
-    throw Error(ErrorCode::Crypto, "aes gcm decrypt init failed");
-  if (EVP_CIPHER_CTX_ctrl(raw_ctx, EVP_CTRL_GCM_SET_IVLEN, static_cast<int>(nonce_len), nullptr) != 1)
-    throw Error(ErrorCode::Crypto, "aes gcm iv len failed");
-  if (EVP_DecryptInit_ex(raw_ctx, nullptr, nullptr, key.data(), nonce) != 1)
-    throw Error(ErrorCode::Crypto, "aes gcm key set failed");
+  std::vector<coinbase::crypto::ecc_point_t> points;
+  std::vector<bn_t> pid_list;
+  std::vector<bn_t> share_values;
+  pid_list.reserve(shares.size());
+  share_values.reserve(shares.size());
+  if (commitments.bytes.empty()) {
+    for (const auto& share : shares) {
+      bn_t pid;
+      bn_t value;
+      DecodeShare(share.data, curve, pid, value);
+      pid_list.push_back(pid);
+      share_values.push_back(value);
+    }
+  } else {
+    points = DecodeCommitments(curve, commitments, threshold);
+    for (auto& share : CheckBackupShares(curve, points, shares)) {
+      if (!share.valid) continue;
+      pid_list.push_back(share.pid);
+      share_values.push_back(share.value);
+      if (pid_list.size() == threshold) break;
+    }
+    if (pid_list.size() < threshold)
+      throw Error(ErrorCode::InvalidArgument, "insufficient valid backup shares provided");
+  }
 
-  int out_len = 0;
-  if (!aad.bytes.empty()) {
-    if (EVP_DecryptUpdate(raw_ctx, nullptr, &out_len, aad.bytes.data(), static_cast<int>(aad.bytes.size())) != 1)
-      throw Error(ErrorCode::Crypto, "aes gcm aad failed");
+  bn_t secret;
+  {
+    profile::Timer timer(profile::Primitive::SecretSharing);
+    secret = coinbase::crypto::lagrange_interpolate(bn_t(0), share_values, pid_list, q);
   }
+  if (!points.empty() && !(secret * curve.generator() == points[0]))
+    throw Error(ErrorCode::Crypto, "backup key does not match its commitment");
+  auto key_bin = secret.to_bin(static_cast<int>(scalar_size));
+  return std::vector<uint8_t>(key_bin.data(), key_bin.data() + key_bin.size());
+}
+
+// Payload key of a wrapped backup: SHA-256 over a domain tag, the shared point
+// s*E = e*C_0 and E.
+std::vector<uint8_t> BackupWrapKey(
+  const coinbase::crypto::ecc_point_t& shared,
+  const coinbase::crypto::ecc_point_t& ephemeral) {
+  static constexpr char kDomain[] = "maany-backup-wrap-v1";
+  profile::Timer timer(profile::Primitive::Hash);
+  auto shared_bin = shared.to_compressed_bin();
+  auto ephemeral_bin = ephemeral.to_compressed_bin();
+  std::vector<uint8_t> preimage(kDomain, kDomain + sizeof(kDomain) - 1);
+  preimage.insert(preimage.end(), shared_bin.data(), shared_bin.data() + shared_bin.size());
+  preimage.insert(preimage.end(), ephemeral_bin.data(), ephemeral_bin.data() + ephemeral_bin.size());
+  std::vector<uint8_t> key(32);
+  unsigned int key_len = 0;
+  if (EVP_Digest(preimage.data(), preimage.size(), key.data(), &key_len, EVP_sha256(), nullptr) != 1 ||
+      key_len != key.size())
+    throw Error(ErrorCode::Crypto, "backup key derivation failed");
+  std::fill(preimage.begin(), preimage.end(), 0);
+  return key;
+}
+
+// Update key of a wrapped backup: SHA-256 over a domain tag and s. Anyone can
+// seal to C_0, so restore only opens payloads MACed under this key.
+std::vector<uint8_t> BackupUpdateKey(const std::vector<uint8_t>& secret) {
+  static constexpr char kDomain[] = "maany-backup-update-v1";
+  profile::Timer timer(profile::Primitive::Hash);
+  std::vector<uint8_t> preimage(kDomain, kDomain + sizeof(kDomain) - 1);
+  preimage.insert(preimage.end(), secret.begin(), secret.end());
+  std::vector<uint8_t> key(kBackupUpdateKeySize);
+  unsigned int key_len = 0;
+  if (EVP_Digest(preimage.data(), preimage.size(), key.data(), &key_len, EVP_sha256(), nullptr) != 1 ||
+      key_len != key.size())
+    throw Error(ErrorCode::Crypto, "backup update key derivation failed");
+  std::fill(preimage.begin(), preimage.end(), 0);
+  return key;
+}
 
-  if (ciphertext_len > 0) {
-    if (EVP_DecryptUpdate(raw_ctx, plaintext.data(), &out_len, ciphertext, static_cast<int>(ciphertext_len)) != 1)
-      throw Error(ErrorCode::Crypto, "aes gcm decrypt failed");
+// HMAC-SHA256 under the update key over every field of a wrapped backup except
+// `auth` itself; variable-length fields are length-prefixed.
+std::vector<uint8_t> BackupAuthTag(const std::vector<uint8_t>& update_key, const BackupCiphertext& ciphertext) {
+  static constexpr char kDomain[] = "maany-backup-auth-v1";
+  std::vector<uint8_t> data(kDomain, kDomain + sizeof(kDomain) - 1);
+  auto append_u32 = [&data](uint32_t value) {
+    for (int shift = 24; shift >= 0; shift -= 8) data.push_back(static_cast<uint8_t>(value >> shift));
+  };
+  append_u32(static_cast<uint32_t>(ciphertext.kind));
+  append_u32(static_cast<uint32_t>(ciphertext.scheme));
+  append_u32(static_cast<uint32_t>(ciphertext.curve));
+  data.insert(data.end(), ciphertext.key_id.bytes.begin(), ciphertext.key_id.bytes.end());
+  append_u32(ciphertext.threshold);
+  append_u32(ciphertext.share_count);
+  for (const BufferOwner* field :
+       {&ciphertext.label, &ciphertext.commitments, &ciphertext.ephemeral, &ciphertext.payload}) {
+    append_u32(static_cast<uint32_t>(field->bytes.size()));
+    data.insert(data.end(), field->bytes.begin(), field->bytes.end());
   }
 
-  if (EVP_CIPHER_CTX_ctrl(raw_ctx, EVP_CTRL_GCM_SET_TAG, static_cast<int>(tag_len), const_cast<uint8_t*>(tag)) != 1)
-    throw Error(ErrorCode::Crypto, "aes gcm tag set failed");
+  std::vector<uint8_t> tag(32);
+  unsigned int tag_len = 0;
+  profile::Timer timer(profile::Primitive::Hash);
+  if (!HMAC(EVP_sha256(), update_key.data(), static_cast<int>(update_key.size()), data.data(), data.size(),
+            tag.data(), &tag_len) ||
+      tag_len != tag.size())
+    throw Error(ErrorCode::Crypto, "backup authentication failed");
+  return tag;
+}
+
+bool BackupAuthValid(const std::vector<uint8_t>& update_key, const BackupCiphertext& ciphertext) {
+  const auto expected = BackupAuthTag(update_key, ciphertext);
+  return ciphertext.auth.bytes.size() == expected.size() &&
+         CRYPTO_memcmp(ciphertext.auth.bytes.data(), expected.data(), expected.size()) == 0;
+}
+
+// One record of a backup bundle envelope. `header` points at the record's
+// kind/scheme/curve/key_id bytes inside the envelope and is bound into the AAD.
+struct BackupRecordRef {
+  KeyId key_id;
+  const uint8_t* header = nullptr;
+  const uint8_t* payload = nullptr;
+  size_t payload_len = 0;
+};
 
-  int final_len = 0;
-  if (EVP_DecryptFinal_ex(raw_ctx, plaintext.data() + out_len, &final_len) != 1)
-    throw Error(ErrorCode::Crypto, "aes gcm final failed");
+// Envelope: magic, version, record count, then per record the fixed header,
+// u32 payload length and nonce || tag || ciphertext; integers are big-endian.
+std::vector<BackupRecordRef> ParseBackupEnvelope(const BufferOwner& envelope) {
+  const auto& bytes = envelope.bytes;
+  size_t offset = 0;
+  Ensure(ReadU32(bytes, offset, "backup envelope truncated") == kBackupBundleMagic, ErrorCode::InvalidArgument,
+         "not a backup bundle");
+  Ensure(ReadU32(bytes, offset, "backup envelope truncated") == kBackupBundleVersion, ErrorCode::InvalidArgument,
+         "unsupported backup bundle version");
+  const uint32_t count = ReadU32(bytes, offset, "backup envelope truncated");
+  Ensure(count >= 1 && count <= kMaxBackupRecords, ErrorCode::InvalidArgument, "backup record count out of range");
+
+  std::vector<BackupRecordRef> records(count);
+  for (auto& record : records) {
+    Ensure(bytes.size() - offset >= kBackupRecordHeaderSize, ErrorCode::InvalidArgument, "backup envelope truncated");
+    record.header = bytes.data() + offset;
+    std::memcpy(record.key_id.bytes.data(), record.header + 12, record.key_id.bytes.size());
+    offset += kBackupRecordHeaderSize;
+    const uint32_t len = ReadU32(bytes, offset, "backup envelope truncated");
+    Ensure(bytes.size() - offset >= len, ErrorCode::InvalidArgument, "backup envelope truncated");
+    record.payload = bytes.data() + offset;
+    record.payload_len = len;
+    offset += len;
+  }
+  Ensure(offset == bytes.size(), ErrorCode::InvalidArgument, "backup envelope has trailing bytes");
+  return records;
+}
 
-  plaintext.resize(static_cast<size_t>(out_len + final_len));
-  return plaintext;
+// AAD of one bundle record: the caller's label, the record count and index and
+// the record header, so records cannot be moved, dropped or relabelled.
+BufferOwner BackupRecordAad(const BufferOwner& label, uint32_t count, uint32_t index, const uint8_t* header) {
+  BufferOwner aad;
+  aad.bytes = label.bytes;
+  AppendU32(aad.bytes, kBackupBundleMagic);
+  AppendU32(aad.bytes, count);
+  AppendU32(aad.bytes, index);
+  aad.bytes.insert(aad.bytes.end(), header, header + kBackupRecordHeaderSize);
+  return aad;
 }
 
-class AsyncSession {
+// Bounded pool for independent CPU work owned by the bridge. ParallelFor runs
+// fn(0..n-1) on up to size() threads including the caller and writes nothing
+// itself, so callers that store results by index get the same output as a
+// sequential loop. The caller always drains the index range, and helpers that
+// start after it is drained exit without touching it, so nested calls from pool
+// threads cannot deadlock. The helper threads start on the first ParallelFor
+// that can use them, so a context that never fans out work owns none.
+class TaskPool {
  public:
-  AsyncSession() = default;
-  AsyncSession(const AsyncSession&) = delete;
-  AsyncSession& operator=(const AsyncSession&) = delete;
-  virtual ~AsyncSession() {
+  explicit TaskPool(unsigned threads) : threads_(std::max(1u, threads)) {}
+
+  TaskPool(const TaskPool&) = delete;
+  TaskPool& operator=(const TaskPool&) = delete;
+
+  ~TaskPool() {
     {
       std::lock_guard<std::mutex> lock(mutex_);
-      aborted_ = true;
-      cv_.notify_all();
+      stop_ = true;
     }
-    if (worker_.joinable()) worker_.join();
+    cv_.notify_all();
+    for (auto& worker : workers_) worker.join();
+  }
+
+  unsigned size() const { return threads_; }
+
+  void ParallelFor(size_t n, const std::function<void(size_t)>& fn) {
+    if (n == 0) return;
+    if (n == 1 || threads_ == 1) {
+      for (size_t i = 0; i < n; ++i) fn(i);
+      return;
+    }
+
+    struct Call {
+      std::atomic<size_t> next{0};
+      size_t n = 0;
+      const std::function<void(size_t)>* fn = nullptr;
+      std::mutex mutex;
+      std::condition_variable cv;
+      size_t active = 0;
+      bool closed = false;
+      std::exception_ptr error;
+    };
+    auto call = std::make_shared<Call>();
+    call->n = n;
+    call->fn = &fn;
+
+    auto drain = [](Call& c) {
+      for (size_t i = c.next.fetch_add(1); i < c.n; i = c.next.fetch_add(1)) {
+        try {
+          (*c.fn)(i);
+        } catch (...) {
+          std::lock_guard<std::mutex> lock(c.mutex);
+          if (!c.error) c.error = std::current_exception();
+          c.next = c.n;
+        }
+      }
+    };
+
+    const size_t helpers = std::min(n, static_cast<size_t>(size())) - 1;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      if (workers_.empty()) {
+        for (unsigned i = 1; i < threads_; ++i) workers_.emplace_back([this]() { Run(); });
+      }
+      for (size_t h = 0; h < helpers; ++h) {
+        queue_.emplace_back([call, drain]() {
+          {
+            std::lock_guard<std::mutex> lock(call->mutex);
+            if (call->closed) return;
+            ++call->active;
+          }
+          drain(*call);
+          {
+            std::lock_guard<std::mutex> lock(call->mutex);
+            --call->active;
+          }
+          call->cv.notify_all();
+        });
+      }
+    }
+    cv_.notify_all();
+
+    drain(*call);
+    std::unique_lock<std::mutex> lock(call->mutex);
+    call->closed = true;
+    call->cv.wait(lock, [&] { return call->active == 0; });
+    if (call->error) std::rethrow_exception(call->error);
+  }
+
+ private:
+  void Run() {
+    for (;;) {
+      std::function<void()> task;
+      {
+        std::unique_lock<std::mutex> lock(mutex_);
+        cv_.wait(lock, [&] { return stop_ || !queue_.empty(); });
+        if (queue_.empty()) return;
+        task = std::move(queue_.front());
+        queue_.pop_front();
+      }
+      task();
+    }
+  }
+
+  const unsigned threads_;
+  std::vector<std::thread> workers_;
+  std::deque<std::function<void()>> queue_;
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  bool stop_ = false;
+};
+
+// Caps how many lanes of a batch session compute at once. Each lane has its
+// own worker thread; a worker holds a slot while it runs and gives it back
+// while it waits on the peer, so at most `slots` lanes are runnable.
+class LaneGate {
+ public:
+  explicit LaneGate(unsigned slots) : free_(std::max(1u, slots)) {}
+
+  // Returns false, without a slot, once `cancelled()` holds.
+  template <typename Pred>
+  bool Acquire(Pred cancelled) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    cv_.wait(lock, [&] { return free_ > 0 || cancelled(); });
+    if (free_ == 0) return false;
+    --free_;
+    return true;
+  }
+
+  void Release() {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      ++free_;
+    }
+    cv_.notify_one();
+  }
+
+  // Wakes waiters so they re-check their cancel predicate.
+  void Interrupt() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    cv_.notify_all();
   }
 
+ private:
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  unsigned free_;
+};
+
+// Worker thread, failure state and tracing shared by the two- and
+// multi-party sessions. Derived classes own state the worker touches (message
+// queues, jobs, keys), so each calls StopWorker() from its own destructor,
+// before that state is destroyed.
+class SessionWorker {
+ public:
+  SessionWorker() = default;
+  SessionWorker(const SessionWorker&) = delete;
+  SessionWorker& operator=(const SessionWorker&) = delete;
+  virtual ~SessionWorker() { StopWorker(); }
+
  protected:
-  void StartWorker(std::function<void()> fn) {
-    worker_ = std::thread([this, fn = std::move(fn)]() mutable {
-      try {
-        fn();
-      } catch (const Error& err) {
-        Fail(err.code(), err.what());
-      } catch (const std::exception& ex) {
-        Fail(ErrorCode::General, ex.what());
-      } catch (...) {
-        Fail(ErrorCode::General, "unknown exception");
+  // Must precede StartWorker. The worker then draws its randomness from the
+  // trace seed and reports frames to the recorder, if any.
+  void AttachTrace(SessionTrace trace) { trace_ = std::move(trace); }
+
+  // Must precede StartWorker. The worker then computes only while it holds a
+  // slot of `gate`.
+  void AttachGate(std::shared_ptr<LaneGate> gate) { gate_ = std::move(gate); }
+
+  // `type` labels the worker's span on the session timeline, the primitives
+  // it calls and its hardware counters.
+  void StartWorker(SessionType type, std::function<void()> fn) {
+    timeline::Instant("session_create", timeline_id_);
+    worker_ = std::thread([this, type, fn = std::move(fn)]() mutable {
+      MAANY_MPC_PROBE2(worker_start, timeline_id_, static_cast<uint32_t>(type));
+      {
+        timeline::Span span(SessionTypeName(type), timeline_id_);
+        profile::SessionScope scope(type);
+        perf::SessionCounters counters(type);
+        try {
+          std::optional<ScopedSeededRng> rng;
+          if (trace_.seed) rng.emplace(*trace_.seed);
+          if (!AcquireLane()) throw Error(ErrorCode::ProtocolState, "session aborted");
+          fn();
+        } catch (const Error& err) {
+          Fail(err.code(), err.what());
+        } catch (const std::exception& ex) {
+          Fail(ErrorCode::General, ex.what());
+        } catch (...) {
+          Fail(ErrorCode::General, "unknown exception");
+        }
+        ReleaseLane();
+        if (trace_.recorder) trace_.recorder->Write();
       }
+      [[maybe_unused]] bool failed = false;
       {
         std::lock_guard<std::mutex> lock(mutex_);
         worker_done_ = true;
+        failed = fatal_.has_value();
       }
+      MAANY_MPC_PROBE3(worker_end, timeline_id_, static_cast<uint32_t>(type), failed);
       cv_.notify_all();
     });
   }
 
-  ::error_t OnSend(mem_t msg) {
-    std::vector<uint8_t> bytes(msg.data, msg.data + msg.size);
+  // Aborts a worker blocked on a peer or on its lane gate and joins it.
+  // Idempotent.
+  void StopWorker() {
     {
       std::lock_guard<std::mutex> lock(mutex_);
-      outbound_.emplace(std::move(bytes));
+      aborted_ = true;
+      cv_.notify_all();
     }
-    cv_.notify_all();
-    return SUCCESS;
+    if (gate_) gate_->Interrupt();
+    if (worker_.joinable()) worker_.join();
   }
 
-  ::error_t OnReceive(mem_t& msg) {
-    std::unique_lock<std::mutex> lock(mutex_);
-    waiting_for_inbound_ = true;
-    ++wait_request_id_;
-    cv_.notify_all();
-    cv_.wait(lock, [&] { return !inbound_queue_.empty() || aborted_ || fatal_.has_value(); });
-    if (fatal_) return E_GENERAL;
-    if (aborted_) return E_GENERAL;
+  // Worker thread only. Without a gate both are no-ops; AcquireLane returns
+  // false if the session is aborted while it waits.
+  bool AcquireLane() {
+    if (!gate_ || holds_lane_) return true;
+    holds_lane_ = gate_->Acquire([this] {
+      std::lock_guard<std::mutex> lock(mutex_);
+      return aborted_;
+    });
+    return holds_lane_;
+  }
 
-    inbound_active_ = std::move(inbound_queue_.front());
-    inbound_queue_.pop_front();
-    waiting_for_inbound_ = false;
+  void ReleaseLane() {
+    if (!holds_lane_) return;
+    holds_lane_ = false;
+    gate_->Release();
+  }
 
-    msg = mem_t(inbound_active_.data(), static_cast<int>(inbound_active_.size()));
-    return SUCCESS;
+  // Marks one cb-mpc protocol call on the session timeline and in the
+  // primitive profile.
+  template <typename Fn>
+  auto ProtocolCall(const char* name, profile::Primitive primitive, Fn&& fn) {
+    timeline::Span span(name, timeline_id_);
+    profile::Timer timer(primitive);
+    return fn();
   }
 
-  StepOutput AwaitStep(const std::optional<BufferOwner>& inbound) {
-    const uint64_t wait_snapshot = wait_request_id_;
+  void RecordFrame(TranscriptEvent::Type type, const uint8_t* data, size_t size) {
+    if (trace_.recorder) trace_.recorder->Record(type, data, size);
+  }
 
-    if (inbound && !inbound->bytes.empty()) {
-      std::lock_guard<std::mutex> lock(mutex_);
-      inbound_queue_.push_back(inbound->bytes);
-      cv_.notify_all();
-    } else if (inbound && inbound->bytes.empty()) {
-      // Accept empty message as legitimate round data
-      std::lock_guard<std::mutex> lock(mutex_);
-      inbound_queue_.emplace_back();
-      cv_.notify_all();
-    }
+  void Fail(ErrorCode code, std::string message) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!fatal_) fatal_ = StoredError{code, std::move(message)};
+    aborted_ = true;
+    cv_.notify_all();
+  }
 
-    std::unique_lock<std::mutex> lock(mutex_);
+  bool IsDone() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return worker_done_ && !fatal_.has_value();
+  }
+
+  [[nodiscard]] bool HasFailure() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return fatal_.has_value();
+  }
+
+  [[nodiscard]] StoredError GetFailure() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return *fatal_;
+  }
+
+  void EnsureWorkerFinished() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    cv_.wait(lock, [&] { return worker_done_ || fatal_.has_value(); });
+    if (fatal_) {
+      auto err = *fatal_;
+      lock.unlock();
+      throw Error(err.code, err.message);
+    }
+  }
+
+  mutable std::mutex mutex_;
+  std::condition_variable cv_;
+  std::thread worker_;
+  bool worker_done_ = false;
+  bool aborted_ = false;
+  bool waiting_for_inbound_ = false;
+  std::optional<StoredError> fatal_;
+  SessionTrace trace_;
+  std::shared_ptr<LaneGate> gate_;
+  bool holds_lane_ = false;
+  const uint64_t timeline_id_ = timeline::NewSessionId();
+};
+
+class AsyncSession : public SessionWorker {
+ public:
+  ~AsyncSession() override { StopWorker(); }
+
+ protected:
+  ::error_t OnSend(mem_t msg) {
+    timeline::Instant("send", timeline_id_, "bytes", static_cast<uint64_t>(msg.size));
+    MAANY_MPC_PROBE2(send, timeline_id_, msg.size);
+    RecordFrame(TranscriptEvent::Type::Send, msg.data, msg.size);
+    std::vector<uint8_t> bytes(msg.data, msg.data + msg.size);
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      outbound_.emplace(std::move(bytes));
+    }
+    cv_.notify_all();
+    return SUCCESS;
+  }
+
+  ::error_t OnReceive(mem_t& msg) {
+    // Waiting on the peer leaves the lane's slot to a lane that can compute.
+    ReleaseLane();
+    std::unique_lock<std::mutex> lock(mutex_);
+    waiting_for_inbound_ = true;
+    ++wait_request_id_;
+    cv_.notify_all();
+    MAANY_MPC_PROBE1(receive_wait, timeline_id_);
+    {
+      timeline::Span wait("wait_peer", timeline_id_);
+      cv_.wait(lock, [&] { return !inbound_queue_.empty() || aborted_ || fatal_.has_value(); });
+    }
+    MAANY_MPC_PROBE2(receive_wake, timeline_id_, inbound_queue_.empty() ? size_t{0} : inbound_queue_.front().size());
+    if (fatal_) return E_GENERAL;
+    if (aborted_) return E_GENERAL;
+
+    inbound_active_ = std::move(inbound_queue_.front());
+    inbound_queue_.pop_front();
+    waiting_for_inbound_ = false;
+    timeline::Instant("receive", timeline_id_, "bytes", inbound_active_.size());
+    RecordFrame(TranscriptEvent::Type::Receive, inbound_active_.data(), inbound_active_.size());
+
+    msg = mem_t(inbound_active_.data(), static_cast<int>(inbound_active_.size()));
+    lock.unlock();
+    return AcquireLane() ? SUCCESS : E_GENERAL;
+  }
+
+  // A step that throws fires no step_exit; worker_end reports the failure.
+  StepOutput AwaitStep(const std::optional<BufferOwner>& inbound) {
+    timeline::Span span("step", timeline_id_);
+    MAANY_MPC_PROBE2(step_enter, timeline_id_, inbound ? inbound->bytes.size() : size_t{0});
+    StepOutput out = WaitForStepOutput(inbound);
+    MAANY_MPC_PROBE3(step_exit, timeline_id_, out.outbound ? out.outbound->bytes.size() : size_t{0},
+                     out.state == StepState::Done);
+    return out;
+  }
+
+  StepOutput WaitForStepOutput(const std::optional<BufferOwner>& inbound) {
+    const uint64_t wait_snapshot = wait_request_id_;
+
+    if (inbound && !inbound->bytes.empty()) {
+      std::lock_guard<std::mutex> lock(mutex_);
+      inbound_queue_.push_back(inbound->bytes);
+      cv_.notify_all();
+    } else if (inbound && inbound->bytes.empty()) {
+      // Accept empty message as legitimate round data
+      std::lock_guard<std::mutex> lock(mutex_);
+      inbound_queue_.emplace_back();
+      cv_.notify_all();
+    }
+
+    std::unique_lock<std::mutex> lock(mutex_);
     for (;;) {
       if (fatal_) {
         auto err = *fatal_;
@@ -373,44 +1187,12 @@ class AsyncSession {
     }
   }
 
-  void Fail(ErrorCode code, std::string message) {
-    std::lock_guard<std::mutex> lock(mutex_);
-    if (!fatal_) fatal_ = StoredError{code, std::move(message)};
-    aborted_ = true;
-    cv_.notify_all();
-  }
-
-  bool IsDone() const {
-    std::lock_guard<std::mutex> lock(mutex_);
-    return worker_done_ && !fatal_.has_value();
-  }
-
-  [[nodiscard]] bool HasFailure() const {
-    std::lock_guard<std::mutex> lock(mutex_);
-    return fatal_.has_value();
-  }
-
-  [[nodiscard]] StoredError GetFailure() const {
-    std::lock_guard<std::mutex> lock(mutex_);
-    return *fatal_;
-  }
-
   void PushInbound(std::vector<uint8_t> bytes) {
     std::lock_guard<std::mutex> lock(mutex_);
     inbound_queue_.push_back(std::move(bytes));
     cv_.notify_all();
   }
 
-  void EnsureWorkerFinished() {
-    std::unique_lock<std::mutex> lock(mutex_);
-    cv_.wait(lock, [&] { return worker_done_ || fatal_.has_value(); });
-    if (fatal_) {
-      auto err = *fatal_;
-      lock.unlock();
-      throw Error(err.code, err.message);
-    }
-  }
-
   bool waiting_for_inbound() const {
     std::lock_guard<std::mutex> lock(mutex_);
     return waiting_for_inbound_;
@@ -418,16 +1200,9 @@ class AsyncSession {
 
  protected:
   friend class FiberJob;
-  mutable std::mutex mutex_;
-  std::condition_variable cv_;
-  std::thread worker_;
-  bool worker_done_ = false;
-  bool aborted_ = false;
-  bool waiting_for_inbound_ = false;
   std::deque<std::vector<uint8_t>> inbound_queue_;
   std::vector<uint8_t> inbound_active_;
   std::optional<std::vector<uint8_t>> outbound_;
-  std::optional<StoredError> fatal_;
   uint64_t wait_request_id_ = 0;
 };
 
@@ -444,10 +1219,152 @@ class FiberJob final : public job_2p_t {
   AsyncSession& session_;
 };
 
+// Multi-party counterpart of AsyncSession. Inbound frames are queued per sender
+// and outbound frames are tagged with their destination; Step returns once the
+// worker is blocked on a peer whose queue is empty, so every frame of a round is
+// handed to the caller in one batch.
+class MultiPartySession : public SessionWorker {
+ public:
+  ~MultiPartySession() override { StopWorker(); }
+
+ protected:
+  ::error_t OnSend(uint32_t peer, mem_t msg) {
+    timeline::Instant("send", timeline_id_, "bytes", static_cast<uint64_t>(msg.size));
+    MAANY_MPC_PROBE2(send, timeline_id_, msg.size);
+    RecordFrame(TranscriptEvent::Type::Send, msg.data, msg.size);
+    PeerMessage frame;
+    frame.peer = peer;
+    frame.data.bytes.assign(msg.data, msg.data + msg.size);
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      outbound_.push_back(std::move(frame));
+    }
+    cv_.notify_all();
+    return SUCCESS;
+  }
+
+  ::error_t OnReceive(uint32_t peer, mem_t& msg) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    waiting_for_inbound_ = true;
+    awaiting_peer_ = peer;
+    cv_.notify_all();
+    MAANY_MPC_PROBE1(receive_wait, timeline_id_);
+    {
+      timeline::Span wait("wait_peer", timeline_id_);
+      cv_.wait(lock, [&] { return !inbound_[peer].empty() || aborted_ || fatal_.has_value(); });
+    }
+    MAANY_MPC_PROBE2(receive_wake, timeline_id_, inbound_[peer].empty() ? size_t{0} : inbound_[peer].front().size());
+    if (fatal_) return E_GENERAL;
+    if (aborted_) return E_GENERAL;
+
+    // cb-mpc may hold the views of several peers' frames at once while it
+    // collects a round, so each peer keeps its own active buffer.
+    auto& active = inbound_active_[peer];
+    active = std::move(inbound_[peer].front());
+    inbound_[peer].pop_front();
+    waiting_for_inbound_ = false;
+    timeline::Instant("receive", timeline_id_, "bytes", active.size());
+    RecordFrame(TranscriptEvent::Type::Receive, active.data(), active.size());
+
+    msg = mem_t(active.data(), static_cast<int>(active.size()));
+    return SUCCESS;
+  }
+
+  // A step that throws fires no step_exit; worker_end reports the failure.
+  MpStepOutput AwaitStep(const std::vector<PeerMessage>& inbound) {
+    timeline::Span span("step", timeline_id_);
+    MAANY_MPC_PROBE2(step_enter, timeline_id_, FrameBytes(inbound));
+    MpStepOutput out = WaitForStepOutput(inbound);
+    MAANY_MPC_PROBE3(step_exit, timeline_id_, FrameBytes(out.outbound), out.state == StepState::Done);
+    return out;
+  }
+
+  static size_t FrameBytes(const std::vector<PeerMessage>& frames) {
+    size_t bytes = 0;
+    for (const auto& frame : frames) bytes += frame.data.bytes.size();
+    return bytes;
+  }
+
+  MpStepOutput WaitForStepOutput(const std::vector<PeerMessage>& inbound) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    for (const auto& frame : inbound) inbound_[frame.peer].push_back(frame.data.bytes);
+    cv_.notify_all();
+
+    for (;;) {
+      if (fatal_) {
+        auto err = *fatal_;
+        lock.unlock();
+        throw Error(err.code, err.message);
+      }
+      const bool blocked = waiting_for_inbound_ && inbound_[awaiting_peer_].empty();
+      if (worker_done_ || blocked) {
+        MpStepOutput out;
+        out.outbound = std::move(outbound_);
+        outbound_.clear();
+        out.state = worker_done_ ? StepState::Done : StepState::Continue;
+        return out;
+      }
+      cv_.wait(lock);
+    }
+  }
+
+ protected:
+  friend class FiberJobMp;
+  uint32_t awaiting_peer_ = 0;
+  std::map<uint32_t, std::deque<std::vector<uint8_t>>> inbound_;
+  std::map<uint32_t, std::vector<uint8_t>> inbound_active_;
+  std::vector<PeerMessage> outbound_;
+};
+
+// job_mp_t over a subset of the threshold parties. cb-mpc indexes parties
+// 0..k-1 within the job; `parties` maps those local indices to the global
+// party indices used to tag frames on the wire.
+class FiberJobMp final : public job_mp_t {
+ public:
+  FiberJobMp(party_idx_t local_index, const std::vector<uint32_t>& parties, MultiPartySession& session)
+      : job_mp_t(local_index, PidsFor(parties)), parties_(parties), session_(session) {}
+
+ protected:
+  ::error_t send_impl(party_idx_t to, mem_t msg) override { return session_.OnSend(parties_.at(to), msg); }
+  ::error_t receive_impl(party_idx_t from, mem_t& msg) override {
+    return session_.OnReceive(parties_.at(from), msg);
+  }
+
+ private:
+  static std::vector<mpc_pid_t> PidsFor(const std::vector<uint32_t>& parties) {
+    std::vector<mpc_pid_t> pids;
+    pids.reserve(parties.size());
+    for (uint32_t index : parties) pids.push_back(pid_from_name(TnPartyName(index)));
+    return pids;
+  }
+
+  std::vector<uint32_t> parties_;
+  MultiPartySession& session_;
+};
+
+// The Paillier key pair is by far the largest part of a 2p share and never
+// changes under child derivation, so it is held separately and shared between a
+// parent and every keypair derived from it. key() carries the remaining share
+// fields with an empty paillier member; full_key() assembles a protocol-ready
+// copy for sessions. A null paillier marks a deferred DKG whose Paillier setup
+// has not run yet.
 class KeypairImpl final : public Keypair {
  public:
   KeypairImpl(ShareKind kind, Scheme scheme, Curve curve, KeyId id, key_t key)
-      : kind_(kind), scheme_(scheme), curve_(curve), key_id_(id), key_(std::move(key)) {}
+      : kind_(kind),
+        scheme_(scheme),
+        curve_(curve),
+        key_id_(id),
+        paillier_(std::make_shared<const coinbase::crypto::paillier_t>(std::move(key.paillier))),
+        key_(std::move(key)) {
+    key_.paillier = coinbase::crypto::paillier_t();
+  }
+
+  KeypairImpl(ShareKind kind, Scheme scheme, Curve curve, KeyId id, key_t key,
+              std::shared_ptr<const coinbase::crypto::paillier_t> paillier)
+      : kind_(kind), scheme_(scheme), curve_(curve), key_id_(id), paillier_(std::move(paillier)), key_(std::move(key)) {
+    key_.paillier = coinbase::crypto::paillier_t();
+  }
 
   ~KeypairImpl() override = default;
 
@@ -456,14 +1373,31 @@ class KeypairImpl final : public Keypair {
   Curve curve() const override { return curve_; }
   KeyId key_id() const override { return key_id_; }
 
-  key_t& key() { return key_; }
   const key_t& key() const { return key_; }
+  bool sign_ready() const { return paillier_ != nullptr; }
+  const coinbase::crypto::paillier_t& paillier() const {
+    EnsureSignReady();
+    return *paillier_;
+  }
+  const std::shared_ptr<const coinbase::crypto::paillier_t>& shared_paillier() const { return paillier_; }
+
+  key_t full_key() const {
+    EnsureSignReady();
+    key_t full = key_;
+    full.paillier = *paillier_;
+    return full;
+  }
 
  private:
+  void EnsureSignReady() const {
+    if (!paillier_) throw Error(ErrorCode::ProtocolState, "Paillier setup for this key has not completed");
+  }
+
   ShareKind kind_;
   Scheme scheme_;
   Curve curve_;
   KeyId key_id_;
+  std::shared_ptr<const coinbase::crypto::paillier_t> paillier_;
   key_t key_;
 };
 
@@ -471,23 +1405,28 @@ class ContextImpl;
 
 class DkgSessionImpl final : public DkgSession, private AsyncSession {
  public:
-  DkgSessionImpl(const DkgOptions& opts)
+  DkgSessionImpl(const DkgOptions& opts, SessionTrace trace = {}, std::shared_ptr<LaneGate> gate = nullptr)
       : opts_(opts),
         curve_(ToCbCurve(opts.curve)),
         party_(ToParty(opts.kind)),
         job_(std::make_unique<FiberJob>(party_, static_cast<AsyncSession&>(*this))) {
     if (opts.scheme != Scheme::Ecdsa2p) throw Error(ErrorCode::Unsupported, "only ECDSA 2p supported");
-    StartWorker([this]() { Worker(); });
+    AttachTrace(std::move(trace));
+    AttachGate(std::move(gate));
+    StartWorker(SessionType::Dkg, [this]() { Worker(); });
   }
 
-  ~DkgSessionImpl() override = default;
+  ~DkgSessionImpl() override { StopWorker(); }
 
   StepOutput Step(const std::optional<BufferOwner>& inbound) override { return AwaitStep(inbound); }
 
   std::unique_ptr<Keypair> Finalize() override {
+    timeline::Span span("finalize", timeline_id_);
     EnsureWorkerFinished();
     if (!key_ready_) throw Error(ErrorCode::ProtocolState, "DKG not complete");
     key_ready_ = false;
+    if (opts_.defer_paillier)
+      return std::make_unique<KeypairImpl>(opts_.kind, opts_.scheme, opts_.curve, opts_.key_id, key_, nullptr);
     return std::make_unique<KeypairImpl>(opts_.kind, opts_.scheme, opts_.curve, opts_.key_id, key_);
   }
 
@@ -496,12 +1435,222 @@ class DkgSessionImpl final : public DkgSession, private AsyncSession {
     key_t tmp;
     tmp.role = party_;
     tmp.curve = curve_;
-    auto rv = dkg(*job_, curve_, tmp);
+    if (opts_.defer_paillier) {
+      coinbase::mpc::eckey::key_share_2p_t ec_key;
+      auto rv = ProtocolCall("eckey::key_share_2p_t::dkg", profile::Primitive::Cbmpc2pDkg,
+                             [&] { return coinbase::mpc::eckey::key_share_2p_t::dkg(*job_, curve_, ec_key); });
+      if (rv != SUCCESS) {
+        Fail(MapError(rv), FormatError(rv, "eckey::key_share_2p_t::dkg"));
+        return;
+      }
+      tmp.Q = ec_key.Q;
+      tmp.x_share = ec_key.x_share;
+    } else {
+      auto rv = ProtocolCall("ecdsa2pc::dkg", profile::Primitive::Cbmpc2pDkg, [&] { return dkg(*job_, curve_, tmp); });
+      if (rv != SUCCESS) {
+        Fail(MapError(rv), FormatError(rv, "ecdsa2pc::dkg"));
+        return;
+      }
+    }
+
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      key_ = std::move(tmp);
+      key_ready_ = true;
+    }
+    cv_.notify_all();
+  }
+
+  DkgOptions opts_;
+  ecurve_t curve_;
+  party_t party_;
+  std::unique_ptr<FiberJob> job_;
+  key_t key_{};
+  bool key_ready_ = false;
+};
+
+// Runs several independent 2p sessions (DKGs or refreshes) as lanes of one
+// session. The lanes follow the same message schedule, so each round's messages
+// are coalesced into one frame: u32 lane count, then per lane a presence byte,
+// u32 length and payload. Every lane keeps its own worker, so the expensive
+// parts (Paillier generation, proofs) proceed in parallel while the caller waits
+// on a single round-trip; a LaneGate sized to the context's task pool bounds how
+// many of them compute at once. FinalizeMany is all-or-nothing: if any lane fails, the
+// keys already collected are dropped with the exception.
+class BatchSessionImpl final : public DkgSession {
+ public:
+  explicit BatchSessionImpl(std::vector<std::unique_ptr<DkgSession>> lanes) : lanes_(std::move(lanes)) {
+    if (lanes_.size() < 2 || lanes_.size() > kMaxBatchLanes)
+      throw Error(ErrorCode::InvalidArgument, "batch size out of range");
+    done_.assign(lanes_.size(), false);
+  }
+
+  ~BatchSessionImpl() override = default;
+
+  StepOutput Step(const std::optional<BufferOwner>& inbound) override {
+    std::vector<std::optional<BufferOwner>> parts(lanes_.size());
+    if (inbound) parts = DecodeFrame(*inbound);
+
+    std::vector<std::optional<BufferOwner>> outbound(lanes_.size());
+    bool any_outbound = false;
+    for (size_t i = 0; i < lanes_.size(); ++i) {
+      if (done_[i]) {
+        if (parts[i]) throw Error(ErrorCode::ProtocolState, "batch frame addressed a finished lane");
+        continue;
+      }
+      // Lanes advance in lockstep; a live lane missing from a peer frame would wait forever.
+      if (inbound && !parts[i]) throw Error(ErrorCode::ProtocolState, "batch frame skipped a live lane");
+      auto out = lanes_[i]->Step(parts[i]);
+      done_[i] = out.state == StepState::Done;
+      if (out.outbound) {
+        outbound[i] = std::move(out.outbound);
+        any_outbound = true;
+      }
+    }
+
+    StepOutput out;
+    out.state = std::all_of(done_.begin(), done_.end(), [](bool d) { return d; }) ? StepState::Done
+                                                                                   : StepState::Continue;
+    if (any_outbound) out.outbound = EncodeFrame(outbound);
+    return out;
+  }
+
+  std::unique_ptr<Keypair> Finalize() override {
+    throw Error(ErrorCode::InvalidArgument, "batch session produces several keys; use FinalizeMany");
+  }
+
+  std::vector<std::unique_ptr<Keypair>> FinalizeMany() override {
+    std::vector<std::unique_ptr<Keypair>> keys;
+    keys.reserve(lanes_.size());
+    for (auto& lane : lanes_) keys.push_back(lane->Finalize());
+    return keys;
+  }
+
+ private:
+  static BufferOwner EncodeFrame(const std::vector<std::optional<BufferOwner>>& parts) {
+    std::vector<uint8_t> frame;
+    AppendU32(frame, static_cast<uint32_t>(parts.size()));
+    for (const auto& part : parts) {
+      frame.push_back(part ? 1 : 0);
+      if (!part) continue;
+      AppendU32(frame, static_cast<uint32_t>(part->bytes.size()));
+      frame.insert(frame.end(), part->bytes.begin(), part->bytes.end());
+    }
+    return MakeBuffer(std::move(frame));
+  }
+
+  std::vector<std::optional<BufferOwner>> DecodeFrame(const BufferOwner& frame) const {
+    const auto& bytes = frame.bytes;
+    size_t offset = 0;
+    auto read_u32 = [&]() { return ReadU32(bytes, offset, "batch frame truncated"); };
+
+    Ensure(read_u32() == lanes_.size(), ErrorCode::InvalidArgument, "batch lane count mismatch");
+    std::vector<std::optional<BufferOwner>> parts(lanes_.size());
+    for (auto& part : parts) {
+      Ensure(offset < bytes.size(), ErrorCode::InvalidArgument, "batch frame truncated");
+      const uint8_t present = bytes[offset++];
+      Ensure(present <= 1, ErrorCode::InvalidArgument, "batch frame malformed");
+      if (!present) continue;
+      const uint32_t len = read_u32();
+      Ensure(bytes.size() - offset >= len, ErrorCode::InvalidArgument, "batch frame truncated");
+      part = MakeBuffer(std::vector<uint8_t>(bytes.begin() + offset, bytes.begin() + offset + len));
+      offset += len;
+    }
+    Ensure(offset == bytes.size(), ErrorCode::InvalidArgument, "batch frame has trailing bytes");
+    return parts;
+  }
+
+  std::vector<std::unique_ptr<DkgSession>> lanes_;
+  std::vector<bool> done_;
+};
+
+// Second phase of a deferred DKG. A full ecdsa2pc::dkg yields a Paillier key
+// and c_aux = Enc(x1') with cb-mpc's proofs that it encrypts dlog(Q1'). The
+// device then sends d = (x1 - x1') mod q, which is uniform whatever x1 is, and
+// c_key = Enc(x1) with a proof that it is c_aux shifted by d (see
+// paillier_shift.h). The server checks Q1' + d*G == Q1 and the proof. Both
+// shares stay in [0, q); the auxiliary key is discarded.
+class PaillierSetupSessionImpl final : public DkgSession, private AsyncSession {
+ public:
+  explicit PaillierSetupSessionImpl(const KeypairImpl& kp)
+      : kind_(kp.kind()),
+        scheme_(kp.scheme()),
+        curve_(kp.key().curve),
+        party_(ToParty(kp.kind())),
+        key_id_(kp.key_id()),
+        ec_key_(kp.key()),
+        job_(std::make_unique<FiberJob>(party_, static_cast<AsyncSession&>(*this))) {
+    if (kp.sign_ready()) throw Error(ErrorCode::ProtocolState, "Paillier setup already complete");
+    StartWorker(SessionType::PaillierSetup, [this]() { Worker(); });
+  }
+
+  ~PaillierSetupSessionImpl() override { StopWorker(); }
+
+  StepOutput Step(const std::optional<BufferOwner>& inbound) override { return AwaitStep(inbound); }
+
+  std::unique_ptr<Keypair> Finalize() override {
+    timeline::Span span("finalize", timeline_id_);
+    EnsureWorkerFinished();
+    if (!key_ready_) throw Error(ErrorCode::ProtocolState, "Paillier setup not complete");
+    key_ready_ = false;
+    return std::make_unique<KeypairImpl>(kind_, scheme_, FromCbCurve(curve_), key_id_, std::move(key_));
+  }
+
+ private:
+  void Worker() {
+    key_t aux;
+    aux.role = party_;
+    aux.curve = curve_;
+    auto rv = ProtocolCall("ecdsa2pc::dkg", profile::Primitive::Cbmpc2pDkg, [&] { return dkg(*job_, curve_, aux); });
     if (rv != SUCCESS) {
       Fail(MapError(rv), FormatError(rv, "ecdsa2pc::dkg"));
       return;
     }
 
+    const mod_t& q = curve_.order();
+    const bn_t& q_bn = q;
+    const auto& G = curve_.generator();
+    const auto q_bin = ec_key_.Q.to_compressed_bin();
+    std::vector<uint8_t> binding(key_id_.bytes.begin(), key_id_.bytes.end());
+    binding.insert(binding.end(), q_bin.data(), q_bin.data() + q_bin.size());
+    const mem_t bound(binding.data(), static_cast<int>(binding.size()));
+    bn_t d;
+    bn_t c_key;
+    PaillierShiftProof proof;
+    if (party_ == party_t::p1) {
+      d = (ec_key_.x_share + q_bn - aux.x_share) % q;
+      profile::Timer timer(profile::Primitive::PaillierHomomorphic);
+      c_key = ShiftPaillierShare(aux.paillier, aux.c_key, aux.x_share, d, q, bound, proof);
+    }
+    rv = job_->p1_to_p2(d, c_key, proof);
+    if (rv != SUCCESS) {
+      Fail(MapError(rv), FormatError(rv, "paillier setup offset"));
+      return;
+    }
+
+    if (party_ == party_t::p2) {
+      bool valid;
+      {
+        profile::Timer timer(profile::Primitive::EcMul);
+        const auto Q1 = ec_key_.Q - ec_key_.x_share * G;
+        const auto aux_Q1 = aux.Q - aux.x_share * G;
+        valid = !(d < 0) && d < q_bn && aux_Q1 + d * G == Q1;
+      }
+      if (valid) {
+        profile::Timer timer(profile::Primitive::PaillierHomomorphic);
+        valid = VerifyPaillierShift(aux.paillier, aux.c_key, d, q, c_key, bound, proof);
+      }
+      if (!valid) {
+        Fail(ErrorCode::Crypto, "Paillier setup offset does not match the device share");
+        return;
+      }
+    }
+
+    key_t tmp = ec_key_;
+    tmp.c_key = c_key;
+    tmp.paillier = std::move(aux.paillier);
+    aux.x_share = 0;
+
     {
       std::lock_guard<std::mutex> lock(mutex_);
       key_ = std::move(tmp);
@@ -510,47 +1659,96 @@ class DkgSessionImpl final : public DkgSession, private AsyncSession {
     cv_.notify_all();
   }
 
-  DkgOptions opts_;
+  ShareKind kind_;
+  Scheme scheme_;
   ecurve_t curve_;
   party_t party_;
-  std::unique_ptr<FiberJob> job_;
+  KeyId key_id_;
+  key_t ec_key_;
   key_t key_{};
+  std::unique_ptr<FiberJob> job_;
   bool key_ready_ = false;
 };
 
+// Commitment for the lightweight refresh coin toss: SHA-256(sid | Q | r1 | salt).
+// Binding Q makes the server reject a device that pairs the toss with another
+// key, which matters once several keys are refreshed in one batch.
+std::vector<uint8_t> CommitRefreshShare(const std::vector<uint8_t>& sid, const coinbase::crypto::ecc_point_t& Q,
+                                        const bn_t& r1, const std::vector<uint8_t>& salt, int scalar_size) {
+  profile::Timer timer(profile::Primitive::Hash);
+  auto r1_bin = r1.to_bin(scalar_size);
+  auto q_bin = Q.to_compressed_bin();
+  std::vector<uint8_t> preimage(sid);
+  preimage.insert(preimage.end(), q_bin.data(), q_bin.data() + q_bin.size());
+  preimage.insert(preimage.end(), r1_bin.data(), r1_bin.data() + r1_bin.size());
+  preimage.insert(preimage.end(), salt.begin(), salt.end());
+  std::vector<uint8_t> digest(32);
+  unsigned int digest_len = 0;
+  if (EVP_Digest(preimage.data(), preimage.size(), digest.data(), &digest_len, EVP_sha256(), nullptr) != 1 ||
+      digest_len != digest.size())
+    throw Error(ErrorCode::Crypto, "refresh commitment failed");
+  r1_bin.secure_bzero();
+  std::fill(preimage.begin(), preimage.end(), 0);
+  return digest;
+}
+
+// A coin-toss contribution received from the peer must be a scalar in [0, q).
+bool CoinTossShareValid(const bn_t& r, const bn_t& q) { return !(r < 0) && r < q; }
+
 class RefreshSessionImpl final : public DkgSession, private AsyncSession {
  public:
-  RefreshSessionImpl(const KeypairImpl& kp, const RefreshOptions& opts)
+  // Lightweight refresh draws its coin toss from `rng`, except under a trace
+  // seed, where the seeded RAND keeps the session replayable.
+  RefreshSessionImpl(const KeypairImpl& kp, const RefreshOptions& opts, RngCallback rng, SessionTrace trace = {},
+                     std::shared_ptr<LaneGate> gate = nullptr)
       : kind_(kp.kind()),
         scheme_(kp.scheme()),
         curve_(kp.key().curve),
         party_(ToParty(kp.kind())),
         key_id_(kp.key_id()),
-        existing_key_(kp.key()),
+        opts_(opts),
         job_(std::make_unique<FiberJob>(party_, static_cast<AsyncSession&>(*this))) {
     if (scheme_ != Scheme::Ecdsa2p) throw Error(ErrorCode::Unsupported, "only ECDSA 2p refresh supported");
-    (void)opts;
-    StartWorker([this]() { Worker(); });
+    if (opts_.reuse_paillier) {
+      existing_key_ = kp.key();
+      paillier_ = kp.shared_paillier();
+      if (!paillier_) throw Error(ErrorCode::ProtocolState, "Paillier setup for this key has not completed");
+    } else {
+      existing_key_ = kp.full_key();
+    }
+    if (!trace.seed) rng_ = std::move(rng);
+    AttachTrace(std::move(trace));
+    AttachGate(std::move(gate));
+    StartWorker(SessionType::Refresh, [this]() { Worker(); });
   }
 
-  ~RefreshSessionImpl() override = default;
+  ~RefreshSessionImpl() override { StopWorker(); }
 
   StepOutput Step(const std::optional<BufferOwner>& inbound) override { return AwaitStep(inbound); }
 
   std::unique_ptr<Keypair> Finalize() override {
+    timeline::Span span("finalize", timeline_id_);
     EnsureWorkerFinished();
     if (!key_ready_) throw Error(ErrorCode::ProtocolState, "refresh not complete");
     key_ready_ = false;
+    if (opts_.reuse_paillier)
+      return std::make_unique<KeypairImpl>(kind_, scheme_, FromCbCurve(curve_), key_id_, key_, paillier_);
     return std::make_unique<KeypairImpl>(kind_, scheme_, FromCbCurve(curve_), key_id_, key_);
   }
 
  private:
   void Worker() {
+    if (opts_.reuse_paillier) {
+      LightweightRefresh();
+      return;
+    }
+
     key_t tmp;
     tmp.role = party_;
     tmp.curve = curve_;
     tmp.Q = existing_key_.Q;
-    auto rv = coinbase::mpc::ecdsa2pc::refresh(*job_, existing_key_, tmp);
+    auto rv = ProtocolCall("ecdsa2pc::refresh", profile::Primitive::Cbmpc2pRefresh,
+                           [&] { return coinbase::mpc::ecdsa2pc::refresh(*job_, existing_key_, tmp); });
     if (rv != SUCCESS) {
       Fail(MapError(rv), FormatError(rv, "ecdsa2pc::refresh"));
       return;
@@ -564,30 +1762,387 @@ class RefreshSessionImpl final : public DkgSession, private AsyncSession {
     cv_.notify_all();
   }
 
+  // Coin-toss r = r1 + r2 mod q (device commits to r1 before seeing r2), then
+  // x1' = (x1 + r) mod q and x2' = (x2 - r) mod q under the same Paillier key.
+  // Whether x1 + r wraps depends on x1, so the device sends c_key' = Enc(x1')
+  // with its reveal and proves it is c_key shifted by r (paillier_shift.h).
+  void LightweightRefresh() {
+    const mod_t& q = curve_.order();
+    const bn_t& q_bn = q;
+    const int scalar_size = q.get_bin_size();
+    const auto& sid = opts_.session_id.bytes;
+    const auto q_bin = existing_key_.Q.to_compressed_bin();
+    std::vector<uint8_t> binding(sid);
+    binding.insert(binding.end(), key_id_.bytes.begin(), key_id_.bytes.end());
+    binding.insert(binding.end(), q_bin.data(), q_bin.data() + q_bin.size());
+    const mem_t bound(binding.data(), static_cast<int>(binding.size()));
+
+    bn_t r1, r2;
+    std::vector<uint8_t> salt;
+    coinbase::buf_t commitment, salt_buf;
+    if (party_ == party_t::p1) {
+      r1 = DrawRandomScalar(rng_, q);
+      salt = DrawRandom(rng_, kRefreshSaltSize);
+      auto digest = CommitRefreshShare(sid, existing_key_.Q, r1, salt, scalar_size);
+      commitment = coinbase::buf_t(mem_t(digest.data(), static_cast<int>(digest.size())));
+    } else {
+      r2 = DrawRandomScalar(rng_, q);
+    }
+
+    auto rv = job_->p1_to_p2(commitment);
+    if (rv == SUCCESS) rv = job_->p2_to_p1(r2);
+    bn_t r;
+    bn_t c_key;
+    PaillierShiftProof proof;
+    if (party_ == party_t::p1 && rv == SUCCESS) {
+      if (!CoinTossShareValid(r2, q_bn)) {
+        Fail(ErrorCode::Crypto, "lightweight refresh contribution out of range");
+        return;
+      }
+      r = (r1 + r2) % q;
+      salt_buf = coinbase::buf_t(mem_t(salt.data(), static_cast<int>(salt.size())));
+      profile::Timer timer(profile::Primitive::PaillierHomomorphic);
+      c_key = ShiftPaillierShare(*paillier_, existing_key_.c_key, existing_key_.x_share, r, q, bound, proof);
+    }
+    if (rv == SUCCESS) rv = job_->p1_to_p2(r1, salt_buf, c_key, proof);
+    if (rv != SUCCESS) {
+      Fail(MapError(rv), FormatError(rv, "lightweight refresh"));
+      return;
+    }
+
+    if (party_ == party_t::p2) {
+      if (salt_buf.size() != static_cast<int>(kRefreshSaltSize) || !CoinTossShareValid(r1, q_bn)) {
+        Fail(ErrorCode::Crypto, "lightweight refresh reveal malformed");
+        return;
+      }
+      std::vector<uint8_t> revealed_salt(salt_buf.data(), salt_buf.data() + salt_buf.size());
+      auto expected = CommitRefreshShare(sid, existing_key_.Q, r1, revealed_salt, scalar_size);
+      if (commitment.size() != static_cast<int>(expected.size()) ||
+          std::memcmp(commitment.data(), expected.data(), expected.size()) != 0) {
+        Fail(ErrorCode::Crypto, "lightweight refresh commitment mismatch");
+        return;
+      }
+      r = (r1 + r2) % q;
+      bool valid;
+      {
+        profile::Timer timer(profile::Primitive::PaillierHomomorphic);
+        valid = VerifyPaillierShift(*paillier_, existing_key_.c_key, r, q, c_key, bound, proof);
+      }
+      if (!valid) {
+        Fail(ErrorCode::Crypto, "lightweight refresh ciphertext does not match the coin toss");
+        return;
+      }
+    }
+
+    key_t tmp = existing_key_;
+    tmp.c_key = c_key;
+    if (party_ == party_t::p1) {
+      tmp.x_share = (existing_key_.x_share + r) % q;
+    } else {
+      tmp.x_share = (existing_key_.x_share + q_bn - r) % q;
+    }
+    r1 = 0;
+    r2 = 0;
+    r = 0;
+
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      key_ = std::move(tmp);
+      key_ready_ = true;
+    }
+    cv_.notify_all();
+  }
+
   ShareKind kind_;
   Scheme scheme_;
   ecurve_t curve_;
   party_t party_;
   KeyId key_id_;
+  RefreshOptions opts_;
+  RngCallback rng_;
   key_t existing_key_;
+  std::shared_ptr<const coinbase::crypto::paillier_t> paillier_;
   key_t key_{};
   std::unique_ptr<FiberJob> job_;
   bool key_ready_ = false;
 };
 
-class SignSessionImpl final : public SignSession, private AsyncSession {
+class SignSessionImpl final : public SignSession, private AsyncSession {
+ public:
+  SignSessionImpl(const KeypairImpl& kp, const SignOptions& opts, SessionTrace trace = {})
+      : opts_(opts),
+        curve_(kp.key().curve),
+        party_(ToParty(kp.kind())),
+        key_(kp.full_key()),
+        job_(std::make_unique<FiberJob>(party_, static_cast<AsyncSession&>(*this))) {
+    if (opts.scheme != Scheme::Ecdsa2p) throw Error(ErrorCode::Unsupported, "only ECDSA 2p sign supported");
+    AttachTrace(std::move(trace));
+    StartWorker(SessionType::Sign, [this]() { Worker(); });
+  }
+
+  ~SignSessionImpl() override {
+    StopWorker();
+    std::fill(signature_der_.bytes.begin(), signature_der_.bytes.end(), 0);
+    std::fill(signature_raw_.bytes.begin(), signature_raw_.bytes.end(), 0);
+  }
+
+  void SetMessage(const uint8_t* msg, size_t len) override {
+    if (!msg || len == 0) throw Error(ErrorCode::InvalidArgument, "message required");
+    std::lock_guard<std::mutex> lock(message_mutex_);
+    if (message_ready_) throw Error(ErrorCode::ProtocolState, "message already set");
+    message_.assign(msg, msg + len);
+    message_ready_ = true;
+    message_cv_.notify_all();
+  }
+
+  StepOutput Step(const std::optional<BufferOwner>& inbound) override { return AwaitStep(inbound); }
+
+  BufferOwner Finalize(SigFormat fmt) override {
+    timeline::Span span("finalize", timeline_id_);
+    EnsureWorkerFinished();
+    if (party_ != party_t::p1) throw Error(ErrorCode::ProtocolState, "signature finalize not available for this share");
+    BufferOwner out;
+    {
+      std::lock_guard<std::mutex> guard(result_mutex_);
+      if (!signature_ready_) throw Error(ErrorCode::ProtocolState, "signature not ready");
+      const std::vector<uint8_t>& src = (fmt == SigFormat::Der) ? signature_der_.bytes : signature_raw_.bytes;
+      if (src.empty()) throw Error(ErrorCode::ProtocolState, "requested signature format unavailable");
+      out.bytes = src;
+    }
+    return out;
+  }
+
+ private:
+  void Worker() {
+    std::unique_lock<std::mutex> lock(message_mutex_);
+    message_cv_.wait(lock, [&] { return message_ready_ || fatal_.has_value() || aborted_; });
+    if (!message_ready_) return;
+    std::vector<uint8_t> msg = std::move(message_);
+    message_.clear();
+    message_ready_ = false;
+    lock.unlock();
+    if (trace_.recorder) trace_.recorder->SetMessage(msg);
+
+    coinbase::mem_t msg_mem(msg.data(), static_cast<int>(msg.size()));
+
+    coinbase::buf_t sid_buf;
+    if (!opts_.session_id.bytes.empty()) {
+      sid_buf = coinbase::buf_t(static_cast<int>(opts_.session_id.bytes.size()));
+      std::memcpy(sid_buf.data(), opts_.session_id.bytes.data(), opts_.session_id.bytes.size());
+    }
+
+    coinbase::buf_t sig_buf;
+    auto rv = ProtocolCall("ecdsa2pc::sign", profile::Primitive::Cbmpc2pSign,
+                           [&] { return coinbase::mpc::ecdsa2pc::sign(*job_, sid_buf, key_, msg_mem, sig_buf); });
+    if (rv != SUCCESS) {
+      Fail(MapError(rv), FormatError(rv, "ecdsa2pc::sign"));
+      return;
+    }
+
+    if (sig_buf.size() == 0) {
+      sig_buf.secure_bzero();
+      std::fill(msg.begin(), msg.end(), 0);
+      cv_.notify_all();
+      return;
+    }
+
+    signature_der_.bytes.assign(sig_buf.data(), sig_buf.data() + sig_buf.size());
+    sig_buf.secure_bzero();
+
+    coinbase::crypto::ecdsa_signature_t parsed;
+    rv = parsed.from_der(curve_, coinbase::mem_t(signature_der_.bytes.data(),
+                                                static_cast<int>(signature_der_.bytes.size())));
+    if (rv) {
+      Fail(MapError(rv), FormatError(rv, "ecdsa_signature_t::from_der"));
+      return;
+    }
+
+    const auto order = curve_.order();
+    int coord_size = order.get_bin_size();
+    coinbase::buf_t r_bin = parsed.get_r().to_bin(coord_size);
+    coinbase::buf_t s_bin = parsed.get_s().to_bin(coord_size);
+    signature_raw_.bytes.resize(static_cast<size_t>(coord_size) * 2);
+    std::memcpy(signature_raw_.bytes.data(), r_bin.data(), coord_size);
+    std::memcpy(signature_raw_.bytes.data() + coord_size, s_bin.data(), coord_size);
+    r_bin.secure_bzero();
+    s_bin.secure_bzero();
+
+    std::fill(msg.begin(), msg.end(), 0);
+
+    {
+      std::lock_guard<std::mutex> guard(result_mutex_);
+      signature_ready_ = true;
+    }
+    cv_.notify_all();
+  }
+
+  SignOptions opts_;
+  coinbase::crypto::ecurve_t curve_;
+  party_t party_;
+  key_t key_;
+  std::unique_ptr<FiberJob> job_;
+
+  std::mutex message_mutex_;
+  std::condition_variable message_cv_;
+  std::vector<uint8_t> message_;
+  bool message_ready_ = false;
+
+  std::mutex result_mutex_;
+  bool signature_ready_ = false;
+  BufferOwner signature_der_;
+  BufferOwner signature_raw_;
+};
+
+class ThresholdKeypairImpl final : public Keypair {
+ public:
+  ThresholdKeypairImpl(uint32_t party_index, uint32_t party_count, uint32_t threshold, Curve curve, KeyId id, TnKey key)
+      : party_index_(party_index),
+        party_count_(party_count),
+        threshold_(threshold),
+        curve_(curve),
+        key_id_(id),
+        key_(std::move(key)) {}
+
+  ~ThresholdKeypairImpl() override = default;
+
+  ShareKind kind() const override { return TnShareKind(party_index_); }
+  Scheme scheme() const override { return Scheme::EcdsaThresholdN; }
+  Curve curve() const override { return curve_; }
+  KeyId key_id() const override { return key_id_; }
+
+  uint32_t party_index() const { return party_index_; }
+  uint32_t party_count() const { return party_count_; }
+  uint32_t threshold() const { return threshold_; }
+  const TnKey& key() const { return key_; }
+
+ private:
+  uint32_t party_index_;
+  uint32_t party_count_;
+  uint32_t threshold_;
+  Curve curve_;
+  KeyId key_id_;
+  TnKey key_;
+};
+
+// Builds the t-of-n access structure over all parties of a threshold key.
+coinbase::crypto::ss::ac_owned_t ThresholdAccessStructure(uint32_t party_count, uint32_t threshold) {
+  using coinbase::crypto::ss::node_e;
+  using coinbase::crypto::ss::node_t;
+  auto* root = new node_t(node_e::THRESHOLD, "", static_cast<int>(threshold));
+  for (uint32_t i = 0; i < party_count; ++i) root->add_child_node(new node_t(node_e::LEAF, TnPartyName(i)));
+  return coinbase::crypto::ss::ac_owned_t(root);
+}
+
+std::vector<uint32_t> AllParties(uint32_t party_count) {
+  std::vector<uint32_t> parties(party_count);
+  for (uint32_t i = 0; i < party_count; ++i) parties[i] = i;
+  return parties;
+}
+
+party_idx_t LocalIndex(const std::vector<uint32_t>& parties, uint32_t party_index) {
+  auto it = std::find(parties.begin(), parties.end(), party_index);
+  if (it == parties.end()) throw Error(ErrorCode::InvalidArgument, "party is not part of the session");
+  return static_cast<party_idx_t>(it - parties.begin());
+}
+
+void CheckInboundPeers(const std::vector<PeerMessage>& inbound, const std::vector<uint32_t>& parties, uint32_t self) {
+  for (const auto& frame : inbound) {
+    if (frame.peer == self || std::find(parties.begin(), parties.end(), frame.peer) == parties.end())
+      throw Error(ErrorCode::InvalidArgument, "inbound frame from unknown peer");
+  }
+}
+
+class ThresholdDkgSessionImpl final : public MpDkgSession, private MultiPartySession {
+ public:
+  explicit ThresholdDkgSessionImpl(const ThresholdDkgOptions& opts, SessionTrace trace = {})
+      : opts_(opts), curve_(ToCbCurve(opts.curve)), parties_(AllParties(opts.party_count)) {
+    if (opts.party_count < 2) throw Error(ErrorCode::InvalidArgument, "party_count must be >= 2");
+    if (opts.threshold < 2 || opts.threshold > opts.party_count)
+      throw Error(ErrorCode::InvalidArgument, "threshold must be in [2, party_count]");
+    if (opts.party_index >= opts.party_count) throw Error(ErrorCode::InvalidArgument, "party_index out of range");
+    job_ = std::make_unique<FiberJobMp>(LocalIndex(parties_, opts.party_index), parties_,
+                                        static_cast<MultiPartySession&>(*this));
+    AttachTrace(std::move(trace));
+    StartWorker(SessionType::ThresholdDkg, [this]() { Worker(); });
+  }
+
+  ~ThresholdDkgSessionImpl() override { StopWorker(); }
+
+  MpStepOutput Step(const std::vector<PeerMessage>& inbound) override {
+    CheckInboundPeers(inbound, parties_, opts_.party_index);
+    return AwaitStep(inbound);
+  }
+
+  std::unique_ptr<Keypair> Finalize() override {
+    timeline::Span span("finalize", timeline_id_);
+    EnsureWorkerFinished();
+    if (!key_ready_) throw Error(ErrorCode::ProtocolState, "threshold DKG not complete");
+    key_ready_ = false;
+    return std::make_unique<ThresholdKeypairImpl>(opts_.party_index, opts_.party_count, opts_.threshold, opts_.curve,
+                                                  opts_.key_id, key_);
+  }
+
+ private:
+  void Worker() {
+    coinbase::buf_t sid;
+    if (!opts_.session_id.bytes.empty()) {
+      sid = coinbase::buf_t(static_cast<int>(opts_.session_id.bytes.size()));
+      std::memcpy(sid.data(), opts_.session_id.bytes.data(), opts_.session_id.bytes.size());
+    }
+    auto ac = ThresholdAccessStructure(opts_.party_count, opts_.threshold);
+    party_set_t quorum;
+    for (uint32_t i = 0; i < opts_.party_count; ++i) quorum.add(static_cast<party_idx_t>(i));
+
+    TnKey tmp;
+    auto rv = ProtocolCall("eckey::threshold_dkg", profile::Primitive::CbmpcTnDkg, [&] {
+      return coinbase::mpc::eckey::key_share_mp_t::threshold_dkg(*job_, curve_, sid, ac, quorum, tmp);
+    });
+    if (rv != SUCCESS) {
+      Fail(MapError(rv), FormatError(rv, "eckey::threshold_dkg"));
+      return;
+    }
+
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      key_ = std::move(tmp);
+      key_ready_ = true;
+    }
+    cv_.notify_all();
+  }
+
+  ThresholdDkgOptions opts_;
+  ecurve_t curve_;
+  std::vector<uint32_t> parties_;
+  std::unique_ptr<FiberJobMp> job_;
+  TnKey key_{};
+  bool key_ready_ = false;
+};
+
+class ThresholdSignSessionImpl final : public MpSignSession, private MultiPartySession {
  public:
-  SignSessionImpl(const KeypairImpl& kp, const SignOptions& opts)
+  ThresholdSignSessionImpl(const ThresholdKeypairImpl& kp, const ThresholdSignOptions& opts, SessionTrace trace = {})
       : opts_(opts),
+        party_index_(kp.party_index()),
+        party_count_(kp.party_count()),
+        threshold_(kp.threshold()),
         curve_(kp.key().curve),
-        party_(ToParty(kp.kind())),
         key_(kp.key()),
-        job_(std::make_unique<FiberJob>(party_, static_cast<AsyncSession&>(*this))) {
-    if (opts.scheme != Scheme::Ecdsa2p) throw Error(ErrorCode::Unsupported, "only ECDSA 2p sign supported");
-    StartWorker([this]() { Worker(); });
+        signers_(opts.signers) {
+    std::sort(signers_.begin(), signers_.end());
+    if (std::adjacent_find(signers_.begin(), signers_.end()) != signers_.end())
+      throw Error(ErrorCode::InvalidArgument, "duplicate signer index");
+    if (signers_.size() < threshold_) throw Error(ErrorCode::InvalidArgument, "not enough signers for threshold");
+    if (!signers_.empty() && signers_.back() >= party_count_)
+      throw Error(ErrorCode::InvalidArgument, "signer index out of range");
+    job_ = std::make_unique<FiberJobMp>(LocalIndex(signers_, party_index_), signers_,
+                                        static_cast<MultiPartySession&>(*this));
+    sig_receiver_ = LocalIndex(signers_, opts.sig_receiver);
+    AttachTrace(std::move(trace));
+    StartWorker(SessionType::ThresholdSign, [this]() { Worker(); });
   }
 
-  ~SignSessionImpl() override {
+  ~ThresholdSignSessionImpl() override {
+    StopWorker();
     std::fill(signature_der_.bytes.begin(), signature_der_.bytes.end(), 0);
     std::fill(signature_raw_.bytes.begin(), signature_raw_.bytes.end(), 0);
   }
@@ -601,11 +2156,16 @@ class SignSessionImpl final : public SignSession, private AsyncSession {
     message_cv_.notify_all();
   }
 
-  StepOutput Step(const std::optional<BufferOwner>& inbound) override { return AwaitStep(inbound); }
+  MpStepOutput Step(const std::vector<PeerMessage>& inbound) override {
+    CheckInboundPeers(inbound, signers_, party_index_);
+    return AwaitStep(inbound);
+  }
 
   BufferOwner Finalize(SigFormat fmt) override {
+    timeline::Span span("finalize", timeline_id_);
     EnsureWorkerFinished();
-    if (party_ != party_t::p1) throw Error(ErrorCode::ProtocolState, "signature finalize not available for this share");
+    if (party_index_ != opts_.sig_receiver)
+      throw Error(ErrorCode::ProtocolState, "signature finalize not available for this share");
     BufferOwner out;
     {
       std::lock_guard<std::mutex> guard(result_mutex_);
@@ -627,24 +2187,40 @@ class SignSessionImpl final : public SignSession, private AsyncSession {
     message_ready_ = false;
     lock.unlock();
 
-    coinbase::mem_t msg_mem(msg.data(), static_cast<int>(msg.size()));
+    // Convert the Shamir share into an additive share over the signing quorum,
+    // then run the n-of-n protocol among the quorum only.
+    std::set<coinbase::crypto::pname_t> quorum_names;
+    for (uint32_t index : signers_) quorum_names.insert(TnPartyName(index));
+    auto ac = ThresholdAccessStructure(party_count_, threshold_);
+    TnKey additive;
+    auto rv = key_.to_additive_share(ac, quorum_names, additive);
+    if (rv != SUCCESS) {
+      Fail(MapError(rv), FormatError(rv, "key_share_mp_t::to_additive_share"));
+      return;
+    }
 
-    coinbase::buf_t sid_buf;
-    if (!opts_.session_id.bytes.empty()) {
-      sid_buf = coinbase::buf_t(static_cast<int>(opts_.session_id.bytes.size()));
-      std::memcpy(sid_buf.data(), opts_.session_id.bytes.data(), opts_.session_id.bytes.size());
+    const int n = static_cast<int>(signers_.size());
+    std::vector<std::vector<int>> ot_role_map(n, std::vector<int>(n, coinbase::mpc::ecdsampc::ot_no_role));
+    for (int i = 0; i < n; ++i) {
+      for (int j = i + 1; j < n; ++j) {
+        ot_role_map[i][j] = coinbase::mpc::ecdsampc::ot_sender;
+        ot_role_map[j][i] = coinbase::mpc::ecdsampc::ot_receiver;
+      }
     }
 
     coinbase::buf_t sig_buf;
-    auto rv = coinbase::mpc::ecdsa2pc::sign(*job_, sid_buf, key_, msg_mem, sig_buf);
+    rv = ProtocolCall("ecdsampc::sign", profile::Primitive::CbmpcTnSign, [&] {
+      return coinbase::mpc::ecdsampc::sign(*job_, additive, mem_t(msg.data(), static_cast<int>(msg.size())),
+                                           sig_receiver_, ot_role_map, sig_buf);
+    });
+    additive.x_share = 0;
+    std::fill(msg.begin(), msg.end(), 0);
     if (rv != SUCCESS) {
-      Fail(MapError(rv), FormatError(rv, "ecdsa2pc::sign"));
+      Fail(MapError(rv), FormatError(rv, "ecdsampc::sign"));
       return;
     }
 
     if (sig_buf.size() == 0) {
-      sig_buf.secure_bzero();
-      std::fill(msg.begin(), msg.end(), 0);
       cv_.notify_all();
       return;
     }
@@ -653,15 +2229,13 @@ class SignSessionImpl final : public SignSession, private AsyncSession {
     sig_buf.secure_bzero();
 
     coinbase::crypto::ecdsa_signature_t parsed;
-    rv = parsed.from_der(curve_, coinbase::mem_t(signature_der_.bytes.data(),
-                                                static_cast<int>(signature_der_.bytes.size())));
+    rv = parsed.from_der(curve_, mem_t(signature_der_.bytes.data(), static_cast<int>(signature_der_.bytes.size())));
     if (rv) {
       Fail(MapError(rv), FormatError(rv, "ecdsa_signature_t::from_der"));
       return;
     }
 
-    const auto order = curve_.order();
-    int coord_size = order.get_bin_size();
+    const int coord_size = curve_.order().get_bin_size();
     coinbase::buf_t r_bin = parsed.get_r().to_bin(coord_size);
     coinbase::buf_t s_bin = parsed.get_s().to_bin(coord_size);
     signature_raw_.bytes.resize(static_cast<size_t>(coord_size) * 2);
@@ -670,8 +2244,6 @@ class SignSessionImpl final : public SignSession, private AsyncSession {
     r_bin.secure_bzero();
     s_bin.secure_bzero();
 
-    std::fill(msg.begin(), msg.end(), 0);
-
     {
       std::lock_guard<std::mutex> guard(result_mutex_);
       signature_ready_ = true;
@@ -679,11 +2251,15 @@ class SignSessionImpl final : public SignSession, private AsyncSession {
     cv_.notify_all();
   }
 
-  SignOptions opts_;
-  coinbase::crypto::ecurve_t curve_;
-  party_t party_;
-  key_t key_;
-  std::unique_ptr<FiberJob> job_;
+  ThresholdSignOptions opts_;
+  uint32_t party_index_;
+  uint32_t party_count_;
+  uint32_t threshold_;
+  ecurve_t curve_;
+  TnKey key_;
+  std::vector<uint32_t> signers_;
+  party_idx_t sig_receiver_ = 0;
+  std::unique_ptr<FiberJobMp> job_;
 
   std::mutex message_mutex_;
   std::condition_variable message_cv_;
@@ -696,16 +2272,261 @@ class SignSessionImpl final : public SignSession, private AsyncSession {
   BufferOwner signature_raw_;
 };
 
+// Header for recording a session on an existing share.
+Transcript TranscriptHeader(const KeypairImpl& kp, TranscriptKind kind, const BufferOwner& session_id) {
+  Transcript header;
+  header.kind = kind;
+  header.party = kp.kind();
+  header.curve = kp.curve();
+  header.key_id = kp.key_id();
+  header.session_id = session_id;
+  return header;
+}
+
 class ContextImpl final : public Context {
  public:
-  explicit ContextImpl(const InitOptions& opts) : opts_(opts) {}
+  explicit ContextImpl(const InitOptions& opts) : opts_(opts), logger_(opts.logger, opts.log_level) {
+    unsigned threads = opts_.max_threads ? opts_.max_threads : std::thread::hardware_concurrency();
+    pool_ = std::make_shared<TaskPool>(threads);
+    if (logger_.ShouldLog(LogLevel::Info)) {
+      LogLine line("context_init");
+      line.Add("worker_threads", static_cast<uint64_t>(pool_->size()));
+      logger_.Write(LogLevel::Info, line);
+    }
+  }
 
   std::unique_ptr<DkgSession> CreateDkg(const DkgOptions& opts) override {
-    return std::make_unique<DkgSessionImpl>(opts);
+    if (opts.count == 0) throw Error(ErrorCode::InvalidArgument, "DKG count must be at least 1");
+    if (opts.count > 1) {
+      if (!opts.transcript_path.empty())
+        throw Error(ErrorCode::Unsupported, "transcripts record single-key sessions only");
+      if (opts.count > kMaxBatchLanes) throw Error(ErrorCode::InvalidArgument, "batch size out of range");
+      DkgOptions lane_opts = opts;
+      lane_opts.count = 1;
+      std::vector<std::unique_ptr<DkgSession>> lanes;
+      lanes.reserve(opts.count);
+      auto gate = std::make_shared<LaneGate>(pool_->size());
+      for (uint32_t i = 0; i < opts.count; ++i)
+        lanes.push_back(std::make_unique<DkgSessionImpl>(lane_opts, SessionTrace{}, gate));
+      return std::make_unique<BatchSessionImpl>(std::move(lanes));
+    }
+    SessionTrace trace;
+    if (!opts.transcript_path.empty()) {
+      Transcript header;
+      header.kind = TranscriptKind::Dkg;
+      header.party = opts.kind;
+      header.curve = opts.curve;
+      header.key_id = opts.key_id;
+      header.defer_paillier = opts.defer_paillier;
+      header.session_id = opts.session_id;
+      trace = RecordTrace(opts.transcript_path, std::move(header));
+    }
+    return std::make_unique<DkgSessionImpl>(opts, std::move(trace));
   }
 
   std::unique_ptr<Keypair> ImportKey(const BufferOwner& blob) override {
+    MAANY_MPC_PROBE1(key_import_enter, blob.bytes.size());
+    auto kp = DecodeKey(blob);
+    MAANY_MPC_PROBE1(key_import_exit, static_cast<uint32_t>(kp->scheme()));
+    return kp;
+  }
+
+  BufferOwner ExportKey(const Keypair& kp) override {
+    MAANY_MPC_PROBE1(key_export_enter, static_cast<uint32_t>(kp.scheme()));
+    auto blob = EncodeKey(kp);
+    MAANY_MPC_PROBE1(key_export_exit, blob.bytes.size());
+    return blob;
+  }
+
+  PubKey GetPubKey(const Keypair& kp_base) override {
+    const auto& Q = kp_base.scheme() == Scheme::EcdsaThresholdN
+                      ? dynamic_cast<const ThresholdKeypairImpl&>(kp_base).key().Q
+                      : dynamic_cast<const KeypairImpl&>(kp_base).key().Q;
+    auto compressed = Q.to_compressed_bin();
+    PubKey pub;
+    pub.curve = kp_base.curve();
+    pub.compressed.bytes.assign(compressed.data(), compressed.data() + compressed.size());
+    return pub;
+  }
+
+  std::unique_ptr<SignSession> CreateSign(const Keypair& kp_base, const SignOptions& opts) override {
+    if (kp_base.scheme() == Scheme::EcdsaThresholdN)
+      throw Error(ErrorCode::Unsupported, "threshold keys sign through the multi-party API");
+    auto& kp = dynamic_cast<const KeypairImpl&>(kp_base);
+    SessionTrace trace;
+    if (!opts.transcript_path.empty()) {
+      Transcript header = TranscriptHeader(kp, TranscriptKind::Sign, opts.session_id);
+      trace = RecordTrace(opts.transcript_path, std::move(header));
+    }
+    return std::make_unique<SignSessionImpl>(kp, opts, std::move(trace));
+  }
+
+  std::unique_ptr<DkgSession> CreateRefresh(const Keypair& kp_base, const RefreshOptions& opts) override {
+    if (kp_base.scheme() == Scheme::EcdsaThresholdN)
+      throw Error(ErrorCode::Unsupported, "threshold key refresh not supported");
+    auto& kp = dynamic_cast<const KeypairImpl&>(kp_base);
+    SessionTrace trace;
+    if (!opts.transcript_path.empty()) {
+      Transcript header = TranscriptHeader(kp, TranscriptKind::Refresh, opts.session_id);
+      header.reuse_paillier = opts.reuse_paillier;
+      trace = RecordTrace(opts.transcript_path, std::move(header));
+    }
+    return std::make_unique<RefreshSessionImpl>(kp, opts, opts_.rng, std::move(trace));
+  }
+
+  std::unique_ptr<DkgSession> CreateRefreshMany(
+    const std::vector<const Keypair*>& kps,
+    const RefreshOptions& opts) override {
+    if (kps.size() < 2 || kps.size() > kMaxBatchLanes)
+      throw Error(ErrorCode::InvalidArgument, "batch size out of range");
+    if (!opts.transcript_path.empty())
+      throw Error(ErrorCode::Unsupported, "transcripts record single-key sessions only");
+    std::vector<std::unique_ptr<DkgSession>> lanes;
+    lanes.reserve(kps.size());
+    auto gate = std::make_shared<LaneGate>(pool_->size());
+    for (size_t i = 0; i < kps.size(); ++i) {
+      Ensure(kps[i] != nullptr, ErrorCode::InvalidArgument, "null keypair in refresh batch");
+      if (kps[i]->scheme() == Scheme::EcdsaThresholdN)
+        throw Error(ErrorCode::Unsupported, "threshold key refresh not supported");
+      Ensure(kps[i]->kind() == kps[0]->kind(), ErrorCode::InvalidArgument,
+             "refresh batch mixes device and server shares");
+      // Give each lane its own session id so transcripts cannot be swapped between lanes.
+      RefreshOptions lane_opts = opts;
+      const uint32_t lane = static_cast<uint32_t>(i);
+      for (int shift = 24; shift >= 0; shift -= 8)
+        lane_opts.session_id.bytes.push_back(static_cast<uint8_t>(lane >> shift));
+      lanes.push_back(std::make_unique<RefreshSessionImpl>(dynamic_cast<const KeypairImpl&>(*kps[i]), lane_opts,
+                                                           opts_.rng, SessionTrace{}, gate));
+    }
+    return std::make_unique<BatchSessionImpl>(std::move(lanes));
+  }
+
+  std::unique_ptr<DkgSession> CreatePaillierSetup(const Keypair& kp_base) override {
+    if (kp_base.scheme() != Scheme::Ecdsa2p) throw Error(ErrorCode::Unsupported, "Paillier setup requires a 2p share");
+    auto& kp = dynamic_cast<const KeypairImpl&>(kp_base);
+    return std::make_unique<PaillierSetupSessionImpl>(kp);
+  }
+
+  void CreateBackup(
+    const Keypair& kp_base,
+    uint32_t threshold,
+    size_t share_count,
+    const BufferOwner& label,
+    BackupCiphertext& out_ciphertext,
+    std::vector<BackupShare>& out_shares,
+    BufferOwner& out_update_key) override;
+
+  std::unique_ptr<Keypair> RestoreBackup(
+    const BackupCiphertext& ciphertext,
+    const std::vector<BackupShare>& shares) override;
+
+  void UpdateBackup(
+    const Keypair& kp_base,
+    const BackupCiphertext& existing,
+    const BufferOwner& update_key,
+    BackupCiphertext& out_ciphertext) override;
+
+  void CreateBackupMany(
+    const std::vector<const Keypair*>& kps,
+    uint32_t threshold,
+    size_t share_count,
+    const BufferOwner& label,
+    BackupBundle& out_bundle,
+    std::vector<BackupShare>& out_shares) override;
+
+  std::vector<std::unique_ptr<Keypair>> RestoreBackupMany(
+    const BackupBundle& bundle,
+    const std::vector<BackupShare>& shares,
+    const std::vector<uint32_t>& indices) override;
+
+  std::vector<bool> VerifyBackupShares(
+    const BufferOwner& commitments,
+    uint32_t threshold,
+    const std::vector<BackupShare>& shares) override {
+    const ecurve_t curve = curve_secp256k1;
+    auto checked = CheckBackupShares(curve, DecodeCommitments(curve, commitments, threshold), shares);
+    std::vector<bool> valid(checked.size());
+    for (size_t i = 0; i < checked.size(); ++i) valid[i] = checked[i].valid;
+    return valid;
+  }
+
+  std::vector<BufferOwner> RewrapEnvelopes(
+    const BufferOwner& old_kek,
+    const BufferOwner& new_kek,
+    const std::vector<ByteView>& envelopes) override;
+
+  std::unique_ptr<Kek> CreateKek(const BufferOwner& key) override {
+    return std::make_unique<KekImpl>(key.bytes);
+  }
+
+  BufferOwner ExportKeySealed(const Keypair& kp, const Kek& kek_base, const BufferOwner& aad) override {
+    const auto& kek = dynamic_cast<const KekImpl&>(kek_base);
+    auto blob = ExportKey(kp);
+    auto sealed = kek.Seal(RandomBytes(kBackupNonceSize), aad, blob.bytes);
+    std::fill(blob.bytes.begin(), blob.bytes.end(), 0);
+    return sealed;
+  }
+
+  std::unique_ptr<Keypair> ImportKeySealed(
+    const Kek& kek_base,
+    const BufferOwner& aad,
+    ByteView sealed) override {
+    const auto& kek = dynamic_cast<const KekImpl&>(kek_base);
+    BufferOwner blob{kek.Open(aad, sealed)};
+    try {
+      auto kp = ImportKey(blob);
+      std::fill(blob.bytes.begin(), blob.bytes.end(), 0);
+      return kp;
+    } catch (...) {
+      std::fill(blob.bytes.begin(), blob.bytes.end(), 0);
+      throw;
+    }
+  }
+
+  std::unique_ptr<Keypair> DeriveChild(
+    const Keypair& kp_base,
+    const ChainCode& chain_code,
+    const std::vector<uint32_t>& path) override;
+
+  std::vector<PubKey> DerivePubKeys(
+    const Keypair& kp_base,
+    const ChainCode& chain_code,
+    const std::vector<uint32_t>& parent_path,
+    uint32_t first_index,
+    size_t count) override;
+
+  std::vector<ReplayStep> Replay(ByteView transcript, const Keypair* kp) override;
+
+  uint32_t WorkerThreads() const override { return static_cast<uint32_t>(pool_->size()); }
+
+  Logger& Log() override { return logger_; }
+
+  std::unique_ptr<MpDkgSession> CreateThresholdDkg(const ThresholdDkgOptions& opts) override {
+    return std::make_unique<ThresholdDkgSessionImpl>(opts);
+  }
+
+  std::unique_ptr<MpSignSession> CreateThresholdSign(
+    const Keypair& kp_base,
+    const ThresholdSignOptions& opts) override {
+    if (kp_base.scheme() != Scheme::EcdsaThresholdN)
+      throw Error(ErrorCode::InvalidArgument, "keypair is not a threshold share");
+    return std::make_unique<ThresholdSignSessionImpl>(dynamic_cast<const ThresholdKeypairImpl&>(kp_base), opts);
+  }
+
+ private:
+  // Key blob codecs; ImportKey and ExportKey wrap them in probes.
+  std::unique_ptr<Keypair> DecodeKey(const BufferOwner& blob) {
+    profile::Timer timer(profile::Primitive::Serialize);
     mem_t mem(blob.bytes.data(), static_cast<int>(blob.bytes.size()));
+    KeyBlobHeader header;
+    coinbase::converter_t header_conv(mem);
+    header.convert(header_conv);
+    if (header_conv.get_rv() != SUCCESS)
+      throw Error(ErrorCode::InvalidArgument, "invalid key blob");
+    if (header.scheme == static_cast<uint32_t>(Scheme::EcdsaThresholdN)) return ImportThresholdKey(mem);
+
+    if (header.version == kKeyBlobVersionEcOnly) return ImportEcOnlyKey(mem);
+
     coinbase::converter_t conv(mem);
     KeyBlob stored;
     stored.convert(conv);
@@ -729,8 +2550,12 @@ class ContextImpl final : public Context {
     return std::make_unique<KeypairImpl>(kind, scheme, curve, stored.key_id, std::move(key));
   }
 
-  BufferOwner ExportKey(const Keypair& kp_base) override {
+  BufferOwner EncodeKey(const Keypair& kp_base) {
+    profile::Timer timer(profile::Primitive::Serialize);
+    if (kp_base.scheme() == Scheme::EcdsaThresholdN)
+      return ExportThresholdKey(dynamic_cast<const ThresholdKeypairImpl&>(kp_base));
     auto& kp = dynamic_cast<const KeypairImpl&>(kp_base);
+    if (!kp.sign_ready()) return ExportEcOnlyKey(kp);
     KeyBlob blob;
     blob.scheme = static_cast<uint32_t>(kp.scheme());
     blob.kind = static_cast<uint32_t>(kp.kind());
@@ -739,7 +2564,7 @@ class ContextImpl final : public Context {
     blob.Q = kp.key().Q;
     blob.x_share = kp.key().x_share;
     blob.c_key = kp.key().c_key;
-    blob.paillier = kp.key().paillier;
+    blob.paillier = kp.paillier();
 
     coinbase::converter_t calc(true);
     blob.convert(calc);
@@ -751,70 +2576,255 @@ class ContextImpl final : public Context {
     return MakeBuffer(std::move(out));
   }
 
-  PubKey GetPubKey(const Keypair& kp_base) override {
-    auto& kp = dynamic_cast<const KeypairImpl&>(kp_base);
-    auto compressed = kp.key().Q.to_compressed_bin();
-    PubKey pub;
-    pub.curve = kp.curve();
-    pub.compressed.bytes.assign(compressed.data(), compressed.data() + compressed.size());
-    return pub;
+  std::unique_ptr<Keypair> ImportThresholdKey(mem_t mem);
+  BufferOwner ExportThresholdKey(const ThresholdKeypairImpl& kp);
+  std::unique_ptr<Keypair> ImportEcOnlyKey(mem_t mem);
+  BufferOwner ExportEcOnlyKey(const KeypairImpl& kp);
+  std::vector<uint8_t> RandomBytes(size_t len) const;
+  std::vector<uint8_t> NewBackupKey(
+    uint32_t threshold,
+    size_t share_count,
+    std::vector<BackupShare>& out_shares,
+    BufferOwner& out_commitments);
+  void SealBackupPayload(const Keypair& kp, const std::vector<uint8_t>& update_key, BackupCiphertext& out_ciphertext);
+  InitOptions opts_;
+  Logger logger_;
+  std::shared_ptr<TaskPool> pool_;
+};
+
+std::vector<ReplayStep> ContextImpl::Replay(ByteView bytes, const Keypair* kp_base) {
+  const Transcript t = DecodeTranscript(bytes);
+  SessionTrace trace;
+  trace.seed = t.seed;
+
+  const KeypairImpl* kp = nullptr;
+  if (t.kind != TranscriptKind::Dkg) {
+    Ensure(kp_base != nullptr, ErrorCode::InvalidArgument, "replay needs the recorded party's share");
+    Ensure(kp_base->scheme() == Scheme::Ecdsa2p, ErrorCode::InvalidArgument, "replay needs a 2p share");
+    kp = &dynamic_cast<const KeypairImpl&>(*kp_base);
+    Ensure(kp->kind() == t.party && kp->key_id().bytes == t.key_id.bytes, ErrorCode::InvalidArgument,
+           "share does not match the transcript");
   }
 
-  std::unique_ptr<SignSession> CreateSign(const Keypair& kp_base, const SignOptions& opts) override {
-    auto& kp = dynamic_cast<const KeypairImpl&>(kp_base);
-    return std::make_unique<SignSessionImpl>(kp, opts);
+  std::unique_ptr<DkgSession> dkg;
+  std::unique_ptr<SignSession> sign;
+  switch (t.kind) {
+    case TranscriptKind::Dkg: {
+      DkgOptions opts;
+      opts.curve = t.curve;
+      opts.kind = t.party;
+      opts.key_id = t.key_id;
+      opts.session_id = t.session_id;
+      opts.defer_paillier = t.defer_paillier;
+      dkg = std::make_unique<DkgSessionImpl>(opts, std::move(trace));
+      break;
+    }
+    case TranscriptKind::Sign: {
+      SignOptions opts;
+      opts.session_id = t.session_id;
+      sign = std::make_unique<SignSessionImpl>(*kp, opts, std::move(trace));
+      sign->SetMessage(t.message.bytes.data(), t.message.bytes.size());
+      break;
+    }
+    case TranscriptKind::Refresh: {
+      RefreshOptions opts;
+      opts.session_id = t.session_id;
+      opts.reuse_paillier = t.reuse_paillier;
+      dkg = std::make_unique<RefreshSessionImpl>(*kp, opts, RngCallback{}, std::move(trace));
+      break;
+    }
   }
 
-  std::unique_ptr<DkgSession> CreateRefresh(const Keypair& kp_base, const RefreshOptions& opts) override {
-    auto& kp = dynamic_cast<const KeypairImpl&>(kp_base);
-    return std::make_unique<RefreshSessionImpl>(kp, opts);
+  std::vector<const TranscriptEvent*> received;
+  std::vector<const TranscriptEvent*> sent;
+  for (const auto& e : t.events) (e.type == TranscriptEvent::Type::Receive ? received : sent).push_back(&e);
+
+  // Step with each recorded inbound frame in turn. After a step that sends,
+  // step again without input until the party waits, since it may send twice.
+  std::vector<ReplayStep> steps;
+  std::optional<BufferOwner> inbound;
+  size_t next_in = 0;
+  size_t next_out = 0;
+  for (;;) {
+    ReplayStep record;
+    record.in_bytes = inbound ? inbound->bytes.size() : 0;
+    const auto start = std::chrono::steady_clock::now();
+    StepOutput out = dkg ? dkg->Step(inbound) : sign->Step(inbound);
+    record.compute_ms =
+        std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    inbound.reset();
+    if (out.outbound) {
+      record.out_bytes = out.outbound->bytes.size();
+      if (next_out >= sent.size() || out.outbound->bytes != sent[next_out]->bytes)
+        throw Error(ErrorCode::ProtocolState,
+                    "replay diverged from the transcript at outbound frame " + std::to_string(next_out));
+      ++next_out;
+    }
+    steps.push_back(record);
+    if (out.state == StepState::Done) break;
+    if (out.outbound) continue;
+    if (next_in >= received.size())
+      throw Error(ErrorCode::ProtocolState, "replay waits for a frame the transcript lacks");
+    inbound = MakeBuffer(received[next_in++]->bytes);
   }
+  if (next_out != sent.size())
+    throw Error(ErrorCode::ProtocolState, "replay finished before the recorded session did");
+  if (dkg) dkg->Finalize();
+  return steps;
+}
 
-  void CreateBackup(
-    const Keypair& kp_base,
-    uint32_t threshold,
-    size_t share_count,
-    const BufferOwner& label,
-    BackupCiphertext& out_ciphertext,
-    std::vector<BackupShare>& out_shares) override;
+std::unique_ptr<Keypair> ContextImpl::ImportThresholdKey(mem_t mem) {
+  coinbase::converter_t conv(mem);
+  ThresholdKeyBlob stored;
+  stored.convert(conv);
+  if (conv.get_rv() != SUCCESS)
+    throw Error(ErrorCode::InvalidArgument, "invalid threshold key blob");
+  if (stored.magic != kKeyBlobMagic || stored.version != kKeyBlobVersion)
+    throw Error(ErrorCode::InvalidArgument, "unsupported key blob version");
+  if (stored.party_index >= stored.party_count || stored.threshold < 2 || stored.threshold > stored.party_count)
+    throw Error(ErrorCode::InvalidArgument, "invalid threshold key parameters");
+
+  auto curve = FromCbCurve(stored.key.curve);
+  return std::make_unique<ThresholdKeypairImpl>(stored.party_index, stored.party_count, stored.threshold, curve,
+                                                stored.key_id, std::move(stored.key));
+}
 
-  std::unique_ptr<Keypair> RestoreBackup(
-    const BackupCiphertext& ciphertext,
-    const std::vector<BackupShare>& shares) override;
+BufferOwner ContextImpl::ExportThresholdKey(const ThresholdKeypairImpl& kp) {
+  ThresholdKeyBlob blob;
+  blob.kind = static_cast<uint32_t>(kp.kind());
+  blob.key_id = kp.key_id();
+  blob.party_index = kp.party_index();
+  blob.party_count = kp.party_count();
+  blob.threshold = kp.threshold();
+  blob.key = kp.key();
+
+  coinbase::converter_t calc(true);
+  blob.convert(calc);
+  std::vector<uint8_t> out(calc.get_offset());
+  coinbase::converter_t writer(out.data());
+  blob.convert(writer);
+  if (writer.get_rv() != SUCCESS)
+    throw Error(ErrorCode::General, "failed to serialize threshold key");
+  return MakeBuffer(std::move(out));
+}
 
- private:
-  std::vector<uint8_t> RandomBytes(size_t len) const;
-  InitOptions opts_;
-};
+std::unique_ptr<Keypair> ContextImpl::ImportEcOnlyKey(mem_t mem) {
+  coinbase::converter_t conv(mem);
+  EcOnlyKeyBlob stored;
+  stored.convert(conv);
+  if (conv.get_rv() != SUCCESS)
+    throw Error(ErrorCode::InvalidArgument, "invalid key blob");
+  if (stored.magic != kKeyBlobMagic || stored.scheme != static_cast<uint32_t>(Scheme::Ecdsa2p))
+    throw Error(ErrorCode::InvalidArgument, "unsupported key blob version");
+
+  auto kind = static_cast<ShareKind>(stored.kind);
+  key_t key;
+  key.role = ToParty(kind);
+  key.curve = stored.curve;
+  key.Q = stored.Q;
+  key.x_share = stored.x_share;
+  return std::make_unique<KeypairImpl>(kind, Scheme::Ecdsa2p, FromCbCurve(stored.curve), stored.key_id,
+                                       std::move(key), nullptr);
+}
 
-std::vector<uint8_t> ContextImpl::RandomBytes(size_t len) const {
-  std::vector<uint8_t> out(len);
-  if (len == 0) return out;
-  if (opts_.rng) {
-    if (opts_.rng(out.data(), len) != 0)
-      throw Error(ErrorCode::Rng, "rng callback failed");
-  } else {
-    if (len > static_cast<size_t>(std::numeric_limits<int>::max()))
-      throw Error(ErrorCode::InvalidArgument, "random length too large");
-    if (RAND_bytes(out.data(), static_cast<int>(len)) != 1)
-      throw Error(ErrorCode::Rng, "RAND_bytes failed");
+BufferOwner ContextImpl::ExportEcOnlyKey(const KeypairImpl& kp) {
+  EcOnlyKeyBlob blob;
+  blob.scheme = static_cast<uint32_t>(kp.scheme());
+  blob.kind = static_cast<uint32_t>(kp.kind());
+  blob.key_id = kp.key_id();
+  blob.curve = kp.key().curve;
+  blob.Q = kp.key().Q;
+  blob.x_share = kp.key().x_share;
+
+  coinbase::converter_t calc(true);
+  blob.convert(calc);
+  std::vector<uint8_t> out(calc.get_offset());
+  coinbase::converter_t writer(out.data());
+  blob.convert(writer);
+  if (writer.get_rv() != SUCCESS)
+    throw Error(ErrorCode::General, "failed to serialize key");
+  return MakeBuffer(std::move(out));
+}
+
+std::unique_ptr<Keypair> ContextImpl::DeriveChild(
+  const Keypair& kp_base,
+  const ChainCode& chain_code,
+  const std::vector<uint32_t>& path) {
+  if (kp_base.scheme() != Scheme::Ecdsa2p) throw Error(ErrorCode::Unsupported, "child derivation requires a 2p share");
+  if (path.empty()) throw Error(ErrorCode::InvalidArgument, "derivation path must not be empty");
+  auto& kp = dynamic_cast<const KeypairImpl&>(kp_base);
+  if (!kp.sign_ready()) throw Error(ErrorCode::ProtocolState, "Paillier setup for this key has not completed");
+  const ecurve_t curve = kp.key().curve;
+
+  // The summed tweak goes onto the server share, reduced mod q. The device
+  // share and c_key = Enc(x1) are untouched, so both shares stay in [0, q)
+  // and no Paillier operation is needed.
+  const mod_t& q = curve.order();
+  bn_t total_tweak = 0;
+  coinbase::crypto::ecc_point_t Q = kp.key().Q;
+  ChainCode cc = chain_code;
+  for (uint32_t index : path) {
+    auto child = Bip32DerivePublic(curve, Q, cc, index);
+    total_tweak = (total_tweak + child.tweak) % q;
+    Q = child.Q;
+    cc = child.chain_code;
   }
-  return out;
+
+  key_t derived = kp.key();
+  derived.Q = Q;
+  if (kp.key().role == party_t::p2) derived.x_share = (kp.key().x_share + total_tweak) % q;
+  total_tweak = 0;
+
+  return std::make_unique<KeypairImpl>(kp.kind(), kp.scheme(), kp.curve(), ChildKeyId(kp.key_id(), path),
+                                       std::move(derived), kp.shared_paillier());
 }
 
-void ContextImpl::CreateBackup(
+std::vector<PubKey> ContextImpl::DerivePubKeys(
   const Keypair& kp_base,
+  const ChainCode& chain_code,
+  const std::vector<uint32_t>& parent_path,
+  uint32_t first_index,
+  size_t count) {
+  if (kp_base.scheme() != Scheme::Ecdsa2p) throw Error(ErrorCode::Unsupported, "child derivation requires a 2p share");
+  if (count > static_cast<size_t>(kBip32HardenedBit - first_index))
+    throw Error(ErrorCode::InvalidArgument, "index range crosses into hardened indices");
+  auto& kp = dynamic_cast<const KeypairImpl&>(kp_base);
+  const ecurve_t curve = kp.key().curve;
+
+  coinbase::crypto::ecc_point_t parent = kp.key().Q;
+  ChainCode cc = chain_code;
+  for (uint32_t index : parent_path) {
+    auto child = Bip32DerivePublic(curve, parent, cc, index);
+    parent = child.Q;
+    cc = child.chain_code;
+  }
+
+  std::vector<PubKey> out(count);
+  pool_->ParallelFor(count, [&](size_t i) {
+    auto child = Bip32DerivePublic(curve, parent, cc, first_index + static_cast<uint32_t>(i));
+    auto compressed = child.Q.to_compressed_bin();
+    out[i].curve = kp.curve();
+    out[i].compressed.bytes.assign(compressed.data(), compressed.data() + compressed.size());
+  });
+  return out;
+}
+
+std::vector<uint8_t> ContextImpl::RandomBytes(size_t len) const {
+  return DrawRandom(opts_.rng, len);
+}
+
+// Draws a fresh backup key and splits it into `share_count` Shamir shares, any
+// `threshold` of which recover it. The Feldman commitments are the polynomial
+// coefficients times G, constant term first.
+std::vector<uint8_t> ContextImpl::NewBackupKey(
   uint32_t threshold,
   size_t share_count,
-  const BufferOwner& label,
-  BackupCiphertext& out_ciphertext,
-  std::vector<BackupShare>& out_shares) {
-  auto& kp = dynamic_cast<const KeypairImpl&>(kp_base);
+  std::vector<BackupShare>& out_shares,
+  BufferOwner& out_commitments) {
   if (threshold < 1) throw Error(ErrorCode::InvalidArgument, "threshold must be >= 1");
   if (share_count < threshold) throw Error(ErrorCode::InvalidArgument, "share_count must be >= threshold");
   if (share_count == 0) throw Error(ErrorCode::InvalidArgument, "share_count must be > 0");
 
-  auto blob = ExportKey(kp);
   const ecurve_t curve = curve_secp256k1;
   const auto& q = curve.order();
   const size_t scalar_size = static_cast<size_t>(curve.size());
@@ -824,16 +2834,6 @@ void ContextImpl::CreateBackup(
   bn_t secret = drbg.gen_bn(q);
   auto key_bin = secret.to_bin(static_cast<int>(scalar_size));
   std::vector<uint8_t> key_bytes(key_bin.data(), key_bin.data() + key_bin.size());
-  auto nonce = RandomBytes(kBackupNonceSize);
-
-  out_ciphertext.payload = AesGcmEncrypt(key_bytes, nonce, label, blob.bytes);
-  out_ciphertext.kind = kp.kind();
-  out_ciphertext.scheme = kp.scheme();
-  out_ciphertext.curve = kp.curve();
-  out_ciphertext.key_id = kp.key_id();
-  out_ciphertext.threshold = threshold;
-  out_ciphertext.share_count = static_cast<uint32_t>(share_count);
-  out_ciphertext.label = label;
 
   out_shares.clear();
   out_shares.resize(share_count);
@@ -842,70 +2842,290 @@ void ContextImpl::CreateBackup(
     pids[i] = static_cast<int>(i + 1);
   }
 
-  auto share_pair = coinbase::crypto::ss::share_threshold(
-    q,
-    secret,
-    static_cast<int>(threshold),
-    static_cast<int>(share_count),
-    pids,
-    &drbg);
+  auto share_pair = [&] {
+    profile::Timer timer(profile::Primitive::SecretSharing);
+    return coinbase::crypto::ss::share_threshold(
+      q,
+      secret,
+      static_cast<int>(threshold),
+      static_cast<int>(share_count),
+      pids,
+      &drbg);
+  }();
   const auto& share_values = share_pair.first;
   for (size_t i = 0; i < share_count; ++i) {
     out_shares[i].data = EncodeShare(pids[i], share_values[i], scalar_size);
   }
+  const auto& coefficients = share_pair.second;
+  if (coefficients.size() != threshold) throw Error(ErrorCode::General, "unexpected Shamir polynomial degree");
+  out_commitments.bytes.clear();
+  for (const auto& coefficient : coefficients) {
+    auto point = (coefficient * curve.generator()).to_compressed_bin();
+    out_commitments.bytes.insert(out_commitments.bytes.end(), point.data(), point.data() + point.size());
+  }
+  return key_bytes;
+}
 
+void ContextImpl::CreateBackup(
+  const Keypair& kp_base,
+  uint32_t threshold,
+  size_t share_count,
+  const BufferOwner& label,
+  BackupCiphertext& out_ciphertext,
+  std::vector<BackupShare>& out_shares,
+  BufferOwner& out_update_key) {
+  MAANY_MPC_PROBE3(backup_create_enter, threshold, share_count, size_t{1});
+  // The shared secret only serves as the wrapping key; the payload is sealed to
+  // its commitment like any later update.
+  auto key_bytes = NewBackupKey(threshold, share_count, out_shares, out_ciphertext.commitments);
+  out_update_key.bytes = BackupUpdateKey(key_bytes);
   std::fill(key_bytes.begin(), key_bytes.end(), 0);
-}
 
-std::unique_ptr<Keypair> ContextImpl::RestoreBackup(
-  const BackupCiphertext& ciphertext,
-  const std::vector<BackupShare>& shares) {
-  if (ciphertext.threshold < 1)
-    throw Error(ErrorCode::InvalidArgument, "invalid backup threshold");
-  if (shares.size() < ciphertext.threshold)
-    throw Error(ErrorCode::InvalidArgument, "insufficient backup shares provided");
+  out_ciphertext.kind = kp_base.kind();
+  out_ciphertext.scheme = kp_base.scheme();
+  out_ciphertext.curve = kp_base.curve();
+  out_ciphertext.key_id = kp_base.key_id();
+  out_ciphertext.threshold = threshold;
+  out_ciphertext.share_count = static_cast<uint32_t>(share_count);
+  out_ciphertext.label = label;
+  SealBackupPayload(kp_base, out_update_key.bytes, out_ciphertext);
+  MAANY_MPC_PROBE1(backup_create_exit, size_t{1});
+}
 
+// Encrypts a fresh export of `kp` under a new ephemeral key E = e*G and the
+// wrapping public key C_0 from out_ciphertext.commitments, then MACs the result
+// under the update key.
+void ContextImpl::SealBackupPayload(
+  const Keypair& kp,
+  const std::vector<uint8_t>& update_key,
+  BackupCiphertext& out_ciphertext) {
   const ecurve_t curve = curve_secp256k1;
-  const auto& q = curve.order();
-  const size_t scalar_size = static_cast<size_t>(curve.size());
+  const auto wrap_pub = DecodeCommitments(curve, out_ciphertext.commitments, out_ciphertext.threshold)[0];
 
-  std::vector<bn_t> pid_list;
-  std::vector<bn_t> share_values;
-  pid_list.reserve(shares.size());
-  share_values.reserve(shares.size());
-  for (const auto& share : shares) {
-    bn_t pid;
-    bn_t value;
-    DecodeShare(share.data, scalar_size, pid, value);
-    pid_list.push_back(pid);
-    share_values.push_back(value);
+  auto seed = RandomBytes(32);
+  coinbase::crypto::drbg_aes_ctr_t drbg(mem_t(seed.data(), static_cast<int>(seed.size())));
+  bn_t e = drbg.gen_bn(curve.order());
+  Ensure(e != bn_t(0), ErrorCode::Rng, "backup ephemeral key is zero");
+  coinbase::crypto::ecc_point_t E;
+  coinbase::crypto::ecc_point_t shared;
+  {
+    profile::Timer timer(profile::Primitive::EcMul);
+    E = e * curve.generator();
+    shared = e * wrap_pub;
   }
+  auto key_bytes = BackupWrapKey(shared, E);
 
-  bn_t secret = coinbase::crypto::lagrange_interpolate(bn_t(0), share_values, pid_list, q);
-  auto key_bin = secret.to_bin(static_cast<int>(scalar_size));
-  std::vector<uint8_t> key_bytes(key_bin.data(), key_bin.data() + key_bin.size());
+  auto blob = ExportKey(kp);
+  auto nonce = RandomBytes(kBackupNonceSize);
+  out_ciphertext.payload = AesGcmEncrypt(key_bytes, nonce, out_ciphertext.label, blob.bytes);
+  auto E_bin = E.to_compressed_bin();
+  out_ciphertext.ephemeral.bytes.assign(E_bin.data(), E_bin.data() + E_bin.size());
+  out_ciphertext.auth.bytes = BackupAuthTag(update_key, out_ciphertext);
 
-  if (ciphertext.payload.bytes.size() < kBackupNonceSize + kBackupTagSize)
-    throw Error(ErrorCode::InvalidArgument, "backup ciphertext too short");
-  const uint8_t* nonce = ciphertext.payload.bytes.data();
-  const uint8_t* tag = ciphertext.payload.bytes.data() + kBackupNonceSize;
-  const uint8_t* cipher_data = ciphertext.payload.bytes.data() + kBackupNonceSize + kBackupTagSize;
-  const size_t cipher_len = ciphertext.payload.bytes.size() - kBackupNonceSize - kBackupTagSize;
+  std::fill(blob.bytes.begin(), blob.bytes.end(), 0);
+  std::fill(key_bytes.begin(), key_bytes.end(), 0);
+}
+
+void ContextImpl::UpdateBackup(
+  const Keypair& kp_base,
+  const BackupCiphertext& existing,
+  const BufferOwner& update_key,
+  BackupCiphertext& out_ciphertext) {
+  if (existing.commitments.bytes.empty() || existing.auth.bytes.empty())
+    throw Error(ErrorCode::InvalidArgument, "backup has no wrapping key; create a new backup instead");
+  if (kp_base.key_id().bytes != existing.key_id.bytes || kp_base.kind() != existing.kind)
+    throw Error(ErrorCode::InvalidArgument, "backup belongs to a different key share");
+  if (update_key.bytes.size() != kBackupUpdateKeySize || !BackupAuthValid(update_key.bytes, existing))
+    throw Error(ErrorCode::InvalidArgument, "update key does not match this backup");
+
+  BackupCiphertext updated;
+  updated.kind = existing.kind;
+  updated.scheme = kp_base.scheme();
+  updated.curve = kp_base.curve();
+  updated.key_id = existing.key_id;
+  updated.threshold = existing.threshold;
+  updated.share_count = existing.share_count;
+  updated.label = existing.label;
+  updated.commitments = existing.commitments;
+  SealBackupPayload(kp_base, update_key.bytes, updated);
+  out_ciphertext = std::move(updated);
+}
 
-  auto plaintext = AesGcmDecrypt(
+std::unique_ptr<Keypair> ContextImpl::RestoreBackup(
+  const BackupCiphertext& ciphertext,
+  const std::vector<BackupShare>& shares) {
+  MAANY_MPC_PROBE2(backup_restore_enter, shares.size(), size_t{1});
+  auto key_bytes = RecoverBackupKey(ciphertext.threshold, ciphertext.commitments, shares);
+  if (!ciphertext.ephemeral.bytes.empty()) {
+    const ecurve_t curve = curve_secp256k1;
+    const auto& E_bin = ciphertext.ephemeral.bytes;
+    coinbase::crypto::ecc_point_t E;
+    if (E.from_bin(curve, mem_t(E_bin.data(), static_cast<int>(E_bin.size()))) != SUCCESS)
+      throw Error(ErrorCode::InvalidArgument, "invalid backup ephemeral key");
+    auto update_key = BackupUpdateKey(key_bytes);
+    const bool authentic = BackupAuthValid(update_key, ciphertext);
+    std::fill(update_key.begin(), update_key.end(), 0);
+    if (!authentic) {
+      std::fill(key_bytes.begin(), key_bytes.end(), 0);
+      throw Error(ErrorCode::Crypto, "backup payload is not authenticated by its update key");
+    }
+    const bn_t s = bn_t::from_bin(mem_t(key_bytes.data(), static_cast<int>(key_bytes.size())));
+    std::fill(key_bytes.begin(), key_bytes.end(), 0);
+    key_bytes = BackupWrapKey(s * E, E);
+  }
+  auto plaintext = OpenBackupPayload(
     key_bytes,
     ciphertext.label,
-    nonce,
-    kBackupNonceSize,
-    tag,
-    kBackupTagSize,
-    cipher_data,
-    cipher_len);
+    ciphertext.payload.bytes.data(),
+    ciphertext.payload.bytes.size());
+  std::fill(key_bytes.begin(), key_bytes.end(), 0);
 
   BufferOwner blob;
   blob.bytes = std::move(plaintext);
   auto restored = ImportKey(blob);
+  std::fill(blob.bytes.begin(), blob.bytes.end(), 0);
+  if (restored->key_id().bytes != ciphertext.key_id.bytes)
+    throw Error(ErrorCode::Crypto, "backup payload belongs to a different key");
+  MAANY_MPC_PROBE1(backup_restore_exit, size_t{1});
+  return restored;
+}
+
+void ContextImpl::CreateBackupMany(
+  const std::vector<const Keypair*>& kps,
+  uint32_t threshold,
+  size_t share_count,
+  const BufferOwner& label,
+  BackupBundle& out_bundle,
+  std::vector<BackupShare>& out_shares) {
+  if (kps.empty() || kps.size() > kMaxBackupRecords)
+    throw Error(ErrorCode::InvalidArgument, "backup record count out of range");
+  for (const auto* kp : kps) Ensure(kp != nullptr, ErrorCode::InvalidArgument, "null keypair in backup bundle");
+  const uint32_t count = static_cast<uint32_t>(kps.size());
+  MAANY_MPC_PROBE3(backup_create_enter, threshold, share_count, kps.size());
+
+  auto key_bytes = NewBackupKey(threshold, share_count, out_shares, out_bundle.commitments);
+  // Nonces come from the context RNG, which may be a caller callback, so they
+  // are drawn here rather than on pool threads.
+  std::vector<std::vector<uint8_t>> nonces(count);
+  for (auto& nonce : nonces) nonce = RandomBytes(kBackupNonceSize);
+
+  std::vector<std::vector<uint8_t>> headers(count);
+  std::vector<BufferOwner> payloads(count);
+  pool_->ParallelFor(count, [&](size_t i) {
+    const Keypair& kp = *kps[i];
+    auto& header = headers[i];
+    AppendU32(header, static_cast<uint32_t>(kp.kind()));
+    AppendU32(header, static_cast<uint32_t>(kp.scheme()));
+    AppendU32(header, static_cast<uint32_t>(kp.curve()));
+    const KeyId key_id = kp.key_id();
+    header.insert(header.end(), key_id.bytes.begin(), key_id.bytes.end());
+
+    auto blob = ExportKey(kp);
+    auto aad = BackupRecordAad(label, count, static_cast<uint32_t>(i), header.data());
+    payloads[i] = AesGcmEncrypt(key_bytes, nonces[i], aad, blob.bytes);
+    std::fill(blob.bytes.begin(), blob.bytes.end(), 0);
+  });
+  std::fill(key_bytes.begin(), key_bytes.end(), 0);
+
+  std::vector<uint8_t> envelope;
+  AppendU32(envelope, kBackupBundleMagic);
+  AppendU32(envelope, kBackupBundleVersion);
+  AppendU32(envelope, count);
+  for (uint32_t i = 0; i < count; ++i) {
+    envelope.insert(envelope.end(), headers[i].begin(), headers[i].end());
+    AppendU32(envelope, static_cast<uint32_t>(payloads[i].bytes.size()));
+    envelope.insert(envelope.end(), payloads[i].bytes.begin(), payloads[i].bytes.end());
+  }
+
+  out_bundle.threshold = threshold;
+  out_bundle.share_count = static_cast<uint32_t>(share_count);
+  out_bundle.record_count = count;
+  out_bundle.label = label;
+  out_bundle.envelope = MakeBuffer(std::move(envelope));
+  MAANY_MPC_PROBE1(backup_create_exit, kps.size());
+}
+
+std::vector<BufferOwner> ContextImpl::RewrapEnvelopes(
+  const BufferOwner& old_kek,
+  const BufferOwner& new_kek,
+  const std::vector<ByteView>& envelopes) {
+  Ensure(old_kek.bytes.size() == 32 && new_kek.bytes.size() == 32, ErrorCode::InvalidArgument,
+         "envelope kek must be 32 bytes");
+  const size_t count = envelopes.size();
+  std::vector<BufferOwner> out(count);
+  if (count == 0) return out;
+  for (const auto& envelope : envelopes) {
+    Ensure(envelope.data != nullptr && envelope.len > kBackupNonceSize + kBackupTagSize, ErrorCode::InvalidArgument,
+           "envelope too short");
+  }
+  // As for bundles, nonces are drawn on the calling thread.
+  const auto nonces = RandomBytes(count * kBackupNonceSize);
+
+  // Contiguous ranges rather than one task per envelope, so each task sets up
+  // its two key schedules once and reuses them for the whole range.
+  const size_t tasks = std::min(count, static_cast<size_t>(pool_->size()) * 4);
+  pool_->ParallelFor(tasks, [&](size_t task) {
+    AesGcmCipher opener(old_kek.bytes, AesGcmCipher::Mode::Decrypt);
+    AesGcmCipher sealer(new_kek.bytes, AesGcmCipher::Mode::Encrypt);
+    const BufferOwner no_aad;
+    const size_t end = count * (task + 1) / tasks;
+    for (size_t i = count * task / tasks; i < end; ++i) {
+      const uint8_t* nonce = envelopes[i].data;
+      const uint8_t* tag = nonce + kBackupNonceSize;
+      const uint8_t* ciphertext = tag + kBackupTagSize;
+      auto blob = opener.Open(no_aad, nonce, tag, ciphertext, envelopes[i].len - kBackupNonceSize - kBackupTagSize);
+
+      KeyBlobHeader header;
+      coinbase::converter_t header_conv(mem_t(blob.data(), static_cast<int>(blob.size())));
+      header.convert(header_conv);
+      const bool known = header_conv.get_rv() == SUCCESS && header.magic == kKeyBlobMagic &&
+                         (header.version == kKeyBlobVersion || header.version == kKeyBlobVersionEcOnly);
+      if (!known) {
+        std::fill(blob.begin(), blob.end(), 0);
+        throw Error(ErrorCode::InvalidArgument, "envelope does not hold a key blob");
+      }
+      out[i] = sealer.Seal(nonces.data() + i * kBackupNonceSize, no_aad, blob.data(), blob.size());
+      std::fill(blob.begin(), blob.end(), 0);
+    }
+  });
+  return out;
+}
+
+std::vector<std::unique_ptr<Keypair>> ContextImpl::RestoreBackupMany(
+  const BackupBundle& bundle,
+  const std::vector<BackupShare>& shares,
+  const std::vector<uint32_t>& indices) {
+  auto records = ParseBackupEnvelope(bundle.envelope);
+  const uint32_t count = static_cast<uint32_t>(records.size());
+  Ensure(bundle.record_count == count, ErrorCode::InvalidArgument, "backup record count mismatch");
+
+  std::vector<uint32_t> wanted = indices;
+  if (wanted.empty()) {
+    wanted.resize(count);
+    for (uint32_t i = 0; i < count; ++i) wanted[i] = i;
+  }
+  for (uint32_t index : wanted) Ensure(index < count, ErrorCode::InvalidArgument, "backup record index out of range");
+  MAANY_MPC_PROBE2(backup_restore_enter, shares.size(), wanted.size());
+
+  auto key_bytes = RecoverBackupKey(bundle.threshold, bundle.commitments, shares);
+  std::vector<std::unique_ptr<Keypair>> restored(wanted.size());
+  try {
+    pool_->ParallelFor(wanted.size(), [&](size_t i) {
+      const uint32_t index = wanted[i];
+      const auto& record = records[index];
+      auto aad = BackupRecordAad(bundle.label, count, index, record.header);
+      BufferOwner blob;
+      blob.bytes = OpenBackupPayload(key_bytes, aad, record.payload, record.payload_len);
+      restored[i] = ImportKey(blob);
+      std::fill(blob.bytes.begin(), blob.bytes.end(), 0);
+      Ensure(restored[i]->key_id().bytes == record.key_id.bytes, ErrorCode::Crypto, "backup record key id mismatch");
+    });
+  } catch (...) {
+    std::fill(key_bytes.begin(), key_bytes.end(), 0);
+    throw;
+  }
   std::fill(key_bytes.begin(), key_bytes.end(), 0);
+  MAANY_MPC_PROBE1(backup_restore_exit, restored.size());
   return restored;
 }
 
@@ -917,7 +3137,16 @@ std::unique_ptr<Context> Context::Create(const InitOptions& opts) {
 
 Context::~Context() = default;
 Keypair::~Keypair() = default;
+Kek::~Kek() = default;
 DkgSession::~DkgSession() = default;
+
+std::vector<std::unique_ptr<Keypair>> DkgSession::FinalizeMany() {
+  std::vector<std::unique_ptr<Keypair>> keys;
+  keys.push_back(Finalize());
+  return keys;
+}
 SignSession::~SignSession() = default;
+MpDkgSession::~MpDkgSession() = default;
+MpSignSession::~MpSignSession() = default;
 
 }  // namespace maany::bridge
@@ -0,0 +1,111 @@
+#include "log.h"
+
+#include <chrono>
+#include <utility>
+
+namespace maany::bridge {
+
+namespace {
+
+constexpr int kLogOff = -1;
+
+uint64_t NowSecond() {
+  return static_cast<uint64_t>(
+    std::chrono::duration_cast<std::chrono::seconds>(std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+bool NeedsQuotes(const std::string& value) {
+  if (value.empty()) return true;
+  for (char c : value) {
+    if (c == ' ' || c == '"' || c == '=' || c == '\\' || c == '\n' || c == '\t') return true;
+  }
+  return false;
+}
+
+}  // namespace
+
+LogLine::LogLine(const char* event) {
+  text_.reserve(128);
+  text_ += "event=";
+  text_ += event;
+}
+
+LogLine& LogLine::Add(const char* key, uint64_t value) {
+  text_ += ' ';
+  text_ += key;
+  text_ += '=';
+  text_ += std::to_string(value);
+  return *this;
+}
+
+LogLine& LogLine::Add(const char* key, const std::string& value) {
+  text_ += ' ';
+  text_ += key;
+  text_ += '=';
+  if (!NeedsQuotes(value)) {
+    text_ += value;
+    return *this;
+  }
+  text_ += '"';
+  for (char c : value) {
+    if (c == '"' || c == '\\') text_ += '\\';
+    text_ += c == '\n' || c == '\t' ? ' ' : c;
+  }
+  text_ += '"';
+  return *this;
+}
+
+LogLine& LogLine::AddHex(const char* key, const uint8_t* data, size_t len) {
+  static constexpr char kHex[] = "0123456789abcdef";
+  text_ += ' ';
+  text_ += key;
+  text_ += '=';
+  for (size_t i = 0; i < len; ++i) {
+    text_ += kHex[data[i] >> 4];
+    text_ += kHex[data[i] & 0xf];
+  }
+  return *this;
+}
+
+Logger::Logger(LogCallback sink, LogLevel level)
+    : sink_(std::move(sink)), level_(sink_ ? static_cast<int>(level) : kLogOff) {}
+
+void Logger::Configure(const LogConfig& config) {
+  max_per_second_.store(config.max_per_second, std::memory_order_relaxed);
+  sample_every_.store(config.sample_every ? config.sample_every : 1, std::memory_order_relaxed);
+  level_.store(sink_ ? static_cast<int>(config.level) : kLogOff, std::memory_order_relaxed);
+}
+
+bool Logger::ShouldLog(LogLevel level, uint64_t session) {
+  if (!Enabled(level)) return false;
+  if (session && level >= LogLevel::Info) {
+    const uint32_t every = sample_every_.load(std::memory_order_relaxed);
+    if (every > 1 && session % every != 0) return false;
+  }
+  return TakeToken();
+}
+
+// Fixed one-second windows: the first thread to see a new second resets the
+// count. A thread racing the reset can let a window run a few events over.
+bool Logger::TakeToken() {
+  const uint32_t limit = max_per_second_.load(std::memory_order_relaxed);
+  if (!limit) return true;
+  const uint64_t now = NowSecond();
+  uint64_t window = window_.load(std::memory_order_relaxed);
+  if (window != now && window_.compare_exchange_strong(window, now, std::memory_order_relaxed))
+    window_count_.store(0, std::memory_order_relaxed);
+  if (window_count_.fetch_add(1, std::memory_order_relaxed) < limit) return true;
+  suppressed_.fetch_add(1, std::memory_order_relaxed);
+  return false;
+}
+
+void Logger::Write(LogLevel level, LogLine& line) {
+  if (!sink_) return;
+  if (suppressed_.load(std::memory_order_relaxed)) {
+    const uint64_t dropped = suppressed_.exchange(0, std::memory_order_relaxed);
+    if (dropped) line.Add("suppressed", dropped);
+  }
+  sink_(static_cast<int>(level), line.text());
+}
+
+}  // namespace maany::bridge
@@ -1,8 +1,15 @@
 #include "maany_mpc.h"
 
 #include "bridge.h"
+#include "log.h"
+#include "metrics.h"
+#include "perf_counters.h"
+#include "primitive_profile.h"
+#include "share_store.h"
+#include "timeline.h"
 
 #include <algorithm>
+#include <chrono>
 #include <cstdlib>
 #include <cstring>
 #include <memory>
@@ -18,11 +25,14 @@ struct maany_mpc_ctx_s {
   maany_mpc_malloc_fn malloc_fn;
   maany_mpc_free_fn free_fn;
   maany_mpc_secure_zero_fn secure_zero_fn;
+  maany::bridge::Metrics metrics;
 };
 
 struct maany_mpc_dkg_s {
   std::unique_ptr<maany::bridge::DkgSession> session;
   maany_mpc_ctx_t* owner;
+  size_t key_count = 1;
+  maany::bridge::SessionMeter meter;
 };
 
 struct maany_mpc_kp_s {
@@ -33,17 +43,48 @@ struct maany_mpc_kp_s {
 struct maany_mpc_sign_s {
   std::unique_ptr<maany::bridge::SignSession> session;
   maany_mpc_ctx_t* owner;
+  maany::bridge::SessionMeter meter;
+};
+
+struct maany_mpc_tn_dkg_s {
+  std::unique_ptr<maany::bridge::MpDkgSession> session;
+  maany_mpc_ctx_t* owner;
+  maany::bridge::SessionMeter meter;
+};
+
+struct maany_mpc_tn_sign_s {
+  std::unique_ptr<maany::bridge::MpSignSession> session;
+  maany_mpc_ctx_t* owner;
+  maany::bridge::SessionMeter meter;
+};
+
+struct maany_mpc_kek_s {
+  std::shared_ptr<maany::bridge::Kek> kek;  // shared with stores opened under it
+  maany_mpc_ctx_t* owner;  // compared only; the context may be gone by kek_free
+  maany_mpc_free_fn free_fn;
+};
+
+struct maany_mpc_store_s {
+  std::unique_ptr<maany::bridge::ShareStore> store;
+  std::shared_ptr<maany::bridge::Kek> kek;
+  maany_mpc_ctx_t* owner;  // compared only, as for maany_mpc_kek_s
+  maany_mpc_free_fn free_fn;
 };
 
 namespace {
 
 using maany::bridge::BufferOwner;
+using maany::bridge::ByteView;
+using maany::bridge::ChainCode;
 using maany::bridge::Context;
 using maany::bridge::DkgOptions;
 using maany::bridge::DkgSession;
 using maany::bridge::Error;
 using maany::bridge::ErrorCode;
 using maany::bridge::KeyId;
+using maany::bridge::LogConfig;
+using maany::bridge::LogLevel;
+using maany::bridge::ShareStore;
 using maany::bridge::Keypair;
 using maany::bridge::PubKey;
 using maany::bridge::ShareKind;
@@ -56,7 +97,14 @@ using maany::bridge::Scheme;
 using maany::bridge::Curve;
 using maany::bridge::RefreshOptions;
 using maany::bridge::BackupCiphertext;
+using maany::bridge::BackupBundle;
 using maany::bridge::BackupShare;
+using maany::bridge::MpStepOutput;
+using maany::bridge::PeerMessage;
+using maany::bridge::ThresholdDkgOptions;
+using maany::bridge::ThresholdSignOptions;
+using maany::bridge::SessionType;
+using SteadyClock = std::chrono::steady_clock;
 
 void* DefaultMalloc(size_t n) {
   return std::malloc(n);
@@ -142,6 +190,9 @@ DkgOptions ConvertDkgOptions(const maany_mpc_dkg_opts_t& opts) {
     o.session_id.bytes.assign(static_cast<const uint8_t*>(opts.session_id.data),
                               static_cast<const uint8_t*>(opts.session_id.data) + opts.session_id.len);
   }
+  o.count = opts.count ? opts.count : 1;
+  o.defer_paillier = opts.defer_paillier != 0;
+  if (opts.transcript_path) o.transcript_path = opts.transcript_path;
   return o;
 }
 
@@ -157,6 +208,7 @@ SignOptions ConvertSignOptions(const maany_mpc_sign_opts_t* opts) {
     o.extra_aad.bytes.assign(static_cast<const uint8_t*>(opts->extra_aad.data),
                              static_cast<const uint8_t*>(opts->extra_aad.data) + opts->extra_aad.len);
   }
+  if (opts->transcript_path) o.transcript_path = opts->transcript_path;
   return o;
 }
 
@@ -167,9 +219,131 @@ RefreshOptions ConvertRefreshOptions(const maany_mpc_refresh_opts_t* opts) {
     o.session_id.bytes.assign(static_cast<const uint8_t*>(opts->session_id.data),
                               static_cast<const uint8_t*>(opts->session_id.data) + opts->session_id.len);
   }
+  o.reuse_paillier = opts->reuse_paillier != 0;
+  if (opts->transcript_path) o.transcript_path = opts->transcript_path;
+  return o;
+}
+
+ThresholdDkgOptions ConvertThresholdDkgOptions(const maany_mpc_tn_dkg_opts_t& opts) {
+  ThresholdDkgOptions o;
+  o.curve = static_cast<Curve>(opts.curve);
+  o.party_index = opts.party_index;
+  o.party_count = opts.party_count;
+  o.threshold = opts.threshold;
+  std::memcpy(o.key_id.bytes.data(), opts.key_id_hint.bytes, sizeof(opts.key_id_hint.bytes));
+  if (opts.session_id.data && opts.session_id.len) {
+    o.session_id.bytes.assign(static_cast<const uint8_t*>(opts.session_id.data),
+                              static_cast<const uint8_t*>(opts.session_id.data) + opts.session_id.len);
+  }
+  return o;
+}
+
+ThresholdSignOptions ConvertThresholdSignOptions(const maany_mpc_tn_sign_opts_t& opts) {
+  ThresholdSignOptions o;
+  if (opts.signer_count && !opts.signers) throw std::invalid_argument("null signer list");
+  o.signers.assign(opts.signers, opts.signers + opts.signer_count);
+  o.sig_receiver = opts.sig_receiver;
+  if (opts.session_id.data && opts.session_id.len) {
+    o.session_id.bytes.assign(static_cast<const uint8_t*>(opts.session_id.data),
+                              static_cast<const uint8_t*>(opts.session_id.data) + opts.session_id.len);
+  }
   return o;
 }
 
+size_t PeerMessageBytes(const std::vector<PeerMessage>& msgs) {
+  size_t total = 0;
+  for (const auto& m : msgs) total += m.data.bytes.size();
+  return total;
+}
+
+std::vector<PeerMessage> CopyInPeerMessages(const maany_mpc_peer_msg_t* msgs, size_t count) {
+  if (count && !msgs) throw std::invalid_argument("null peer message array");
+  std::vector<PeerMessage> out(count);
+  for (size_t i = 0; i < count; ++i) {
+    out[i].peer = msgs[i].peer;
+    out[i].data.bytes = CopyInBuffer(&msgs[i].msg);
+  }
+  return out;
+}
+
+void FreePeerMessages(maany_mpc_ctx_t* ctx, maany_mpc_peer_msg_t* msgs, size_t count) {
+  if (!msgs) return;
+  for (size_t i = 0; i < count; ++i) maany_mpc_buf_free(ctx, &msgs[i].msg);
+  auto free_fn = ctx->free_fn ? ctx->free_fn : DefaultFree;
+  free_fn(msgs);
+}
+
+maany_mpc_error_t CopyOutPeerMessages(
+  maany_mpc_ctx_t* ctx,
+  const std::vector<PeerMessage>& src,
+  maany_mpc_peer_msg_t** out_msgs,
+  size_t* out_count) {
+  *out_msgs = nullptr;
+  *out_count = 0;
+  if (src.empty()) return MAANY_MPC_OK;
+
+  auto alloc = ctx->malloc_fn ? ctx->malloc_fn : DefaultMalloc;
+  auto* msgs = static_cast<maany_mpc_peer_msg_t*>(alloc(sizeof(maany_mpc_peer_msg_t) * src.size()));
+  if (!msgs) return MAANY_MPC_ERR_MEMORY;
+  std::memset(msgs, 0, sizeof(maany_mpc_peer_msg_t) * src.size());
+  for (size_t i = 0; i < src.size(); ++i) {
+    msgs[i].peer = src[i].peer;
+    maany_mpc_error_t err = CopyOutBuffer(ctx, src[i].data.bytes, &msgs[i].msg);
+    if (err != MAANY_MPC_OK) {
+      FreePeerMessages(ctx, msgs, src.size());
+      return err;
+    }
+  }
+  *out_msgs = msgs;
+  *out_count = src.size();
+  return MAANY_MPC_OK;
+}
+
+// Throws std::invalid_argument on malformed buffers.
+BackupCiphertext ConvertBackupCiphertext(const maany_mpc_backup_ciphertext_t& in) {
+  BackupCiphertext artifact;
+  artifact.kind = static_cast<ShareKind>(in.kind);
+  artifact.scheme = static_cast<Scheme>(in.scheme);
+  artifact.curve = static_cast<Curve>(in.curve);
+  std::memcpy(artifact.key_id.bytes.data(), in.key_id.bytes, artifact.key_id.bytes.size());
+  artifact.threshold = in.threshold;
+  artifact.share_count = in.share_count;
+  artifact.label.bytes = CopyInBuffer(&in.label);
+  artifact.payload.bytes = CopyInBuffer(&in.ciphertext);
+  artifact.commitments.bytes = CopyInBuffer(&in.commitments);
+  artifact.ephemeral.bytes = CopyInBuffer(&in.ephemeral);
+  artifact.auth.bytes = CopyInBuffer(&in.auth);
+  return artifact;
+}
+
+// On failure every buffer already copied out is released again.
+maany_mpc_error_t CopyOutBackupCiphertext(
+  maany_mpc_ctx_t* ctx,
+  const BackupCiphertext& artifact,
+  maany_mpc_backup_ciphertext_t* out) {
+  *out = maany_mpc_backup_ciphertext_t{};
+  out->kind = static_cast<maany_mpc_share_kind_t>(artifact.kind);
+  out->scheme = static_cast<maany_mpc_scheme_t>(artifact.scheme);
+  out->curve = static_cast<maany_mpc_curve_t>(artifact.curve);
+  std::memcpy(out->key_id.bytes, artifact.key_id.bytes.data(), artifact.key_id.bytes.size());
+  out->threshold = artifact.threshold;
+  out->share_count = artifact.share_count;
+
+  maany_mpc_error_t status = CopyOutBuffer(ctx, artifact.label.bytes, &out->label);
+  if (status == MAANY_MPC_OK) status = CopyOutBuffer(ctx, artifact.payload.bytes, &out->ciphertext);
+  if (status == MAANY_MPC_OK) status = CopyOutBuffer(ctx, artifact.commitments.bytes, &out->commitments);
+  if (status == MAANY_MPC_OK) status = CopyOutBuffer(ctx, artifact.ephemeral.bytes, &out->ephemeral);
+  if (status == MAANY_MPC_OK) status = CopyOutBuffer(ctx, artifact.auth.bytes, &out->auth);
+  if (status != MAANY_MPC_OK) {
+    maany_mpc_buf_free(ctx, &out->label);
+    maany_mpc_buf_free(ctx, &out->ciphertext);
+    maany_mpc_buf_free(ctx, &out->commitments);
+    maany_mpc_buf_free(ctx, &out->ephemeral);
+    maany_mpc_buf_free(ctx, &out->auth);
+  }
+  return status;
+}
+
 maany_mpc_error_t FillMeta(const Keypair& kp, maany_mpc_kp_meta_t* out_meta) {
   if (!out_meta) return MAANY_MPC_ERR_INVALID_ARG;
   out_meta->kind = static_cast<maany_mpc_share_kind_t>(kp.kind());
@@ -180,6 +354,52 @@ maany_mpc_error_t FillMeta(const Keypair& kp, maany_mpc_kp_meta_t* out_meta) {
   return MAANY_MPC_OK;
 }
 
+maany_mpc_error_t CreateBackup(
+  maany_mpc_ctx_t* ctx,
+  const maany_mpc_keypair_t* kp,
+  uint32_t threshold,
+  size_t share_count,
+  const maany_mpc_buf_t* label,
+  maany_mpc_backup_ciphertext_t* out_ciphertext,
+  maany_mpc_backup_share_t* out_shares,
+  maany_mpc_buf_t* out_update_key) {
+  if (!ctx || !ctx->bridge || !kp || !kp->keypair || !out_ciphertext || !out_shares)
+    return MAANY_MPC_ERR_INVALID_ARG;
+
+  BufferOwner label_owner;
+  if (label && label->data && label->len) {
+    try {
+      label_owner.bytes = CopyInBuffer(label);
+    } catch (...) {
+      return MAANY_MPC_ERR_INVALID_ARG;
+    }
+  }
+
+  try {
+    BackupCiphertext artifact;
+    std::vector<BackupShare> shares;
+    BufferOwner update_key;
+    ctx->bridge->CreateBackup(*kp->keypair, threshold, share_count, label_owner, artifact, shares, update_key);
+
+    maany_mpc_error_t status = CopyOutBackupCiphertext(ctx, artifact, out_ciphertext);
+    if (status != MAANY_MPC_OK) return status;
+
+    if (shares.size() != share_count)
+      return MAANY_MPC_ERR_GENERAL;
+
+    for (size_t i = 0; i < share_count; ++i) {
+      status = CopyOutBuffer(ctx, shares[i].data.bytes, &out_shares[i].data);
+      if (status != MAANY_MPC_OK) return status;
+    }
+
+    if (out_update_key) status = CopyOutBuffer(ctx, update_key.bytes, out_update_key);
+    std::fill(update_key.bytes.begin(), update_key.bytes.end(), 0);
+    return status;
+  } catch (...) {
+    return TranslateException();
+  }
+}
+
 }  // namespace
 
 extern "C" {
@@ -210,10 +430,12 @@ maany_mpc_ctx_t* maany_mpc_init(const maany_mpc_init_opts_t* opts) {
   if (opts && opts->free_fn) {
     bridge_opts.free_fn = [cb = opts->free_fn](void* p) { cb(p); };
   }
+  if (opts) bridge_opts.max_threads = opts->max_threads;
   if (opts && opts->logger) {
     bridge_opts.logger = [cb = opts->logger](int level, const std::string& msg) {
       cb(static_cast<maany_mpc_log_level_t>(level), msg.c_str());
     };
+    bridge_opts.log_level = static_cast<LogLevel>(opts->log_level);
   }
 
   try {
@@ -234,6 +456,17 @@ void maany_mpc_shutdown(maany_mpc_ctx_t* ctx) {
   free_fn(ctx);
 }
 
+maany_mpc_error_t maany_mpc_log_configure(maany_mpc_ctx_t* ctx, const maany_mpc_log_config_t* config) {
+  if (!ctx || !ctx->bridge || !config) return MAANY_MPC_ERR_INVALID_ARG;
+  if (config->level < MAANY_MPC_LOG_ERROR || config->level > MAANY_MPC_LOG_DEBUG) return MAANY_MPC_ERR_INVALID_ARG;
+  LogConfig bridge_config;
+  bridge_config.level = static_cast<LogLevel>(config->level);
+  bridge_config.max_per_second = config->max_per_second;
+  bridge_config.sample_every = config->sample_every;
+  ctx->bridge->Log().Configure(bridge_config);
+  return MAANY_MPC_OK;
+}
+
 maany_mpc_version_t maany_mpc_version(void) {
   maany_mpc_version_t v = {MAANY_MPC_API_VERSION_MAJOR, MAANY_MPC_API_VERSION_MINOR,
                            MAANY_MPC_API_VERSION_PATCH};
@@ -310,145 +543,94 @@ maany_mpc_error_t maany_mpc_kp_import(
   }
 }
 
-void maany_mpc_kp_free(maany_mpc_keypair_t* kp) {
-  if (!kp) return;
-  maany_mpc_ctx_t* owner = kp->owner;
-  maany_mpc_free_fn free_fn = owner && owner->free_fn ? owner->free_fn : DefaultFree;
-  kp->keypair.reset();
-  kp->~maany_mpc_kp_s();
-  free_fn(kp);
-}
-
-maany_mpc_error_t maany_mpc_kp_meta(
-  maany_mpc_ctx_t* ctx,
-  const maany_mpc_keypair_t* kp,
-  maany_mpc_kp_meta_t* out_meta) {
-  if (!ctx || !kp || !kp->keypair || !out_meta) return MAANY_MPC_ERR_INVALID_ARG;
-  try {
-    return FillMeta(*kp->keypair, out_meta);
-  } catch (...) {
-    return TranslateException();
-  }
-}
-
-maany_mpc_error_t maany_mpc_kp_pubkey(
+maany_mpc_error_t maany_mpc_kek_register(
   maany_mpc_ctx_t* ctx,
-  const maany_mpc_keypair_t* kp,
-  maany_mpc_pubkey_t* out_pub) {
-  if (!ctx || !ctx->bridge || !kp || !kp->keypair || !out_pub) return MAANY_MPC_ERR_INVALID_ARG;
+  const maany_mpc_buf_t* key,
+  maany_mpc_kek_t** out_kek) {
+  if (!ctx || !ctx->bridge || !key || !out_kek) return MAANY_MPC_ERR_INVALID_ARG;
+  if (!key->data || key->len != 32) return MAANY_MPC_ERR_INVALID_ARG;
 
+  auto zero = ctx->secure_zero_fn ? ctx->secure_zero_fn : DefaultSecureZero;
+  BufferOwner key_owner;
   try {
-    PubKey pub = ctx->bridge->GetPubKey(*kp->keypair);
-    out_pub->curve = static_cast<maany_mpc_curve_t>(pub.curve);
-    return CopyOutBuffer(ctx, pub.compressed.bytes, &out_pub->pubkey);
+    key_owner.bytes = CopyInBuffer(key);
+    auto kek = ctx->bridge->CreateKek(key_owner);
+    zero(key_owner.bytes.data(), key_owner.bytes.size());
+
+    void* raw = ctx->malloc_fn(sizeof(maany_mpc_kek_s));
+    if (!raw) return MAANY_MPC_ERR_MEMORY;
+    auto* handle = new (raw) maany_mpc_kek_s();
+    handle->owner = ctx;
+    handle->free_fn = ctx->free_fn ? ctx->free_fn : DefaultFree;
+    handle->kek = std::move(kek);
+    *out_kek = handle;
+    return MAANY_MPC_OK;
   } catch (...) {
+    zero(key_owner.bytes.data(), key_owner.bytes.size());
     return TranslateException();
   }
 }
 
-void maany_mpc_buf_free(maany_mpc_ctx_t* ctx, maany_mpc_buf_t* buf) {
-  if (!ctx || !buf || !buf->data) return;
-  auto zero = ctx->secure_zero_fn ? ctx->secure_zero_fn : DefaultSecureZero;
-  zero(buf->data, buf->len);
-  auto free_fn = ctx->free_fn ? ctx->free_fn : DefaultFree;
-  free_fn(buf->data);
-  buf->data = nullptr;
-  buf->len = 0;
+void maany_mpc_kek_free(maany_mpc_kek_t* kek) {
+  if (!kek) return;
+  maany_mpc_free_fn free_fn = kek->free_fn;
+  kek->kek.reset();
+  kek->~maany_mpc_kek_s();
+  free_fn(kek);
 }
 
-maany_mpc_error_t maany_mpc_backup_create(
+maany_mpc_error_t maany_mpc_kp_export_sealed(
   maany_mpc_ctx_t* ctx,
   const maany_mpc_keypair_t* kp,
-  uint32_t threshold,
-  size_t share_count,
-  const maany_mpc_buf_t* label,
-  maany_mpc_backup_ciphertext_t* out_ciphertext,
-  maany_mpc_backup_share_t* out_shares) {
-  if (!ctx || !ctx->bridge || !kp || !kp->keypair || !out_ciphertext || !out_shares)
+  const maany_mpc_kek_t* kek,
+  const maany_mpc_buf_t* aad,
+  maany_mpc_buf_t* out_sealed) {
+  if (!ctx || !ctx->bridge || !kp || !kp->keypair || !kek || !kek->kek || !out_sealed)
     return MAANY_MPC_ERR_INVALID_ARG;
+  if (kek->owner != ctx) return MAANY_MPC_ERR_INVALID_ARG;
 
-  BufferOwner label_owner;
-  if (label && label->data && label->len) {
-    try {
-      label_owner.bytes = CopyInBuffer(label);
-    } catch (...) {
-      return MAANY_MPC_ERR_INVALID_ARG;
-    }
+  BufferOwner aad_owner;
+  try {
+    if (aad) aad_owner.bytes = CopyInBuffer(aad);
+  } catch (...) {
+    return MAANY_MPC_ERR_INVALID_ARG;
   }
 
   try {
-    BackupCiphertext artifact;
-    std::vector<BackupShare> shares;
-    ctx->bridge->CreateBackup(*kp->keypair, threshold, share_count, label_owner, artifact, shares);
-
-    out_ciphertext->kind = static_cast<maany_mpc_share_kind_t>(artifact.kind);
-    out_ciphertext->scheme = static_cast<maany_mpc_scheme_t>(artifact.scheme);
-    out_ciphertext->curve = static_cast<maany_mpc_curve_t>(artifact.curve);
-    std::memcpy(out_ciphertext->key_id.bytes, artifact.key_id.bytes.data(), artifact.key_id.bytes.size());
-    out_ciphertext->threshold = artifact.threshold;
-    out_ciphertext->share_count = artifact.share_count;
-
-    maany_mpc_error_t status = CopyOutBuffer(ctx, artifact.label.bytes, &out_ciphertext->label);
-    if (status != MAANY_MPC_OK) return status;
-    status = CopyOutBuffer(ctx, artifact.payload.bytes, &out_ciphertext->ciphertext);
-    if (status != MAANY_MPC_OK) return status;
-
-    if (shares.size() != share_count)
-      return MAANY_MPC_ERR_GENERAL;
-
-    for (size_t i = 0; i < share_count; ++i) {
-      status = CopyOutBuffer(ctx, shares[i].data.bytes, &out_shares[i].data);
-      if (status != MAANY_MPC_OK) return status;
-    }
-
-    return MAANY_MPC_OK;
+    BufferOwner sealed = ctx->bridge->ExportKeySealed(*kp->keypair, *kek->kek, aad_owner);
+    return CopyOutBuffer(ctx, sealed.bytes, out_sealed);
   } catch (...) {
     return TranslateException();
   }
 }
 
-maany_mpc_error_t maany_mpc_backup_restore(
+maany_mpc_error_t maany_mpc_kp_import_sealed(
   maany_mpc_ctx_t* ctx,
-  const maany_mpc_backup_ciphertext_t* ciphertext,
-  const maany_mpc_backup_share_t* shares,
-  size_t share_count,
+  const maany_mpc_kek_t* kek,
+  const maany_mpc_buf_t* aad,
+  const maany_mpc_buf_t* in_sealed,
   maany_mpc_keypair_t** out_kp) {
-  if (!ctx || !ctx->bridge || !ciphertext || !shares || !out_kp)
-    return MAANY_MPC_ERR_INVALID_ARG;
+  if (!ctx || !ctx->bridge || !kek || !kek->kek || !in_sealed || !out_kp) return MAANY_MPC_ERR_INVALID_ARG;
+  if (kek->owner != ctx) return MAANY_MPC_ERR_INVALID_ARG;
 
-  BackupCiphertext artifact;
-  artifact.kind = static_cast<ShareKind>(ciphertext->kind);
-  artifact.scheme = static_cast<Scheme>(ciphertext->scheme);
-  artifact.curve = static_cast<Curve>(ciphertext->curve);
-  std::memcpy(artifact.key_id.bytes.data(), ciphertext->key_id.bytes, artifact.key_id.bytes.size());
-  artifact.threshold = ciphertext->threshold;
-  artifact.share_count = ciphertext->share_count;
-
-  try {
-    artifact.label.bytes = CopyInBuffer(&ciphertext->label);
-    artifact.payload.bytes = CopyInBuffer(&ciphertext->ciphertext);
-  } catch (...) {
-    return MAANY_MPC_ERR_INVALID_ARG;
-  }
+  if (!in_sealed->data || in_sealed->len == 0) return MAANY_MPC_ERR_INVALID_ARG;
 
-  std::vector<BackupShare> share_vec;
-  share_vec.resize(share_count);
+  BufferOwner aad_owner;
   try {
-    for (size_t i = 0; i < share_count; ++i) {
-      share_vec[i].data.bytes = CopyInBuffer(&shares[i].data);
-    }
+    if (aad) aad_owner.bytes = CopyInBuffer(aad);
   } catch (...) {
     return MAANY_MPC_ERR_INVALID_ARG;
   }
 
   try {
-    auto restored = ctx->bridge->RestoreBackup(artifact, share_vec);
+    ByteView sealed{static_cast<const uint8_t*>(in_sealed->data), in_sealed->len};
+    auto key = ctx->bridge->ImportKeySealed(*kek->kek, aad_owner, sealed);
 
     void* raw = ctx->malloc_fn(sizeof(maany_mpc_kp_s));
     if (!raw) return MAANY_MPC_ERR_MEMORY;
     auto* handle = new (raw) maany_mpc_kp_s();
     handle->owner = ctx;
-    handle->keypair = std::move(restored);
+    handle->keypair = std::move(key);
     *out_kp = handle;
     return MAANY_MPC_OK;
   } catch (...) {
@@ -456,113 +638,694 @@ maany_mpc_error_t maany_mpc_backup_restore(
   }
 }
 
-maany_mpc_error_t maany_mpc_dkg_new(
+maany_mpc_error_t maany_mpc_store_open(
   maany_mpc_ctx_t* ctx,
-  const maany_mpc_dkg_opts_t* opts,
-  maany_mpc_dkg_t** out_dkg) {
-  if (!ctx || !ctx->bridge || !opts || !out_dkg) return MAANY_MPC_ERR_INVALID_ARG;
+  const char* path,
+  const maany_mpc_kek_t* kek,
+  const maany_mpc_store_opts_t* opts,
+  maany_mpc_store_t** out_store) {
+  if (!ctx || !ctx->bridge || !path || !*path || !kek || !kek->kek || !out_store) return MAANY_MPC_ERR_INVALID_ARG;
+  if (kek->owner != ctx) return MAANY_MPC_ERR_INVALID_ARG;
 
   try {
-    DkgOptions bridge_opts = ConvertDkgOptions(*opts);
-    auto session = ctx->bridge->CreateDkg(bridge_opts);
+    ShareStore::Options store_opts;
+    if (opts) store_opts.sync_writes = opts->sync_writes != 0;
+    auto store = ShareStore::Open(path, store_opts);
 
-    void* raw = ctx->malloc_fn(sizeof(maany_mpc_dkg_t));
+    void* raw = ctx->malloc_fn(sizeof(maany_mpc_store_s));
     if (!raw) return MAANY_MPC_ERR_MEMORY;
-    maany_mpc_dkg_t* handle = new (raw) maany_mpc_dkg_t();
+    auto* handle = new (raw) maany_mpc_store_s();
     handle->owner = ctx;
-    handle->session = std::move(session);
-    *out_dkg = handle;
+    handle->free_fn = ctx->free_fn ? ctx->free_fn : DefaultFree;
+    handle->kek = kek->kek;
+    handle->store = std::move(store);
+    *out_store = handle;
     return MAANY_MPC_OK;
   } catch (...) {
     return TranslateException();
   }
 }
 
-maany_mpc_error_t maany_mpc_dkg_step(
+void maany_mpc_store_close(maany_mpc_store_t* store) {
+  if (!store) return;
+  maany_mpc_free_fn free_fn = store->free_fn;
+  store->store.reset();
+  store->kek.reset();
+  store->~maany_mpc_store_s();
+  free_fn(store);
+}
+
+maany_mpc_error_t maany_mpc_store_put(
   maany_mpc_ctx_t* ctx,
-  maany_mpc_dkg_t* dkg,
-  const maany_mpc_buf_t* in_peer_msg,
-  maany_mpc_buf_t* out_msg,
-  maany_mpc_step_result_t* result) {
-  if (!ctx || !dkg || !dkg->session) return MAANY_MPC_ERR_INVALID_ARG;
-  if (out_msg) {
-    out_msg->data = nullptr;
-    out_msg->len = 0;
-  }
-  if (result) *result = MAANY_MPC_STEP_CONTINUE;
+  maany_mpc_store_t* store,
+  const maany_mpc_keypair_t* kp) {
+  if (!ctx || !ctx->bridge || !store || !store->store || !kp || !kp->keypair) return MAANY_MPC_ERR_INVALID_ARG;
+  if (store->owner != ctx) return MAANY_MPC_ERR_INVALID_ARG;
 
   try {
-    std::optional<BufferOwner> inbound;
-    if (in_peer_msg && in_peer_msg->len) {
-      try {
-        inbound = BufferOwner{CopyInBuffer(in_peer_msg)};
-      } catch (...) {
-        return MAANY_MPC_ERR_INVALID_ARG;
-      }
-    } else if (in_peer_msg && in_peer_msg->len == 0) {
-      inbound = BufferOwner{};
-    }
-
-    StepOutput output = dkg->session->Step(inbound);
-    if (output.outbound && !out_msg) return MAANY_MPC_ERR_INVALID_ARG;
-    if (out_msg && output.outbound) {
-      maany_mpc_error_t err = CopyOutBuffer(ctx, output.outbound->bytes, out_msg);
-      if (err != MAANY_MPC_OK) return err;
-    }
-    if (result) *result = static_cast<maany_mpc_step_result_t>(output.state);
+    const KeyId id = kp->keypair->key_id();
+    if (std::all_of(id.bytes.begin(), id.bytes.end(), [](uint8_t b) { return b == 0; }))
+      return MAANY_MPC_ERR_INVALID_ARG;
+    BufferOwner aad{std::vector<uint8_t>(id.bytes.begin(), id.bytes.end())};
+    BufferOwner sealed = ctx->bridge->ExportKeySealed(*kp->keypair, *store->kek, aad);
+    store->store->Put(id, sealed.bytes.data(), sealed.bytes.size());
     return MAANY_MPC_OK;
   } catch (...) {
     return TranslateException();
   }
 }
 
-maany_mpc_error_t maany_mpc_dkg_finalize(
+maany_mpc_error_t maany_mpc_store_get(
   maany_mpc_ctx_t* ctx,
-  maany_mpc_dkg_t* dkg,
-  maany_mpc_keypair_t** out_local_share) {
-  if (!ctx || !dkg || !dkg->session || !out_local_share) return MAANY_MPC_ERR_INVALID_ARG;
+  maany_mpc_store_t* store,
+  const maany_mpc_key_id_t* key_id,
+  maany_mpc_keypair_t** out_kp) {
+  if (!ctx || !ctx->bridge || !store || !store->store || !key_id || !out_kp) return MAANY_MPC_ERR_INVALID_ARG;
+  if (store->owner != ctx) return MAANY_MPC_ERR_INVALID_ARG;
+  *out_kp = nullptr;
 
   try {
-    auto key = dkg->session->Finalize();
-    dkg->session.reset();
+    KeyId id;
+    std::memcpy(id.bytes.data(), key_id->bytes, id.bytes.size());
+    BufferOwner aad{std::vector<uint8_t>(id.bytes.begin(), id.bytes.end())};
+    std::unique_ptr<Keypair> key;
+    bool found = store->store->Read(id, [&](ByteView sealed) {
+      key = ctx->bridge->ImportKeySealed(*store->kek, aad, sealed);
+    });
+    ctx->metrics.RecordStoreLookup(found);
+    if (!found) return MAANY_MPC_OK;
 
     void* raw = ctx->malloc_fn(sizeof(maany_mpc_kp_s));
     if (!raw) return MAANY_MPC_ERR_MEMORY;
     auto* handle = new (raw) maany_mpc_kp_s();
     handle->owner = ctx;
     handle->keypair = std::move(key);
-    *out_local_share = handle;
+    *out_kp = handle;
     return MAANY_MPC_OK;
   } catch (...) {
     return TranslateException();
   }
 }
 
-void maany_mpc_dkg_free(maany_mpc_dkg_t* dkg) {
-  if (!dkg) return;
-  maany_mpc_ctx_t* owner = dkg->owner;
-  maany_mpc_free_fn free_fn = owner && owner->free_fn ? owner->free_fn : DefaultFree;
-  dkg->session.reset();
-  dkg->~maany_mpc_dkg_s();
-  free_fn(dkg);
-}
-
-maany_mpc_error_t maany_mpc_sign_new(
+maany_mpc_error_t maany_mpc_store_remove(
   maany_mpc_ctx_t* ctx,
-  const maany_mpc_keypair_t* kp,
-  const maany_mpc_sign_opts_t* opts,
-  maany_mpc_sign_t** out_sign) {
-  if (!ctx || !ctx->bridge || !kp || !kp->keypair || !out_sign) return MAANY_MPC_ERR_INVALID_ARG;
+  maany_mpc_store_t* store,
+  const maany_mpc_key_id_t* key_id,
+  uint32_t* out_removed) {
+  if (!ctx || !store || !store->store || !key_id) return MAANY_MPC_ERR_INVALID_ARG;
+  if (store->owner != ctx) return MAANY_MPC_ERR_INVALID_ARG;
 
   try {
-    SignOptions bridge_opts = ConvertSignOptions(opts);
-    auto session = ctx->bridge->CreateSign(*kp->keypair, bridge_opts);
-
-    void* raw = ctx->malloc_fn(sizeof(maany_mpc_sign_s));
-    if (!raw) return MAANY_MPC_ERR_MEMORY;
+    KeyId id;
+    std::memcpy(id.bytes.data(), key_id->bytes, id.bytes.size());
+    bool removed = store->store->Remove(id);
+    if (out_removed) *out_removed = removed ? 1u : 0u;
+    return MAANY_MPC_OK;
+  } catch (...) {
+    return TranslateException();
+  }
+}
+
+maany_mpc_error_t maany_mpc_store_compact(maany_mpc_ctx_t* ctx, maany_mpc_store_t* store) {
+  if (!ctx || !store || !store->store) return MAANY_MPC_ERR_INVALID_ARG;
+  if (store->owner != ctx) return MAANY_MPC_ERR_INVALID_ARG;
+  try {
+    store->store->Compact();
+    return MAANY_MPC_OK;
+  } catch (...) {
+    return TranslateException();
+  }
+}
+
+maany_mpc_error_t maany_mpc_store_sync(maany_mpc_ctx_t* ctx, maany_mpc_store_t* store) {
+  if (!ctx || !store || !store->store) return MAANY_MPC_ERR_INVALID_ARG;
+  if (store->owner != ctx) return MAANY_MPC_ERR_INVALID_ARG;
+  try {
+    store->store->Sync();
+    return MAANY_MPC_OK;
+  } catch (...) {
+    return TranslateException();
+  }
+}
+
+maany_mpc_error_t maany_mpc_store_stats(
+  maany_mpc_ctx_t* ctx,
+  maany_mpc_store_t* store,
+  maany_mpc_store_stats_t* out_stats) {
+  if (!ctx || !store || !store->store || !out_stats) return MAANY_MPC_ERR_INVALID_ARG;
+  if (store->owner != ctx) return MAANY_MPC_ERR_INVALID_ARG;
+  try {
+    auto stats = store->store->GetStats();
+    out_stats->live_records = stats.live_records;
+    out_stats->live_bytes = stats.live_bytes;
+    out_stats->file_bytes = stats.file_bytes;
+    return MAANY_MPC_OK;
+  } catch (...) {
+    return TranslateException();
+  }
+}
+
+void maany_mpc_kp_free(maany_mpc_keypair_t* kp) {
+  if (!kp) return;
+  maany_mpc_ctx_t* owner = kp->owner;
+  maany_mpc_free_fn free_fn = owner && owner->free_fn ? owner->free_fn : DefaultFree;
+  kp->keypair.reset();
+  kp->~maany_mpc_kp_s();
+  free_fn(kp);
+}
+
+maany_mpc_error_t maany_mpc_kp_meta(
+  maany_mpc_ctx_t* ctx,
+  const maany_mpc_keypair_t* kp,
+  maany_mpc_kp_meta_t* out_meta) {
+  if (!ctx || !kp || !kp->keypair || !out_meta) return MAANY_MPC_ERR_INVALID_ARG;
+  try {
+    return FillMeta(*kp->keypair, out_meta);
+  } catch (...) {
+    return TranslateException();
+  }
+}
+
+maany_mpc_error_t maany_mpc_kp_pubkey(
+  maany_mpc_ctx_t* ctx,
+  const maany_mpc_keypair_t* kp,
+  maany_mpc_pubkey_t* out_pub) {
+  if (!ctx || !ctx->bridge || !kp || !kp->keypair || !out_pub) return MAANY_MPC_ERR_INVALID_ARG;
+
+  try {
+    PubKey pub = ctx->bridge->GetPubKey(*kp->keypair);
+    out_pub->curve = static_cast<maany_mpc_curve_t>(pub.curve);
+    return CopyOutBuffer(ctx, pub.compressed.bytes, &out_pub->pubkey);
+  } catch (...) {
+    return TranslateException();
+  }
+}
+
+maany_mpc_error_t maany_mpc_kp_derive_child(
+  maany_mpc_ctx_t* ctx,
+  const maany_mpc_keypair_t* kp,
+  const maany_mpc_chain_code_t* chain_code,
+  const maany_mpc_bip32_path_t* path,
+  maany_mpc_keypair_t** out_child) {
+  if (!ctx || !ctx->bridge || !kp || !kp->keypair || !chain_code || !path || !out_child)
+    return MAANY_MPC_ERR_INVALID_ARG;
+  if (!path->indices || path->len == 0) return MAANY_MPC_ERR_INVALID_ARG;
+
+  try {
+    ChainCode cc;
+    std::memcpy(cc.bytes.data(), chain_code->bytes, cc.bytes.size());
+    std::vector<uint32_t> indices(path->indices, path->indices + path->len);
+    auto child = ctx->bridge->DeriveChild(*kp->keypair, cc, indices);
+
+    void* raw = ctx->malloc_fn(sizeof(maany_mpc_kp_s));
+    if (!raw) return MAANY_MPC_ERR_MEMORY;
+    auto* handle = new (raw) maany_mpc_kp_s();
+    handle->owner = ctx;
+    handle->keypair = std::move(child);
+    *out_child = handle;
+    return MAANY_MPC_OK;
+  } catch (...) {
+    return TranslateException();
+  }
+}
+
+maany_mpc_error_t maany_mpc_kp_derive_pubkeys(
+  maany_mpc_ctx_t* ctx,
+  const maany_mpc_keypair_t* kp,
+  const maany_mpc_chain_code_t* chain_code,
+  const maany_mpc_bip32_path_t* parent_path,
+  uint32_t first_index,
+  size_t count,
+  maany_mpc_pubkey_t* out_pubs) {
+  if (!ctx || !ctx->bridge || !kp || !kp->keypair || !chain_code || !out_pubs || count == 0)
+    return MAANY_MPC_ERR_INVALID_ARG;
+  if (parent_path && parent_path->len && !parent_path->indices) return MAANY_MPC_ERR_INVALID_ARG;
+
+  try {
+    ChainCode cc;
+    std::memcpy(cc.bytes.data(), chain_code->bytes, cc.bytes.size());
+    std::vector<uint32_t> indices;
+    if (parent_path && parent_path->len)
+      indices.assign(parent_path->indices, parent_path->indices + parent_path->len);
+    auto pubs = ctx->bridge->DerivePubKeys(*kp->keypair, cc, indices, first_index, count);
+
+    for (size_t i = 0; i < count; ++i) out_pubs[i] = maany_mpc_pubkey_t{};
+    for (size_t i = 0; i < count; ++i) {
+      out_pubs[i].curve = static_cast<maany_mpc_curve_t>(pubs[i].curve);
+      maany_mpc_error_t err = CopyOutBuffer(ctx, pubs[i].compressed.bytes, &out_pubs[i].pubkey);
+      if (err != MAANY_MPC_OK) {
+        for (size_t j = 0; j < i; ++j) maany_mpc_buf_free(ctx, &out_pubs[j].pubkey);
+        return err;
+      }
+    }
+    return MAANY_MPC_OK;
+  } catch (...) {
+    return TranslateException();
+  }
+}
+
+void maany_mpc_buf_free(maany_mpc_ctx_t* ctx, maany_mpc_buf_t* buf) {
+  if (!ctx || !buf || !buf->data) return;
+  auto zero = ctx->secure_zero_fn ? ctx->secure_zero_fn : DefaultSecureZero;
+  zero(buf->data, buf->len);
+  auto free_fn = ctx->free_fn ? ctx->free_fn : DefaultFree;
+  free_fn(buf->data);
+  buf->data = nullptr;
+  buf->len = 0;
+}
+
+maany_mpc_error_t maany_mpc_backup_create(
+  maany_mpc_ctx_t* ctx,
+  const maany_mpc_keypair_t* kp,
+  uint32_t threshold,
+  size_t share_count,
+  const maany_mpc_buf_t* label,
+  maany_mpc_backup_ciphertext_t* out_ciphertext,
+  maany_mpc_backup_share_t* out_shares) {
+  return CreateBackup(ctx, kp, threshold, share_count, label, out_ciphertext, out_shares, nullptr);
+}
+
+maany_mpc_error_t maany_mpc_backup_create_updatable(
+  maany_mpc_ctx_t* ctx,
+  const maany_mpc_keypair_t* kp,
+  uint32_t threshold,
+  size_t share_count,
+  const maany_mpc_buf_t* label,
+  maany_mpc_backup_ciphertext_t* out_ciphertext,
+  maany_mpc_backup_share_t* out_shares,
+  maany_mpc_buf_t* out_update_key) {
+  if (!out_update_key) return MAANY_MPC_ERR_INVALID_ARG;
+  return CreateBackup(ctx, kp, threshold, share_count, label, out_ciphertext, out_shares, out_update_key);
+}
+
+maany_mpc_error_t maany_mpc_backup_restore(
+  maany_mpc_ctx_t* ctx,
+  const maany_mpc_backup_ciphertext_t* ciphertext,
+  const maany_mpc_backup_share_t* shares,
+  size_t share_count,
+  maany_mpc_keypair_t** out_kp) {
+  if (!ctx || !ctx->bridge || !ciphertext || !shares || !out_kp)
+    return MAANY_MPC_ERR_INVALID_ARG;
+
+  BackupCiphertext artifact;
+  try {
+    artifact = ConvertBackupCiphertext(*ciphertext);
+  } catch (...) {
+    return MAANY_MPC_ERR_INVALID_ARG;
+  }
+
+  std::vector<BackupShare> share_vec;
+  share_vec.resize(share_count);
+  try {
+    for (size_t i = 0; i < share_count; ++i) {
+      share_vec[i].data.bytes = CopyInBuffer(&shares[i].data);
+    }
+  } catch (...) {
+    return MAANY_MPC_ERR_INVALID_ARG;
+  }
+
+  try {
+    auto restored = ctx->bridge->RestoreBackup(artifact, share_vec);
+
+    void* raw = ctx->malloc_fn(sizeof(maany_mpc_kp_s));
+    if (!raw) return MAANY_MPC_ERR_MEMORY;
+    auto* handle = new (raw) maany_mpc_kp_s();
+    handle->owner = ctx;
+    handle->keypair = std::move(restored);
+    *out_kp = handle;
+    return MAANY_MPC_OK;
+  } catch (...) {
+    return TranslateException();
+  }
+}
+
+maany_mpc_error_t maany_mpc_backup_update(
+  maany_mpc_ctx_t* ctx,
+  const maany_mpc_keypair_t* kp,
+  const maany_mpc_backup_ciphertext_t* existing,
+  const maany_mpc_buf_t* update_key,
+  maany_mpc_backup_ciphertext_t* out_ciphertext) {
+  if (!ctx || !ctx->bridge || !kp || !kp->keypair || !existing || !update_key || !update_key->data ||
+      !out_ciphertext)
+    return MAANY_MPC_ERR_INVALID_ARG;
+
+  BackupCiphertext current;
+  BufferOwner key_owner;
+  try {
+    current = ConvertBackupCiphertext(*existing);
+    key_owner.bytes = CopyInBuffer(update_key);
+  } catch (...) {
+    return MAANY_MPC_ERR_INVALID_ARG;
+  }
+
+  try {
+    BackupCiphertext updated;
+    ctx->bridge->UpdateBackup(*kp->keypair, current, key_owner, updated);
+    std::fill(key_owner.bytes.begin(), key_owner.bytes.end(), 0);
+    return CopyOutBackupCiphertext(ctx, updated, out_ciphertext);
+  } catch (...) {
+    std::fill(key_owner.bytes.begin(), key_owner.bytes.end(), 0);
+    return TranslateException();
+  }
+}
+
+maany_mpc_error_t maany_mpc_backup_create_many(
+  maany_mpc_ctx_t* ctx,
+  const maany_mpc_keypair_t* const* kps,
+  size_t kp_count,
+  uint32_t threshold,
+  size_t share_count,
+  const maany_mpc_buf_t* label,
+  maany_mpc_backup_bundle_t* out_bundle,
+  maany_mpc_backup_share_t* out_shares) {
+  if (!ctx || !ctx->bridge || !kps || kp_count == 0 || !out_bundle || !out_shares)
+    return MAANY_MPC_ERR_INVALID_ARG;
+
+  BufferOwner label_owner;
+  if (label && label->data && label->len) {
+    try {
+      label_owner.bytes = CopyInBuffer(label);
+    } catch (...) {
+      return MAANY_MPC_ERR_INVALID_ARG;
+    }
+  }
+
+  try {
+    std::vector<const Keypair*> keys;
+    keys.reserve(kp_count);
+    for (size_t i = 0; i < kp_count; ++i) {
+      if (!kps[i] || !kps[i]->keypair) return MAANY_MPC_ERR_INVALID_ARG;
+      keys.push_back(kps[i]->keypair.get());
+    }
+
+    BackupBundle bundle;
+    std::vector<BackupShare> shares;
+    ctx->bridge->CreateBackupMany(keys, threshold, share_count, label_owner, bundle, shares);
+    if (shares.size() != share_count)
+      return MAANY_MPC_ERR_GENERAL;
+
+    *out_bundle = maany_mpc_backup_bundle_t{};
+    out_bundle->threshold = bundle.threshold;
+    out_bundle->share_count = bundle.share_count;
+    out_bundle->record_count = bundle.record_count;
+    maany_mpc_error_t status = CopyOutBuffer(ctx, bundle.label.bytes, &out_bundle->label);
+    if (status == MAANY_MPC_OK) status = CopyOutBuffer(ctx, bundle.envelope.bytes, &out_bundle->envelope);
+    if (status == MAANY_MPC_OK) status = CopyOutBuffer(ctx, bundle.commitments.bytes, &out_bundle->commitments);
+    for (size_t i = 0; i < share_count && status == MAANY_MPC_OK; ++i) {
+      out_shares[i] = maany_mpc_backup_share_t{};
+      status = CopyOutBuffer(ctx, shares[i].data.bytes, &out_shares[i].data);
+      if (status != MAANY_MPC_OK) {
+        for (size_t j = 0; j < i; ++j) maany_mpc_buf_free(ctx, &out_shares[j].data);
+      }
+    }
+    if (status != MAANY_MPC_OK) {
+      maany_mpc_buf_free(ctx, &out_bundle->label);
+      maany_mpc_buf_free(ctx, &out_bundle->envelope);
+      maany_mpc_buf_free(ctx, &out_bundle->commitments);
+    }
+    return status;
+  } catch (...) {
+    return TranslateException();
+  }
+}
+
+maany_mpc_error_t maany_mpc_backup_restore_many(
+  maany_mpc_ctx_t* ctx,
+  const maany_mpc_backup_bundle_t* bundle,
+  const maany_mpc_backup_share_t* shares,
+  size_t share_count,
+  const uint32_t* indices,
+  size_t index_count,
+  maany_mpc_keypair_t** out_kps) {
+  if (!ctx || !ctx->bridge || !bundle || !shares || index_count == 0 || !out_kps)
+    return MAANY_MPC_ERR_INVALID_ARG;
+  if (!indices && index_count != bundle->record_count) return MAANY_MPC_ERR_INVALID_ARG;
+
+  BackupBundle artifact;
+  artifact.threshold = bundle->threshold;
+  artifact.share_count = bundle->share_count;
+  artifact.record_count = bundle->record_count;
+  std::vector<BackupShare> share_vec(share_count);
+  try {
+    artifact.label.bytes = CopyInBuffer(&bundle->label);
+    artifact.envelope.bytes = CopyInBuffer(&bundle->envelope);
+    artifact.commitments.bytes = CopyInBuffer(&bundle->commitments);
+    for (size_t i = 0; i < share_count; ++i) {
+      share_vec[i].data.bytes = CopyInBuffer(&shares[i].data);
+    }
+  } catch (...) {
+    return MAANY_MPC_ERR_INVALID_ARG;
+  }
+
+  try {
+    std::vector<uint32_t> wanted;
+    if (indices) wanted.assign(indices, indices + index_count);
+    auto restored = ctx->bridge->RestoreBackupMany(artifact, share_vec, wanted);
+    if (restored.size() != index_count) return MAANY_MPC_ERR_GENERAL;
+
+    std::vector<maany_mpc_keypair_t*> handles;
+    handles.reserve(restored.size());
+    for (auto& key : restored) {
+      void* raw = ctx->malloc_fn(sizeof(maany_mpc_kp_s));
+      if (!raw) {
+        for (auto* handle : handles) maany_mpc_kp_free(handle);
+        return MAANY_MPC_ERR_MEMORY;
+      }
+      auto* handle = new (raw) maany_mpc_kp_s();
+      handle->owner = ctx;
+      handle->keypair = std::move(key);
+      handles.push_back(handle);
+    }
+    std::copy(handles.begin(), handles.end(), out_kps);
+    return MAANY_MPC_OK;
+  } catch (...) {
+    return TranslateException();
+  }
+}
+
+maany_mpc_error_t maany_mpc_backup_verify_shares(
+  maany_mpc_ctx_t* ctx,
+  const maany_mpc_buf_t* commitments,
+  uint32_t threshold,
+  const maany_mpc_backup_share_t* shares,
+  size_t share_count,
+  uint8_t* out_valid) {
+  if (!ctx || !ctx->bridge || !commitments || !shares || share_count == 0 || !out_valid)
+    return MAANY_MPC_ERR_INVALID_ARG;
+
+  BufferOwner commitments_owner;
+  std::vector<BackupShare> share_vec(share_count);
+  try {
+    commitments_owner.bytes = CopyInBuffer(commitments);
+    for (size_t i = 0; i < share_count; ++i) {
+      share_vec[i].data.bytes = CopyInBuffer(&shares[i].data);
+    }
+  } catch (...) {
+    return MAANY_MPC_ERR_INVALID_ARG;
+  }
+
+  try {
+    auto valid = ctx->bridge->VerifyBackupShares(commitments_owner, threshold, share_vec);
+    for (size_t i = 0; i < share_count; ++i) out_valid[i] = valid[i] ? 1 : 0;
+    return MAANY_MPC_OK;
+  } catch (...) {
+    return TranslateException();
+  }
+}
+
+maany_mpc_error_t maany_mpc_envelope_rewrap_many(
+  maany_mpc_ctx_t* ctx,
+  const maany_mpc_buf_t* old_kek,
+  const maany_mpc_buf_t* new_kek,
+  const maany_mpc_buf_t* blobs,
+  size_t blob_count,
+  maany_mpc_buf_t* out_blobs) {
+  if (!ctx || !ctx->bridge || !old_kek || !new_kek || !blobs || blob_count == 0 || !out_blobs)
+    return MAANY_MPC_ERR_INVALID_ARG;
+
+  BufferOwner old_owner;
+  BufferOwner new_owner;
+  // Blobs are only read, so they are borrowed rather than copied.
+  std::vector<ByteView> views(blob_count);
+  try {
+    old_owner.bytes = CopyInBuffer(old_kek);
+    new_owner.bytes = CopyInBuffer(new_kek);
+  } catch (...) {
+    return MAANY_MPC_ERR_INVALID_ARG;
+  }
+  for (size_t i = 0; i < blob_count; ++i) {
+    if (!blobs[i].data || blobs[i].len == 0) return MAANY_MPC_ERR_INVALID_ARG;
+    views[i].data = static_cast<const uint8_t*>(blobs[i].data);
+    views[i].len = blobs[i].len;
+  }
+
+  try {
+    auto rewrapped = ctx->bridge->RewrapEnvelopes(old_owner, new_owner, views);
+    std::fill(old_owner.bytes.begin(), old_owner.bytes.end(), 0);
+    std::fill(new_owner.bytes.begin(), new_owner.bytes.end(), 0);
+    for (size_t i = 0; i < blob_count; ++i) {
+      maany_mpc_error_t status = CopyOutBuffer(ctx, rewrapped[i].bytes, &out_blobs[i]);
+      if (status != MAANY_MPC_OK) {
+        for (size_t j = 0; j < i; ++j) maany_mpc_buf_free(ctx, &out_blobs[j]);
+        return status;
+      }
+    }
+    return MAANY_MPC_OK;
+  } catch (...) {
+    std::fill(old_owner.bytes.begin(), old_owner.bytes.end(), 0);
+    std::fill(new_owner.bytes.begin(), new_owner.bytes.end(), 0);
+    return TranslateException();
+  }
+}
+
+maany_mpc_error_t maany_mpc_dkg_new(
+  maany_mpc_ctx_t* ctx,
+  const maany_mpc_dkg_opts_t* opts,
+  maany_mpc_dkg_t** out_dkg) {
+  if (!ctx || !ctx->bridge || !opts || !out_dkg) return MAANY_MPC_ERR_INVALID_ARG;
+
+  try {
+    DkgOptions bridge_opts = ConvertDkgOptions(*opts);
+    auto session = ctx->bridge->CreateDkg(bridge_opts);
+
+    void* raw = ctx->malloc_fn(sizeof(maany_mpc_dkg_t));
+    if (!raw) return MAANY_MPC_ERR_MEMORY;
+    maany_mpc_dkg_t* handle = new (raw) maany_mpc_dkg_t();
+    handle->owner = ctx;
+    handle->session = std::move(session);
+    handle->key_count = bridge_opts.count;
+    handle->meter.Start(&ctx->metrics, &ctx->bridge->Log(), SessionType::Dkg, &bridge_opts.session_id);
+    *out_dkg = handle;
+    return MAANY_MPC_OK;
+  } catch (...) {
+    return TranslateException();
+  }
+}
+
+maany_mpc_error_t maany_mpc_dkg_step(
+  maany_mpc_ctx_t* ctx,
+  maany_mpc_dkg_t* dkg,
+  const maany_mpc_buf_t* in_peer_msg,
+  maany_mpc_buf_t* out_msg,
+  maany_mpc_step_result_t* result) {
+  if (!ctx || !dkg || !dkg->session) return MAANY_MPC_ERR_INVALID_ARG;
+  if (out_msg) {
+    out_msg->data = nullptr;
+    out_msg->len = 0;
+  }
+  if (result) *result = MAANY_MPC_STEP_CONTINUE;
+
+  try {
+    std::optional<BufferOwner> inbound;
+    if (in_peer_msg && in_peer_msg->len) {
+      try {
+        inbound = BufferOwner{CopyInBuffer(in_peer_msg)};
+      } catch (...) {
+        return MAANY_MPC_ERR_INVALID_ARG;
+      }
+    } else if (in_peer_msg && in_peer_msg->len == 0) {
+      inbound = BufferOwner{};
+    }
+
+    const auto start = SteadyClock::now();
+    StepOutput output = dkg->session->Step(inbound);
+    dkg->meter.Step(start, inbound ? inbound->bytes.size() : 0,
+                    output.outbound ? output.outbound->bytes.size() : 0, output.state == StepState::Done);
+    if (output.outbound && !out_msg) return MAANY_MPC_ERR_INVALID_ARG;
+    if (out_msg && output.outbound) {
+      maany_mpc_error_t err = CopyOutBuffer(ctx, output.outbound->bytes, out_msg);
+      if (err != MAANY_MPC_OK) return err;
+    }
+    if (result) *result = static_cast<maany_mpc_step_result_t>(output.state);
+    return MAANY_MPC_OK;
+  } catch (...) {
+    dkg->meter.Fail();
+    return TranslateException();
+  }
+}
+
+maany_mpc_error_t maany_mpc_dkg_finalize(
+  maany_mpc_ctx_t* ctx,
+  maany_mpc_dkg_t* dkg,
+  maany_mpc_keypair_t** out_local_share) {
+  if (!ctx || !dkg || !dkg->session || !out_local_share) return MAANY_MPC_ERR_INVALID_ARG;
+
+  try {
+    auto key = dkg->session->Finalize();
+    dkg->session.reset();
+
+    void* raw = ctx->malloc_fn(sizeof(maany_mpc_kp_s));
+    if (!raw) return MAANY_MPC_ERR_MEMORY;
+    auto* handle = new (raw) maany_mpc_kp_s();
+    handle->owner = ctx;
+    handle->keypair = std::move(key);
+    *out_local_share = handle;
+    return MAANY_MPC_OK;
+  } catch (...) {
+    dkg->meter.Fail();
+    return TranslateException();
+  }
+}
+
+maany_mpc_error_t maany_mpc_dkg_finalize_many(
+  maany_mpc_ctx_t* ctx,
+  maany_mpc_dkg_t* dkg,
+  maany_mpc_keypair_t** out_shares,
+  size_t count) {
+  if (!ctx || !dkg || !dkg->session || !out_shares || count != dkg->key_count) return MAANY_MPC_ERR_INVALID_ARG;
+
+  try {
+    auto keys = dkg->session->FinalizeMany();
+    dkg->session.reset();
+
+    std::vector<maany_mpc_keypair_t*> handles;
+    handles.reserve(keys.size());
+    for (auto& key : keys) {
+      void* raw = ctx->malloc_fn(sizeof(maany_mpc_kp_s));
+      if (!raw) {
+        for (auto* handle : handles) maany_mpc_kp_free(handle);
+        return MAANY_MPC_ERR_MEMORY;
+      }
+      auto* handle = new (raw) maany_mpc_kp_s();
+      handle->owner = ctx;
+      handle->keypair = std::move(key);
+      handles.push_back(handle);
+    }
+    std::copy(handles.begin(), handles.end(), out_shares);
+    return MAANY_MPC_OK;
+  } catch (...) {
+    dkg->meter.Fail();
+    return TranslateException();
+  }
+}
+
+void maany_mpc_dkg_free(maany_mpc_dkg_t* dkg) {
+  if (!dkg) return;
+  maany_mpc_ctx_t* owner = dkg->owner;
+  maany_mpc_free_fn free_fn = owner && owner->free_fn ? owner->free_fn : DefaultFree;
+  dkg->session.reset();
+  dkg->meter.Release();
+  dkg->~maany_mpc_dkg_s();
+  free_fn(dkg);
+}
+
+maany_mpc_error_t maany_mpc_sign_new(
+  maany_mpc_ctx_t* ctx,
+  const maany_mpc_keypair_t* kp,
+  const maany_mpc_sign_opts_t* opts,
+  maany_mpc_sign_t** out_sign) {
+  if (!ctx || !ctx->bridge || !kp || !kp->keypair || !out_sign) return MAANY_MPC_ERR_INVALID_ARG;
+
+  try {
+    SignOptions bridge_opts = ConvertSignOptions(opts);
+    auto session = ctx->bridge->CreateSign(*kp->keypair, bridge_opts);
+
+    void* raw = ctx->malloc_fn(sizeof(maany_mpc_sign_s));
+    if (!raw) return MAANY_MPC_ERR_MEMORY;
     auto* handle = new (raw) maany_mpc_sign_s();
     handle->owner = ctx;
     handle->session = std::move(session);
+    handle->meter.Start(&ctx->metrics, &ctx->bridge->Log(), SessionType::Sign, &bridge_opts.session_id);
     *out_sign = handle;
     return MAANY_MPC_OK;
   } catch (...) {
@@ -610,7 +1373,10 @@ maany_mpc_error_t maany_mpc_sign_step(
       inbound = BufferOwner{};
     }
 
+    const auto start = SteadyClock::now();
     StepOutput output = sign->session->Step(inbound);
+    sign->meter.Step(start, inbound ? inbound->bytes.size() : 0,
+                     output.outbound ? output.outbound->bytes.size() : 0, output.state == StepState::Done);
     if (output.outbound && !out_msg) return MAANY_MPC_ERR_INVALID_ARG;
     if (out_msg && output.outbound) {
       maany_mpc_error_t err = CopyOutBuffer(ctx, output.outbound->bytes, out_msg);
@@ -619,6 +1385,7 @@ maany_mpc_error_t maany_mpc_sign_step(
     if (result) *result = static_cast<maany_mpc_step_result_t>(output.state);
     return MAANY_MPC_OK;
   } catch (...) {
+    sign->meter.Fail();
     return TranslateException();
   }
 }
@@ -637,6 +1404,7 @@ maany_mpc_error_t maany_mpc_sign_finalize(
     std::fill(sig.bytes.begin(), sig.bytes.end(), 0);
     return MAANY_MPC_OK;
   } catch (...) {
+    sign->meter.Fail();
     return TranslateException();
   }
 }
@@ -646,6 +1414,7 @@ void maany_mpc_sign_free(maany_mpc_sign_t* sign) {
   maany_mpc_ctx_t* owner = sign->owner;
   maany_mpc_free_fn free_fn = owner && owner->free_fn ? owner->free_fn : DefaultFree;
   sign->session.reset();
+  sign->meter.Release();
   sign->~maany_mpc_sign_s();
   free_fn(sign);
 }
@@ -666,6 +1435,39 @@ maany_mpc_error_t maany_mpc_refresh_new(
     maany_mpc_dkg_t* handle = new (raw) maany_mpc_dkg_t();
     handle->owner = ctx;
     handle->session = std::move(session);
+    handle->meter.Start(&ctx->metrics, &ctx->bridge->Log(), SessionType::Refresh, &bridge_opts.session_id);
+    *out_refresh = handle;
+    return MAANY_MPC_OK;
+  } catch (...) {
+    return TranslateException();
+  }
+}
+
+maany_mpc_error_t maany_mpc_refresh_new_many(
+  maany_mpc_ctx_t* ctx,
+  const maany_mpc_keypair_t* const* kps,
+  size_t n,
+  const maany_mpc_refresh_opts_t* opts,
+  maany_mpc_dkg_t** out_refresh) {
+  if (!ctx || !ctx->bridge || !kps || n == 0 || !out_refresh) return MAANY_MPC_ERR_INVALID_ARG;
+
+  try {
+    std::vector<const Keypair*> keys;
+    keys.reserve(n);
+    for (size_t i = 0; i < n; ++i) {
+      if (!kps[i] || !kps[i]->keypair) return MAANY_MPC_ERR_INVALID_ARG;
+      keys.push_back(kps[i]->keypair.get());
+    }
+    RefreshOptions bridge_opts = ConvertRefreshOptions(opts);
+    auto session = ctx->bridge->CreateRefreshMany(keys, bridge_opts);
+
+    void* raw = ctx->malloc_fn(sizeof(maany_mpc_dkg_t));
+    if (!raw) return MAANY_MPC_ERR_MEMORY;
+    maany_mpc_dkg_t* handle = new (raw) maany_mpc_dkg_t();
+    handle->owner = ctx;
+    handle->session = std::move(session);
+    handle->key_count = n;
+    handle->meter.Start(&ctx->metrics, &ctx->bridge->Log(), SessionType::Refresh, &bridge_opts.session_id);
     *out_refresh = handle;
     return MAANY_MPC_OK;
   } catch (...) {
@@ -673,6 +1475,382 @@ maany_mpc_error_t maany_mpc_refresh_new(
   }
 }
 
+maany_mpc_error_t maany_mpc_paillier_setup_new(
+  maany_mpc_ctx_t* ctx,
+  const maany_mpc_keypair_t* kp,
+  maany_mpc_dkg_t** out_setup) {
+  if (!ctx || !ctx->bridge || !kp || !kp->keypair || !out_setup) return MAANY_MPC_ERR_INVALID_ARG;
+
+  try {
+    auto session = ctx->bridge->CreatePaillierSetup(*kp->keypair);
+
+    void* raw = ctx->malloc_fn(sizeof(maany_mpc_dkg_t));
+    if (!raw) return MAANY_MPC_ERR_MEMORY;
+    maany_mpc_dkg_t* handle = new (raw) maany_mpc_dkg_t();
+    handle->owner = ctx;
+    handle->session = std::move(session);
+    handle->meter.Start(&ctx->metrics, &ctx->bridge->Log(), SessionType::PaillierSetup);
+    *out_setup = handle;
+    return MAANY_MPC_OK;
+  } catch (...) {
+    return TranslateException();
+  }
+}
+
+maany_mpc_error_t maany_mpc_replay(
+  maany_mpc_ctx_t* ctx,
+  const maany_mpc_buf_t* transcript,
+  const maany_mpc_keypair_t* kp,
+  maany_mpc_replay_step_t* out_steps,
+  size_t cap,
+  size_t* out_count) {
+  if (!ctx || !ctx->bridge || !transcript || !out_count || (cap && !out_steps)) return MAANY_MPC_ERR_INVALID_ARG;
+  if (!transcript->data || transcript->len == 0 || (kp && !kp->keypair)) return MAANY_MPC_ERR_INVALID_ARG;
+  *out_count = 0;
+
+  try {
+    ByteView bytes{static_cast<const uint8_t*>(transcript->data), transcript->len};
+    auto steps = ctx->bridge->Replay(bytes, kp ? kp->keypair.get() : nullptr);
+    for (size_t i = 0; i < steps.size() && i < cap; ++i) {
+      out_steps[i].compute_ms = steps[i].compute_ms;
+      out_steps[i].in_bytes = steps[i].in_bytes;
+      out_steps[i].out_bytes = steps[i].out_bytes;
+    }
+    *out_count = steps.size();
+    return MAANY_MPC_OK;
+  } catch (...) {
+    return TranslateException();
+  }
+}
+
+maany_mpc_error_t maany_mpc_tn_dkg_new(
+  maany_mpc_ctx_t* ctx,
+  const maany_mpc_tn_dkg_opts_t* opts,
+  maany_mpc_tn_dkg_t** out_dkg) {
+  if (!ctx || !ctx->bridge || !opts || !out_dkg) return MAANY_MPC_ERR_INVALID_ARG;
+
+  try {
+    ThresholdDkgOptions bridge_opts = ConvertThresholdDkgOptions(*opts);
+    auto session = ctx->bridge->CreateThresholdDkg(bridge_opts);
+
+    void* raw = ctx->malloc_fn(sizeof(maany_mpc_tn_dkg_t));
+    if (!raw) return MAANY_MPC_ERR_MEMORY;
+    auto* handle = new (raw) maany_mpc_tn_dkg_t();
+    handle->owner = ctx;
+    handle->session = std::move(session);
+    handle->meter.Start(&ctx->metrics, &ctx->bridge->Log(), SessionType::ThresholdDkg, &bridge_opts.session_id);
+    *out_dkg = handle;
+    return MAANY_MPC_OK;
+  } catch (...) {
+    return TranslateException();
+  }
+}
+
+maany_mpc_error_t maany_mpc_tn_dkg_step(
+  maany_mpc_ctx_t* ctx,
+  maany_mpc_tn_dkg_t* dkg,
+  const maany_mpc_peer_msg_t* in_msgs,
+  size_t in_count,
+  maany_mpc_peer_msg_t** out_msgs,
+  size_t* out_count,
+  maany_mpc_step_result_t* result) {
+  if (!ctx || !dkg || !dkg->session || !out_msgs || !out_count) return MAANY_MPC_ERR_INVALID_ARG;
+  *out_msgs = nullptr;
+  *out_count = 0;
+  if (result) *result = MAANY_MPC_STEP_CONTINUE;
+
+  std::vector<PeerMessage> inbound;
+  try {
+    inbound = CopyInPeerMessages(in_msgs, in_count);
+  } catch (...) {
+    return MAANY_MPC_ERR_INVALID_ARG;
+  }
+
+  try {
+    const auto start = SteadyClock::now();
+    MpStepOutput output = dkg->session->Step(inbound);
+    dkg->meter.Step(start, PeerMessageBytes(inbound), PeerMessageBytes(output.outbound),
+                    output.state == StepState::Done);
+    maany_mpc_error_t err = CopyOutPeerMessages(ctx, output.outbound, out_msgs, out_count);
+    if (err != MAANY_MPC_OK) return err;
+    if (result) *result = static_cast<maany_mpc_step_result_t>(output.state);
+    return MAANY_MPC_OK;
+  } catch (...) {
+    dkg->meter.Fail();
+    return TranslateException();
+  }
+}
+
+maany_mpc_error_t maany_mpc_tn_dkg_finalize(
+  maany_mpc_ctx_t* ctx,
+  maany_mpc_tn_dkg_t* dkg,
+  maany_mpc_keypair_t** out_local_share) {
+  if (!ctx || !dkg || !dkg->session || !out_local_share) return MAANY_MPC_ERR_INVALID_ARG;
+
+  try {
+    auto key = dkg->session->Finalize();
+    dkg->session.reset();
+
+    void* raw = ctx->malloc_fn(sizeof(maany_mpc_kp_s));
+    if (!raw) return MAANY_MPC_ERR_MEMORY;
+    auto* handle = new (raw) maany_mpc_kp_s();
+    handle->owner = ctx;
+    handle->keypair = std::move(key);
+    *out_local_share = handle;
+    return MAANY_MPC_OK;
+  } catch (...) {
+    dkg->meter.Fail();
+    return TranslateException();
+  }
+}
+
+void maany_mpc_tn_dkg_free(maany_mpc_tn_dkg_t* dkg) {
+  if (!dkg) return;
+  maany_mpc_ctx_t* owner = dkg->owner;
+  maany_mpc_free_fn free_fn = owner && owner->free_fn ? owner->free_fn : DefaultFree;
+  dkg->session.reset();
+  dkg->meter.Release();
+  dkg->~maany_mpc_tn_dkg_s();
+  free_fn(dkg);
+}
+
+maany_mpc_error_t maany_mpc_tn_sign_new(
+  maany_mpc_ctx_t* ctx,
+  const maany_mpc_keypair_t* kp,
+  const maany_mpc_tn_sign_opts_t* opts,
+  maany_mpc_tn_sign_t** out_sign) {
+  if (!ctx || !ctx->bridge || !kp || !kp->keypair || !opts || !out_sign) return MAANY_MPC_ERR_INVALID_ARG;
+
+  ThresholdSignOptions bridge_opts;
+  try {
+    bridge_opts = ConvertThresholdSignOptions(*opts);
+  } catch (...) {
+    return MAANY_MPC_ERR_INVALID_ARG;
+  }
+
+  try {
+    auto session = ctx->bridge->CreateThresholdSign(*kp->keypair, bridge_opts);
+
+    void* raw = ctx->malloc_fn(sizeof(maany_mpc_tn_sign_s));
+    if (!raw) return MAANY_MPC_ERR_MEMORY;
+    auto* handle = new (raw) maany_mpc_tn_sign_s();
+    handle->owner = ctx;
+    handle->session = std::move(session);
+    handle->meter.Start(&ctx->metrics, &ctx->bridge->Log(), SessionType::ThresholdSign, &bridge_opts.session_id);
+    *out_sign = handle;
+    return MAANY_MPC_OK;
+  } catch (...) {
+    return TranslateException();
+  }
+}
+
+maany_mpc_error_t maany_mpc_tn_sign_set_message(
+  maany_mpc_ctx_t* ctx,
+  maany_mpc_tn_sign_t* sign,
+  const uint8_t* msg,
+  size_t msg_len) {
+  if (!ctx || !sign || !sign->session || !msg || msg_len == 0) return MAANY_MPC_ERR_INVALID_ARG;
+
+  try {
+    sign->session->SetMessage(msg, msg_len);
+    return MAANY_MPC_OK;
+  } catch (...) {
+    return TranslateException();
+  }
+}
+
+maany_mpc_error_t maany_mpc_tn_sign_step(
+  maany_mpc_ctx_t* ctx,
+  maany_mpc_tn_sign_t* sign,
+  const maany_mpc_peer_msg_t* in_msgs,
+  size_t in_count,
+  maany_mpc_peer_msg_t** out_msgs,
+  size_t* out_count,
+  maany_mpc_step_result_t* result) {
+  if (!ctx || !sign || !sign->session || !out_msgs || !out_count) return MAANY_MPC_ERR_INVALID_ARG;
+  *out_msgs = nullptr;
+  *out_count = 0;
+  if (result) *result = MAANY_MPC_STEP_CONTINUE;
+
+  std::vector<PeerMessage> inbound;
+  try {
+    inbound = CopyInPeerMessages(in_msgs, in_count);
+  } catch (...) {
+    return MAANY_MPC_ERR_INVALID_ARG;
+  }
+
+  try {
+    const auto start = SteadyClock::now();
+    MpStepOutput output = sign->session->Step(inbound);
+    sign->meter.Step(start, PeerMessageBytes(inbound), PeerMessageBytes(output.outbound),
+                     output.state == StepState::Done);
+    maany_mpc_error_t err = CopyOutPeerMessages(ctx, output.outbound, out_msgs, out_count);
+    if (err != MAANY_MPC_OK) return err;
+    if (result) *result = static_cast<maany_mpc_step_result_t>(output.state);
+    return MAANY_MPC_OK;
+  } catch (...) {
+    sign->meter.Fail();
+    return TranslateException();
+  }
+}
+
+maany_mpc_error_t maany_mpc_tn_sign_finalize(
+  maany_mpc_ctx_t* ctx,
+  maany_mpc_tn_sign_t* sign,
+  maany_mpc_sig_format_t fmt,
+  maany_mpc_buf_t* out_signature) {
+  if (!ctx || !sign || !sign->session || !out_signature) return MAANY_MPC_ERR_INVALID_ARG;
+
+  try {
+    BufferOwner sig = sign->session->Finalize(static_cast<SigFormat>(fmt));
+    maany_mpc_error_t err = CopyOutBuffer(ctx, sig.bytes, out_signature);
+    if (err != MAANY_MPC_OK) return err;
+    std::fill(sig.bytes.begin(), sig.bytes.end(), 0);
+    return MAANY_MPC_OK;
+  } catch (...) {
+    sign->meter.Fail();
+    return TranslateException();
+  }
+}
+
+void maany_mpc_tn_sign_free(maany_mpc_tn_sign_t* sign) {
+  if (!sign) return;
+  maany_mpc_ctx_t* owner = sign->owner;
+  maany_mpc_free_fn free_fn = owner && owner->free_fn ? owner->free_fn : DefaultFree;
+  sign->session.reset();
+  sign->meter.Release();
+  sign->~maany_mpc_tn_sign_s();
+  free_fn(sign);
+}
+
+void maany_mpc_peer_msgs_free(maany_mpc_ctx_t* ctx, maany_mpc_peer_msg_t* msgs, size_t count) {
+  if (!ctx || !msgs) return;
+  FreePeerMessages(ctx, msgs, count);
+}
+
+maany_mpc_error_t maany_mpc_stats_snapshot(maany_mpc_ctx_t* ctx, maany_mpc_stats_t* out_stats) {
+  if (!ctx || !ctx->bridge || !out_stats) return MAANY_MPC_ERR_INVALID_ARG;
+  try {
+    const auto snap = ctx->metrics.Snapshot();
+    for (size_t t = 0; t < maany::bridge::kSessionTypeCount; ++t) {
+      const auto& src = snap.sessions[t];
+      maany_mpc_session_stats_t& dst = out_stats->sessions[t];
+      dst.live = src.live;
+      dst.started = src.started;
+      dst.completed = src.completed;
+      dst.failed = src.failed;
+      dst.steps = src.steps;
+      dst.step_ns = src.step_ns;
+      std::copy(src.step_hist.begin(), src.step_hist.end(), dst.step_hist);
+      dst.bytes_in = src.bytes_in;
+      dst.bytes_out = src.bytes_out;
+    }
+    out_stats->worker_threads = ctx->bridge->WorkerThreads();
+    out_stats->store_hits = snap.store_hits;
+    out_stats->store_misses = snap.store_misses;
+    return MAANY_MPC_OK;
+  } catch (...) {
+    return TranslateException();
+  }
+}
+
+void maany_mpc_trace_enable(int enabled) {
+  if (enabled) {
+    maany::bridge::timeline::Start();
+  } else {
+    maany::bridge::timeline::Stop();
+  }
+}
+
+maany_mpc_error_t maany_mpc_trace_dump(maany_mpc_ctx_t* ctx, maany_mpc_buf_t* out_json) {
+  if (!ctx || !out_json) return MAANY_MPC_ERR_INVALID_ARG;
+  try {
+    const std::string json = maany::bridge::timeline::DumpChromeJson();
+    return CopyOutBuffer(ctx, std::vector<uint8_t>(json.begin(), json.end()), out_json);
+  } catch (...) {
+    return TranslateException();
+  }
+}
+
+maany_mpc_error_t maany_mpc_primitive_profile(maany_mpc_primitive_profile_t* out_profile) {
+  if (!out_profile) return MAANY_MPC_ERR_INVALID_ARG;
+  if (!maany::bridge::profile::kCompiledIn) return MAANY_MPC_ERR_UNSUPPORTED;
+  try {
+    const auto snap = maany::bridge::profile::Snapshot();
+    for (size_t s = 0; s < maany::bridge::profile::kScopeCount; ++s) {
+      for (size_t p = 0; p < maany::bridge::profile::kPrimitiveCount; ++p) {
+        maany_mpc_primitive_stats_t& dst = out_profile->by_session[s][p];
+        dst.calls = snap[s][p].calls;
+        dst.wall_ns = snap[s][p].wall_ns;
+        dst.cpu_ns = snap[s][p].cpu_ns;
+      }
+    }
+    return MAANY_MPC_OK;
+  } catch (...) {
+    return TranslateException();
+  }
+}
+
+const char* maany_mpc_primitive_name(maany_mpc_primitive_t primitive) {
+  switch (primitive) {
+    case MAANY_MPC_PRIM_PAILLIER_HOMOMORPHIC:
+      return "paillier_homomorphic";
+    case MAANY_MPC_PRIM_EC_MUL:
+      return "ec_mul";
+    case MAANY_MPC_PRIM_HASH:
+      return "hash";
+    case MAANY_MPC_PRIM_SYMMETRIC:
+      return "symmetric";
+    case MAANY_MPC_PRIM_SERIALIZE:
+      return "serialize";
+    case MAANY_MPC_PRIM_SECRET_SHARING:
+      return "secret_sharing";
+    case MAANY_MPC_PRIM_CBMPC_2P_DKG:
+      return "cbmpc_2p_dkg";
+    case MAANY_MPC_PRIM_CBMPC_2P_REFRESH:
+      return "cbmpc_2p_refresh";
+    case MAANY_MPC_PRIM_CBMPC_2P_SIGN:
+      return "cbmpc_2p_sign";
+    case MAANY_MPC_PRIM_CBMPC_TN_DKG:
+      return "cbmpc_tn_dkg";
+    case MAANY_MPC_PRIM_CBMPC_TN_SIGN:
+      return "cbmpc_tn_sign";
+    case MAANY_MPC_PRIM_COUNT:
+      break;
+  }
+  return nullptr;
+}
+
+maany_mpc_error_t maany_mpc_perf_enable(int enabled) {
+  try {
+    if (!enabled) {
+      maany::bridge::perf::Disable();
+      return MAANY_MPC_OK;
+    }
+    return maany::bridge::perf::Enable() ? MAANY_MPC_OK : MAANY_MPC_ERR_UNSUPPORTED;
+  } catch (...) {
+    return TranslateException();
+  }
+}
+
+maany_mpc_error_t maany_mpc_perf_snapshot(maany_mpc_perf_stats_t* out_stats) {
+  if (!out_stats) return MAANY_MPC_ERR_INVALID_ARG;
+  try {
+    const auto snap = maany::bridge::perf::Snapshot();
+    out_stats->enabled = snap.enabled ? 1 : 0;
+    out_stats->counters = snap.counters;
+    out_stats->error = snap.error;
+    for (size_t s = 0; s < maany::bridge::kSessionTypeCount; ++s) {
+      maany_mpc_perf_session_stats_t& dst = out_stats->by_session[s];
+      dst.sessions = snap.sessions[s].sessions;
+      for (size_t c = 0; c < maany::bridge::perf::kCounterCount; ++c) dst.values[c] = snap.sessions[s].values[c];
+    }
+    return MAANY_MPC_OK;
+  } catch (...) {
+    return TranslateException();
+  }
+}
+
 void maany_mpc_free(void* p) {
   DefaultFree(p);
 }
@@ -0,0 +1,187 @@
+#include "metrics.h"
+
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <string>
+
+namespace maany::bridge {
+
+namespace {
+
+// Enough that threads rarely share a slot on a busy coordinator host; each
+// slot costs about 1.6 KB per context.
+constexpr size_t kSlots = 16;
+
+std::atomic<size_t> g_next_slot{0};
+
+size_t ThreadSlot() {
+  thread_local const size_t slot = g_next_slot.fetch_add(1, std::memory_order_relaxed) % kSlots;
+  return slot;
+}
+
+size_t StepBucket(uint64_t ns) {
+  uint64_t us = ns / 1000;
+  size_t bucket = 0;
+  while (us && bucket + 1 < kStepBuckets) {
+    us >>= 1;
+    ++bucket;
+  }
+  return bucket;
+}
+
+void Add(std::atomic<uint64_t>& counter, uint64_t v) {
+  counter.fetch_add(v, std::memory_order_relaxed);
+}
+
+}  // namespace
+
+struct alignas(64) Metrics::Slot {
+  struct PerType {
+    std::atomic<int64_t> live{0};
+    std::atomic<uint64_t> started{0};
+    std::atomic<uint64_t> completed{0};
+    std::atomic<uint64_t> failed{0};
+    std::atomic<uint64_t> steps{0};
+    std::atomic<uint64_t> step_ns{0};
+    std::array<std::atomic<uint64_t>, kStepBuckets> step_hist{};
+    std::atomic<uint64_t> bytes_in{0};
+    std::atomic<uint64_t> bytes_out{0};
+  };
+
+  std::array<PerType, kSessionTypeCount> sessions;
+  std::atomic<uint64_t> store_hits{0};
+  std::atomic<uint64_t> store_misses{0};
+};
+
+Metrics::Metrics() : slots_(new Slot[kSlots]) {}
+
+Metrics::~Metrics() = default;
+
+Metrics::Slot& Metrics::Local() const {
+  return slots_[ThreadSlot()];
+}
+
+void Metrics::SessionStarted(SessionType type) {
+  auto& s = Local().sessions[static_cast<size_t>(type)];
+  s.live.fetch_add(1, std::memory_order_relaxed);
+  Add(s.started, 1);
+}
+
+void Metrics::SessionCompleted(SessionType type) {
+  Add(Local().sessions[static_cast<size_t>(type)].completed, 1);
+}
+
+void Metrics::SessionFailed(SessionType type) {
+  Add(Local().sessions[static_cast<size_t>(type)].failed, 1);
+}
+
+void Metrics::SessionReleased(SessionType type) {
+  Local().sessions[static_cast<size_t>(type)].live.fetch_sub(1, std::memory_order_relaxed);
+}
+
+void Metrics::RecordStep(SessionType type, uint64_t ns, size_t in_bytes, size_t out_bytes) {
+  auto& s = Local().sessions[static_cast<size_t>(type)];
+  Add(s.steps, 1);
+  Add(s.step_ns, ns);
+  Add(s.step_hist[StepBucket(ns)], 1);
+  if (in_bytes) Add(s.bytes_in, in_bytes);
+  if (out_bytes) Add(s.bytes_out, out_bytes);
+}
+
+void Metrics::RecordStoreLookup(bool hit) {
+  Slot& slot = Local();
+  Add(hit ? slot.store_hits : slot.store_misses, 1);
+}
+
+MetricsSnapshot Metrics::Snapshot() const {
+  MetricsSnapshot out;
+  std::array<int64_t, kSessionTypeCount> live{};
+  for (size_t i = 0; i < kSlots; ++i) {
+    const Slot& slot = slots_[i];
+    for (size_t t = 0; t < kSessionTypeCount; ++t) {
+      const auto& src = slot.sessions[t];
+      SessionStats& dst = out.sessions[t];
+      live[t] += src.live.load(std::memory_order_relaxed);
+      dst.started += src.started.load(std::memory_order_relaxed);
+      dst.completed += src.completed.load(std::memory_order_relaxed);
+      dst.failed += src.failed.load(std::memory_order_relaxed);
+      dst.steps += src.steps.load(std::memory_order_relaxed);
+      dst.step_ns += src.step_ns.load(std::memory_order_relaxed);
+      for (size_t b = 0; b < kStepBuckets; ++b) dst.step_hist[b] += src.step_hist[b].load(std::memory_order_relaxed);
+      dst.bytes_in += src.bytes_in.load(std::memory_order_relaxed);
+      dst.bytes_out += src.bytes_out.load(std::memory_order_relaxed);
+    }
+    out.store_hits += slot.store_hits.load(std::memory_order_relaxed);
+    out.store_misses += slot.store_misses.load(std::memory_order_relaxed);
+  }
+  // Slots are read one at a time, so a snapshot can see a session's release
+  // without its start.
+  for (size_t t = 0; t < kSessionTypeCount; ++t)
+    out.sessions[t].live = live[t] > 0 ? static_cast<uint64_t>(live[t]) : 0;
+  return out;
+}
+
+namespace {
+
+// Enough of the caller's session id to match coordinator logs.
+constexpr size_t kLoggedSessionIdBytes = 8;
+
+uint64_t ElapsedUs(SessionMeter::Clock::time_point since) {
+  return static_cast<uint64_t>(
+    std::chrono::duration_cast<std::chrono::microseconds>(SessionMeter::Clock::now() - since).count());
+}
+
+std::string CurrentErrorMessage() {
+  try {
+    if (auto e = std::current_exception()) std::rethrow_exception(e);
+  } catch (const std::exception& e) {
+    return e.what();
+  } catch (...) {
+  }
+  return "unknown error";
+}
+
+}  // namespace
+
+void SessionMeter::LogStart(const BufferOwner* session_id) noexcept {
+  try {
+    LogLine line("session_start");
+    line.Add("session", session_).Add("type", SessionTypeName(type_));
+    if (session_id && !session_id->bytes.empty())
+      line.AddHex("sid", session_id->bytes.data(), std::min(session_id->bytes.size(), kLoggedSessionIdBytes));
+    logger_->Write(LogLevel::Debug, line);
+  } catch (...) {
+  }
+}
+
+void SessionMeter::LogStep(uint64_t ns, size_t in_bytes, size_t out_bytes) noexcept {
+  try {
+    LogLine line("step");
+    line.Add("session", session_)
+      .Add("type", SessionTypeName(type_))
+      .Add("round", rounds_)
+      .Add("in_bytes", in_bytes)
+      .Add("out_bytes", out_bytes)
+      .Add("dur_us", ns / 1000);
+    logger_->Write(LogLevel::Debug, line);
+  } catch (...) {
+  }
+}
+
+void SessionMeter::LogEnd(LogLevel level, const char* event) noexcept {
+  try {
+    LogLine line(event);
+    line.Add("session", session_)
+      .Add("type", SessionTypeName(type_))
+      .Add("rounds", rounds_)
+      .Add("bytes_in", bytes_in_)
+      .Add("bytes_out", bytes_out_)
+      .Add("dur_us", ElapsedUs(started_));
+    if (level == LogLevel::Warn) line.Add("error", CurrentErrorMessage());
+    logger_->Write(level, line);
+  } catch (...) {
+  }
+}
+
+}  // namespace maany::bridge
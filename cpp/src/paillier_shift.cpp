@@ -0,0 +1,119 @@
+#include "paillier_shift.h"
+
+#include "bridge.h"
+
+#include <openssl/evp.h>
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+namespace maany::bridge {
+
+namespace {
+
+using coinbase::mem_t;
+using coinbase::crypto::bn_t;
+using coinbase::crypto::mod_t;
+using coinbase::crypto::paillier_t;
+
+constexpr int kChallengeSize = 16;
+using Challenge = std::array<uint8_t, kChallengeSize>;
+
+// 2^128; challenges lie below it.
+bn_t ChallengeBound() {
+  uint8_t bytes[kChallengeSize + 1] = {1};
+  return bn_t::from_bin(mem_t(bytes, sizeof(bytes)));
+}
+
+void AppendBn(std::vector<uint8_t>& out, const bn_t& value) {
+  const auto bin = value.to_bin();
+  const auto len = static_cast<uint32_t>(bin.size());
+  for (int shift = 24; shift >= 0; shift -= 8) out.push_back(static_cast<uint8_t>(len >> shift));
+  out.insert(out.end(), bin.data(), bin.data() + bin.size());
+}
+
+Challenge HashChallenge(const paillier_t& paillier, const bn_t& c, const bn_t& shift, const bn_t& shifted,
+                        mem_t binding, const bn_t (&a)[2]) {
+  std::vector<uint8_t> preimage(binding.data, binding.data + binding.size);
+  const bn_t& n = paillier.get_N();
+  for (const bn_t* value : {&n, &c, &shift, &shifted, &a[0], &a[1]}) AppendBn(preimage, *value);
+  uint8_t digest[32];
+  unsigned int digest_len = 0;
+  if (EVP_Digest(preimage.data(), preimage.size(), digest, &digest_len, EVP_sha256(), nullptr) != 1 ||
+      digest_len != sizeof(digest))
+    throw Error(ErrorCode::Crypto, "Paillier shift challenge failed");
+  Challenge out;
+  std::copy(digest, digest + kChallengeSize, out.begin());
+  return out;
+}
+
+// The challenge of the other branch; `e` must be below ChallengeBound().
+bn_t OtherChallenge(const Challenge& challenge, const bn_t& e) {
+  auto bin = e.to_bin(kChallengeSize);
+  for (int i = 0; i < kChallengeSize; ++i) bin.data()[i] ^= challenge[i];
+  return bn_t::from_bin(mem_t(bin.data(), kChallengeSize));
+}
+
+// Enc(x + shift) and Enc(x + shift - q), both with c's randomness.
+void ShiftedBases(const paillier_t& paillier, const bn_t& c, const bn_t& shift, const bn_t& q, bn_t (&base)[2]) {
+  const bn_t& n = paillier.get_N();
+  base[0] = paillier.add_scalar(c, shift);
+  base[1] = paillier.add_scalar(c, shift + n - q);
+}
+
+}  // namespace
+
+bn_t ShiftPaillierShare(const paillier_t& paillier, const bn_t& c, const bn_t& x, const bn_t& shift, const mod_t& q,
+                        mem_t binding, PaillierShiftProof& proof) {
+  const bn_t& q_bn = q;
+  if (x < 0 || !(x < q_bn) || shift < 0 || !(shift < q_bn))
+    throw Error(ErrorCode::Crypto, "Paillier shift out of range");
+  const mod_t& n = paillier.get_N();
+  const int wrap = x + shift < q_bn ? 0 : 1;
+  const int other = 1 - wrap;
+
+  bn_t base[2];
+  ShiftedBases(paillier, c, shift, q_bn, base);
+  // c' = base[wrap] * s^N, so c' / base[wrap] is an N-th residue with root s.
+  const bn_t s = bn_t::rand(n);
+  const bn_t shifted = paillier.add_ciphers(base[wrap], paillier.encrypt(0, s));
+
+  bn_t e[2];
+  e[other] = bn_t::rand(ChallengeBound());
+  proof.t[other] = bn_t::rand(n);
+  proof.a[other] = paillier.sub_ciphers(
+      paillier.add_ciphers(paillier.encrypt(0, proof.t[other]), paillier.mul_scalar(base[other], e[other])),
+      paillier.mul_scalar(shifted, e[other]));
+  const bn_t r = bn_t::rand(n);
+  proof.a[wrap] = paillier.encrypt(0, r);
+  e[wrap] = OtherChallenge(HashChallenge(paillier, c, shift, shifted, binding, proof.a), e[other]);
+  proof.t[wrap] = n.mul(r, n.pow(s, e[wrap]));
+  proof.e0 = e[0];
+  return shifted;
+}
+
+bool VerifyPaillierShift(const paillier_t& paillier, const bn_t& c, const bn_t& shift, const mod_t& q,
+                         const bn_t& shifted, mem_t binding, const PaillierShiftProof& proof) {
+  const bn_t& q_bn = q;
+  const bn_t& n = paillier.get_N();
+  if (shift < 0 || !(shift < q_bn)) return false;
+  if (proof.e0 < 0 || !(proof.e0 < ChallengeBound())) return false;
+  for (const bn_t& t : proof.t) {
+    if (t <= 0 || !(t < n)) return false;
+  }
+
+  bn_t base[2];
+  ShiftedBases(paillier, c, shift, q_bn, base);
+  const bn_t e[2] = {proof.e0,
+                     OtherChallenge(HashChallenge(paillier, c, shift, shifted, binding, proof.a), proof.e0)};
+  // t^N * base^e == a * c'^e for both branches.
+  for (int i = 0; i < 2; ++i) {
+    const bn_t lhs = paillier.add_ciphers(paillier.encrypt(0, proof.t[i]), paillier.mul_scalar(base[i], e[i]));
+    const bn_t rhs = paillier.add_ciphers(proof.a[i], paillier.mul_scalar(shifted, e[i]));
+    if (lhs != rhs) return false;
+  }
+  return true;
+}
+
+}  // namespace maany::bridge
@@ -0,0 +1,148 @@
+#include "perf_counters.h"
+
+#include <cerrno>
+
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace maany::bridge::perf {
+
+namespace detail {
+std::atomic<bool> enabled{false};
+}  // namespace detail
+
+namespace {
+
+struct Totals {
+  std::atomic<uint64_t> sessions{0};
+  std::array<std::atomic<uint64_t>, kCounterCount> values{};
+};
+
+// Added to once per session, so plain shared atomics are enough.
+Totals g_totals[kSessionTypeCount];
+std::atomic<uint32_t> g_counters{0};
+std::atomic<int> g_error{0};
+
+#if defined(__linux__)
+
+constexpr uint64_t kConfigs[kCounterCount] = {
+  PERF_COUNT_HW_CPU_CYCLES,
+  PERF_COUNT_HW_INSTRUCTIONS,
+  PERF_COUNT_HW_CACHE_MISSES,
+  PERF_COUNT_HW_BRANCH_MISSES,
+};
+
+// Set once the kernel refused kernel-mode counting (perf_event_paranoid >= 2
+// without CAP_PERFMON); user-mode counts are then all we get.
+std::atomic<bool> g_user_only{false};
+
+int OpenCounter(uint64_t config, int group_fd) {
+  perf_event_attr attr{};
+  attr.size = sizeof(attr);
+  attr.type = PERF_TYPE_HARDWARE;
+  attr.config = config;
+  attr.disabled = group_fd < 0 ? 1 : 0;
+  attr.exclude_hv = 1;
+  attr.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+  for (;;) {
+    attr.exclude_kernel = g_user_only.load(std::memory_order_relaxed) ? 1 : 0;
+    const long fd = syscall(SYS_perf_event_open, &attr, 0, -1, group_fd, PERF_FLAG_FD_CLOEXEC);
+    if (fd >= 0) return static_cast<int>(fd);
+    if ((errno == EACCES || errno == EPERM) && !attr.exclude_kernel) {
+      g_user_only.store(true, std::memory_order_relaxed);
+      continue;
+    }
+    g_error.store(errno, std::memory_order_relaxed);
+    return -1;
+  }
+}
+
+#endif
+
+}  // namespace
+
+bool Enable() {
+#if defined(__linux__)
+  const int fd = OpenCounter(kConfigs[0], -1);
+  if (fd < 0) return false;
+  close(fd);
+  g_error.store(0, std::memory_order_relaxed);
+  detail::enabled.store(true, std::memory_order_relaxed);
+  return true;
+#else
+  g_error.store(ENOSYS, std::memory_order_relaxed);
+  return false;
+#endif
+}
+
+void Disable() {
+  detail::enabled.store(false, std::memory_order_relaxed);
+}
+
+PerfSnapshot Snapshot() {
+  PerfSnapshot out;
+  out.enabled = Enabled();
+  out.counters = g_counters.load(std::memory_order_relaxed);
+  out.error = g_error.load(std::memory_order_relaxed);
+  for (size_t t = 0; t < kSessionTypeCount; ++t) {
+    out.sessions[t].sessions = g_totals[t].sessions.load(std::memory_order_relaxed);
+    for (size_t c = 0; c < kCounterCount; ++c)
+      out.sessions[t].values[c] = g_totals[t].values[c].load(std::memory_order_relaxed);
+  }
+  return out;
+}
+
+void SessionCounters::Open() {
+#if defined(__linux__)
+  // Cycles lead the group; without them the session goes uncounted.
+  leader_ = OpenCounter(kConfigs[0], -1);
+  if (leader_ < 0) return;
+  fds_[0] = leader_;
+  for (size_t c = 1; c < kCounterCount; ++c) fds_[c] = OpenCounter(kConfigs[c], leader_);
+  ioctl(leader_, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+  ioctl(leader_, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+#endif
+}
+
+void SessionCounters::Close() {
+#if defined(__linux__)
+  ioctl(leader_, PERF_EVENT_IOC_DISABLE, PERF_IOC_FLAG_GROUP);
+  // nr, time_enabled, time_running, then one value per open counter in the
+  // order they joined the group.
+  uint64_t buf[3 + kCounterCount] = {};
+  const ssize_t n = read(leader_, buf, sizeof(buf));
+  for (int fd : fds_) {
+    if (fd >= 0) close(fd);
+  }
+  leader_ = -1;
+  if (n < static_cast<ssize_t>(3 * sizeof(uint64_t))) return;
+
+  const uint64_t nr = buf[0];
+  const uint64_t time_enabled = buf[1];
+  const uint64_t time_running = buf[2];
+  if (!time_running) return;
+  // Counters share the PMU with other groups; scale up any that were
+  // multiplexed out for part of the session.
+  const double scale = time_enabled > time_running
+                         ? static_cast<double>(time_enabled) / static_cast<double>(time_running)
+                         : 1.0;
+
+  Totals& totals = g_totals[static_cast<size_t>(type_)];
+  totals.sessions.fetch_add(1, std::memory_order_relaxed);
+  uint32_t read_mask = 0;
+  uint64_t slot = 0;
+  for (size_t c = 0; c < kCounterCount && slot < nr; ++c) {
+    if (fds_[c] < 0) continue;
+    const auto value = static_cast<uint64_t>(static_cast<double>(buf[3 + slot++]) * scale);
+    totals.values[c].fetch_add(value, std::memory_order_relaxed);
+    read_mask |= 1u << c;
+  }
+  g_counters.fetch_or(read_mask, std::memory_order_relaxed);
+#endif
+}
+
+}  // namespace maany::bridge::perf
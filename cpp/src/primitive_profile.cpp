@@ -0,0 +1,101 @@
+#include "primitive_profile.h"
+
+#ifdef MAANY_MPC_PROFILE_PRIMITIVES
+#include <atomic>
+#include <chrono>
+#include <ctime>
+#endif
+
+namespace maany::bridge::profile {
+
+#ifdef MAANY_MPC_PROFILE_PRIMITIVES
+
+namespace {
+
+// Same striping as Metrics: threads spread over cache-line aligned slots and
+// add with relaxed atomics.
+constexpr size_t kSlots = 16;
+constexpr size_t kOutsideSession = kSessionTypeCount;
+
+struct Counters {
+  std::atomic<uint64_t> calls{0};
+  std::atomic<uint64_t> wall_ns{0};
+  std::atomic<uint64_t> cpu_ns{0};
+};
+
+struct alignas(64) Slot {
+  Counters counters[kScopeCount][kPrimitiveCount];
+};
+
+Slot g_slots[kSlots];
+std::atomic<size_t> g_next_slot{0};
+thread_local size_t t_scope = kOutsideSession;
+
+Slot& LocalSlot() {
+  thread_local const size_t slot = g_next_slot.fetch_add(1, std::memory_order_relaxed) % kSlots;
+  return g_slots[slot];
+}
+
+uint64_t WallNs() {
+  return static_cast<uint64_t>(
+    std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch())
+      .count());
+}
+
+// Zero where there is no per-thread CPU clock, which leaves wall time only.
+uint64_t ThreadCpuNs() {
+#if defined(CLOCK_THREAD_CPUTIME_ID)
+  timespec ts{};
+  if (clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts) != 0) return 0;
+  return static_cast<uint64_t>(ts.tv_sec) * 1000000000ull + static_cast<uint64_t>(ts.tv_nsec);
+#else
+  return 0;
+#endif
+}
+
+}  // namespace
+
+SessionScope::SessionScope(SessionType type) : previous_(t_scope) {
+  t_scope = static_cast<size_t>(type);
+}
+
+SessionScope::~SessionScope() {
+  t_scope = previous_;
+}
+
+Timer::Timer(Primitive primitive) : primitive_(primitive), wall_start_(WallNs()), cpu_start_(ThreadCpuNs()) {}
+
+Timer::~Timer() {
+  const uint64_t cpu = ThreadCpuNs() - cpu_start_;
+  const uint64_t wall = WallNs() - wall_start_;
+  Counters& c = LocalSlot().counters[t_scope][static_cast<size_t>(primitive_)];
+  c.calls.fetch_add(1, std::memory_order_relaxed);
+  c.wall_ns.fetch_add(wall, std::memory_order_relaxed);
+  c.cpu_ns.fetch_add(cpu, std::memory_order_relaxed);
+}
+
+ProfileSnapshot Snapshot() {
+  ProfileSnapshot out{};
+  for (const Slot& slot : g_slots) {
+    for (size_t s = 0; s < kScopeCount; ++s) {
+      for (size_t p = 0; p < kPrimitiveCount; ++p) {
+        const Counters& src = slot.counters[s][p];
+        PrimitiveStats& dst = out[s][p];
+        dst.calls += src.calls.load(std::memory_order_relaxed);
+        dst.wall_ns += src.wall_ns.load(std::memory_order_relaxed);
+        dst.cpu_ns += src.cpu_ns.load(std::memory_order_relaxed);
+      }
+    }
+  }
+  return out;
+}
+
+#else
+
+ProfileSnapshot Snapshot() {
+  return ProfileSnapshot{};
+}
+
+#endif
+
+}  // namespace maany::bridge::profile
@@ -0,0 +1,762 @@
+#include "share_store.h"
+
+#include <algorithm>
+#include <array>
+#include <cerrno>
+#include <cstring>
+#include <mutex>
+#include <random>
+#include <shared_mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+#if !defined(_WIN32)
+#include <fcntl.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace maany::bridge {
+
+ShareStore::~ShareStore() = default;
+
+#if defined(_WIN32)
+
+std::unique_ptr<ShareStore> ShareStore::Open(const std::string&, const Options&) {
+  throw Error(ErrorCode::Unsupported, "share store requires POSIX mmap");
+}
+
+#else
+
+namespace {
+
+constexpr uint32_t kLogMagic = 0x5343504D;     // "MPCS"
+constexpr uint32_t kIndexMagic = 0x4943504D;   // "MPCI"
+constexpr uint32_t kRecordMagic = 0x5243504D;  // "MPCR"
+constexpr uint32_t kStoreVersion = 1;
+
+constexpr uint32_t kOpPut = 1;
+constexpr uint32_t kOpRemove = 2;
+
+// Log header: magic u32 | version u32 | generation u64 | reserved[16]
+constexpr size_t kLogHeaderSize = 32;
+// Record header: magic u32 | op u32 | key_id[32] | payload_len u32 | crc32 u32
+constexpr size_t kRecordHeaderSize = 48;
+constexpr size_t kMaxPayload = 1u << 24;
+
+// Index header: magic u32 | version u32 | generation u64 | capacity u64 |
+// used u64 | live_records u64 | live_bytes u64 | covered u64 | clean u32 | pad
+constexpr size_t kIndexHeaderSize = 64;
+// Slot: key_id[32] | offset u64. Offset 0 is empty, kDeletedSlot is a removed key.
+constexpr size_t kSlotSize = 40;
+constexpr uint64_t kDeletedSlot = ~0ull;
+constexpr uint64_t kMinCapacity = 64;
+
+constexpr size_t kMinLogMapping = 1u << 20;
+
+void StoreU32(uint8_t* p, uint32_t v) {
+  for (int i = 0; i < 4; ++i) p[i] = static_cast<uint8_t>(v >> (8 * i));
+}
+
+void StoreU64(uint8_t* p, uint64_t v) {
+  for (int i = 0; i < 8; ++i) p[i] = static_cast<uint8_t>(v >> (8 * i));
+}
+
+uint32_t LoadU32(const uint8_t* p) {
+  uint32_t v = 0;
+  for (int i = 3; i >= 0; --i) v = (v << 8) | p[i];
+  return v;
+}
+
+uint64_t LoadU64(const uint8_t* p) {
+  uint64_t v = 0;
+  for (int i = 7; i >= 0; --i) v = (v << 8) | p[i];
+  return v;
+}
+
+constexpr std::array<uint32_t, 256> MakeCrcTable() {
+  std::array<uint32_t, 256> table{};
+  for (uint32_t i = 0; i < 256; ++i) {
+    uint32_t c = i;
+    for (int k = 0; k < 8; ++k) c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+    table[i] = c;
+  }
+  return table;
+}
+
+constexpr auto kCrcTable = MakeCrcTable();
+
+uint32_t Crc32(uint32_t crc, const uint8_t* data, size_t len) {
+  crc = ~crc;
+  for (size_t i = 0; i < len; ++i) crc = kCrcTable[(crc ^ data[i]) & 0xFF] ^ (crc >> 8);
+  return ~crc;
+}
+
+size_t Pad8(size_t n) {
+  return (n + 7) & ~size_t{7};
+}
+
+size_t RecordSize(size_t payload_len) {
+  return kRecordHeaderSize + Pad8(payload_len);
+}
+
+// CRC over op, key_id, payload_len and payload; the magic is checked separately.
+uint32_t RecordCrc(const uint8_t* header, const uint8_t* payload, size_t payload_len) {
+  uint32_t crc = Crc32(0, header + 4, 40);
+  return Crc32(crc, payload, payload_len);
+}
+
+uint64_t NewGeneration() {
+  std::random_device rd;
+  uint64_t gen = (static_cast<uint64_t>(rd()) << 32) | rd();
+  return gen ? gen : 1;
+}
+
+uint64_t HashKey(const KeyId& id) {
+  uint64_t h = 0x9E3779B97F4A7C15ull;
+  for (size_t i = 0; i < id.bytes.size(); i += 8) {
+    h ^= LoadU64(id.bytes.data() + i);
+    h *= 0xBF58476D1CE4E5B9ull;
+    h ^= h >> 31;
+  }
+  return h;
+}
+
+uint64_t NextPow2(uint64_t n) {
+  uint64_t cap = kMinCapacity;
+  while (cap < n) cap <<= 1;
+  return cap;
+}
+
+[[noreturn]] void ThrowIo(const std::string& what) {
+  throw Error(ErrorCode::Io, what + ": " + std::strerror(errno));
+}
+
+void WriteAll(int fd, const uint8_t* data, size_t len, uint64_t offset) {
+  while (len > 0) {
+    ssize_t n = ::pwrite(fd, data, len, static_cast<off_t>(offset));
+    if (n < 0) {
+      if (errno == EINTR) continue;
+      ThrowIo("share store write failed");
+    }
+    data += n;
+    len -= static_cast<size_t>(n);
+    offset += static_cast<uint64_t>(n);
+  }
+}
+
+void SyncDir(const std::string& path) {
+  auto slash = path.find_last_of('/');
+  std::string dir = slash == std::string::npos ? "." : (slash == 0 ? "/" : path.substr(0, slash));
+  int fd = ::open(dir.c_str(), O_RDONLY | O_CLOEXEC);
+  if (fd < 0) return;
+  ::fsync(fd);
+  ::close(fd);
+}
+
+class Fd {
+ public:
+  Fd() = default;
+  explicit Fd(int fd) : fd_(fd) {}
+  Fd(const Fd&) = delete;
+  Fd& operator=(const Fd&) = delete;
+  Fd(Fd&& other) noexcept : fd_(std::exchange(other.fd_, -1)) {}
+  Fd& operator=(Fd&& other) noexcept {
+    if (this != &other) {
+      Reset();
+      fd_ = std::exchange(other.fd_, -1);
+    }
+    return *this;
+  }
+  ~Fd() { Reset(); }
+
+  int get() const { return fd_; }
+  void Reset() {
+    if (fd_ >= 0) ::close(fd_);
+    fd_ = -1;
+  }
+
+ private:
+  int fd_ = -1;
+};
+
+class Mapping {
+ public:
+  Mapping() = default;
+  Mapping(const Mapping&) = delete;
+  Mapping& operator=(const Mapping&) = delete;
+  ~Mapping() { Reset(); }
+
+  void Map(int fd, size_t len, bool writable) {
+    Reset();
+    int prot = PROT_READ | (writable ? PROT_WRITE : 0);
+    void* p = ::mmap(nullptr, len, prot, MAP_SHARED, fd, 0);
+    if (p == MAP_FAILED) ThrowIo("share store mmap failed");
+    data_ = static_cast<uint8_t*>(p);
+    len_ = len;
+  }
+
+  void Reset() {
+    if (data_) ::munmap(data_, len_);
+    data_ = nullptr;
+    len_ = 0;
+  }
+
+  void Flush(size_t len) const {
+    if (data_ && ::msync(data_, std::min(len, len_), MS_SYNC) != 0) ThrowIo("share store msync failed");
+  }
+
+  uint8_t* data() const { return data_; }
+  size_t size() const { return len_; }
+
+ private:
+  uint8_t* data_ = nullptr;
+  size_t len_ = 0;
+};
+
+// Open-addressing table over a header + slot array, either mapped from
+// `<path>.idx` or held in memory while rebuilding.
+class IndexView {
+ public:
+  explicit IndexView(uint8_t* base) : base_(base) {}
+
+  static size_t FileSize(uint64_t capacity) { return kIndexHeaderSize + capacity * kSlotSize; }
+
+  static void Init(uint8_t* base, uint64_t generation, uint64_t capacity) {
+    std::memset(base, 0, FileSize(capacity));
+    StoreU32(base, kIndexMagic);
+    StoreU32(base + 4, kStoreVersion);
+    StoreU64(base + 8, generation);
+    StoreU64(base + 16, capacity);
+  }
+
+  uint32_t magic() const { return LoadU32(base_); }
+  uint32_t version() const { return LoadU32(base_ + 4); }
+  uint64_t generation() const { return LoadU64(base_ + 8); }
+  uint64_t capacity() const { return LoadU64(base_ + 16); }
+  uint64_t used() const { return LoadU64(base_ + 24); }
+  uint64_t live_records() const { return LoadU64(base_ + 32); }
+  uint64_t live_bytes() const { return LoadU64(base_ + 40); }
+  uint64_t covered() const { return LoadU64(base_ + 48); }
+  bool clean() const { return LoadU32(base_ + 56) != 0; }
+
+  void set_used(uint64_t v) { StoreU64(base_ + 24, v); }
+  void set_live_records(uint64_t v) { StoreU64(base_ + 32, v); }
+  void set_live_bytes(uint64_t v) { StoreU64(base_ + 40, v); }
+  void set_covered(uint64_t v) { StoreU64(base_ + 48, v); }
+  void set_clean(bool v) { StoreU32(base_ + 56, v ? 1u : 0u); }
+
+  uint8_t* slot(uint64_t i) const { return base_ + kIndexHeaderSize + i * kSlotSize; }
+  static uint64_t SlotOffset(const uint8_t* s) { return LoadU64(s + 32); }
+
+  // Returns the live offset for `id`, or 0.
+  uint64_t Find(const KeyId& id) const {
+    const uint8_t* s = Probe(id, nullptr);
+    if (!s) return 0;
+    uint64_t off = SlotOffset(s);
+    return off == kDeletedSlot ? 0 : off;
+  }
+
+  // Points `id` at `offset`; returns the previous live offset or 0. The caller
+  // keeps the load factor in check, so a free slot always exists.
+  uint64_t Upsert(const KeyId& id, uint64_t offset) {
+    uint8_t* free_slot = nullptr;
+    uint8_t* s = Probe(id, &free_slot);
+    if (s) {
+      uint64_t prev = SlotOffset(s);
+      StoreU64(s + 32, offset);
+      return prev == kDeletedSlot ? 0 : prev;
+    }
+    std::memcpy(free_slot, id.bytes.data(), id.bytes.size());
+    StoreU64(free_slot + 32, offset);
+    set_used(used() + 1);
+    return 0;
+  }
+
+  // Marks `id` removed, keeping its slot so probe chains stay intact.
+  // Returns the previous live offset or 0.
+  uint64_t Erase(const KeyId& id) {
+    uint8_t* s = Probe(id, nullptr);
+    if (!s) return 0;
+    uint64_t prev = SlotOffset(s);
+    if (prev == kDeletedSlot) return 0;
+    StoreU64(s + 32, kDeletedSlot);
+    return prev;
+  }
+
+  bool NeedsGrow() const { return (used() + 1) * 2 > capacity(); }
+
+ private:
+  // Finds the slot holding `id` (live or removed). On a miss, returns null and
+  // sets `*free_slot` to the empty slot that ends the chain.
+  uint8_t* Probe(const KeyId& id, uint8_t** free_slot) const {
+    const uint64_t mask = capacity() - 1;
+    for (uint64_t i = HashKey(id) & mask, n = 0; n <= mask; i = (i + 1) & mask, ++n) {
+      uint8_t* s = slot(i);
+      uint64_t off = SlotOffset(s);
+      if (off == 0) {
+        if (free_slot) *free_slot = s;
+        return nullptr;
+      }
+      if (std::memcmp(s, id.bytes.data(), id.bytes.size()) == 0) return s;
+    }
+    throw Error(ErrorCode::General, "share store index full");
+  }
+
+  uint8_t* base_;
+};
+
+// In-memory index image used for recovery, growth and compaction, then
+// written out under a temporary name and renamed into place.
+class IndexImage {
+ public:
+  IndexImage(uint64_t generation, uint64_t capacity) : bytes_(IndexView::FileSize(capacity)) {
+    IndexView::Init(bytes_.data(), generation, capacity);
+  }
+
+  // Re-hashes the live slots of `old` into a table of `capacity` slots.
+  IndexImage(IndexView old, uint64_t capacity) : IndexImage(old.generation(), capacity) {
+    IndexView nv = view();
+    for (uint64_t i = 0; i < old.capacity(); ++i) {
+      const uint8_t* s = old.slot(i);
+      uint64_t off = IndexView::SlotOffset(s);
+      if (off == 0 || off == kDeletedSlot) continue;
+      KeyId id;
+      std::memcpy(id.bytes.data(), s, id.bytes.size());
+      nv.Upsert(id, off);
+    }
+    nv.set_live_records(old.live_records());
+    nv.set_live_bytes(old.live_bytes());
+    nv.set_covered(old.covered());
+  }
+
+  IndexView view() { return IndexView(bytes_.data()); }
+
+  void Upsert(const KeyId& id, uint64_t offset) {
+    if (view().NeedsGrow()) Grow();
+    view().Upsert(id, offset);
+  }
+
+  void WriteTo(const std::string& path) const {
+    const std::string tmp = path + ".tmp";
+    Fd fd(::open(tmp.c_str(), O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0600));
+    if (fd.get() < 0) ThrowIo("share store index create failed");
+    WriteAll(fd.get(), bytes_.data(), bytes_.size(), 0);
+    if (::fsync(fd.get()) != 0) ThrowIo("share store index fsync failed");
+    if (::rename(tmp.c_str(), path.c_str()) != 0) ThrowIo("share store index rename failed");
+  }
+
+  void Grow() { *this = IndexImage(view(), view().capacity() * 2); }
+
+ private:
+  std::vector<uint8_t> bytes_;
+};
+
+class ShareStoreImpl final : public ShareStore {
+ public:
+  ShareStoreImpl(std::string path, const Options& opts)
+      : path_(std::move(path)), index_path_(path_ + ".idx"), opts_(opts) {
+    OpenFiles();
+    // Only once the lock is held: these may belong to another handle's
+    // compaction in flight.
+    ::unlink((path_ + ".compact").c_str());
+    ::unlink((path_ + ".compact.idx").c_str());
+    ::unlink((path_ + ".compact.idx.tmp").c_str());
+    ::unlink((index_path_ + ".tmp").c_str());
+  }
+
+  ~ShareStoreImpl() override {
+    try {
+      CloseFiles();
+    } catch (...) {
+      // The next open rebuilds the index if it was not marked clean.
+    }
+  }
+
+  void Put(const KeyId& key_id, const uint8_t* sealed, size_t len) override {
+    if (!sealed || len == 0 || len > kMaxPayload)
+      throw Error(ErrorCode::InvalidArgument, "share store payload size invalid");
+    std::unique_lock<std::shared_mutex> lock(mutex_);
+    EnsureOpen();
+    const uint64_t offset = Append(kOpPut, key_id, sealed, len);
+    IndexView index = Index();
+    uint64_t prev = index.Upsert(key_id, offset);
+    if (prev) {
+      index.set_live_bytes(index.live_bytes() - RecordSizeAt(prev));
+    } else {
+      index.set_live_records(index.live_records() + 1);
+    }
+    index.set_live_bytes(index.live_bytes() + RecordSize(len));
+    index.set_covered(log_len_);
+    if (index.NeedsGrow()) GrowIndex();
+  }
+
+  bool Remove(const KeyId& key_id) override {
+    std::unique_lock<std::shared_mutex> lock(mutex_);
+    EnsureOpen();
+    if (!Index().Find(key_id)) return false;
+    Append(kOpRemove, key_id, nullptr, 0);
+    IndexView index = Index();
+    uint64_t prev = index.Erase(key_id);
+    index.set_live_records(index.live_records() - 1);
+    index.set_live_bytes(index.live_bytes() - RecordSizeAt(prev));
+    index.set_covered(log_len_);
+    return true;
+  }
+
+  bool Read(const KeyId& key_id, const std::function<void(ByteView)>& fn) const override {
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+    EnsureOpen();
+    uint64_t offset = Index().Find(key_id);
+    if (!offset) return false;
+    const uint8_t* rec = log_map_.data() + offset;
+    if (offset + kRecordHeaderSize > log_len_ || LoadU32(rec) != kRecordMagic ||
+        std::memcmp(rec + 8, key_id.bytes.data(), key_id.bytes.size()) != 0 ||
+        offset + RecordSize(LoadU32(rec + 40)) > log_len_)
+      throw Error(ErrorCode::Io, "share store index points at a foreign record");
+    fn(ByteView{rec + kRecordHeaderSize, LoadU32(rec + 40)});
+    return true;
+  }
+
+  void Compact() override {
+    std::unique_lock<std::shared_mutex> lock(mutex_);
+    EnsureOpen();
+    const std::string tmp_log = path_ + ".compact";
+    const std::string tmp_index = path_ + ".compact.idx";
+    const uint64_t generation = NewGeneration();
+
+    IndexView old = Index();
+    IndexImage image(generation, NextPow2(old.live_records() * 4));
+    Fd fd(::open(tmp_log.c_str(), O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0600));
+    if (fd.get() < 0) ThrowIo("share store compaction create failed");
+    // Locked before the rename so the new log is never visible unlocked.
+    if (::flock(fd.get(), LOCK_EX | LOCK_NB) != 0) ThrowIo("share store compaction lock failed");
+    {
+      uint8_t header[kLogHeaderSize];
+      EncodeLogHeader(header, generation);
+      WriteAll(fd.get(), header, sizeof(header), 0);
+
+      uint64_t out = kLogHeaderSize;
+      for (uint64_t i = 0; i < old.capacity(); ++i) {
+        const uint8_t* s = old.slot(i);
+        uint64_t off = IndexView::SlotOffset(s);
+        if (off == 0 || off == kDeletedSlot) continue;
+        const size_t size = RecordSizeAt(off);
+        WriteAll(fd.get(), log_map_.data() + off, size, out);
+        KeyId id;
+        std::memcpy(id.bytes.data(), s, id.bytes.size());
+        image.Upsert(id, out);
+        out += size;
+      }
+      if (::fsync(fd.get()) != 0) ThrowIo("share store compaction fsync failed");
+
+      IndexView nv = image.view();
+      nv.set_live_records(old.live_records());
+      nv.set_live_bytes(out - kLogHeaderSize);
+      nv.set_covered(out);
+      nv.set_clean(true);
+      image.WriteTo(tmp_index);
+    }
+
+    // Log first: a crash before the index rename leaves a generation mismatch,
+    // which the next open repairs by rebuilding.
+    CloseFiles();
+    const bool moved = ::rename(tmp_log.c_str(), path_.c_str()) == 0;
+    const int err = errno;
+    try {
+      if (moved) {
+        // A failed index rename leaves the old index behind; OpenFiles sees
+        // its stale generation and rebuilds.
+        (void)::rename(tmp_index.c_str(), index_path_.c_str());
+        SyncDir(path_);
+        OpenFiles(std::move(fd));
+      } else {
+        fd.Reset();
+        OpenFiles();
+      }
+    } catch (...) {
+      // No mappings are left to serve from; every later call fails until the
+      // store is opened again.
+      DropFiles();
+      failed_ = true;
+      throw;
+    }
+    if (!moved) {
+      errno = err;
+      ThrowIo("share store compaction rename failed");
+    }
+  }
+
+  void Sync() override {
+    std::unique_lock<std::shared_mutex> lock(mutex_);
+    EnsureOpen();
+    if (::fdatasync(log_fd_.get()) != 0) ThrowIo("share store fdatasync failed");
+    index_map_.Flush(index_map_.size());
+  }
+
+  Stats GetStats() const override {
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+    EnsureOpen();
+    IndexView index = Index();
+    Stats s;
+    s.live_records = index.live_records();
+    s.live_bytes = index.live_bytes();
+    s.file_bytes = log_len_;
+    return s;
+  }
+
+ private:
+  IndexView Index() const { return IndexView(index_map_.data()); }
+
+  void EnsureOpen() const {
+    if (failed_) throw Error(ErrorCode::Io, "share store unusable after a failed compaction; reopen it: " + path_);
+  }
+
+  static void EncodeLogHeader(uint8_t* header, uint64_t generation) {
+    std::memset(header, 0, kLogHeaderSize);
+    StoreU32(header, kLogMagic);
+    StoreU32(header + 4, kStoreVersion);
+    StoreU64(header + 8, generation);
+  }
+
+  size_t RecordSizeAt(uint64_t offset) const { return RecordSize(LoadU32(log_map_.data() + offset + 40)); }
+
+  // `locked` is a log fd whose lock is already held (the compacted log).
+  void OpenFiles(Fd locked = Fd()) {
+    if (locked.get() >= 0) {
+      log_fd_ = std::move(locked);
+    } else {
+      log_fd_ = Fd(::open(path_.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0600));
+      if (log_fd_.get() < 0) ThrowIo("share store open failed");
+      // One handle per store: two writers would interleave appends and race
+      // each other's index.
+      if (::flock(log_fd_.get(), LOCK_EX | LOCK_NB) != 0) {
+        if (errno == EWOULDBLOCK) throw Error(ErrorCode::Io, "share store is locked by another handle: " + path_);
+        ThrowIo("share store lock failed");
+      }
+      // A compaction elsewhere may have renamed a new log over the path
+      // between our open and the lock; the inode we hold would be orphaned.
+      struct stat held {}, named {};
+      if (::fstat(log_fd_.get(), &held) != 0 || ::stat(path_.c_str(), &named) != 0 ||
+          held.st_dev != named.st_dev || held.st_ino != named.st_ino)
+        throw Error(ErrorCode::Io, "share store is locked by another handle: " + path_);
+    }
+    struct stat st {};
+    if (::fstat(log_fd_.get(), &st) != 0) ThrowIo("share store stat failed");
+    log_len_ = static_cast<uint64_t>(st.st_size);
+
+    if (log_len_ == 0) {
+      uint8_t header[kLogHeaderSize];
+      EncodeLogHeader(header, NewGeneration());
+      WriteAll(log_fd_.get(), header, sizeof(header), 0);
+      if (::fsync(log_fd_.get()) != 0) ThrowIo("share store fsync failed");
+      SyncDir(path_);
+      log_len_ = kLogHeaderSize;
+    }
+    MapLog(log_len_);
+
+    const uint8_t* header = log_map_.data();
+    if (log_len_ < kLogHeaderSize || LoadU32(header) != kLogMagic || LoadU32(header + 4) != kStoreVersion)
+      throw Error(ErrorCode::Io, "not a share store: " + path_);
+    generation_ = LoadU64(header + 8);
+
+    if (!OpenIndex()) RebuildIndex();
+
+    IndexView index = Index();
+    index.set_clean(false);
+    index_map_.Flush(kIndexHeaderSize);
+  }
+
+  void CloseFiles() {
+    if (log_fd_.get() >= 0) {
+      if (::fdatasync(log_fd_.get()) != 0) ThrowIo("share store fdatasync failed");
+    }
+    if (index_map_.data()) {
+      // Slots before the clean flag, so a crash between the two flushes still
+      // reads as dirty.
+      index_map_.Flush(index_map_.size());
+      Index().set_clean(true);
+      index_map_.Flush(kIndexHeaderSize);
+    }
+    DropFiles();
+  }
+
+  void DropFiles() {
+    index_map_.Reset();
+    index_fd_.Reset();
+    log_map_.Reset();
+    log_fd_.Reset();
+  }
+
+  void MapLog(uint64_t needed) {
+    size_t len = std::max(log_map_.size(), kMinLogMapping);
+    while (len < needed) len *= 2;
+    if (log_map_.data() && len == log_map_.size()) return;
+    // Pages past EOF are mapped but never touched; reads stay below log_len_.
+    log_map_.Map(log_fd_.get(), len, false);
+  }
+
+  // Maps an existing index if it is clean and matches this log generation,
+  // then replays any records it does not cover.
+  bool OpenIndex() {
+    index_fd_ = Fd(::open(index_path_.c_str(), O_RDWR | O_CLOEXEC));
+    if (index_fd_.get() < 0) return false;
+    struct stat st {};
+    if (::fstat(index_fd_.get(), &st) != 0 || static_cast<size_t>(st.st_size) < kIndexHeaderSize) return false;
+    index_map_.Map(index_fd_.get(), static_cast<size_t>(st.st_size), true);
+
+    IndexView index = Index();
+    const uint64_t cap = index.capacity();
+    const bool valid = index.magic() == kIndexMagic && index.version() == kStoreVersion &&
+                       index.generation() == generation_ && index.clean() && cap >= kMinCapacity &&
+                       (cap & (cap - 1)) == 0 && cap <= (SIZE_MAX - kIndexHeaderSize) / kSlotSize &&
+                       IndexView::FileSize(cap) == static_cast<size_t>(st.st_size) &&
+                       index.covered() >= kLogHeaderSize && index.covered() <= log_len_;
+    if (!valid) {
+      index_map_.Reset();
+      index_fd_.Reset();
+      return false;
+    }
+
+    const uint64_t end = Scan(index.covered(), [&](uint32_t op, const KeyId& id, uint64_t off, size_t len) {
+      IndexView idx = Index();
+      if (op == kOpPut) {
+        uint64_t prev = idx.Upsert(id, off);
+        if (prev) idx.set_live_bytes(idx.live_bytes() - RecordSizeAt(prev));
+        else idx.set_live_records(idx.live_records() + 1);
+        idx.set_live_bytes(idx.live_bytes() + RecordSize(len));
+        if (idx.NeedsGrow()) GrowIndex();
+      } else if (uint64_t prev = idx.Erase(id)) {
+        idx.set_live_records(idx.live_records() - 1);
+        idx.set_live_bytes(idx.live_bytes() - RecordSizeAt(prev));
+      }
+    });
+    TruncateTail(end);
+    Index().set_covered(log_len_);
+    return true;
+  }
+
+  void RebuildIndex() {
+    index_map_.Reset();
+    index_fd_.Reset();
+
+    IndexImage image(generation_, kMinCapacity);
+    uint64_t live_records = 0;
+    uint64_t live_bytes = 0;
+    const uint64_t end = Scan(kLogHeaderSize, [&](uint32_t op, const KeyId& id, uint64_t off, size_t len) {
+      uint64_t prev = image.view().Find(id);
+      if (prev) live_bytes -= RecordSizeAt(prev);
+      else if (op == kOpPut) ++live_records;
+      if (op == kOpPut) {
+        image.Upsert(id, off);
+        live_bytes += RecordSize(len);
+      } else if (prev) {
+        image.view().Erase(id);
+        --live_records;
+      }
+    });
+    TruncateTail(end);
+
+    IndexView nv = image.view();
+    nv.set_live_records(live_records);
+    nv.set_live_bytes(live_bytes);
+    nv.set_covered(log_len_);
+    image.WriteTo(index_path_);
+    SyncDir(index_path_);
+    MapIndex();
+  }
+
+  void MapIndex() {
+    index_fd_ = Fd(::open(index_path_.c_str(), O_RDWR | O_CLOEXEC));
+    if (index_fd_.get() < 0) ThrowIo("share store index open failed");
+    struct stat st {};
+    if (::fstat(index_fd_.get(), &st) != 0) ThrowIo("share store index stat failed");
+    index_map_.Map(index_fd_.get(), static_cast<size_t>(st.st_size), true);
+  }
+
+  // Copies the live slots into a table twice the size and swaps it in.
+  void GrowIndex() {
+    IndexImage image(Index(), Index().capacity() * 2);
+    image.WriteTo(index_path_);
+    MapIndex();
+  }
+
+  // Walks well-formed records from `from`, returning the offset just past the
+  // last one. Anything after that is a torn append.
+  template <typename Fn>
+  uint64_t Scan(uint64_t from, Fn&& fn) const {
+    const uint8_t* base = log_map_.data();
+    uint64_t off = from;
+    while (off + kRecordHeaderSize <= log_len_) {
+      const uint8_t* rec = base + off;
+      if (LoadU32(rec) != kRecordMagic) break;
+      const uint32_t op = LoadU32(rec + 4);
+      const size_t len = LoadU32(rec + 40);
+      if ((op != kOpPut && op != kOpRemove) || (op == kOpPut) != (len != 0) || len > kMaxPayload) break;
+      if (off + RecordSize(len) > log_len_) break;
+      if (RecordCrc(rec, rec + kRecordHeaderSize, len) != LoadU32(rec + 44)) break;
+      KeyId id;
+      std::memcpy(id.bytes.data(), rec + 8, id.bytes.size());
+      fn(op, id, off, len);
+      off += RecordSize(len);
+    }
+    return off;
+  }
+
+  void TruncateTail(uint64_t end) {
+    if (end == log_len_) return;
+    if (::ftruncate(log_fd_.get(), static_cast<off_t>(end)) != 0) ThrowIo("share store truncate failed");
+    if (::fsync(log_fd_.get()) != 0) ThrowIo("share store fsync failed");
+    log_len_ = end;
+  }
+
+  uint64_t Append(uint32_t op, const KeyId& key_id, const uint8_t* payload, size_t len) {
+    const size_t size = RecordSize(len);
+    std::vector<uint8_t> rec(size, 0);
+    StoreU32(rec.data(), kRecordMagic);
+    StoreU32(rec.data() + 4, op);
+    std::memcpy(rec.data() + 8, key_id.bytes.data(), key_id.bytes.size());
+    StoreU32(rec.data() + 40, static_cast<uint32_t>(len));
+    if (len) std::memcpy(rec.data() + kRecordHeaderSize, payload, len);
+    StoreU32(rec.data() + 44, RecordCrc(rec.data(), rec.data() + kRecordHeaderSize, len));
+
+    const uint64_t offset = log_len_;
+    try {
+      WriteAll(log_fd_.get(), rec.data(), rec.size(), offset);
+      if (opts_.sync_writes && ::fdatasync(log_fd_.get()) != 0) ThrowIo("share store fdatasync failed");
+      MapLog(offset + size);
+    } catch (...) {
+      // Drop the partial record so the next append does not land behind it.
+      (void)::ftruncate(log_fd_.get(), static_cast<off_t>(offset));
+      throw;
+    }
+    log_len_ = offset + size;
+    return offset;
+  }
+
+  const std::string path_;
+  const std::string index_path_;
+  const Options opts_;
+  mutable std::shared_mutex mutex_;
+  Fd log_fd_;
+  Fd index_fd_;
+  Mapping log_map_;
+  Mapping index_map_;
+  uint64_t log_len_ = 0;
+  uint64_t generation_ = 0;
+  bool failed_ = false;
+};
+
+}  // namespace
+
+std::unique_ptr<ShareStore> ShareStore::Open(const std::string& path, const Options& opts) {
+  if (path.empty()) throw Error(ErrorCode::InvalidArgument, "share store path empty");
+  return std::make_unique<ShareStoreImpl>(path, opts);
+}
+
+#endif
+
+}  // namespace maany::bridge
@@ -0,0 +1,196 @@
+#include "timeline.h"
+
+#include <chrono>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace maany::bridge::timeline {
+
+namespace detail {
+std::atomic<bool> enabled{false};
+}  // namespace detail
+
+namespace {
+
+// Seqlock slot: `seq` is 2i+1 while event i is being written and 2i+2 once it
+// is complete, so a reader can tell a finished event from a torn one.
+struct Slot {
+  std::atomic<uint64_t> seq{0};
+  std::atomic<uint64_t> ts_ns{0};
+  std::atomic<uint64_t> session{0};
+  std::atomic<const char*> name{nullptr};
+  std::atomic<const char*> arg_name{nullptr};
+  std::atomic<uint64_t> arg{0};
+  std::atomic<uint32_t> tid{0};
+  std::atomic<uint8_t> phase{0};
+};
+
+struct Ring {
+  Slot slots[kEventsPerThread];
+  std::atomic<uint64_t> head{0};
+};
+
+// Never destroyed: threads can still exit, and hand their rings back, while
+// static destructors run.
+struct Registry {
+  std::mutex mutex;
+  std::vector<std::unique_ptr<Ring>> rings;
+  std::vector<Ring*> free;
+};
+
+Registry& GetRegistry() {
+  static Registry* registry = new Registry();
+  return *registry;
+}
+
+std::atomic<uint64_t> g_epoch_ns{0};
+std::atomic<uint64_t> g_next_session{0};
+std::atomic<uint32_t> g_next_tid{0};
+
+uint64_t NowNs() {
+  return static_cast<uint64_t>(
+    std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch())
+      .count());
+}
+
+struct Lease {
+  Ring* ring = nullptr;
+  uint32_t tid = 0;
+
+  ~Lease() {
+    if (!ring) return;
+    Registry& registry = GetRegistry();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    registry.free.push_back(ring);
+  }
+};
+
+thread_local Lease t_lease;
+
+Lease& LocalLease() {
+  if (t_lease.ring) return t_lease;
+  Registry& registry = GetRegistry();
+  std::lock_guard<std::mutex> lock(registry.mutex);
+  if (!registry.free.empty()) {
+    t_lease.ring = registry.free.back();
+    registry.free.pop_back();
+  } else {
+    registry.rings.push_back(std::make_unique<Ring>());
+    t_lease.ring = registry.rings.back().get();
+  }
+  t_lease.tid = g_next_tid.fetch_add(1, std::memory_order_relaxed) + 1;
+  return t_lease;
+}
+
+struct Event {
+  uint64_t ts_ns;
+  uint64_t session;
+  const char* name;
+  const char* arg_name;
+  uint64_t arg;
+  uint32_t tid;
+  Phase phase;
+};
+
+void CollectRing(const Ring& ring, uint64_t epoch_ns, std::vector<Event>& out) {
+  const uint64_t head = ring.head.load(std::memory_order_acquire);
+  const uint64_t first = head > kEventsPerThread ? head - kEventsPerThread : 0;
+  for (uint64_t i = first; i < head; ++i) {
+    const Slot& slot = ring.slots[i % kEventsPerThread];
+    const uint64_t seq = slot.seq.load(std::memory_order_acquire);
+    if (seq != 2 * i + 2) continue;
+    Event e{};
+    e.ts_ns = slot.ts_ns.load(std::memory_order_relaxed);
+    e.session = slot.session.load(std::memory_order_relaxed);
+    e.name = slot.name.load(std::memory_order_relaxed);
+    e.arg_name = slot.arg_name.load(std::memory_order_relaxed);
+    e.arg = slot.arg.load(std::memory_order_relaxed);
+    e.tid = slot.tid.load(std::memory_order_relaxed);
+    e.phase = static_cast<Phase>(slot.phase.load(std::memory_order_relaxed));
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (slot.seq.load(std::memory_order_relaxed) != seq) continue;
+    if (e.ts_ns < epoch_ns || !e.name) continue;
+    out.push_back(e);
+  }
+}
+
+const char* PhaseCode(Phase phase) {
+  switch (phase) {
+    case Phase::Begin:
+      return "B";
+    case Phase::End:
+      return "E";
+    case Phase::Instant:
+      return "i";
+  }
+  return "i";
+}
+
+}  // namespace
+
+void Start() {
+  g_epoch_ns.store(NowNs(), std::memory_order_relaxed);
+  detail::enabled.store(true, std::memory_order_relaxed);
+}
+
+void Stop() {
+  detail::enabled.store(false, std::memory_order_relaxed);
+}
+
+uint64_t NewSessionId() {
+  return g_next_session.fetch_add(1, std::memory_order_relaxed) + 1;
+}
+
+void Record(const char* name, Phase phase, uint64_t session, const char* arg_name, uint64_t arg) {
+  Lease& lease = LocalLease();
+  Ring& ring = *lease.ring;
+  const uint64_t i = ring.head.load(std::memory_order_relaxed);
+  Slot& slot = ring.slots[i % kEventsPerThread];
+  slot.seq.store(2 * i + 1, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+  slot.ts_ns.store(NowNs(), std::memory_order_relaxed);
+  slot.session.store(session, std::memory_order_relaxed);
+  slot.name.store(name, std::memory_order_relaxed);
+  slot.arg_name.store(arg_name, std::memory_order_relaxed);
+  slot.arg.store(arg, std::memory_order_relaxed);
+  slot.tid.store(lease.tid, std::memory_order_relaxed);
+  slot.phase.store(static_cast<uint8_t>(phase), std::memory_order_relaxed);
+  slot.seq.store(2 * i + 2, std::memory_order_release);
+  ring.head.store(i + 1, std::memory_order_release);
+}
+
+std::string DumpChromeJson() {
+  const uint64_t epoch_ns = g_epoch_ns.load(std::memory_order_relaxed);
+  std::vector<Event> events;
+  {
+    Registry& registry = GetRegistry();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    for (const auto& ring : registry.rings) CollectRing(*ring, epoch_ns, events);
+  }
+
+  std::string out = "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+  out += "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"args\":{\"name\":\"maany_mpc\"}}";
+  char line[384];
+  for (const Event& e : events) {
+    const double ts_us = static_cast<double>(e.ts_ns - epoch_ns) / 1000.0;
+    int n = std::snprintf(line, sizeof(line), ",\n{\"name\":\"%s\",\"ph\":\"%s\",\"ts\":%.3f,\"pid\":1,\"tid\":%u",
+                          e.name, PhaseCode(e.phase), ts_us, e.tid);
+    out.append(line, static_cast<size_t>(n));
+    if (e.phase == Phase::Instant) out += ",\"s\":\"t\"";
+    if (e.arg_name) {
+      n = std::snprintf(line, sizeof(line), ",\"args\":{\"session\":%llu,\"%s\":%llu}}",
+                        static_cast<unsigned long long>(e.session), e.arg_name,
+                        static_cast<unsigned long long>(e.arg));
+    } else {
+      n = std::snprintf(line, sizeof(line), ",\"args\":{\"session\":%llu}}",
+                        static_cast<unsigned long long>(e.session));
+    }
+    out.append(line, static_cast<size_t>(n));
+  }
+  out += "\n]}\n";
+  return out;
+}
+
+}  // namespace maany::bridge::timeline
@@ -0,0 +1,274 @@
+// RAND_METHOD is deprecated in OpenSSL 3 but is the one hook that reaches
+// every RAND_bytes, RAND_priv_bytes and BN_rand call cb-mpc makes.
+#define OPENSSL_SUPPRESS_DEPRECATED
+
+#include "transcript.h"
+
+#include <openssl/evp.h>
+#include <openssl/rand.h>
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <mutex>
+#include <utility>
+
+namespace maany::bridge {
+
+namespace {
+
+constexpr uint32_t kTranscriptMagic = 0x4D504354;  // "MPCT"
+constexpr uint32_t kTranscriptVersion = 1;
+constexpr uint32_t kFlagDeferPaillier = 1u << 0;
+constexpr uint32_t kFlagReusePaillier = 1u << 1;
+
+void AppendU32(std::vector<uint8_t>& out, uint32_t v) {
+  for (int shift = 24; shift >= 0; shift -= 8) out.push_back(static_cast<uint8_t>(v >> shift));
+}
+
+void AppendU64(std::vector<uint8_t>& out, uint64_t v) {
+  for (int shift = 56; shift >= 0; shift -= 8) out.push_back(static_cast<uint8_t>(v >> shift));
+}
+
+void AppendBytes(std::vector<uint8_t>& out, const uint8_t* data, size_t len) {
+  if (len > UINT32_MAX) throw Error(ErrorCode::InvalidArgument, "transcript field too large");
+  AppendU32(out, static_cast<uint32_t>(len));
+  out.insert(out.end(), data, data + len);
+}
+
+class Reader {
+ public:
+  explicit Reader(ByteView bytes) : p_(bytes.data), left_(bytes.len) {}
+
+  uint64_t Uint(int size) {
+    Need(static_cast<size_t>(size));
+    uint64_t v = 0;
+    for (int i = 0; i < size; ++i) v = (v << 8) | p_[i];
+    Advance(static_cast<size_t>(size));
+    return v;
+  }
+  uint32_t U32() { return static_cast<uint32_t>(Uint(4)); }
+  uint64_t U64() { return Uint(8); }
+
+  void Fixed(uint8_t* out, size_t len) {
+    Need(len);
+    std::memcpy(out, p_, len);
+    Advance(len);
+  }
+
+  std::vector<uint8_t> Bytes() {
+    const size_t len = U32();
+    Need(len);
+    std::vector<uint8_t> out(p_, p_ + len);
+    Advance(len);
+    return out;
+  }
+
+  bool empty() const { return left_ == 0; }
+
+ private:
+  void Need(size_t len) const {
+    if (left_ < len) throw Error(ErrorCode::InvalidArgument, "transcript truncated");
+  }
+  void Advance(size_t len) {
+    p_ += len;
+    left_ -= len;
+  }
+
+  const uint8_t* p_;
+  size_t left_;
+};
+
+thread_local ScopedSeededRng::Stream* t_stream = nullptr;
+
+}  // namespace
+
+// AES-256-CTR over zeros, keyed by the seed, with a zero IV.
+struct ScopedSeededRng::Stream {
+  EVP_CIPHER_CTX* ctx = nullptr;
+
+  int Generate(unsigned char* out, int len) {
+    if (len < 0) return 0;
+    std::memset(out, 0, static_cast<size_t>(len));
+    int written = 0;
+    return EVP_EncryptUpdate(ctx, out, &written, out, len) == 1 ? 1 : 0;
+  }
+};
+
+namespace {
+
+// Threads without a seeded stream draw from the private DRBG, which is what
+// RAND_priv_bytes would have used; public RAND_bytes output loses nothing.
+int HookBytes(unsigned char* out, int len) {
+  if (t_stream) return t_stream->Generate(out, len);
+  if (len < 0) return 0;
+  EVP_RAND_CTX* drbg = RAND_get0_private(nullptr);
+  return drbg && EVP_RAND_generate(drbg, out, static_cast<size_t>(len), 0, 0, nullptr, 0) == 1 ? 1 : 0;
+}
+
+int HookSeed(const void* buf, int len) {
+  return RAND_OpenSSL()->seed(buf, len);
+}
+
+int HookAdd(const void* buf, int len, double entropy) {
+  return RAND_OpenSSL()->add(buf, len, entropy);
+}
+
+int HookStatus() {
+  return RAND_OpenSSL()->status();
+}
+
+const RAND_METHOD kSeededMethod = {HookSeed, HookBytes, nullptr, HookAdd, HookBytes, HookStatus};
+
+// The hook is process-wide, so it is installed only while a recorded or
+// replayed session holds a ScopedSeededRng and the previous method is put
+// back when the last one ends.
+std::mutex g_method_mutex;
+size_t g_method_users = 0;
+const RAND_METHOD* g_previous_method = nullptr;
+
+void RetainSeededMethod() {
+  std::lock_guard<std::mutex> lock(g_method_mutex);
+  if (g_method_users == 0) {
+    g_previous_method = RAND_get_rand_method();
+    if (RAND_set_rand_method(&kSeededMethod) != 1) throw Error(ErrorCode::Rng, "cannot install seeded RNG");
+  }
+  ++g_method_users;
+}
+
+void ReleaseSeededMethod() {
+  std::lock_guard<std::mutex> lock(g_method_mutex);
+  if (--g_method_users == 0) {
+    RAND_set_rand_method(g_previous_method);
+    g_previous_method = nullptr;
+  }
+}
+
+}  // namespace
+
+ScopedSeededRng::ScopedSeededRng(const std::array<uint8_t, 32>& seed)
+    : stream_(std::make_unique<Stream>()), previous_(t_stream) {
+  static const uint8_t kZeroIv[16] = {};
+  stream_->ctx = EVP_CIPHER_CTX_new();
+  if (!stream_->ctx || EVP_EncryptInit_ex(stream_->ctx, EVP_aes_256_ctr(), nullptr, seed.data(), kZeroIv) != 1) {
+    EVP_CIPHER_CTX_free(stream_->ctx);
+    throw Error(ErrorCode::Rng, "cannot initialise seeded RNG");
+  }
+  try {
+    RetainSeededMethod();
+  } catch (...) {
+    EVP_CIPHER_CTX_free(stream_->ctx);
+    throw;
+  }
+  t_stream = stream_.get();
+}
+
+ScopedSeededRng::~ScopedSeededRng() {
+  t_stream = previous_;
+  ReleaseSeededMethod();
+  EVP_CIPHER_CTX_free(stream_->ctx);
+}
+
+BufferOwner EncodeTranscript(const Transcript& t) {
+  BufferOwner out;
+  auto& b = out.bytes;
+  AppendU32(b, kTranscriptMagic);
+  AppendU32(b, kTranscriptVersion);
+  AppendU32(b, static_cast<uint32_t>(t.kind));
+  AppendU32(b, static_cast<uint32_t>(t.party));
+  AppendU32(b, static_cast<uint32_t>(t.curve));
+  AppendU32(b, (t.defer_paillier ? kFlagDeferPaillier : 0) | (t.reuse_paillier ? kFlagReusePaillier : 0));
+  b.insert(b.end(), t.key_id.bytes.begin(), t.key_id.bytes.end());
+  b.insert(b.end(), t.seed.begin(), t.seed.end());
+  AppendBytes(b, t.session_id.bytes.data(), t.session_id.bytes.size());
+  AppendBytes(b, t.message.bytes.data(), t.message.bytes.size());
+  AppendU32(b, static_cast<uint32_t>(t.events.size()));
+  for (const auto& e : t.events) {
+    AppendU32(b, static_cast<uint32_t>(e.type));
+    AppendU64(b, e.t_ns);
+    AppendBytes(b, e.bytes.data(), e.bytes.size());
+  }
+  return out;
+}
+
+Transcript DecodeTranscript(ByteView bytes) {
+  Reader r(bytes);
+  if (r.U32() != kTranscriptMagic) throw Error(ErrorCode::InvalidArgument, "not a session transcript");
+  if (r.U32() != kTranscriptVersion) throw Error(ErrorCode::Unsupported, "unsupported transcript version");
+  Transcript t;
+  const uint32_t kind = r.U32();
+  if (kind < static_cast<uint32_t>(TranscriptKind::Dkg) || kind > static_cast<uint32_t>(TranscriptKind::Refresh))
+    throw Error(ErrorCode::InvalidArgument, "unknown transcript kind");
+  t.kind = static_cast<TranscriptKind>(kind);
+  const uint32_t party = r.U32();
+  if (party > static_cast<uint32_t>(ShareKind::Server))
+    throw Error(ErrorCode::InvalidArgument, "transcript party must be device or server");
+  t.party = static_cast<ShareKind>(party);
+  const uint32_t curve = r.U32();
+  if (curve > static_cast<uint32_t>(Curve::Ed25519)) throw Error(ErrorCode::InvalidArgument, "unknown curve");
+  t.curve = static_cast<Curve>(curve);
+  const uint32_t flags = r.U32();
+  t.defer_paillier = (flags & kFlagDeferPaillier) != 0;
+  t.reuse_paillier = (flags & kFlagReusePaillier) != 0;
+  r.Fixed(t.key_id.bytes.data(), t.key_id.bytes.size());
+  r.Fixed(t.seed.data(), t.seed.size());
+  t.session_id.bytes = r.Bytes();
+  t.message.bytes = r.Bytes();
+  const uint32_t count = r.U32();
+  for (uint32_t i = 0; i < count; ++i) {
+    TranscriptEvent e;
+    const uint32_t type = r.U32();
+    if (type != static_cast<uint32_t>(TranscriptEvent::Type::Send) &&
+        type != static_cast<uint32_t>(TranscriptEvent::Type::Receive))
+      throw Error(ErrorCode::InvalidArgument, "unknown transcript event");
+    e.type = static_cast<TranscriptEvent::Type>(type);
+    e.t_ns = r.U64();
+    e.bytes = r.Bytes();
+    t.events.push_back(std::move(e));
+  }
+  if (!r.empty()) throw Error(ErrorCode::InvalidArgument, "trailing bytes after transcript");
+  return t;
+}
+
+TranscriptRecorder::TranscriptRecorder(std::string path, Transcript header)
+    : path_(std::move(path)), transcript_(std::move(header)), start_(std::chrono::steady_clock::now()) {
+  if (RAND_bytes(transcript_.seed.data(), static_cast<int>(transcript_.seed.size())) != 1)
+    throw Error(ErrorCode::Rng, "RAND_bytes failed");
+}
+
+void TranscriptRecorder::SetMessage(const std::vector<uint8_t>& message) {
+  transcript_.message.bytes = message;
+}
+
+void TranscriptRecorder::Record(TranscriptEvent::Type type, const uint8_t* data, size_t len) {
+  TranscriptEvent e;
+  e.type = type;
+  e.t_ns = static_cast<uint64_t>(
+      std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start_).count());
+  if (len) e.bytes.assign(data, data + len);
+  transcript_.events.push_back(std::move(e));
+}
+
+void TranscriptRecorder::Write() noexcept {
+  try {
+    const BufferOwner encoded = EncodeTranscript(transcript_);
+    const std::string tmp = path_ + ".tmp";
+    {
+      std::ofstream out(tmp, std::ios::binary | std::ios::trunc);
+      out.write(reinterpret_cast<const char*>(encoded.bytes.data()),
+                static_cast<std::streamsize>(encoded.bytes.size()));
+      if (!out) return;
+    }
+    if (std::rename(tmp.c_str(), path_.c_str()) != 0) std::remove(tmp.c_str());
+  } catch (...) {
+  }
+}
+
+SessionTrace RecordTrace(const std::string& path, Transcript header) {
+  SessionTrace trace;
+  trace.recorder = std::make_shared<TranscriptRecorder>(path, std::move(header));
+  trace.seed = trace.recorder->seed();
+  return trace;
+}
+
+}  // namespace maany::bridge
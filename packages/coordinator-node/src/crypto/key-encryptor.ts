@@ -1,8 +1,12 @@
 import { createCipheriv, createDecipheriv, randomBytes } from 'node:crypto';
+import * as mpc from '@maany/mpc-node';
 
 export interface KeyEncryptor {
   encryptShare(raw: Uint8Array): Promise<string>;
   decryptShare(encoded: string): Promise<Uint8Array>;
+  /** Optional native path: seals a keypair without its plaintext share entering the JS heap. */
+  sealKeypair?(ctx: mpc.Ctx, kp: mpc.Keypair): Promise<string>;
+  openKeypair?(ctx: mpc.Ctx, encoded: string): Promise<mpc.Keypair>;
 }
 
 function normalizeKeyBytes(key: string | Buffer): Buffer {
@@ -22,6 +26,8 @@ function normalizeKeyBytes(key: string | Buffer): Buffer {
 
 export class AesGcmKeyEncryptor implements KeyEncryptor {
   private readonly masterKey: Buffer;
+  // KEKs are registered per native context; sessions each have their own.
+  private readonly keks = new WeakMap<mpc.Ctx, mpc.Kek>();
 
   constructor(masterKey: string | Buffer) {
     this.masterKey = normalizeKeyBytes(masterKey);
@@ -45,6 +51,53 @@ export class AesGcmKeyEncryptor implements KeyEncryptor {
     const plaintext = Buffer.concat([decipher.update(ciphertext), decipher.final()]);
     return new Uint8Array(plaintext);
   }
+
+  // Same envelope as encryptShare, but sealed natively, so records from either
+  // path decrypt with the other.
+  async sealKeypair(ctx: mpc.Ctx, kp: mpc.Keypair): Promise<string> {
+    const sealed = mpc.kpExportSealed(ctx, kp, this.kekFor(ctx));
+    return Buffer.from(sealed.buffer, sealed.byteOffset, sealed.byteLength).toString('base64');
+  }
+
+  async openKeypair(ctx: mpc.Ctx, encoded: string): Promise<mpc.Keypair> {
+    return mpc.kpImportSealed(ctx, this.kekFor(ctx), Buffer.from(encoded, 'base64'));
+  }
+
+  private kekFor(ctx: mpc.Ctx): mpc.Kek {
+    let kek = this.keks.get(ctx);
+    if (!kek) {
+      kek = mpc.kekRegister(ctx, this.masterKey);
+      this.keks.set(ctx, kek);
+    }
+    return kek;
+  }
+}
+
+/**
+ * Master key rotation for shares written by AesGcmKeyEncryptor. Rewrapping runs
+ * natively in batches across the context's worker threads, and every share is
+ * checked to be a key blob on the way. Results come back in input order.
+ */
+export async function* rewrapEncryptedShares(
+  ctx: mpc.Ctx,
+  oldMasterKey: string | Buffer,
+  newMasterKey: string | Buffer,
+  encoded: Iterable<string> | AsyncIterable<string>,
+  options?: { batchSize?: number },
+): AsyncGenerator<string, void, undefined> {
+  async function* decoded() {
+    for await (const value of encoded) yield new Uint8Array(Buffer.from(value, 'base64'));
+  }
+  const rewrapped = mpc.envelopeRewrap(
+    ctx,
+    normalizeKeyBytes(oldMasterKey),
+    normalizeKeyBytes(newMasterKey),
+    decoded(),
+    options,
+  );
+  for await (const blob of rewrapped) {
+    yield Buffer.from(blob).toString('base64');
+  }
 }
 
 export class PlaintextKeyEncryptor implements KeyEncryptor {
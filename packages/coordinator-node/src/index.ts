@@ -19,5 +19,6 @@ export {
   AesGcmKeyEncryptor,
   PlaintextKeyEncryptor,
   createEnvKeyEncryptor,
+  rewrapEncryptedShares,
 } from './crypto/key-encryptor';
 export type { KeyEncryptor } from './crypto/key-encryptor';
@@ -99,12 +99,16 @@ export async function runDkg(ctx: mpc.Ctx, opts: DkgOptions): Promise<DkgResult>
 
   const serverKeypair = mpc.dkgFinalize(ctx, dkgServer);
 
-  const serverBlob = mpc.kpExport(ctx, serverKeypair);
   const walletId =
     opts.metadata?.walletId ??
-    (normalizedKeyId ? Buffer.from(normalizedKeyId).toString('hex') : Buffer.from(serverBlob).toString('hex'));
+    (normalizedKeyId
+      ? Buffer.from(normalizedKeyId).toString('hex')
+      : Buffer.from(mpc.kpExport(ctx, serverKeypair)).toString('hex'));
   const publicKey = Buffer.from(mpc.kpPubkey(ctx, serverKeypair).compressed).toString('hex');
-  const encryptedServerShare = await opts.encryptor.encryptShare(serverBlob);
+  // Encryptors with a native path seal the share without exporting it to JS.
+  const encryptedServerShare = opts.encryptor.sealKeypair
+    ? await opts.encryptor.sealKeypair(ctx, serverKeypair)
+    : await opts.encryptor.encryptShare(mpc.kpExport(ctx, serverKeypair));
 
   const record: WalletShareUpsert = {
     walletId,
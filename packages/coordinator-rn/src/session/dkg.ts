@@ -34,6 +34,8 @@ export interface DeviceBackupOptions {
 export interface DeviceBackupArtifacts {
   ciphertext: BackupCiphertext;
   shares: Uint8Array[];
+  /** Needed by backupUpdate after a refresh; keep it with the device share, not with the ciphertext. */
+  updateKey: Uint8Array;
 }
 
 export type BackupCiphertextKind = 'device' | 'server';
@@ -49,6 +51,9 @@ export interface BackupCiphertext {
   shareCount: number;
   label: Uint8Array;
   blob: Uint8Array;
+  commitments?: Uint8Array;
+  ephemeral?: Uint8Array;
+  auth?: Uint8Array;
 }
 
 interface BackupCreateOptions {
@@ -60,6 +65,7 @@ interface BackupCreateOptions {
 interface BackupCreateResult {
   ciphertext: BackupCiphertext;
   shares: Uint8Array[];
+  updateKey: Uint8Array;
 }
 
 export async function runDkg(ctx: mpc.Ctx, opts: DkgOptions): Promise<DkgResult> {
@@ -163,6 +169,7 @@ function maybeCreateBackup(
   return {
     ciphertext: cloneBackupCiphertext(result.ciphertext),
     shares: result.shares.map((share) => cloneBytes(share)),
+    updateKey: cloneBytes(result.updateKey),
   };
 }
 
@@ -176,5 +183,8 @@ function cloneBackupCiphertext(ciphertext: BackupCiphertext): BackupCiphertext {
     shareCount: ciphertext.shareCount,
     label: cloneBytes(ciphertext.label),
     blob: cloneBytes(ciphertext.blob),
+    commitments: optionalClone(ciphertext.commitments),
+    ephemeral: optionalClone(ciphertext.ephemeral),
+    auth: optionalClone(ciphertext.auth),
   };
 }
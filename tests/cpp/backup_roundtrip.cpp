@@ -0,0 +1,296 @@
+#include "maany_mpc.h"
+#include "test_util.h"
+
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+namespace {
+
+using maany::test::AbortOnError;
+using maany::test::RunDkg;
+
+constexpr uint32_t kKeyCount = 3;
+constexpr uint32_t kThreshold = 2;
+constexpr size_t kShareCount = 3;
+
+// secp256k1 group order, big-endian.
+constexpr uint8_t kCurveOrder[32] = {0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+                                     0xFF, 0xFF, 0xFF, 0xFF, 0xFE, 0xBA, 0xAE, 0xDC, 0xE6, 0xAF, 0x48,
+                                     0xA0, 0x3B, 0xBF, 0xD2, 0x5E, 0x8C, 0xD0, 0x36, 0x41, 0x41};
+
+bool SamePubKey(maany_mpc_ctx_t* ctx, const maany_mpc_keypair_t* a, const maany_mpc_keypair_t* b) {
+  maany_mpc_pubkey_t pa{};
+  maany_mpc_pubkey_t pb{};
+  AbortOnError(maany_mpc_kp_pubkey(ctx, a, &pa), "maany_mpc_kp_pubkey(a)");
+  AbortOnError(maany_mpc_kp_pubkey(ctx, b, &pb), "maany_mpc_kp_pubkey(b)");
+  bool same = maany::test::SamePubKey(pa, pb);
+  maany_mpc_buf_free(ctx, &pa.pubkey);
+  maany_mpc_buf_free(ctx, &pb.pubkey);
+  return same;
+}
+
+bool SameExport(maany_mpc_ctx_t* ctx, const maany_mpc_keypair_t* a, const maany_mpc_keypair_t* b) {
+  maany_mpc_buf_t ea{nullptr, 0};
+  maany_mpc_buf_t eb{nullptr, 0};
+  AbortOnError(maany_mpc_kp_export(ctx, a, &ea), "maany_mpc_kp_export(a)");
+  AbortOnError(maany_mpc_kp_export(ctx, b, &eb), "maany_mpc_kp_export(b)");
+  bool same = ea.len == eb.len && std::memcmp(ea.data, eb.data, ea.len) == 0;
+  maany_mpc_buf_free(ctx, &ea);
+  maany_mpc_buf_free(ctx, &eb);
+  return same;
+}
+
+void FreeCiphertext(maany_mpc_ctx_t* ctx, maany_mpc_backup_ciphertext_t& cipher) {
+  maany_mpc_buf_free(ctx, &cipher.label);
+  maany_mpc_buf_free(ctx, &cipher.ciphertext);
+  maany_mpc_buf_free(ctx, &cipher.commitments);
+  maany_mpc_buf_free(ctx, &cipher.ephemeral);
+  maany_mpc_buf_free(ctx, &cipher.auth);
+}
+
+}  // namespace
+
+int main() {
+  maany_mpc_ctx_t* ctx = maany_mpc_init(nullptr);
+  if (!ctx) {
+    std::fprintf(stderr, "maany_mpc_init failed\n");
+    return 1;
+  }
+
+  maany_mpc_dkg_opts_t opts_device{};
+  opts_device.curve = MAANY_MPC_CURVE_SECP256K1;
+  opts_device.scheme = MAANY_MPC_SCHEME_ECDSA_2P;
+  opts_device.kind = MAANY_MPC_SHARE_DEVICE;
+  opts_device.count = kKeyCount;
+  maany_mpc_dkg_opts_t opts_server = opts_device;
+  opts_server.kind = MAANY_MPC_SHARE_SERVER;
+  maany_mpc_dkg_t* dkg_device = nullptr;
+  maany_mpc_dkg_t* dkg_server = nullptr;
+  AbortOnError(maany_mpc_dkg_new(ctx, &opts_device, &dkg_device), "maany_mpc_dkg_new(device)");
+  AbortOnError(maany_mpc_dkg_new(ctx, &opts_server, &dkg_server), "maany_mpc_dkg_new(server)");
+  if (!RunDkg(ctx, dkg_device, dkg_server)) return 1;
+  std::vector<maany_mpc_keypair_t*> kps(kKeyCount, nullptr);
+  std::vector<maany_mpc_keypair_t*> server_kps(kKeyCount, nullptr);
+  AbortOnError(maany_mpc_dkg_finalize_many(ctx, dkg_device, kps.data(), kps.size()), "maany_mpc_dkg_finalize_many");
+  AbortOnError(maany_mpc_dkg_finalize_many(ctx, dkg_server, server_kps.data(), server_kps.size()),
+               "maany_mpc_dkg_finalize_many(server)");
+  maany_mpc_dkg_free(dkg_device);
+  maany_mpc_dkg_free(dkg_server);
+
+  const char label_text[] = "device-backup";
+  maany_mpc_buf_t label{reinterpret_cast<uint8_t*>(const_cast<char*>(label_text)), sizeof(label_text) - 1};
+
+  // Baseline: one backup (and one share set) per key.
+  for (uint32_t i = 0; i < kKeyCount; ++i) {
+    maany_mpc_backup_ciphertext_t cipher{};
+    std::vector<maany_mpc_backup_share_t> shares(kShareCount);
+    AbortOnError(maany_mpc_backup_create(ctx, kps[i], kThreshold, kShareCount, &label, &cipher, shares.data()),
+                 "maany_mpc_backup_create");
+    maany_mpc_keypair_t* restored = nullptr;
+    AbortOnError(maany_mpc_backup_restore(ctx, &cipher, shares.data(), kThreshold, &restored),
+                 "maany_mpc_backup_restore");
+    if (!SamePubKey(ctx, restored, kps[i])) {
+      std::fprintf(stderr, "Single backup %u restored a different key\n", i);
+      return 1;
+    }
+    maany_mpc_kp_free(restored);
+    FreeCiphertext(ctx, cipher);
+    for (auto& share : shares) maany_mpc_buf_free(ctx, &share.data);
+  }
+
+  // After a refresh the backup payload is replaced while the shares stay put.
+  {
+    maany_mpc_backup_ciphertext_t cipher{};
+    std::vector<maany_mpc_backup_share_t> held(kShareCount);
+    maany_mpc_buf_t update_key{nullptr, 0};
+    AbortOnError(maany_mpc_backup_create_updatable(ctx, kps[0], kThreshold, kShareCount, &label, &cipher,
+                                                   held.data(), &update_key),
+                 "maany_mpc_backup_create_updatable");
+
+    maany_mpc_refresh_opts_t refresh_opts{};
+    refresh_opts.reuse_paillier = 1;
+    maany_mpc_dkg_t* refresh_device = nullptr;
+    maany_mpc_dkg_t* refresh_server = nullptr;
+    AbortOnError(maany_mpc_refresh_new(ctx, kps[0], &refresh_opts, &refresh_device), "maany_mpc_refresh_new(device)");
+    AbortOnError(maany_mpc_refresh_new(ctx, server_kps[0], &refresh_opts, &refresh_server),
+                 "maany_mpc_refresh_new(server)");
+    if (!RunDkg(ctx, refresh_device, refresh_server)) return 1;
+    maany_mpc_keypair_t* refreshed = nullptr;
+    maany_mpc_keypair_t* refreshed_server = nullptr;
+    AbortOnError(maany_mpc_dkg_finalize(ctx, refresh_device, &refreshed), "maany_mpc_dkg_finalize(refresh device)");
+    AbortOnError(maany_mpc_dkg_finalize(ctx, refresh_server, &refreshed_server),
+                 "maany_mpc_dkg_finalize(refresh server)");
+    maany_mpc_dkg_free(refresh_device);
+    maany_mpc_dkg_free(refresh_server);
+
+    maany_mpc_backup_ciphertext_t updated{};
+    AbortOnError(maany_mpc_backup_update(ctx, refreshed, &cipher, &update_key, &updated), "maany_mpc_backup_update");
+    maany_mpc_backup_ciphertext_t rejected_update{};
+    if (maany_mpc_backup_update(ctx, kps[1], &cipher, &update_key, &rejected_update) != MAANY_MPC_ERR_INVALID_ARG) {
+      std::fprintf(stderr, "Backup update accepted a different key\n");
+      return 1;
+    }
+    // Anyone can seal to the public wrapping key; only the update key holder
+    // can produce a payload that restores.
+    std::vector<uint8_t> wrong_key_bytes(update_key.len, 0x5C);
+    maany_mpc_buf_t wrong_key{wrong_key_bytes.data(), wrong_key_bytes.size()};
+    if (maany_mpc_backup_update(ctx, refreshed, &cipher, &wrong_key, &rejected_update) !=
+        MAANY_MPC_ERR_INVALID_ARG) {
+      std::fprintf(stderr, "Backup update accepted a wrong update key\n");
+      return 1;
+    }
+    maany_mpc_buf_free(ctx, &update_key);
+    maany_mpc_keypair_t* forged = nullptr;
+    static_cast<uint8_t*>(updated.auth.data)[0] ^= 0x01;
+    if (maany_mpc_backup_restore(ctx, &updated, held.data(), kThreshold, &forged) == MAANY_MPC_OK) {
+      std::fprintf(stderr, "Restore accepted a payload with a bad authentication tag\n");
+      return 1;
+    }
+    static_cast<uint8_t*>(updated.auth.data)[0] ^= 0x01;
+    maany_mpc_backup_ciphertext_t unauthenticated = updated;
+    unauthenticated.auth = maany_mpc_buf_t{nullptr, 0};
+    if (maany_mpc_backup_restore(ctx, &unauthenticated, held.data(), kThreshold, &forged) == MAANY_MPC_OK) {
+      std::fprintf(stderr, "Restore accepted a wrapped payload without an authentication tag\n");
+      return 1;
+    }
+
+    maany_mpc_keypair_t* restored = nullptr;
+    AbortOnError(maany_mpc_backup_restore(ctx, &updated, held.data() + 1, kThreshold, &restored),
+                 "maany_mpc_backup_restore(updated)");
+    if (!SameExport(ctx, restored, refreshed)) {
+      std::fprintf(stderr, "Updated backup did not restore the refreshed share\n");
+      return 1;
+    }
+    maany_mpc_kp_free(restored);
+
+    FreeCiphertext(ctx, cipher);
+    FreeCiphertext(ctx, updated);
+    for (auto& share : held) maany_mpc_buf_free(ctx, &share.data);
+    maany_mpc_kp_free(kps[0]);
+    maany_mpc_kp_free(server_kps[0]);
+    kps[0] = refreshed;
+    server_kps[0] = refreshed_server;
+  }
+
+  // One bundle and one share set for every key.
+  maany_mpc_backup_bundle_t bundle{};
+  std::vector<maany_mpc_backup_share_t> shares(kShareCount);
+  AbortOnError(maany_mpc_backup_create_many(ctx, kps.data(), kps.size(), kThreshold, kShareCount, &label, &bundle,
+                                            shares.data()),
+               "maany_mpc_backup_create_many");
+  if (bundle.record_count != kKeyCount) {
+    std::fprintf(stderr, "Unexpected bundle record count %u\n", bundle.record_count);
+    return 1;
+  }
+
+  std::vector<maany_mpc_keypair_t*> restored(kKeyCount, nullptr);
+  const maany_mpc_backup_share_t quorum[] = {shares[0], shares[2]};
+  AbortOnError(maany_mpc_backup_restore_many(ctx, &bundle, quorum, 2, nullptr, kKeyCount, restored.data()),
+               "maany_mpc_backup_restore_many(all)");
+  for (uint32_t i = 0; i < kKeyCount; ++i) {
+    if (!SamePubKey(ctx, restored[i], kps[i])) {
+      std::fprintf(stderr, "Bundle record %u restored a different key\n", i);
+      return 1;
+    }
+    maany_mpc_kp_free(restored[i]);
+  }
+
+  // A subset, in caller order, from a different quorum.
+  const uint32_t subset[] = {2, 0};
+  const maany_mpc_backup_share_t other_quorum[] = {shares[1], shares[2]};
+  maany_mpc_keypair_t* subset_kps[2] = {nullptr, nullptr};
+  AbortOnError(maany_mpc_backup_restore_many(ctx, &bundle, other_quorum, 2, subset, 2, subset_kps),
+               "maany_mpc_backup_restore_many(subset)");
+  if (!SamePubKey(ctx, subset_kps[0], kps[2]) || !SamePubKey(ctx, subset_kps[1], kps[0])) {
+    std::fprintf(stderr, "Bundle subset restored the wrong keys\n");
+    return 1;
+  }
+  maany_mpc_kp_free(subset_kps[0]);
+  maany_mpc_kp_free(subset_kps[1]);
+
+  // A single share is below threshold; an out-of-range index is rejected.
+  maany_mpc_keypair_t* rejected = nullptr;
+  if (maany_mpc_backup_restore_many(ctx, &bundle, shares.data(), 1, nullptr, kKeyCount, restored.data()) ==
+      MAANY_MPC_OK) {
+    std::fprintf(stderr, "Restore accepted fewer shares than the threshold\n");
+    return 1;
+  }
+  const uint32_t bad_index[] = {kKeyCount};
+  if (maany_mpc_backup_restore_many(ctx, &bundle, shares.data(), 2, bad_index, 1, &rejected) == MAANY_MPC_OK) {
+    std::fprintf(stderr, "Restore accepted an out-of-range record index\n");
+    return 1;
+  }
+
+  // A corrupted share is identified from the commitments and skipped on restore.
+  std::vector<uint8_t> corrupt_bytes(shares[1].data.data, shares[1].data.data + shares[1].data.len);
+  corrupt_bytes.back() ^= 0x01;
+  const maany_mpc_backup_share_t with_corrupt[] = {
+      {{corrupt_bytes.data(), corrupt_bytes.size()}}, shares[0], shares[2]};
+  uint8_t valid[3] = {0, 0, 0};
+  AbortOnError(maany_mpc_backup_verify_shares(ctx, &bundle.commitments, kThreshold, with_corrupt, 3, valid),
+               "maany_mpc_backup_verify_shares");
+  if (valid[0] != 0 || valid[1] != 1 || valid[2] != 1) {
+    std::fprintf(stderr, "Share verification did not single out the corrupted share\n");
+    return 1;
+  }
+  AbortOnError(maany_mpc_backup_restore_many(ctx, &bundle, with_corrupt, 3, nullptr, kKeyCount, restored.data()),
+               "maany_mpc_backup_restore_many(corrupt share)");
+  for (uint32_t i = 0; i < kKeyCount; ++i) {
+    if (!SamePubKey(ctx, restored[i], kps[i])) {
+      std::fprintf(stderr, "Restore around a corrupted share returned a different key\n");
+      return 1;
+    }
+    maany_mpc_kp_free(restored[i]);
+  }
+  const maany_mpc_backup_share_t corrupt_quorum[] = {with_corrupt[0], shares[0]};
+  if (maany_mpc_backup_restore_many(ctx, &bundle, corrupt_quorum, 2, nullptr, kKeyCount, restored.data()) ==
+      MAANY_MPC_OK) {
+    std::fprintf(stderr, "Restore accepted a quorum containing a corrupted share\n");
+    return 1;
+  }
+
+  // pid + q aliases pid under the Feldman check but must not count as a second
+  // share. Shares encode version | pid | value with 32-byte scalars.
+  std::vector<uint8_t> alias_bytes(shares[0].data.data, shares[0].data.data + shares[0].data.len);
+  unsigned carry = 0;
+  for (size_t i = sizeof(kCurveOrder); i-- > 0;) {
+    carry += alias_bytes[1 + i] + kCurveOrder[i];
+    alias_bytes[1 + i] = static_cast<uint8_t>(carry);
+    carry >>= 8;
+  }
+  const maany_mpc_backup_share_t aliased_quorum[] = {shares[0], {{alias_bytes.data(), alias_bytes.size()}}};
+  AbortOnError(maany_mpc_backup_verify_shares(ctx, &bundle.commitments, kThreshold, aliased_quorum, 2, valid),
+               "maany_mpc_backup_verify_shares(aliased pid)");
+  if (valid[0] != 1 || valid[1] != 0) {
+    std::fprintf(stderr, "Share verification accepted a pid outside [1, q)\n");
+    return 1;
+  }
+  if (maany_mpc_backup_restore_many(ctx, &bundle, aliased_quorum, 2, nullptr, kKeyCount, restored.data()) ==
+      MAANY_MPC_OK) {
+    std::fprintf(stderr, "Restore accepted a quorum with an aliased pid\n");
+    return 1;
+  }
+
+  // The label is bound into every record.
+  maany_mpc_buf_t original_label = bundle.label;
+  const char wrong_text[] = "other-backup";
+  bundle.label = maany_mpc_buf_t{reinterpret_cast<uint8_t*>(const_cast<char*>(wrong_text)), sizeof(wrong_text) - 1};
+  if (maany_mpc_backup_restore_many(ctx, &bundle, shares.data(), 2, nullptr, kKeyCount, restored.data()) ==
+      MAANY_MPC_OK) {
+    std::fprintf(stderr, "Restore accepted a bundle under the wrong label\n");
+    return 1;
+  }
+  bundle.label = original_label;
+
+  maany_mpc_buf_free(ctx, &bundle.label);
+  maany_mpc_buf_free(ctx, &bundle.envelope);
+  maany_mpc_buf_free(ctx, &bundle.commitments);
+  for (auto& share : shares) maany_mpc_buf_free(ctx, &share.data);
+  for (uint32_t i = 0; i < kKeyCount; ++i) {
+    maany_mpc_kp_free(kps[i]);
+    maany_mpc_kp_free(server_kps[i]);
+  }
+  maany_mpc_shutdown(ctx);
+  return 0;
+}
@@ -0,0 +1,129 @@
+#include "maany_mpc.h"
+#include "test_util.h"
+
+#include <cbmpc/crypto/base.h>
+#include <cstdio>
+#include <vector>
+
+namespace {
+
+using maany::test::AbortOnError;
+using maany::test::RunDkg;
+using maany::test::RunSign;
+using maany::test::SamePubKey;
+
+bool SignAndVerify(maany_mpc_ctx_t* ctx, maany_mpc_keypair_t* device, maany_mpc_keypair_t* server,
+                   const maany_mpc_pubkey_t& pub) {
+  const std::vector<uint8_t> message(32, 0x42);
+  maany_mpc_sign_opts_t opts{};
+  opts.scheme = MAANY_MPC_SCHEME_ECDSA_2P;
+  maany_mpc_sign_t* sign_device = nullptr;
+  maany_mpc_sign_t* sign_server = nullptr;
+  AbortOnError(maany_mpc_sign_new(ctx, device, &opts, &sign_device), "maany_mpc_sign_new(device_child)");
+  AbortOnError(maany_mpc_sign_new(ctx, server, &opts, &sign_server), "maany_mpc_sign_new(server_child)");
+  AbortOnError(maany_mpc_sign_set_message(ctx, sign_device, message.data(), message.size()),
+               "maany_mpc_sign_set_message(device_child)");
+  AbortOnError(maany_mpc_sign_set_message(ctx, sign_server, message.data(), message.size()),
+               "maany_mpc_sign_set_message(server_child)");
+  if (!RunSign(ctx, sign_device, sign_server)) return false;
+
+  maany_mpc_buf_t sig_der{};
+  AbortOnError(maany_mpc_sign_finalize(ctx, sign_device, MAANY_MPC_SIG_FORMAT_DER, &sig_der),
+               "maany_mpc_sign_finalize(device_child)");
+  maany_mpc_sign_free(sign_device);
+  maany_mpc_sign_free(sign_server);
+
+  coinbase::crypto::ecc_point_t point;
+  if (point.from_bin(coinbase::crypto::curve_secp256k1,
+                     coinbase::mem_t(pub.pubkey.data, static_cast<int>(pub.pubkey.len)))) {
+    std::fprintf(stderr, "Failed to decode derived public key\n");
+    return false;
+  }
+  coinbase::crypto::ecc_pub_key_t pub_key(point);
+  const bool ok = !pub_key.verify(coinbase::mem_t(message.data(), static_cast<int>(message.size())),
+                                  coinbase::mem_t(sig_der.data, static_cast<int>(sig_der.len)));
+  if (!ok) std::fprintf(stderr, "Signature verification failed for derived key\n");
+  maany_mpc_buf_free(ctx, &sig_der);
+  return ok;
+}
+
+}  // namespace
+
+int main() {
+  maany_mpc_ctx_t* ctx = maany_mpc_init(nullptr);
+  if (!ctx) {
+    std::fprintf(stderr, "maany_mpc_init failed\n");
+    return 1;
+  }
+
+  maany_mpc_dkg_opts_t opts_device{};
+  opts_device.curve = MAANY_MPC_CURVE_SECP256K1;
+  opts_device.scheme = MAANY_MPC_SCHEME_ECDSA_2P;
+  opts_device.kind = MAANY_MPC_SHARE_DEVICE;
+  maany_mpc_dkg_opts_t opts_server = opts_device;
+  opts_server.kind = MAANY_MPC_SHARE_SERVER;
+  maany_mpc_dkg_t* dkg_device = nullptr;
+  maany_mpc_dkg_t* dkg_server = nullptr;
+  AbortOnError(maany_mpc_dkg_new(ctx, &opts_device, &dkg_device), "maany_mpc_dkg_new(device)");
+  AbortOnError(maany_mpc_dkg_new(ctx, &opts_server, &dkg_server), "maany_mpc_dkg_new(server)");
+  if (!RunDkg(ctx, dkg_device, dkg_server)) return 1;
+  maany_mpc_keypair_t* device = nullptr;
+  maany_mpc_keypair_t* server = nullptr;
+  AbortOnError(maany_mpc_dkg_finalize(ctx, dkg_device, &device), "maany_mpc_dkg_finalize(device)");
+  AbortOnError(maany_mpc_dkg_finalize(ctx, dkg_server, &server), "maany_mpc_dkg_finalize(server)");
+  maany_mpc_dkg_free(dkg_device);
+  maany_mpc_dkg_free(dkg_server);
+
+  // Non-hardened BIP-32: derive m/0/5 on both sides, then sign with the children.
+  maany_mpc_chain_code_t chain_code{};
+  for (size_t i = 0; i < sizeof(chain_code.bytes); ++i) chain_code.bytes[i] = static_cast<uint8_t>(0xA0 + i);
+  const uint32_t child_indices[] = {0, 5};
+  maany_mpc_bip32_path_t child_path{child_indices, 2};
+  maany_mpc_keypair_t* child_device = nullptr;
+  maany_mpc_keypair_t* child_server = nullptr;
+  AbortOnError(maany_mpc_kp_derive_child(ctx, device, &chain_code, &child_path, &child_device),
+               "maany_mpc_kp_derive_child(device)");
+  AbortOnError(maany_mpc_kp_derive_child(ctx, server, &chain_code, &child_path, &child_server),
+               "maany_mpc_kp_derive_child(server)");
+
+  const uint32_t hardened_indices[] = {0x80000000u};
+  maany_mpc_bip32_path_t hardened_path{hardened_indices, 1};
+  maany_mpc_keypair_t* hardened_child = nullptr;
+  if (maany_mpc_kp_derive_child(ctx, device, &chain_code, &hardened_path, &hardened_child) !=
+      MAANY_MPC_ERR_INVALID_ARG) {
+    std::fprintf(stderr, "Hardened derivation was not rejected\n");
+    return 1;
+  }
+
+  maany_mpc_pubkey_t child_pub_device{};
+  maany_mpc_pubkey_t child_pub_server{};
+  AbortOnError(maany_mpc_kp_pubkey(ctx, child_device, &child_pub_device), "maany_mpc_kp_pubkey(child_device)");
+  AbortOnError(maany_mpc_kp_pubkey(ctx, child_server, &child_pub_server), "maany_mpc_kp_pubkey(child_server)");
+  if (!SamePubKey(child_pub_device, child_pub_server)) {
+    std::fprintf(stderr, "Derived public keys differ between device and server\n");
+    return 1;
+  }
+
+  // Batch derivation of m/0/3..m/0/6 must agree with the single derivation of m/0/5.
+  const uint32_t parent_indices[] = {0};
+  maany_mpc_bip32_path_t parent_path{parent_indices, 1};
+  maany_mpc_pubkey_t batch_pubs[4]{};
+  AbortOnError(maany_mpc_kp_derive_pubkeys(ctx, server, &chain_code, &parent_path, 3, 4, batch_pubs),
+               "maany_mpc_kp_derive_pubkeys");
+  if (!SamePubKey(batch_pubs[2], child_pub_device)) {
+    std::fprintf(stderr, "Batch-derived public key mismatch\n");
+    return 1;
+  }
+  for (auto& pub : batch_pubs) maany_mpc_buf_free(ctx, &pub.pubkey);
+
+  if (!SignAndVerify(ctx, child_device, child_server, child_pub_device)) return 1;
+
+  maany_mpc_buf_free(ctx, &child_pub_device.pubkey);
+  maany_mpc_buf_free(ctx, &child_pub_server.pubkey);
+  maany_mpc_kp_free(child_device);
+  maany_mpc_kp_free(child_server);
+  maany_mpc_kp_free(device);
+  maany_mpc_kp_free(server);
+  maany_mpc_shutdown(ctx);
+  return 0;
+}
@@ -0,0 +1,139 @@
+#include "maany_mpc.h"
+#include "test_util.h"
+
+#include <cstdio>
+#include <vector>
+
+namespace {
+
+using maany::test::AbortOnError;
+using maany::test::RunDkg;
+using maany::test::SamePubKey;
+
+constexpr uint32_t kBatchSize = 4;
+
+maany_mpc_dkg_opts_t DeviceOpts(uint32_t count) {
+  maany_mpc_dkg_opts_t opts{};
+  opts.curve = MAANY_MPC_CURVE_SECP256K1;
+  opts.scheme = MAANY_MPC_SCHEME_ECDSA_2P;
+  opts.kind = MAANY_MPC_SHARE_DEVICE;
+  opts.count = count;
+  return opts;
+}
+
+}  // namespace
+
+int main() {
+  maany_mpc_ctx_t* ctx = maany_mpc_init(nullptr);
+  if (!ctx) {
+    std::fprintf(stderr, "maany_mpc_init failed\n");
+    return 1;
+  }
+
+  // Reference: the rounds of one single-key session.
+  int single_rounds = 0;
+  {
+    maany_mpc_dkg_opts_t opts_device = DeviceOpts(1);
+    maany_mpc_dkg_opts_t opts_server = opts_device;
+    opts_server.kind = MAANY_MPC_SHARE_SERVER;
+    maany_mpc_dkg_t* device = nullptr;
+    maany_mpc_dkg_t* server = nullptr;
+    AbortOnError(maany_mpc_dkg_new(ctx, &opts_device, &device), "maany_mpc_dkg_new(device)");
+    AbortOnError(maany_mpc_dkg_new(ctx, &opts_server, &server), "maany_mpc_dkg_new(server)");
+    if (!RunDkg(ctx, device, server, "DKG", &single_rounds)) return 1;
+    maany_mpc_keypair_t* kp_device = nullptr;
+    maany_mpc_keypair_t* kp_server = nullptr;
+    AbortOnError(maany_mpc_dkg_finalize(ctx, device, &kp_device), "maany_mpc_dkg_finalize(device)");
+    AbortOnError(maany_mpc_dkg_finalize(ctx, server, &kp_server), "maany_mpc_dkg_finalize(server)");
+    maany_mpc_kp_free(kp_device);
+    maany_mpc_kp_free(kp_server);
+    maany_mpc_dkg_free(device);
+    maany_mpc_dkg_free(server);
+  }
+
+  // One batch session producing kBatchSize key pairs in the same rounds.
+  int batch_rounds = 0;
+  maany_mpc_dkg_opts_t opts_device = DeviceOpts(kBatchSize);
+  maany_mpc_dkg_opts_t opts_server = opts_device;
+  opts_server.kind = MAANY_MPC_SHARE_SERVER;
+  maany_mpc_dkg_t* device = nullptr;
+  maany_mpc_dkg_t* server = nullptr;
+  AbortOnError(maany_mpc_dkg_new(ctx, &opts_device, &device), "maany_mpc_dkg_new(device batch)");
+  AbortOnError(maany_mpc_dkg_new(ctx, &opts_server, &server), "maany_mpc_dkg_new(server batch)");
+  if (!RunDkg(ctx, device, server, "batch DKG", &batch_rounds)) return 1;
+  if (batch_rounds != single_rounds) {
+    std::fprintf(stderr, "Batch DKG took %d rounds, a single DKG %d\n", batch_rounds, single_rounds);
+    return 1;
+  }
+
+  maany_mpc_keypair_t* single = nullptr;
+  if (maany_mpc_dkg_finalize(ctx, device, &single) != MAANY_MPC_ERR_INVALID_ARG) {
+    std::fprintf(stderr, "Single-key finalize accepted a batch session\n");
+    return 1;
+  }
+
+  std::vector<maany_mpc_keypair_t*> device_kps(kBatchSize, nullptr);
+  std::vector<maany_mpc_keypair_t*> server_kps(kBatchSize, nullptr);
+  AbortOnError(maany_mpc_dkg_finalize_many(ctx, device, device_kps.data(), device_kps.size()),
+               "maany_mpc_dkg_finalize_many(device)");
+  AbortOnError(maany_mpc_dkg_finalize_many(ctx, server, server_kps.data(), server_kps.size()),
+               "maany_mpc_dkg_finalize_many(server)");
+
+  std::vector<maany_mpc_pubkey_t> pubs(kBatchSize);
+  for (uint32_t i = 0; i < kBatchSize; ++i) {
+    maany_mpc_pubkey_t server_pub{};
+    AbortOnError(maany_mpc_kp_pubkey(ctx, device_kps[i], &pubs[i]), "maany_mpc_kp_pubkey(device)");
+    AbortOnError(maany_mpc_kp_pubkey(ctx, server_kps[i], &server_pub), "maany_mpc_kp_pubkey(server)");
+    if (!SamePubKey(pubs[i], server_pub)) {
+      std::fprintf(stderr, "Batch key %u: public keys differ\n", i);
+      return 1;
+    }
+    maany_mpc_buf_free(ctx, &server_pub.pubkey);
+    for (uint32_t j = 0; j < i; ++j) {
+      if (SamePubKey(pubs[i], pubs[j])) {
+        std::fprintf(stderr, "Batch keys %u and %u are not independent\n", j, i);
+        return 1;
+      }
+    }
+  }
+
+  for (uint32_t i = 0; i < kBatchSize; ++i) {
+    maany_mpc_buf_free(ctx, &pubs[i].pubkey);
+    maany_mpc_kp_free(device_kps[i]);
+    maany_mpc_kp_free(server_kps[i]);
+  }
+  maany_mpc_dkg_free(device);
+  maany_mpc_dkg_free(server);
+  maany_mpc_shutdown(ctx);
+
+  // With a single worker thread the lanes take turns computing and the batch
+  // still completes, including a session abandoned mid-protocol.
+  maany_mpc_init_opts_t serial_opts{};
+  serial_opts.max_threads = 1;
+  maany_mpc_ctx_t* serial = maany_mpc_init(&serial_opts);
+  if (!serial) {
+    std::fprintf(stderr, "maany_mpc_init(max_threads = 1) failed\n");
+    return 1;
+  }
+  AbortOnError(maany_mpc_dkg_new(serial, &opts_device, &device), "maany_mpc_dkg_new(device serial)");
+  AbortOnError(maany_mpc_dkg_new(serial, &opts_server, &server), "maany_mpc_dkg_new(server serial)");
+  if (!RunDkg(serial, device, server, "serial batch DKG")) return 1;
+  AbortOnError(maany_mpc_dkg_finalize_many(serial, device, device_kps.data(), device_kps.size()),
+               "maany_mpc_dkg_finalize_many(device serial)");
+  AbortOnError(maany_mpc_dkg_finalize_many(serial, server, server_kps.data(), server_kps.size()),
+               "maany_mpc_dkg_finalize_many(server serial)");
+  for (uint32_t i = 0; i < kBatchSize; ++i) {
+    maany_mpc_kp_free(device_kps[i]);
+    maany_mpc_kp_free(server_kps[i]);
+  }
+  maany_mpc_dkg_free(device);
+  maany_mpc_dkg_free(server);
+  AbortOnError(maany_mpc_dkg_new(serial, &opts_device, &device), "maany_mpc_dkg_new(device abandoned)");
+  maany_mpc_buf_t first{nullptr, 0};
+  maany_mpc_step_result_t step{};
+  AbortOnError(maany_mpc_dkg_step(serial, device, nullptr, &first, &step), "maany_mpc_dkg_step(abandoned)");
+  maany_mpc_buf_free(serial, &first);
+  maany_mpc_dkg_free(device);
+  maany_mpc_shutdown(serial);
+  return 0;
+}
@@ -0,0 +1,173 @@
+#include "maany_mpc.h"
+#include "paillier_shift.h"
+#include "test_util.h"
+
+#include <cbmpc/crypto/base.h>
+#include <cstdio>
+#include <vector>
+
+namespace {
+
+using maany::test::AbortOnError;
+using maany::test::RunDkg;
+using maany::test::RunSign;
+using maany::test::SamePubKey;
+
+// The Paillier setup's offset d = (x1 - x1') mod q must be accepted on both
+// sides of the wrap and rejected once it leaves [0, q); the shifted ciphertext
+// must hold the reduced share.
+bool CheckPaillierShift() {
+  using coinbase::crypto::bn_t;
+  const auto& q = coinbase::crypto::curve_secp256k1.order();
+  const bn_t& q_bn = q;
+  coinbase::crypto::paillier_t paillier;
+  paillier.generate();
+  const uint8_t tag[] = {'t', 'e', 's', 't'};
+  const coinbase::mem_t binding(tag, sizeof(tag));
+
+  const bn_t cases[][2] = {{bn_t(7), bn_t(5)}, {q_bn - bn_t(1), bn_t(5)}, {bn_t(3), q_bn - bn_t(3)}};
+  for (const auto& [x, d] : cases) {
+    const bn_t c = paillier.encrypt(x);
+    maany::bridge::PaillierShiftProof proof;
+    const bn_t shifted = maany::bridge::ShiftPaillierShare(paillier, c, x, d, q, binding, proof);
+    const bn_t plain = paillier.decrypt(shifted);
+    if (!(plain < q_bn) || plain != (x + d) % q) {
+      std::fprintf(stderr, "Paillier shift left the share unreduced\n");
+      return false;
+    }
+    if (!maany::bridge::VerifyPaillierShift(paillier, c, d, q, shifted, binding, proof)) {
+      std::fprintf(stderr, "Paillier shift proof rejected\n");
+      return false;
+    }
+    const uint8_t other_tag[] = {'o', 't', 'h', 'r'};
+    if (maany::bridge::VerifyPaillierShift(paillier, c, d + q_bn, q, shifted, binding, proof) ||
+        maany::bridge::VerifyPaillierShift(paillier, c, d, q, paillier.add_scalar(shifted, q_bn), binding, proof) ||
+        maany::bridge::VerifyPaillierShift(paillier, c, d, q, shifted, coinbase::mem_t(other_tag, sizeof(other_tag)),
+                                           proof)) {
+      std::fprintf(stderr, "Paillier shift proof accepted a bad offset\n");
+      return false;
+    }
+  }
+  return true;
+}
+
+}  // namespace
+
+int main() {
+  if (!CheckPaillierShift()) return 1;
+
+  maany_mpc_ctx_t* ctx = maany_mpc_init(nullptr);
+  if (!ctx) {
+    std::fprintf(stderr, "maany_mpc_init failed\n");
+    return 1;
+  }
+
+  // Phase one: EC-only DKG, the address is available as soon as it finishes.
+  maany_mpc_dkg_opts_t opts_device{};
+  opts_device.curve = MAANY_MPC_CURVE_SECP256K1;
+  opts_device.scheme = MAANY_MPC_SCHEME_ECDSA_2P;
+  opts_device.kind = MAANY_MPC_SHARE_DEVICE;
+  opts_device.defer_paillier = 1;
+  maany_mpc_dkg_opts_t opts_server = opts_device;
+  opts_server.kind = MAANY_MPC_SHARE_SERVER;
+
+  maany_mpc_dkg_t* dkg_device = nullptr;
+  maany_mpc_dkg_t* dkg_server = nullptr;
+  AbortOnError(maany_mpc_dkg_new(ctx, &opts_device, &dkg_device), "maany_mpc_dkg_new(device)");
+  AbortOnError(maany_mpc_dkg_new(ctx, &opts_server, &dkg_server), "maany_mpc_dkg_new(server)");
+  if (!RunDkg(ctx, dkg_device, dkg_server, "Deferred DKG")) return 1;
+  maany_mpc_keypair_t* pending_device = nullptr;
+  maany_mpc_keypair_t* pending_server = nullptr;
+  AbortOnError(maany_mpc_dkg_finalize(ctx, dkg_device, &pending_device), "maany_mpc_dkg_finalize(device)");
+  AbortOnError(maany_mpc_dkg_finalize(ctx, dkg_server, &pending_server), "maany_mpc_dkg_finalize(server)");
+  maany_mpc_dkg_free(dkg_device);
+  maany_mpc_dkg_free(dkg_server);
+
+  maany_mpc_pubkey_t pub{};
+  maany_mpc_pubkey_t pub_server{};
+  AbortOnError(maany_mpc_kp_pubkey(ctx, pending_device, &pub), "maany_mpc_kp_pubkey(device)");
+  AbortOnError(maany_mpc_kp_pubkey(ctx, pending_server, &pub_server), "maany_mpc_kp_pubkey(server)");
+  if (!SamePubKey(pub, pub_server)) {
+    std::fprintf(stderr, "Deferred DKG public keys differ\n");
+    return 1;
+  }
+  maany_mpc_buf_free(ctx, &pub_server.pubkey);
+
+  maany_mpc_sign_opts_t sign_opts{};
+  sign_opts.scheme = MAANY_MPC_SCHEME_ECDSA_2P;
+  maany_mpc_sign_t* early_sign = nullptr;
+  if (maany_mpc_sign_new(ctx, pending_device, &sign_opts, &early_sign) != MAANY_MPC_ERR_PROTO_STATE) {
+    std::fprintf(stderr, "Signing before Paillier setup was not rejected\n");
+    return 1;
+  }
+
+  // Pending shares persist like any other share.
+  maany_mpc_buf_t exported{nullptr, 0};
+  AbortOnError(maany_mpc_kp_export(ctx, pending_server, &exported), "maany_mpc_kp_export(pending)");
+  maany_mpc_kp_free(pending_server);
+  pending_server = nullptr;
+  AbortOnError(maany_mpc_kp_import(ctx, &exported, &pending_server), "maany_mpc_kp_import(pending)");
+  maany_mpc_buf_free(ctx, &exported);
+
+  // Phase two: Paillier key and proofs, bound to the existing shares.
+  maany_mpc_keypair_t* device = nullptr;
+  maany_mpc_keypair_t* server = nullptr;
+  maany_mpc_dkg_t* setup_device = nullptr;
+  maany_mpc_dkg_t* setup_server = nullptr;
+  AbortOnError(maany_mpc_paillier_setup_new(ctx, pending_device, &setup_device),
+               "maany_mpc_paillier_setup_new(device)");
+  AbortOnError(maany_mpc_paillier_setup_new(ctx, pending_server, &setup_server),
+               "maany_mpc_paillier_setup_new(server)");
+  if (!RunDkg(ctx, setup_device, setup_server, "Paillier setup")) return 1;
+  AbortOnError(maany_mpc_dkg_finalize(ctx, setup_device, &device), "maany_mpc_dkg_finalize(setup device)");
+  AbortOnError(maany_mpc_dkg_finalize(ctx, setup_server, &server), "maany_mpc_dkg_finalize(setup server)");
+  maany_mpc_dkg_free(setup_device);
+  maany_mpc_dkg_free(setup_server);
+
+  maany_mpc_pubkey_t ready_pub{};
+  AbortOnError(maany_mpc_kp_pubkey(ctx, device, &ready_pub), "maany_mpc_kp_pubkey(ready)");
+  if (!SamePubKey(pub, ready_pub)) {
+    std::fprintf(stderr, "Paillier setup changed the public key\n");
+    return 1;
+  }
+  maany_mpc_buf_free(ctx, &ready_pub.pubkey);
+
+  std::vector<uint8_t> message(32);
+  for (size_t i = 0; i < message.size(); ++i) message[i] = static_cast<uint8_t>(0x40 + i);
+  maany_mpc_sign_t* sign_device = nullptr;
+  maany_mpc_sign_t* sign_server = nullptr;
+  AbortOnError(maany_mpc_sign_new(ctx, device, &sign_opts, &sign_device), "maany_mpc_sign_new(device)");
+  AbortOnError(maany_mpc_sign_new(ctx, server, &sign_opts, &sign_server), "maany_mpc_sign_new(server)");
+  AbortOnError(maany_mpc_sign_set_message(ctx, sign_device, message.data(), message.size()),
+               "maany_mpc_sign_set_message(device)");
+  AbortOnError(maany_mpc_sign_set_message(ctx, sign_server, message.data(), message.size()),
+               "maany_mpc_sign_set_message(server)");
+  if (!RunSign(ctx, sign_device, sign_server)) return 1;
+
+  maany_mpc_buf_t sig_der{};
+  AbortOnError(maany_mpc_sign_finalize(ctx, sign_device, MAANY_MPC_SIG_FORMAT_DER, &sig_der),
+               "maany_mpc_sign_finalize(device)");
+  coinbase::crypto::ecc_point_t pub_point;
+  if (pub_point.from_bin(coinbase::crypto::curve_secp256k1,
+                         coinbase::mem_t(pub.pubkey.data, static_cast<int>(pub.pubkey.len)))) {
+    std::fprintf(stderr, "Failed to decode public key\n");
+    return 1;
+  }
+  coinbase::crypto::ecc_pub_key_t pub_key(pub_point);
+  if (pub_key.verify(coinbase::mem_t(message.data(), static_cast<int>(message.size())),
+                     coinbase::mem_t(sig_der.data, static_cast<int>(sig_der.len)))) {
+    std::fprintf(stderr, "Signature verification failed after Paillier setup\n");
+    return 1;
+  }
+
+  maany_mpc_buf_free(ctx, &sig_der);
+  maany_mpc_sign_free(sign_device);
+  maany_mpc_sign_free(sign_server);
+  maany_mpc_buf_free(ctx, &pub.pubkey);
+  maany_mpc_kp_free(pending_device);
+  maany_mpc_kp_free(pending_server);
+  maany_mpc_kp_free(device);
+  maany_mpc_kp_free(server);
+  maany_mpc_shutdown(ctx);
+  return 0;
+}
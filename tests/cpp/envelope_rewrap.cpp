@@ -0,0 +1,224 @@
+#include "maany_mpc.h"
+#include "test_util.h"
+
+#include <openssl/evp.h>
+#include <openssl/rand.h>
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+namespace {
+
+using maany::test::AbortOnError;
+using maany::test::RunDkg;
+
+constexpr uint32_t kKeyCount = 4;
+// Enough envelopes that every worker of the context's pool gets a share.
+constexpr size_t kEnvelopeCount = 256;
+constexpr size_t kNonceSize = 12;
+constexpr size_t kTagSize = 16;
+
+// Same layout as the coordinator's AesGcmKeyEncryptor: nonce || tag || ciphertext.
+std::vector<uint8_t> Seal(const std::vector<uint8_t>& key, const std::vector<uint8_t>& plaintext) {
+  std::vector<uint8_t> out(kNonceSize + kTagSize + plaintext.size());
+  uint8_t* nonce = out.data();
+  uint8_t* tag = nonce + kNonceSize;
+  uint8_t* ciphertext = tag + kTagSize;
+  int len = 0;
+  EVP_CIPHER_CTX* cctx = EVP_CIPHER_CTX_new();
+  bool ok = cctx && RAND_bytes(nonce, kNonceSize) == 1 &&
+            EVP_EncryptInit_ex(cctx, EVP_aes_256_gcm(), nullptr, key.data(), nonce) == 1 &&
+            EVP_EncryptUpdate(cctx, ciphertext, &len, plaintext.data(), static_cast<int>(plaintext.size())) == 1 &&
+            EVP_EncryptFinal_ex(cctx, ciphertext + len, &len) == 1 &&
+            EVP_CIPHER_CTX_ctrl(cctx, EVP_CTRL_GCM_GET_TAG, kTagSize, tag) == 1;
+  EVP_CIPHER_CTX_free(cctx);
+  if (!ok) {
+    std::fprintf(stderr, "test seal failed\n");
+    std::exit(1);
+  }
+  return out;
+}
+
+bool Open(const std::vector<uint8_t>& key, const maany_mpc_buf_t& envelope, std::vector<uint8_t>& out) {
+  if (envelope.len < kNonceSize + kTagSize) return false;
+  const uint8_t* nonce = envelope.data;
+  const uint8_t* tag = nonce + kNonceSize;
+  const uint8_t* ciphertext = tag + kTagSize;
+  const size_t ciphertext_len = envelope.len - kNonceSize - kTagSize;
+  out.assign(ciphertext_len, 0);
+  int len = 0;
+  int final_len = 0;
+  EVP_CIPHER_CTX* cctx = EVP_CIPHER_CTX_new();
+  bool ok = cctx && EVP_DecryptInit_ex(cctx, EVP_aes_256_gcm(), nullptr, key.data(), nonce) == 1 &&
+            EVP_DecryptUpdate(cctx, out.data(), &len, ciphertext, static_cast<int>(ciphertext_len)) == 1 &&
+            EVP_CIPHER_CTX_ctrl(cctx, EVP_CTRL_GCM_SET_TAG, kTagSize, const_cast<uint8_t*>(tag)) == 1 &&
+            EVP_DecryptFinal_ex(cctx, out.data() + len, &final_len) == 1;
+  EVP_CIPHER_CTX_free(cctx);
+  return ok;
+}
+
+maany_mpc_buf_t View(std::vector<uint8_t>& bytes) {
+  return maany_mpc_buf_t{bytes.data(), bytes.size()};
+}
+
+}  // namespace
+
+int main() {
+  maany_mpc_ctx_t* ctx = maany_mpc_init(nullptr);
+  if (!ctx) {
+    std::fprintf(stderr, "maany_mpc_init failed\n");
+    return 1;
+  }
+
+  maany_mpc_dkg_opts_t opts_device{};
+  opts_device.curve = MAANY_MPC_CURVE_SECP256K1;
+  opts_device.scheme = MAANY_MPC_SCHEME_ECDSA_2P;
+  opts_device.kind = MAANY_MPC_SHARE_DEVICE;
+  opts_device.count = kKeyCount;
+  maany_mpc_dkg_opts_t opts_server = opts_device;
+  opts_server.kind = MAANY_MPC_SHARE_SERVER;
+  maany_mpc_dkg_t* dkg_device = nullptr;
+  maany_mpc_dkg_t* dkg_server = nullptr;
+  AbortOnError(maany_mpc_dkg_new(ctx, &opts_device, &dkg_device), "maany_mpc_dkg_new(device)");
+  AbortOnError(maany_mpc_dkg_new(ctx, &opts_server, &dkg_server), "maany_mpc_dkg_new(server)");
+  if (!RunDkg(ctx, dkg_device, dkg_server)) return 1;
+  std::vector<maany_mpc_keypair_t*> device_kps(kKeyCount, nullptr);
+  std::vector<maany_mpc_keypair_t*> server_kps(kKeyCount, nullptr);
+  AbortOnError(maany_mpc_dkg_finalize_many(ctx, dkg_device, device_kps.data(), device_kps.size()),
+               "maany_mpc_dkg_finalize_many(device)");
+  AbortOnError(maany_mpc_dkg_finalize_many(ctx, dkg_server, server_kps.data(), server_kps.size()),
+               "maany_mpc_dkg_finalize_many(server)");
+  maany_mpc_dkg_free(dkg_device);
+  maany_mpc_dkg_free(dkg_server);
+
+  std::vector<std::vector<uint8_t>> exports(kKeyCount);
+  for (uint32_t i = 0; i < kKeyCount; ++i) {
+    maany_mpc_buf_t blob{nullptr, 0};
+    AbortOnError(maany_mpc_kp_export(ctx, server_kps[i], &blob), "maany_mpc_kp_export");
+    exports[i].assign(blob.data, blob.data + blob.len);
+    maany_mpc_buf_free(ctx, &blob);
+  }
+
+  std::vector<uint8_t> old_kek(32);
+  std::vector<uint8_t> new_kek(32);
+  RAND_bytes(old_kek.data(), static_cast<int>(old_kek.size()));
+  RAND_bytes(new_kek.data(), static_cast<int>(new_kek.size()));
+  maany_mpc_buf_t old_buf = View(old_kek);
+  maany_mpc_buf_t new_buf = View(new_kek);
+
+  // Stored shares as the coordinator writes them, several envelopes per key.
+  std::vector<std::vector<uint8_t>> stored(kEnvelopeCount);
+  std::vector<maany_mpc_buf_t> blobs(kEnvelopeCount);
+  for (size_t i = 0; i < kEnvelopeCount; ++i) {
+    stored[i] = Seal(old_kek, exports[i % kKeyCount]);
+    blobs[i] = View(stored[i]);
+  }
+
+  std::vector<maany_mpc_buf_t> rewrapped(kEnvelopeCount);
+  AbortOnError(maany_mpc_envelope_rewrap_many(ctx, &old_buf, &new_buf, blobs.data(), blobs.size(), rewrapped.data()),
+               "maany_mpc_envelope_rewrap_many");
+
+  std::vector<uint8_t> plaintext;
+  for (size_t i = 0; i < kEnvelopeCount; ++i) {
+    if (!Open(new_kek, rewrapped[i], plaintext) || plaintext != exports[i % kKeyCount]) {
+      std::fprintf(stderr, "Envelope %zu did not round-trip under the new kek\n", i);
+      return 1;
+    }
+    if (Open(old_kek, rewrapped[i], plaintext)) {
+      std::fprintf(stderr, "Envelope %zu still opens under the old kek\n", i);
+      return 1;
+    }
+  }
+  if (std::memcmp(rewrapped[0].data, rewrapped[kKeyCount].data, kNonceSize) == 0) {
+    std::fprintf(stderr, "Rewrapped envelopes share a nonce\n");
+    return 1;
+  }
+  maany_mpc_keypair_t* imported = nullptr;
+  if (!Open(new_kek, rewrapped[0], plaintext)) return 1;
+  maany_mpc_buf_t share_buf = View(plaintext);
+  AbortOnError(maany_mpc_kp_import(ctx, &share_buf, &imported), "maany_mpc_kp_import(rewrapped)");
+  maany_mpc_kp_free(imported);
+  for (auto& buf : rewrapped) maany_mpc_buf_free(ctx, &buf);
+
+  // Wrong old kek: authentication fails and nothing is returned.
+  std::vector<maany_mpc_buf_t> rejected(kEnvelopeCount);
+  if (maany_mpc_envelope_rewrap_many(ctx, &new_buf, &old_buf, blobs.data(), blobs.size(), rejected.data()) ==
+      MAANY_MPC_OK) {
+    std::fprintf(stderr, "Rewrap accepted the wrong kek\n");
+    return 1;
+  }
+
+  // A well-formed envelope around something other than a key blob is refused.
+  std::vector<uint8_t> not_a_share(64, 0xAB);
+  std::vector<uint8_t> foreign = Seal(old_kek, not_a_share);
+  blobs[kEnvelopeCount / 2] = View(foreign);
+  if (maany_mpc_envelope_rewrap_many(ctx, &old_buf, &new_buf, blobs.data(), blobs.size(), rejected.data()) !=
+      MAANY_MPC_ERR_INVALID_ARG) {
+    std::fprintf(stderr, "Rewrap accepted an envelope without a key blob\n");
+    return 1;
+  }
+
+  // Sealed export writes the same layout, so it can be rewrapped and then
+  // imported under the new kek without the share leaving the library.
+  maany_mpc_kek_t* old_handle = nullptr;
+  maany_mpc_kek_t* new_handle = nullptr;
+  AbortOnError(maany_mpc_kek_register(ctx, &old_buf, &old_handle), "maany_mpc_kek_register(old)");
+  AbortOnError(maany_mpc_kek_register(ctx, &new_buf, &new_handle), "maany_mpc_kek_register(new)");
+  maany_mpc_buf_t sealed{nullptr, 0};
+  AbortOnError(maany_mpc_kp_export_sealed(ctx, server_kps[0], old_handle, nullptr, &sealed),
+               "maany_mpc_kp_export_sealed");
+  if (!Open(old_kek, sealed, plaintext) || plaintext != exports[0]) {
+    std::fprintf(stderr, "Sealed export does not open as an envelope\n");
+    return 1;
+  }
+  maany_mpc_buf_t resealed{nullptr, 0};
+  AbortOnError(maany_mpc_envelope_rewrap_many(ctx, &old_buf, &new_buf, &sealed, 1, &resealed),
+               "maany_mpc_envelope_rewrap_many(sealed)");
+  AbortOnError(maany_mpc_kp_import_sealed(ctx, new_handle, nullptr, &resealed, &imported),
+               "maany_mpc_kp_import_sealed");
+  maany_mpc_buf_t reexport{nullptr, 0};
+  AbortOnError(maany_mpc_kp_export(ctx, imported, &reexport), "maany_mpc_kp_export(imported)");
+  const bool same =
+      reexport.len == exports[0].size() && std::memcmp(reexport.data, exports[0].data(), reexport.len) == 0;
+  maany_mpc_buf_free(ctx, &reexport);
+  maany_mpc_kp_free(imported);
+  imported = nullptr;
+  if (!same) {
+    std::fprintf(stderr, "Sealed import returned a different share\n");
+    return 1;
+  }
+
+  // AAD is bound, and a kek only works on the context that registered it.
+  const char aad_text[] = "wallet-1";
+  maany_mpc_buf_t aad{reinterpret_cast<uint8_t*>(const_cast<char*>(aad_text)), sizeof(aad_text) - 1};
+  maany_mpc_buf_t bound{nullptr, 0};
+  AbortOnError(maany_mpc_kp_export_sealed(ctx, server_kps[1], old_handle, &aad, &bound),
+               "maany_mpc_kp_export_sealed(aad)");
+  if (maany_mpc_kp_import_sealed(ctx, old_handle, nullptr, &bound, &imported) == MAANY_MPC_OK) {
+    std::fprintf(stderr, "Sealed import ignored the AAD\n");
+    return 1;
+  }
+  AbortOnError(maany_mpc_kp_import_sealed(ctx, old_handle, &aad, &bound, &imported), "maany_mpc_kp_import_sealed(aad)");
+  maany_mpc_kp_free(imported);
+  maany_mpc_ctx_t* other = maany_mpc_init(nullptr);
+  if (!other || maany_mpc_kp_export_sealed(other, server_kps[1], old_handle, nullptr, &sealed) !=
+                    MAANY_MPC_ERR_INVALID_ARG) {
+    std::fprintf(stderr, "Kek was accepted by another context\n");
+    return 1;
+  }
+  maany_mpc_shutdown(other);
+  maany_mpc_buf_free(ctx, &bound);
+  maany_mpc_buf_free(ctx, &resealed);
+  maany_mpc_buf_free(ctx, &sealed);
+  maany_mpc_kek_free(old_handle);
+  maany_mpc_kek_free(new_handle);
+
+  for (uint32_t i = 0; i < kKeyCount; ++i) {
+    maany_mpc_kp_free(device_kps[i]);
+    maany_mpc_kp_free(server_kps[i]);
+  }
+  maany_mpc_shutdown(ctx);
+  return 0;
+}
@@ -0,0 +1,165 @@
+#include "maany_mpc.h"
+#include "test_util.h"
+
+#include <cstdio>
+#include <string>
+#include <vector>
+
+namespace {
+
+using maany::test::AbortOnError;
+using maany::test::RunDkg;
+using maany::test::RunSign;
+
+// Every counter below is checked against this many two-party signs, so the
+// test runs no other sign sessions.
+constexpr uint64_t kSignCount = 3;
+
+std::vector<std::string> g_log;
+
+void CaptureLog(maany_mpc_log_level_t, const char* msg) {
+  g_log.emplace_back(msg);
+}
+
+bool Logged(const char* needle) {
+  for (const auto& line : g_log) {
+    if (line.find(needle) != std::string::npos) return true;
+  }
+  return false;
+}
+
+bool Sign(maany_mpc_ctx_t* ctx, maany_mpc_keypair_t* device, maany_mpc_keypair_t* server) {
+  maany_mpc_sign_opts_t opts{};
+  opts.scheme = MAANY_MPC_SCHEME_ECDSA_2P;
+  const std::vector<uint8_t> message(32, 0x42);
+  maany_mpc_sign_t* sign_device = nullptr;
+  maany_mpc_sign_t* sign_server = nullptr;
+  AbortOnError(maany_mpc_sign_new(ctx, device, &opts, &sign_device), "maany_mpc_sign_new(device)");
+  AbortOnError(maany_mpc_sign_new(ctx, server, &opts, &sign_server), "maany_mpc_sign_new(server)");
+  AbortOnError(maany_mpc_sign_set_message(ctx, sign_device, message.data(), message.size()),
+               "maany_mpc_sign_set_message(device)");
+  AbortOnError(maany_mpc_sign_set_message(ctx, sign_server, message.data(), message.size()),
+               "maany_mpc_sign_set_message(server)");
+  const bool ok = RunSign(ctx, sign_device, sign_server);
+  if (ok) {
+    maany_mpc_buf_t sig{nullptr, 0};
+    AbortOnError(maany_mpc_sign_finalize(ctx, sign_device, MAANY_MPC_SIG_FORMAT_DER, &sig), "maany_mpc_sign_finalize");
+    maany_mpc_buf_free(ctx, &sig);
+  }
+  maany_mpc_sign_free(sign_device);
+  maany_mpc_sign_free(sign_server);
+  return ok;
+}
+
+}  // namespace
+
+int main() {
+  maany_mpc_init_opts_t init_opts{};
+  init_opts.logger = CaptureLog;
+  init_opts.log_level = MAANY_MPC_LOG_DEBUG;
+  maany_mpc_ctx_t* ctx = maany_mpc_init(&init_opts);
+  if (!ctx) {
+    std::fprintf(stderr, "maany_mpc_init failed\n");
+    return 1;
+  }
+
+  maany_mpc_dkg_opts_t opts_device{};
+  opts_device.curve = MAANY_MPC_CURVE_SECP256K1;
+  opts_device.scheme = MAANY_MPC_SCHEME_ECDSA_2P;
+  opts_device.kind = MAANY_MPC_SHARE_DEVICE;
+  maany_mpc_dkg_opts_t opts_server = opts_device;
+  opts_server.kind = MAANY_MPC_SHARE_SERVER;
+  maany_mpc_dkg_t* dkg_device = nullptr;
+  maany_mpc_dkg_t* dkg_server = nullptr;
+  AbortOnError(maany_mpc_dkg_new(ctx, &opts_device, &dkg_device), "maany_mpc_dkg_new(device)");
+  AbortOnError(maany_mpc_dkg_new(ctx, &opts_server, &dkg_server), "maany_mpc_dkg_new(server)");
+  if (!RunDkg(ctx, dkg_device, dkg_server)) return 1;
+  maany_mpc_keypair_t* device = nullptr;
+  maany_mpc_keypair_t* server = nullptr;
+  AbortOnError(maany_mpc_dkg_finalize(ctx, dkg_device, &device), "maany_mpc_dkg_finalize(device)");
+  AbortOnError(maany_mpc_dkg_finalize(ctx, dkg_server, &server), "maany_mpc_dkg_finalize(server)");
+  maany_mpc_dkg_free(dkg_device);
+  maany_mpc_dkg_free(dkg_server);
+
+  maany_mpc_trace_enable(1);
+  // Unsupported in most containers; the signs then run uncounted.
+  const bool perf_enabled = maany_mpc_perf_enable(1) == MAANY_MPC_OK;
+  for (uint64_t i = 0; i < kSignCount; ++i) {
+    if (!Sign(ctx, device, server)) return 1;
+  }
+  maany_mpc_trace_enable(0);
+
+  // Session timeline.
+  maany_mpc_buf_t trace_buf{};
+  AbortOnError(maany_mpc_trace_dump(ctx, &trace_buf), "maany_mpc_trace_dump");
+  const std::string trace(reinterpret_cast<const char*>(trace_buf.data), trace_buf.len);
+  maany_mpc_buf_free(ctx, &trace_buf);
+  for (const char* name : {"\"session_create\"", "\"sign\"", "\"ecdsa2pc::sign\"", "\"wait_peer\"", "\"send\"",
+                           "\"receive\"", "\"step\"", "\"finalize\""}) {
+    if (trace.find(name) == std::string::npos) {
+      std::fprintf(stderr, "Trace is missing %s events\n", name);
+      return 1;
+    }
+  }
+
+  // Session metrics: both sides of every sign ran to completion and are freed.
+  maany_mpc_stats_t stats{};
+  AbortOnError(maany_mpc_stats_snapshot(ctx, &stats), "maany_mpc_stats_snapshot");
+  const maany_mpc_session_stats_t& sign_stats = stats.sessions[MAANY_MPC_SESSION_SIGN];
+  uint64_t hist_total = 0;
+  for (uint64_t n : sign_stats.step_hist) hist_total += n;
+  if (sign_stats.started != 2 * kSignCount || sign_stats.completed != 2 * kSignCount || sign_stats.failed != 0 ||
+      sign_stats.steps == 0 || hist_total != sign_stats.steps || sign_stats.bytes_out == 0 ||
+      stats.worker_threads == 0) {
+    std::fprintf(stderr, "Unexpected sign stats\n");
+    return 1;
+  }
+  for (const auto& session_stats : stats.sessions) {
+    if (session_stats.live != 0) {
+      std::fprintf(stderr, "Session still counted live after free\n");
+      return 1;
+    }
+  }
+
+  // Structured log events.
+  for (const char* needle : {"event=context_init", "event=session_start session=", "event=step session=",
+                             "type=sign round=", "event=session_done", "dur_us="}) {
+    if (!Logged(needle)) {
+      std::fprintf(stderr, "Log is missing %s\n", needle);
+      return 1;
+    }
+  }
+  maany_mpc_log_config_t log_config{};
+  log_config.level = MAANY_MPC_LOG_WARN;
+  AbortOnError(maany_mpc_log_configure(ctx, &log_config), "maany_mpc_log_configure");
+
+  // Only built in with MAANY_MPC_PROFILE_PRIMITIVES.
+  maany_mpc_primitive_profile_t profile{};
+  const maany_mpc_error_t profile_rc = maany_mpc_primitive_profile(&profile);
+  if (profile_rc == MAANY_MPC_OK) {
+    const auto& sign_row = profile.by_session[MAANY_MPC_SESSION_SIGN];
+    if (sign_row[MAANY_MPC_PRIM_CBMPC_2P_SIGN].calls != 2 * kSignCount ||
+        sign_row[MAANY_MPC_PRIM_CBMPC_2P_SIGN].wall_ns == 0) {
+      std::fprintf(stderr, "Unexpected sign primitive profile\n");
+      return 1;
+    }
+  } else if (profile_rc != MAANY_MPC_ERR_UNSUPPORTED) {
+    std::fprintf(stderr, "maany_mpc_primitive_profile failed\n");
+    return 1;
+  }
+
+  // Workers have all been joined, so every sign session has been read.
+  maany_mpc_perf_stats_t perf{};
+  AbortOnError(maany_mpc_perf_snapshot(&perf), "maany_mpc_perf_snapshot");
+  if (perf_enabled && (perf.by_session[MAANY_MPC_SESSION_SIGN].sessions == 0 ||
+                       perf.by_session[MAANY_MPC_SESSION_SIGN].values[MAANY_MPC_PERF_CYCLES] == 0)) {
+    std::fprintf(stderr, "Unexpected sign hardware counters\n");
+    return 1;
+  }
+  maany_mpc_perf_enable(0);
+
+  maany_mpc_kp_free(device);
+  maany_mpc_kp_free(server);
+  maany_mpc_shutdown(ctx);
+  return 0;
+}
@@ -0,0 +1,227 @@
+#include "maany_mpc.h"
+#include "test_util.h"
+
+#include <cbmpc/crypto/base.h>
+#include <atomic>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+namespace {
+
+using maany::test::AbortOnError;
+using maany::test::RunDkg;
+using maany::test::RunSign;
+using maany::test::SamePubKey;
+
+constexpr int kRefreshIterations = 3;
+constexpr uint32_t kBatchKeys = 3;
+
+std::atomic<uint64_t> g_rng_calls{0};
+
+// Context RNG; counts calls so the test can see which paths draw from it.
+int CountingRng(uint8_t* out, size_t len) {
+  static thread_local std::random_device device;
+  g_rng_calls.fetch_add(1, std::memory_order_relaxed);
+  for (size_t i = 0; i < len; ++i) out[i] = static_cast<uint8_t>(device());
+  return 0;
+}
+
+struct KeyPair {
+  maany_mpc_keypair_t* device{nullptr};
+  maany_mpc_keypair_t* server{nullptr};
+};
+
+// Signs a fixed message with the pair and verifies it against `pub`.
+bool SignAndVerify(maany_mpc_ctx_t* ctx, const KeyPair& kp, const maany_mpc_pubkey_t& pub, const char* label) {
+  std::vector<uint8_t> message(32);
+  for (size_t i = 0; i < message.size(); ++i) message[i] = static_cast<uint8_t>(0x10 + i);
+
+  maany_mpc_sign_opts_t sign_opts{};
+  sign_opts.scheme = MAANY_MPC_SCHEME_ECDSA_2P;
+  maany_mpc_sign_t* sign_device = nullptr;
+  maany_mpc_sign_t* sign_server = nullptr;
+  AbortOnError(maany_mpc_sign_new(ctx, kp.device, &sign_opts, &sign_device), "maany_mpc_sign_new(device)");
+  AbortOnError(maany_mpc_sign_new(ctx, kp.server, &sign_opts, &sign_server), "maany_mpc_sign_new(server)");
+  AbortOnError(maany_mpc_sign_set_message(ctx, sign_device, message.data(), message.size()),
+               "maany_mpc_sign_set_message(device)");
+  AbortOnError(maany_mpc_sign_set_message(ctx, sign_server, message.data(), message.size()),
+               "maany_mpc_sign_set_message(server)");
+  if (!RunSign(ctx, sign_device, sign_server)) return false;
+
+  maany_mpc_buf_t sig_der{};
+  AbortOnError(maany_mpc_sign_finalize(ctx, sign_device, MAANY_MPC_SIG_FORMAT_DER, &sig_der),
+               "maany_mpc_sign_finalize(device)");
+  maany_mpc_sign_free(sign_device);
+  maany_mpc_sign_free(sign_server);
+
+  coinbase::crypto::ecc_point_t pub_point;
+  if (pub_point.from_bin(coinbase::crypto::curve_secp256k1,
+                         coinbase::mem_t(pub.pubkey.data, static_cast<int>(pub.pubkey.len)))) {
+    std::fprintf(stderr, "%s: failed to decode public key\n", label);
+    return false;
+  }
+  coinbase::crypto::ecc_pub_key_t pub_key(pub_point);
+  const bool ok = pub_key.verify(coinbase::mem_t(message.data(), static_cast<int>(message.size())),
+                                 coinbase::mem_t(sig_der.data, static_cast<int>(sig_der.len))) == 0;
+  maany_mpc_buf_free(ctx, &sig_der);
+  if (!ok) std::fprintf(stderr, "%s: signature verification failed\n", label);
+  return ok;
+}
+
+// Refreshes `kp` in place, replacing both handles, and checks the public key is kept.
+bool Refresh(maany_mpc_ctx_t* ctx, KeyPair& kp, const maany_mpc_refresh_opts_t& opts, const maany_mpc_pubkey_t& pub) {
+  maany_mpc_dkg_t* device = nullptr;
+  maany_mpc_dkg_t* server = nullptr;
+  AbortOnError(maany_mpc_refresh_new(ctx, kp.device, &opts, &device), "maany_mpc_refresh_new(device)");
+  AbortOnError(maany_mpc_refresh_new(ctx, kp.server, &opts, &server), "maany_mpc_refresh_new(server)");
+  if (!RunDkg(ctx, device, server, "Refresh")) return false;
+
+  KeyPair refreshed;
+  AbortOnError(maany_mpc_dkg_finalize(ctx, device, &refreshed.device), "maany_mpc_dkg_finalize(refresh device)");
+  AbortOnError(maany_mpc_dkg_finalize(ctx, server, &refreshed.server), "maany_mpc_dkg_finalize(refresh server)");
+  maany_mpc_dkg_free(device);
+  maany_mpc_dkg_free(server);
+  maany_mpc_kp_free(kp.device);
+  maany_mpc_kp_free(kp.server);
+  kp = refreshed;
+
+  maany_mpc_pubkey_t refreshed_pub{};
+  AbortOnError(maany_mpc_kp_pubkey(ctx, kp.device, &refreshed_pub), "maany_mpc_kp_pubkey(refreshed)");
+  const bool same = SamePubKey(pub, refreshed_pub);
+  maany_mpc_buf_free(ctx, &refreshed_pub.pubkey);
+  if (!same) std::fprintf(stderr, "Refresh changed the public key\n");
+  return same;
+}
+
+}  // namespace
+
+int main() {
+  maany_mpc_init_opts_t init_opts{};
+  init_opts.rng = CountingRng;
+  maany_mpc_ctx_t* ctx = maany_mpc_init(&init_opts);
+  if (!ctx) {
+    std::fprintf(stderr, "maany_mpc_init failed\n");
+    return 1;
+  }
+
+  maany_mpc_dkg_opts_t opts_device{};
+  opts_device.curve = MAANY_MPC_CURVE_SECP256K1;
+  opts_device.scheme = MAANY_MPC_SCHEME_ECDSA_2P;
+  opts_device.kind = MAANY_MPC_SHARE_DEVICE;
+  maany_mpc_dkg_opts_t opts_server = opts_device;
+  opts_server.kind = MAANY_MPC_SHARE_SERVER;
+
+  maany_mpc_dkg_t* dkg_device = nullptr;
+  maany_mpc_dkg_t* dkg_server = nullptr;
+  AbortOnError(maany_mpc_dkg_new(ctx, &opts_device, &dkg_device), "maany_mpc_dkg_new(device)");
+  AbortOnError(maany_mpc_dkg_new(ctx, &opts_server, &dkg_server), "maany_mpc_dkg_new(server)");
+  if (!RunDkg(ctx, dkg_device, dkg_server, "DKG")) return 1;
+  KeyPair kp;
+  AbortOnError(maany_mpc_dkg_finalize(ctx, dkg_device, &kp.device), "maany_mpc_dkg_finalize(device)");
+  AbortOnError(maany_mpc_dkg_finalize(ctx, dkg_server, &kp.server), "maany_mpc_dkg_finalize(server)");
+  maany_mpc_dkg_free(dkg_device);
+  maany_mpc_dkg_free(dkg_server);
+
+  maany_mpc_pubkey_t pub{};
+  AbortOnError(maany_mpc_kp_pubkey(ctx, kp.device, &pub), "maany_mpc_kp_pubkey(device)");
+
+  maany_mpc_refresh_opts_t full_opts{};
+  for (int i = 0; i < kRefreshIterations; ++i) {
+    if (!Refresh(ctx, kp, full_opts, pub)) return 1;
+  }
+  if (!SignAndVerify(ctx, kp, pub, "full refresh")) return 1;
+
+  maany_mpc_refresh_opts_t light_opts{};
+  light_opts.reuse_paillier = 1;
+  const uint64_t rng_calls = g_rng_calls.load();
+  for (int i = 0; i < kRefreshIterations; ++i) {
+    if (!Refresh(ctx, kp, light_opts, pub)) return 1;
+  }
+  if (!SignAndVerify(ctx, kp, pub, "lightweight refresh")) return 1;
+  // Both coin-toss contributions and the commitment salt, per refresh.
+  if (g_rng_calls.load() - rng_calls < 3 * kRefreshIterations) {
+    std::fprintf(stderr, "Lightweight refresh bypassed the context rng\n");
+    return 1;
+  }
+
+  // Lightweight-refreshed shares must survive export/import like any other share.
+  maany_mpc_buf_t exported{nullptr, 0};
+  AbortOnError(maany_mpc_kp_export(ctx, kp.device, &exported), "maany_mpc_kp_export(device)");
+  maany_mpc_kp_free(kp.device);
+  kp.device = nullptr;
+  AbortOnError(maany_mpc_kp_import(ctx, &exported, &kp.device), "maany_mpc_kp_import(device)");
+  maany_mpc_buf_free(ctx, &exported);
+  if (!SignAndVerify(ctx, kp, pub, "lightweight refresh after import")) return 1;
+
+  // A full refresh takes the lightweight-refreshed device share as its input,
+  // so that share must still be in range for cb-mpc.
+  if (!Refresh(ctx, kp, full_opts, pub)) return 1;
+  if (!SignAndVerify(ctx, kp, pub, "full refresh after lightweight")) return 1;
+  if (!Refresh(ctx, kp, light_opts, pub)) return 1;
+  if (!SignAndVerify(ctx, kp, pub, "lightweight after full refresh")) return 1;
+
+  // Batch refresh: kBatchKeys keys from one batch DKG, refreshed in one session.
+  maany_mpc_dkg_opts_t batch_device_opts = opts_device;
+  batch_device_opts.count = kBatchKeys;
+  maany_mpc_dkg_opts_t batch_server_opts = opts_server;
+  batch_server_opts.count = kBatchKeys;
+  AbortOnError(maany_mpc_dkg_new(ctx, &batch_device_opts, &dkg_device), "maany_mpc_dkg_new(batch device)");
+  AbortOnError(maany_mpc_dkg_new(ctx, &batch_server_opts, &dkg_server), "maany_mpc_dkg_new(batch server)");
+  if (!RunDkg(ctx, dkg_device, dkg_server, "Batch DKG")) return 1;
+  std::vector<maany_mpc_keypair_t*> batch_device(kBatchKeys, nullptr);
+  std::vector<maany_mpc_keypair_t*> batch_server(kBatchKeys, nullptr);
+  AbortOnError(maany_mpc_dkg_finalize_many(ctx, dkg_device, batch_device.data(), kBatchKeys),
+               "maany_mpc_dkg_finalize_many(device)");
+  AbortOnError(maany_mpc_dkg_finalize_many(ctx, dkg_server, batch_server.data(), kBatchKeys),
+               "maany_mpc_dkg_finalize_many(server)");
+  maany_mpc_dkg_free(dkg_device);
+  maany_mpc_dkg_free(dkg_server);
+
+  std::vector<maany_mpc_pubkey_t> batch_pubs(kBatchKeys);
+  for (uint32_t i = 0; i < kBatchKeys; ++i)
+    AbortOnError(maany_mpc_kp_pubkey(ctx, batch_device[i], &batch_pubs[i]), "maany_mpc_kp_pubkey(batch)");
+
+  maany_mpc_dkg_t* refresh_device = nullptr;
+  maany_mpc_dkg_t* refresh_server = nullptr;
+  AbortOnError(maany_mpc_refresh_new_many(ctx, batch_device.data(), kBatchKeys, &light_opts, &refresh_device),
+               "maany_mpc_refresh_new_many(device)");
+  AbortOnError(maany_mpc_refresh_new_many(ctx, batch_server.data(), kBatchKeys, &light_opts, &refresh_server),
+               "maany_mpc_refresh_new_many(server)");
+  if (!RunDkg(ctx, refresh_device, refresh_server, "Batch refresh")) return 1;
+  std::vector<maany_mpc_keypair_t*> refreshed_device(kBatchKeys, nullptr);
+  std::vector<maany_mpc_keypair_t*> refreshed_server(kBatchKeys, nullptr);
+  AbortOnError(maany_mpc_dkg_finalize_many(ctx, refresh_device, refreshed_device.data(), kBatchKeys),
+               "maany_mpc_dkg_finalize_many(refresh device)");
+  AbortOnError(maany_mpc_dkg_finalize_many(ctx, refresh_server, refreshed_server.data(), kBatchKeys),
+               "maany_mpc_dkg_finalize_many(refresh server)");
+  maany_mpc_dkg_free(refresh_device);
+  maany_mpc_dkg_free(refresh_server);
+
+  for (uint32_t i = 0; i < kBatchKeys; ++i) {
+    maany_mpc_pubkey_t refreshed_pub{};
+    AbortOnError(maany_mpc_kp_pubkey(ctx, refreshed_server[i], &refreshed_pub), "maany_mpc_kp_pubkey(refreshed)");
+    const bool same = SamePubKey(batch_pubs[i], refreshed_pub);
+    maany_mpc_buf_free(ctx, &refreshed_pub.pubkey);
+    if (!same) {
+      std::fprintf(stderr, "Batch refresh changed public key %u\n", i);
+      return 1;
+    }
+    maany_mpc_kp_free(batch_device[i]);
+    maany_mpc_kp_free(batch_server[i]);
+  }
+  KeyPair last{refreshed_device[kBatchKeys - 1], refreshed_server[kBatchKeys - 1]};
+  if (!SignAndVerify(ctx, last, batch_pubs[kBatchKeys - 1], "batch refresh")) return 1;
+
+  for (uint32_t i = 0; i < kBatchKeys; ++i) {
+    maany_mpc_buf_free(ctx, &batch_pubs[i].pubkey);
+    maany_mpc_kp_free(refreshed_device[i]);
+    maany_mpc_kp_free(refreshed_server[i]);
+  }
+
+  maany_mpc_buf_free(ctx, &pub.pubkey);
+  maany_mpc_kp_free(kp.device);
+  maany_mpc_kp_free(kp.server);
+  maany_mpc_shutdown(ctx);
+  return 0;
+}
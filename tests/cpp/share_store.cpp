@@ -0,0 +1,212 @@
+#include "maany_mpc.h"
+#include "test_util.h"
+
+#include <fcntl.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+namespace {
+
+using maany::test::AbortOnError;
+using maany::test::RunDkg;
+
+constexpr uint32_t kKeyCount = 2;
+
+std::vector<uint8_t> Export(maany_mpc_ctx_t* ctx, const maany_mpc_keypair_t* kp) {
+  maany_mpc_buf_t blob{nullptr, 0};
+  AbortOnError(maany_mpc_kp_export(ctx, kp, &blob), "maany_mpc_kp_export");
+  std::vector<uint8_t> out(blob.data, blob.data + blob.len);
+  maany_mpc_buf_free(ctx, &blob);
+  return out;
+}
+
+// Returns the share's export, or an empty vector on a miss.
+std::vector<uint8_t> Lookup(maany_mpc_ctx_t* ctx, maany_mpc_store_t* store, const maany_mpc_key_id_t& id) {
+  maany_mpc_keypair_t* kp = nullptr;
+  AbortOnError(maany_mpc_store_get(ctx, store, &id, &kp), "maany_mpc_store_get");
+  if (!kp) return {};
+  auto out = Export(ctx, kp);
+  maany_mpc_kp_free(kp);
+  return out;
+}
+
+maany_mpc_store_stats_t Stats(maany_mpc_ctx_t* ctx, maany_mpc_store_t* store) {
+  maany_mpc_store_stats_t stats{};
+  AbortOnError(maany_mpc_store_stats(ctx, store, &stats), "maany_mpc_store_stats");
+  return stats;
+}
+
+}  // namespace
+
+int main() {
+  maany_mpc_ctx_t* ctx = maany_mpc_init(nullptr);
+  if (!ctx) {
+    std::fprintf(stderr, "maany_mpc_init failed\n");
+    return 1;
+  }
+
+  std::vector<maany_mpc_keypair_t*> device_kps(kKeyCount, nullptr);
+  std::vector<maany_mpc_keypair_t*> server_kps(kKeyCount, nullptr);
+  std::vector<maany_mpc_key_id_t> ids(kKeyCount);
+  for (uint32_t i = 0; i < kKeyCount; ++i) {
+    std::memset(ids[i].bytes, static_cast<int>(0xA0 + i), sizeof(ids[i].bytes));
+    maany_mpc_dkg_opts_t opts_device{};
+    opts_device.curve = MAANY_MPC_CURVE_SECP256K1;
+    opts_device.scheme = MAANY_MPC_SCHEME_ECDSA_2P;
+    opts_device.kind = MAANY_MPC_SHARE_DEVICE;
+    opts_device.key_id_hint = ids[i];
+    maany_mpc_dkg_opts_t opts_server = opts_device;
+    opts_server.kind = MAANY_MPC_SHARE_SERVER;
+    maany_mpc_dkg_t* dkg_device = nullptr;
+    maany_mpc_dkg_t* dkg_server = nullptr;
+    AbortOnError(maany_mpc_dkg_new(ctx, &opts_device, &dkg_device), "maany_mpc_dkg_new(device)");
+    AbortOnError(maany_mpc_dkg_new(ctx, &opts_server, &dkg_server), "maany_mpc_dkg_new(server)");
+    if (!RunDkg(ctx, dkg_device, dkg_server)) return 1;
+    AbortOnError(maany_mpc_dkg_finalize(ctx, dkg_device, &device_kps[i]), "maany_mpc_dkg_finalize(device)");
+    AbortOnError(maany_mpc_dkg_finalize(ctx, dkg_server, &server_kps[i]), "maany_mpc_dkg_finalize(server)");
+    maany_mpc_dkg_free(dkg_device);
+    maany_mpc_dkg_free(dkg_server);
+  }
+  std::vector<std::vector<uint8_t>> exports(kKeyCount);
+  for (uint32_t i = 0; i < kKeyCount; ++i) exports[i] = Export(ctx, server_kps[i]);
+
+  char dir_template[] = "/tmp/maany_store_XXXXXX";
+  if (!mkdtemp(dir_template)) {
+    std::fprintf(stderr, "mkdtemp failed\n");
+    return 1;
+  }
+  const std::string path = std::string(dir_template) + "/shares";
+
+  std::vector<uint8_t> kek_bytes(32, 0x42);
+  maany_mpc_buf_t kek_buf{kek_bytes.data(), kek_bytes.size()};
+  maany_mpc_kek_t* kek = nullptr;
+  AbortOnError(maany_mpc_kek_register(ctx, &kek_buf, &kek), "maany_mpc_kek_register");
+
+  maany_mpc_store_t* store = nullptr;
+  AbortOnError(maany_mpc_store_open(ctx, path.c_str(), kek, nullptr, &store), "maany_mpc_store_open");
+  // The store holds its own reference to the KEK.
+  maany_mpc_kek_free(kek);
+  for (uint32_t i = 0; i < kKeyCount; ++i)
+    AbortOnError(maany_mpc_store_put(ctx, store, server_kps[i]), "maany_mpc_store_put");
+  for (uint32_t i = 0; i < kKeyCount; ++i) {
+    if (Lookup(ctx, store, ids[i]) != exports[i]) {
+      std::fprintf(stderr, "Stored share %u does not round-trip\n", i);
+      return 1;
+    }
+  }
+
+  // A derived child has its own key_id and lives next to its parent.
+  maany_mpc_chain_code_t chain_code{};
+  std::memset(chain_code.bytes, 0x33, sizeof(chain_code.bytes));
+  const uint32_t child_indices[] = {0, 7};
+  maany_mpc_bip32_path_t child_path{child_indices, 2};
+  maany_mpc_keypair_t* child = nullptr;
+  AbortOnError(maany_mpc_kp_derive_child(ctx, server_kps[0], &chain_code, &child_path, &child),
+               "maany_mpc_kp_derive_child");
+  maany_mpc_kp_meta_t child_meta{};
+  AbortOnError(maany_mpc_kp_meta(ctx, child, &child_meta), "maany_mpc_kp_meta(child)");
+  if (std::memcmp(child_meta.key_id.bytes, ids[0].bytes, sizeof(ids[0].bytes)) == 0) {
+    std::fprintf(stderr, "Child share kept the parent's key_id\n");
+    return 1;
+  }
+  const auto child_export = Export(ctx, child);
+  AbortOnError(maany_mpc_store_put(ctx, store, child), "maany_mpc_store_put(child)");
+  if (Lookup(ctx, store, child_meta.key_id) != child_export || Lookup(ctx, store, ids[0]) != exports[0]) {
+    std::fprintf(stderr, "Parent and child shares do not both round-trip\n");
+    return 1;
+  }
+  AbortOnError(maany_mpc_store_remove(ctx, store, &child_meta.key_id, nullptr), "maany_mpc_store_remove(child)");
+  maany_mpc_kp_free(child);
+
+  maany_mpc_key_id_t missing{};
+  std::memset(missing.bytes, 0x5A, sizeof(missing.bytes));
+  if (!Lookup(ctx, store, missing).empty()) {
+    std::fprintf(stderr, "Lookup of an unknown key_id returned a share\n");
+    return 1;
+  }
+
+  // Overwrite one share, remove the other; both leave dead records behind.
+  AbortOnError(maany_mpc_store_put(ctx, store, server_kps[0]), "maany_mpc_store_put(overwrite)");
+  uint32_t removed = 0;
+  AbortOnError(maany_mpc_store_remove(ctx, store, &ids[1], &removed), "maany_mpc_store_remove");
+  if (removed != 1) {
+    std::fprintf(stderr, "Remove did not report the share\n");
+    return 1;
+  }
+  AbortOnError(maany_mpc_store_remove(ctx, store, &ids[1], &removed), "maany_mpc_store_remove(again)");
+  if (removed != 0) {
+    std::fprintf(stderr, "Second remove reported a share\n");
+    return 1;
+  }
+  maany_mpc_store_close(store);
+
+  // A torn append at the tail is dropped on reopen.
+  int fd = ::open(path.c_str(), O_WRONLY | O_APPEND);
+  const char torn[] = "MPCR partial record";
+  if (fd < 0 || ::write(fd, torn, sizeof(torn)) != static_cast<ssize_t>(sizeof(torn))) {
+    std::fprintf(stderr, "Could not append a torn record\n");
+    return 1;
+  }
+  ::close(fd);
+
+  AbortOnError(maany_mpc_kek_register(ctx, &kek_buf, &kek), "maany_mpc_kek_register(reopen)");
+  AbortOnError(maany_mpc_store_open(ctx, path.c_str(), kek, nullptr, &store), "maany_mpc_store_open(reopen)");
+  if (Lookup(ctx, store, ids[0]) != exports[0] || !Lookup(ctx, store, ids[1]).empty()) {
+    std::fprintf(stderr, "Store contents changed across reopen\n");
+    return 1;
+  }
+  auto before = Stats(ctx, store);
+  AbortOnError(maany_mpc_store_compact(ctx, store), "maany_mpc_store_compact");
+  auto after = Stats(ctx, store);
+  if (after.live_records != 1 || before.live_records != 1 || after.file_bytes >= before.file_bytes ||
+      after.live_bytes != before.live_bytes) {
+    std::fprintf(stderr, "Compaction stats unexpected\n");
+    return 1;
+  }
+  // The compacted log is still locked against a second handle.
+  maany_mpc_store_t* second = nullptr;
+  if (maany_mpc_store_open(ctx, path.c_str(), kek, nullptr, &second) != MAANY_MPC_ERR_IO || second) {
+    std::fprintf(stderr, "A second handle opened a store that is in use\n");
+    return 1;
+  }
+  maany_mpc_store_close(store);
+
+  // With the index gone the store rebuilds it from the compacted log.
+  ::unlink((path + ".idx").c_str());
+  AbortOnError(maany_mpc_store_open(ctx, path.c_str(), kek, nullptr, &store), "maany_mpc_store_open(rebuild)");
+  if (Lookup(ctx, store, ids[0]) != exports[0] || Stats(ctx, store).live_records != 1) {
+    std::fprintf(stderr, "Index rebuild lost a share\n");
+    return 1;
+  }
+  maany_mpc_store_close(store);
+  maany_mpc_kek_free(kek);
+
+  // Records are sealed under the store's KEK.
+  std::vector<uint8_t> wrong_bytes(32, 0x17);
+  maany_mpc_buf_t wrong_buf{wrong_bytes.data(), wrong_bytes.size()};
+  maany_mpc_kek_t* wrong = nullptr;
+  AbortOnError(maany_mpc_kek_register(ctx, &wrong_buf, &wrong), "maany_mpc_kek_register(wrong)");
+  AbortOnError(maany_mpc_store_open(ctx, path.c_str(), wrong, nullptr, &store), "maany_mpc_store_open(wrong)");
+  maany_mpc_keypair_t* kp = nullptr;
+  if (maany_mpc_store_get(ctx, store, &ids[0], &kp) == MAANY_MPC_OK) {
+    std::fprintf(stderr, "Store opened a share under the wrong KEK\n");
+    return 1;
+  }
+  maany_mpc_store_close(store);
+  maany_mpc_kek_free(wrong);
+
+  ::unlink(path.c_str());
+  ::unlink((path + ".idx").c_str());
+  ::rmdir(dir_template);
+  for (uint32_t i = 0; i < kKeyCount; ++i) {
+    maany_mpc_kp_free(device_kps[i]);
+    maany_mpc_kp_free(server_kps[i]);
+  }
+  maany_mpc_shutdown(ctx);
+  return 0;
+}
@@ -0,0 +1,92 @@
+#pragma once
+
+// Fixtures shared by the C API tests. Header-only so each test stays one
+// translation unit. Tests check behaviour only; timing lives in bench/.
+
+#include "maany_mpc.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+namespace maany::test {
+
+inline void AbortOnError(maany_mpc_error_t err, const char* where) {
+  if (err == MAANY_MPC_OK) return;
+  std::fprintf(stderr, "%s failed: %s (%d)\n", where, maany_mpc_error_string(err), static_cast<int>(err));
+  std::exit(1);
+}
+
+struct PendingMsg {
+  maany_mpc_buf_t buf{nullptr, 0};
+
+  void Reset(maany_mpc_ctx_t* ctx) {
+    if (!buf.data) return;
+    maany_mpc_buf_free(ctx, &buf);
+    buf.data = nullptr;
+    buf.len = 0;
+  }
+};
+
+// Alternates device and server steps until both report DONE, handing each
+// outbound frame to the other side. `step_fn` is maany_mpc_dkg_step (DKG,
+// refresh, Paillier setup, batches) or maany_mpc_sign_step. `rounds`, if set,
+// receives the number of device/server step pairs.
+template <typename Session, typename StepFn>
+bool RunPair(maany_mpc_ctx_t* ctx, Session* device, Session* server, StepFn step_fn, const char* label,
+             int* rounds = nullptr) {
+  PendingMsg inbound_device;
+  PendingMsg inbound_server;
+  bool device_done = false;
+  bool server_done = false;
+  int guard = 0;
+  while (!(device_done && server_done)) {
+    if (++guard > 64) {
+      std::fprintf(stderr, "%s loop guard triggered\n", label);
+      return false;
+    }
+    if (!device_done) {
+      maany_mpc_buf_t outbound{nullptr, 0};
+      maany_mpc_step_result_t step{};
+      AbortOnError(step_fn(ctx, device, inbound_device.buf.data ? &inbound_device.buf : nullptr, &outbound, &step),
+                   label);
+      inbound_device.Reset(ctx);
+      if (outbound.data) {
+        inbound_server.Reset(ctx);
+        inbound_server.buf = outbound;
+      }
+      device_done = (step == MAANY_MPC_STEP_DONE);
+    }
+    if (!server_done) {
+      maany_mpc_buf_t outbound{nullptr, 0};
+      maany_mpc_step_result_t step{};
+      AbortOnError(step_fn(ctx, server, inbound_server.buf.data ? &inbound_server.buf : nullptr, &outbound, &step),
+                   label);
+      inbound_server.Reset(ctx);
+      if (outbound.data) {
+        inbound_device.Reset(ctx);
+        inbound_device.buf = outbound;
+      }
+      server_done = (step == MAANY_MPC_STEP_DONE);
+    }
+  }
+  inbound_device.Reset(ctx);
+  inbound_server.Reset(ctx);
+  if (rounds) *rounds = guard;
+  return true;
+}
+
+inline bool RunDkg(maany_mpc_ctx_t* ctx, maany_mpc_dkg_t* device, maany_mpc_dkg_t* server,
+                   const char* label = "maany_mpc_dkg_step", int* rounds = nullptr) {
+  return RunPair(ctx, device, server, maany_mpc_dkg_step, label, rounds);
+}
+
+inline bool RunSign(maany_mpc_ctx_t* ctx, maany_mpc_sign_t* device, maany_mpc_sign_t* server) {
+  return RunPair(ctx, device, server, maany_mpc_sign_step, "maany_mpc_sign_step");
+}
+
+inline bool SamePubKey(const maany_mpc_pubkey_t& a, const maany_mpc_pubkey_t& b) {
+  return a.pubkey.len == b.pubkey.len && std::memcmp(a.pubkey.data, b.pubkey.data, a.pubkey.len) == 0;
+}
+
+}  // namespace maany::test
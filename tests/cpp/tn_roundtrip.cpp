@@ -0,0 +1,216 @@
+#include "maany_mpc.h"
+#include "test_util.h"
+
+#include <cbmpc/crypto/base.h>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+namespace {
+
+using maany::test::AbortOnError;
+using maany::test::SamePubKey;
+
+constexpr uint32_t kPartyCount = 3;
+constexpr uint32_t kThreshold = 2;
+
+// Per-party inbox of frames tagged with their sender.
+struct Inbox {
+  std::vector<maany_mpc_peer_msg_t> frames;
+
+  void Reset() {
+    for (auto& frame : frames) std::free(frame.msg.data);
+    frames.clear();
+  }
+};
+
+// Moves every outbound frame of `from` into the inbox of its destination,
+// retagging it with the sender index.
+bool Route(maany_mpc_ctx_t* ctx, uint32_t from, maany_mpc_peer_msg_t* out, size_t out_count,
+           std::vector<Inbox>& inboxes) {
+  for (size_t i = 0; i < out_count; ++i) {
+    if (out[i].peer >= inboxes.size() || out[i].peer == from) {
+      std::fprintf(stderr, "party %u addressed invalid peer %u\n", from, out[i].peer);
+      maany_mpc_peer_msgs_free(ctx, out, out_count);
+      return false;
+    }
+    maany_mpc_peer_msg_t frame{};
+    frame.peer = from;
+    frame.msg.len = out[i].msg.len;
+    frame.msg.data = static_cast<uint8_t*>(std::malloc(out[i].msg.len ? out[i].msg.len : 1));
+    if (out[i].msg.len) std::memcpy(frame.msg.data, out[i].msg.data, out[i].msg.len);
+    inboxes[out[i].peer].frames.push_back(frame);
+  }
+  maany_mpc_peer_msgs_free(ctx, out, out_count);
+  return true;
+}
+
+bool RunDkg(maany_mpc_ctx_t* ctx, std::vector<maany_mpc_tn_dkg_t*>& dkgs) {
+  std::vector<Inbox> inboxes(dkgs.size());
+  std::vector<bool> done(dkgs.size(), false);
+  int guard = 0;
+  for (;;) {
+    bool all_done = true;
+    for (bool d : done) all_done = all_done && d;
+    if (all_done) break;
+    if (++guard > 64) {
+      std::fprintf(stderr, "threshold DKG loop guard triggered\n");
+      return false;
+    }
+
+    for (uint32_t p = 0; p < dkgs.size(); ++p) {
+      if (done[p]) continue;
+      std::vector<maany_mpc_peer_msg_t> in = std::move(inboxes[p].frames);
+      inboxes[p].frames.clear();
+      maany_mpc_peer_msg_t* out = nullptr;
+      size_t out_count = 0;
+      maany_mpc_step_result_t step{};
+      AbortOnError(maany_mpc_tn_dkg_step(ctx, dkgs[p], in.data(), in.size(), &out, &out_count, &step),
+                   "maany_mpc_tn_dkg_step");
+      for (auto& frame : in) std::free(frame.msg.data);
+      if (!Route(ctx, p, out, out_count, inboxes)) return false;
+      done[p] = (step == MAANY_MPC_STEP_DONE);
+    }
+  }
+  for (auto& inbox : inboxes) inbox.Reset();
+  return true;
+}
+
+bool RunSign(maany_mpc_ctx_t* ctx, const std::vector<maany_mpc_keypair_t*>& kps, const std::vector<uint32_t>& signers,
+             uint32_t receiver, const std::vector<uint8_t>& message, const maany_mpc_pubkey_t& pub) {
+  maany_mpc_tn_sign_opts_t opts{};
+  opts.signers = signers.data();
+  opts.signer_count = signers.size();
+  opts.sig_receiver = receiver;
+
+  std::vector<maany_mpc_tn_sign_t*> sessions(kPartyCount, nullptr);
+  for (uint32_t p : signers) {
+    AbortOnError(maany_mpc_tn_sign_new(ctx, kps[p], &opts, &sessions[p]), "maany_mpc_tn_sign_new");
+    AbortOnError(maany_mpc_tn_sign_set_message(ctx, sessions[p], message.data(), message.size()),
+                 "maany_mpc_tn_sign_set_message");
+  }
+
+  std::vector<Inbox> inboxes(kPartyCount);
+  std::vector<bool> done(kPartyCount, true);
+  for (uint32_t p : signers) done[p] = false;
+  int guard = 0;
+  for (;;) {
+    bool all_done = true;
+    for (bool d : done) all_done = all_done && d;
+    if (all_done) break;
+    if (++guard > 128) {
+      std::fprintf(stderr, "threshold sign loop guard triggered\n");
+      return false;
+    }
+
+    for (uint32_t p : signers) {
+      if (done[p]) continue;
+      std::vector<maany_mpc_peer_msg_t> in = std::move(inboxes[p].frames);
+      inboxes[p].frames.clear();
+      maany_mpc_peer_msg_t* out = nullptr;
+      size_t out_count = 0;
+      maany_mpc_step_result_t step{};
+      AbortOnError(maany_mpc_tn_sign_step(ctx, sessions[p], in.data(), in.size(), &out, &out_count, &step),
+                   "maany_mpc_tn_sign_step");
+      for (auto& frame : in) std::free(frame.msg.data);
+      if (!Route(ctx, p, out, out_count, inboxes)) return false;
+      done[p] = (step == MAANY_MPC_STEP_DONE);
+    }
+  }
+  for (auto& inbox : inboxes) inbox.Reset();
+
+  maany_mpc_buf_t sig_der{};
+  AbortOnError(maany_mpc_tn_sign_finalize(ctx, sessions[receiver], MAANY_MPC_SIG_FORMAT_DER, &sig_der),
+               "maany_mpc_tn_sign_finalize");
+  for (uint32_t p : signers) {
+    if (p == receiver) continue;
+    maany_mpc_buf_t none{};
+    if (maany_mpc_tn_sign_finalize(ctx, sessions[p], MAANY_MPC_SIG_FORMAT_DER, &none) != MAANY_MPC_ERR_PROTO_STATE) {
+      std::fprintf(stderr, "non-receiver party %u exposed a signature\n", p);
+      return false;
+    }
+  }
+
+  coinbase::crypto::ecc_point_t pub_point;
+  if (pub_point.from_bin(coinbase::crypto::curve_secp256k1,
+                         coinbase::mem_t(pub.pubkey.data, static_cast<int>(pub.pubkey.len)))) {
+    std::fprintf(stderr, "Failed to decode public key\n");
+    return false;
+  }
+  coinbase::crypto::ecc_pub_key_t pub_key(pub_point);
+  if (pub_key.verify(coinbase::mem_t(message.data(), static_cast<int>(message.size())),
+                     coinbase::mem_t(sig_der.data, static_cast<int>(sig_der.len)))) {
+    std::fprintf(stderr, "Threshold signature verification failed\n");
+    return false;
+  }
+
+  maany_mpc_buf_free(ctx, &sig_der);
+  for (uint32_t p : signers) maany_mpc_tn_sign_free(sessions[p]);
+  return true;
+}
+
+}  // namespace
+
+int main() {
+  maany_mpc_ctx_t* ctx = maany_mpc_init(nullptr);
+  if (!ctx) {
+    std::fprintf(stderr, "maany_mpc_init failed\n");
+    return 1;
+  }
+
+  std::vector<maany_mpc_tn_dkg_t*> dkgs(kPartyCount, nullptr);
+  for (uint32_t p = 0; p < kPartyCount; ++p) {
+    maany_mpc_tn_dkg_opts_t opts{};
+    opts.curve = MAANY_MPC_CURVE_SECP256K1;
+    opts.party_index = p;
+    opts.party_count = kPartyCount;
+    opts.threshold = kThreshold;
+    AbortOnError(maany_mpc_tn_dkg_new(ctx, &opts, &dkgs[p]), "maany_mpc_tn_dkg_new");
+  }
+
+  if (!RunDkg(ctx, dkgs)) return 1;
+
+  std::vector<maany_mpc_keypair_t*> kps(kPartyCount, nullptr);
+  for (uint32_t p = 0; p < kPartyCount; ++p) {
+    AbortOnError(maany_mpc_tn_dkg_finalize(ctx, dkgs[p], &kps[p]), "maany_mpc_tn_dkg_finalize");
+    maany_mpc_tn_dkg_free(dkgs[p]);
+  }
+
+  std::vector<maany_mpc_pubkey_t> pubs(kPartyCount);
+  for (uint32_t p = 0; p < kPartyCount; ++p) {
+    AbortOnError(maany_mpc_kp_pubkey(ctx, kps[p], &pubs[p]), "maany_mpc_kp_pubkey");
+    if (!SamePubKey(pubs[p], pubs[0])) {
+      std::fprintf(stderr, "Public keys differ across parties\n");
+      return 1;
+    }
+  }
+
+  maany_mpc_kp_meta_t meta{};
+  AbortOnError(maany_mpc_kp_meta(ctx, kps[2], &meta), "maany_mpc_kp_meta");
+  if (meta.scheme != MAANY_MPC_SCHEME_ECDSA_TN || meta.kind != MAANY_MPC_SHARE_RECOVERY) {
+    std::fprintf(stderr, "Unexpected threshold keypair metadata\n");
+    return 1;
+  }
+
+  maany_mpc_buf_t exported{nullptr, 0};
+  AbortOnError(maany_mpc_kp_export(ctx, kps[1], &exported), "maany_mpc_kp_export(server)");
+  maany_mpc_kp_free(kps[1]);
+  kps[1] = nullptr;
+  AbortOnError(maany_mpc_kp_import(ctx, &exported, &kps[1]), "maany_mpc_kp_import(server)");
+  maany_mpc_buf_free(ctx, &exported);
+
+  std::vector<uint8_t> message(32);
+  for (size_t i = 0; i < message.size(); ++i) message[i] = static_cast<uint8_t>(i + 1);
+
+  // Device + server, then server + recovery: any two of three can sign.
+  if (!RunSign(ctx, kps, {0, 1}, 0, message, pubs[0])) return 1;
+  if (!RunSign(ctx, kps, {1, 2}, 1, message, pubs[0])) return 1;
+
+  for (uint32_t p = 0; p < kPartyCount; ++p) {
+    maany_mpc_buf_free(ctx, &pubs[p].pubkey);
+    maany_mpc_kp_free(kps[p]);
+  }
+  maany_mpc_shutdown(ctx);
+  return 0;
+}
@@ -0,0 +1,165 @@
+#include "maany_mpc.h"
+#include "test_util.h"
+
+#include <stdlib.h>
+#include <unistd.h>
+
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+namespace {
+
+using maany::test::AbortOnError;
+using maany::test::RunDkg;
+using maany::test::RunSign;
+
+// Offset of the RNG seed in the encoding described in transcript.h: six u32
+// header fields, then the 32-byte key id.
+constexpr size_t kSeedOffset = 6 * 4 + 32;
+
+std::vector<uint8_t> ReadFile(const std::string& path) {
+  std::ifstream in(path, std::ios::binary);
+  return std::vector<uint8_t>(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+}
+
+// Replays `bytes` and checks it reproduces the recording in at least one step.
+bool ReplayMatches(maany_mpc_ctx_t* ctx, std::vector<uint8_t>& bytes, const maany_mpc_keypair_t* kp,
+                   const char* label) {
+  if (bytes.size() <= kSeedOffset) {
+    std::fprintf(stderr, "%s: transcript missing or truncated\n", label);
+    return false;
+  }
+  maany_mpc_buf_t transcript{bytes.data(), bytes.size()};
+  std::vector<maany_mpc_replay_step_t> steps(32);
+  size_t count = 0;
+  AbortOnError(maany_mpc_replay(ctx, &transcript, kp, steps.data(), steps.size(), &count), label);
+  if (count == 0 || count > steps.size()) {
+    std::fprintf(stderr, "%s: unexpected step count %zu\n", label, count);
+    return false;
+  }
+  size_t out_bytes = 0;
+  for (size_t i = 0; i < count; ++i) out_bytes += steps[i].out_bytes;
+  if (out_bytes == 0) {
+    std::fprintf(stderr, "%s: replay produced no frames\n", label);
+    return false;
+  }
+
+  // A different seed changes the party's nonces, so its frames no longer
+  // match the recording.
+  bytes[kSeedOffset] ^= 0x01;
+  maany_mpc_error_t err = maany_mpc_replay(ctx, &transcript, kp, steps.data(), steps.size(), &count);
+  bytes[kSeedOffset] ^= 0x01;
+  if (err != MAANY_MPC_ERR_PROTO_STATE) {
+    std::fprintf(stderr, "%s: replay under a different seed returned %d\n", label, static_cast<int>(err));
+    return false;
+  }
+
+  maany_mpc_buf_t truncated{bytes.data(), bytes.size() - 1};
+  err = maany_mpc_replay(ctx, &truncated, kp, steps.data(), steps.size(), &count);
+  if (err != MAANY_MPC_ERR_INVALID_ARG) {
+    std::fprintf(stderr, "%s: truncated transcript returned %d\n", label, static_cast<int>(err));
+    return false;
+  }
+  return true;
+}
+
+}  // namespace
+
+int main() {
+  maany_mpc_ctx_t* ctx = maany_mpc_init(nullptr);
+  if (!ctx) {
+    std::fprintf(stderr, "maany_mpc_init failed\n");
+    return 1;
+  }
+
+  char dir_template[] = "/tmp/maany_transcript_XXXXXX";
+  if (!mkdtemp(dir_template)) {
+    std::fprintf(stderr, "mkdtemp failed\n");
+    return 1;
+  }
+  const std::string dir = dir_template;
+  const std::string dkg_path = dir + "/dkg";
+  const std::string sign_path = dir + "/sign";
+  const std::string refresh_path = dir + "/refresh";
+
+  // DKG, recording the server side.
+  maany_mpc_dkg_opts_t opts_device{};
+  opts_device.curve = MAANY_MPC_CURVE_SECP256K1;
+  opts_device.scheme = MAANY_MPC_SCHEME_ECDSA_2P;
+  opts_device.kind = MAANY_MPC_SHARE_DEVICE;
+  maany_mpc_dkg_opts_t opts_server = opts_device;
+  opts_server.kind = MAANY_MPC_SHARE_SERVER;
+  opts_server.transcript_path = dkg_path.c_str();
+
+  maany_mpc_dkg_t* dkg_device = nullptr;
+  maany_mpc_dkg_t* dkg_server = nullptr;
+  AbortOnError(maany_mpc_dkg_new(ctx, &opts_device, &dkg_device), "maany_mpc_dkg_new(device)");
+  AbortOnError(maany_mpc_dkg_new(ctx, &opts_server, &dkg_server), "maany_mpc_dkg_new(server)");
+  if (!RunDkg(ctx, dkg_device, dkg_server)) return 1;
+  maany_mpc_keypair_t* kp_device = nullptr;
+  maany_mpc_keypair_t* kp_server = nullptr;
+  AbortOnError(maany_mpc_dkg_finalize(ctx, dkg_device, &kp_device), "maany_mpc_dkg_finalize(device)");
+  AbortOnError(maany_mpc_dkg_finalize(ctx, dkg_server, &kp_server), "maany_mpc_dkg_finalize(server)");
+  maany_mpc_dkg_free(dkg_device);
+  maany_mpc_dkg_free(dkg_server);
+
+  // Sign, recording the server side.
+  std::vector<uint8_t> message(32, 0x5a);
+  maany_mpc_sign_opts_t sign_opts{};
+  sign_opts.scheme = MAANY_MPC_SCHEME_ECDSA_2P;
+  maany_mpc_sign_opts_t sign_server_opts = sign_opts;
+  sign_server_opts.transcript_path = sign_path.c_str();
+  maany_mpc_sign_t* sign_device = nullptr;
+  maany_mpc_sign_t* sign_server = nullptr;
+  AbortOnError(maany_mpc_sign_new(ctx, kp_device, &sign_opts, &sign_device), "maany_mpc_sign_new(device)");
+  AbortOnError(maany_mpc_sign_new(ctx, kp_server, &sign_server_opts, &sign_server), "maany_mpc_sign_new(server)");
+  AbortOnError(maany_mpc_sign_set_message(ctx, sign_device, message.data(), message.size()),
+               "maany_mpc_sign_set_message(device)");
+  AbortOnError(maany_mpc_sign_set_message(ctx, sign_server, message.data(), message.size()),
+               "maany_mpc_sign_set_message(server)");
+  if (!RunSign(ctx, sign_device, sign_server)) return 1;
+  maany_mpc_sign_free(sign_device);
+  maany_mpc_sign_free(sign_server);
+
+  // Refresh, recording the server side. Replay needs the share from before it.
+  maany_mpc_refresh_opts_t refresh_opts{};
+  maany_mpc_refresh_opts_t refresh_server_opts = refresh_opts;
+  refresh_server_opts.transcript_path = refresh_path.c_str();
+  maany_mpc_dkg_t* refresh_device = nullptr;
+  maany_mpc_dkg_t* refresh_server = nullptr;
+  AbortOnError(maany_mpc_refresh_new(ctx, kp_device, &refresh_opts, &refresh_device),
+               "maany_mpc_refresh_new(device)");
+  AbortOnError(maany_mpc_refresh_new(ctx, kp_server, &refresh_server_opts, &refresh_server),
+               "maany_mpc_refresh_new(server)");
+  if (!RunDkg(ctx, refresh_device, refresh_server, "maany_mpc_dkg_step(refresh)")) return 1;
+  maany_mpc_dkg_free(refresh_device);
+  maany_mpc_dkg_free(refresh_server);
+
+  std::vector<uint8_t> dkg_bytes = ReadFile(dkg_path);
+  std::vector<uint8_t> sign_bytes = ReadFile(sign_path);
+  std::vector<uint8_t> refresh_bytes = ReadFile(refresh_path);
+  if (!ReplayMatches(ctx, dkg_bytes, nullptr, "maany_mpc_replay(dkg)")) return 1;
+  if (!ReplayMatches(ctx, sign_bytes, kp_server, "maany_mpc_replay(sign)")) return 1;
+  if (!ReplayMatches(ctx, refresh_bytes, kp_server, "maany_mpc_replay(refresh)")) return 1;
+
+  // Sign and refresh replays need the recorded party's share.
+  maany_mpc_buf_t sign_transcript{sign_bytes.data(), sign_bytes.size()};
+  size_t count = 0;
+  if (maany_mpc_replay(ctx, &sign_transcript, nullptr, nullptr, 0, &count) != MAANY_MPC_ERR_INVALID_ARG ||
+      maany_mpc_replay(ctx, &sign_transcript, kp_device, nullptr, 0, &count) != MAANY_MPC_ERR_INVALID_ARG) {
+    std::fprintf(stderr, "Sign replay accepted a missing or foreign share\n");
+    return 1;
+  }
+
+  ::unlink(dkg_path.c_str());
+  ::unlink(sign_path.c_str());
+  ::unlink(refresh_path.c_str());
+  ::rmdir(dir_template);
+  maany_mpc_kp_free(kp_device);
+  maany_mpc_kp_free(kp_server);
+  maany_mpc_shutdown(ctx);
+  return 0;
+}